@@ -0,0 +1,204 @@
+// FILE: column_sequence.cxx
+// CLASS IMPLEMENTED: column_sequence (see column_sequence.h for documentation)
+// INVARIANT for the column_sequence class:
+//   1. chain holds the order of the records, the cursor and the free slots
+//      (see the invariant in index_chain.cxx).
+//
+//   2. Every column and live_flags have exactly chain.capacity( ) entries.
+//      Field I of the record in slot s is std::get<I>(columns)[s].
+//
+//   3. live_flags[s] is 1 if slot s holds a record and 0 if it is free. Every
+//      field of a free slot holds its default (zero) value.
+
+#include <cassert>    // Provides assert
+
+namespace scu_coen70_6B
+{
+    template<class... Fields>
+    template<std::size_t... I>
+    void column_sequence<Fields...>::reserve_fields(size_type n, std::index_sequence<I...>)
+    {
+        (std::get<I>(columns).reserve(n), ...);
+        live_flags.reserve(n);
+    }
+
+    template<class... Fields>
+    template<class Vector>
+    void column_sequence<Fields...>::make_room(Vector& v)
+    {
+        if (v.size( ) == v.capacity( ))
+            v.reserve(v.empty( ) ? 16 : 2 * v.size( ));
+    }
+
+    template<class... Fields>
+    template<std::size_t... I>
+    void column_sequence<Fields...>::store_fields(index_chain::index_type slot, const value_type& entry,
+                                                  std::index_sequence<I...>)
+    {
+        ((std::get<I>(columns)[slot] = std::get<I>(entry)), ...);
+        live_flags[slot] = 1;
+    }
+
+    template<class... Fields>
+    template<std::size_t... I>
+    void column_sequence<Fields...>::append_fields(const value_type& entry, std::index_sequence<I...>)
+    {
+        // Make room first: once every column has spare capacity, the
+        // push_backs of trivially copyable fields cannot throw, so the
+        // columns never end up with different lengths.
+        (make_room(std::get<I>(columns)), ...);
+        make_room(live_flags);
+        (std::get<I>(columns).push_back(std::get<I>(entry)), ...);
+        live_flags.push_back(1);
+    }
+
+    template<class... Fields>
+    template<std::size_t... I>
+    void column_sequence<Fields...>::drop_last_fields(std::index_sequence<I...>)
+    {
+        (std::get<I>(columns).pop_back( ), ...);
+        live_flags.pop_back( );
+    }
+
+    template<class... Fields>
+    template<std::size_t... I>
+    void column_sequence<Fields...>::clear_fields(index_chain::index_type slot, std::index_sequence<I...>)
+    {
+        ((std::get<I>(columns)[slot] = Fields( )), ...);
+        live_flags[slot] = 0;
+    }
+
+    template<class... Fields>
+    template<std::size_t... I>
+    typename column_sequence<Fields...>::value_type
+    column_sequence<Fields...>::load_fields(index_chain::index_type slot, std::index_sequence<I...>) const
+    {
+        return value_type(std::get<I>(columns)[slot]...);
+    }
+
+    // Acquires a slot from the chain and scatters entry into the columns. A
+    // new slot is added to the columns before the chain grows, so a throw
+    // from either one leaves every column chain.capacity( ) entries long and
+    // the scans below in bounds.
+    template<class... Fields>
+    index_chain::index_type column_sequence<Fields...>::store(const value_type& entry)
+    {
+        static_assert((std::is_trivially_copyable<Fields>::value && ...),
+                      "column_sequence fields must be trivially copyable");
+        index_chain::index_type slot;
+
+        if (chain.has_free( ))
+        {
+            // Recycling a slot and copying trivially copyable fields cannot throw.
+            slot = chain.acquire( );
+            store_fields(slot, entry, field_indices( ));
+            return slot;
+        }
+        append_fields(entry, field_indices( ));
+        try
+        {
+            slot = chain.acquire( );
+        }
+        catch (...)
+        {
+            drop_last_fields(field_indices( ));
+            throw;
+        }
+        return slot;
+    }
+
+    template<class... Fields>
+    void column_sequence<Fields...>::insert(const value_type& entry)
+    {
+        chain.link_insert(store(entry));
+    }
+
+    template<class... Fields>
+    void column_sequence<Fields...>::attach(const value_type& entry)
+    {
+        chain.link_attach(store(entry));
+    }
+
+    template<class... Fields>
+    void column_sequence<Fields...>::remove_current( )
+    {
+        assert(is_item( ));
+
+        clear_fields(chain.unlink_current( ), field_indices( ));
+    }
+
+    template<class... Fields>
+    template<std::size_t I>
+    void column_sequence<Fields...>::set(const field_type<I>& value)
+    {
+        assert(is_item( ));
+
+        std::get<I>(columns)[chain.cursor( )] = value;
+    }
+
+    template<class... Fields>
+    void column_sequence<Fields...>::reserve(size_type n)
+    {
+        chain.reserve(n);
+        reserve_fields(n, field_indices( ));
+    }
+
+    template<class... Fields>
+    typename column_sequence<Fields...>::value_type column_sequence<Fields...>::current( ) const
+    {
+        assert(is_item( ));
+
+        return load_fields(chain.cursor( ), field_indices( ));
+    }
+
+    template<class... Fields>
+    template<std::size_t I>
+    typename column_sequence<Fields...>::template field_type<I> column_sequence<Fields...>::get( ) const
+    {
+        assert(is_item( ));
+
+        return std::get<I>(columns)[chain.cursor( )];
+    }
+
+    template<class... Fields>
+    template<std::size_t I>
+    typename column_sequence<Fields...>::template field_type<I> column_sequence<Fields...>::sum_column( ) const
+    {
+        const field_type<I>* data = column<I>( );
+        size_type n = capacity( );
+        field_type<I> answer = field_type<I>( );
+
+        for (size_type i = 0; i < n; ++i)
+            answer += data[i];
+        return answer;
+    }
+
+    template<class... Fields>
+    template<std::size_t I, class T, class BinaryOp>
+    T column_sequence<Fields...>::reduce_column(T init, BinaryOp op) const
+    {
+        const field_type<I>* data = column<I>( );
+        const unsigned char* flags = live( );
+        size_type n = capacity( );
+
+        for (size_type i = 0; i < n; ++i)
+            if (flags[i])
+                init = op(init, data[i]);
+        return init;
+    }
+
+    template<class... Fields>
+    template<std::size_t I, class Predicate>
+    typename column_sequence<Fields...>::size_type column_sequence<Fields...>::count_column_if(Predicate pred) const
+    {
+        const field_type<I>* data = column<I>( );
+        const unsigned char* flags = live( );
+        size_type n = capacity( );
+        size_type answer = 0;
+
+        // Branch-free so that the loop vectorizes.
+        for (size_type i = 0; i < n; ++i)
+            answer += size_type(flags[i] != 0) & size_type(pred(data[i]) ? 1 : 0);
+        return answer;
+    }
+}
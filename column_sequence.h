@@ -0,0 +1,166 @@
+// FILE: column_sequence.h
+// CLASS PROVIDED: column_sequence (part of the namespace scu_coen70_6B)
+// A structure-of-arrays sequence of records. column_sequence<F0, F1, ...>
+// stores a sequence of std::tuple<F0, F1, ...> records, but keeps each field
+// in a contiguous column of its own. The order of the records, the cursor and
+// the free slots are shared by all columns through one index_chain (see
+// index_chain.h), so insert, attach and remove_current still work one record
+// at a time, while a scan of one field reads only that field's column.
+//
+// Each field type must be trivially copyable (int, double, a small POD
+// struct, ...). Requires C++17.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the column_sequence class:
+//   typedef std::tuple<Fields...> value_type
+//     The record type.
+//
+//   typedef ____ size_type
+//     The data type of any variable that counts records or slots.
+//
+//   template<std::size_t I> using field_type = ...
+//     The type of field I.
+//
+//   static const std::size_t FIELDS
+//     The number of fields in a record.
+//
+// CONSTRUCTOR for the column_sequence class:
+//   column_sequence( )
+//     Postcondition: The column_sequence is empty.
+//
+// MODIFICATION MEMBER FUNCTIONS for the column_sequence class:
+//   void start( )
+//   void advance( )
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current( )
+//     Same preconditions and postconditions as in sequence4.h, for whole
+//     records. Every field of a removed slot is reset to its default value.
+//
+//   template<std::size_t I> void set(const field_type<I>& value)
+//     Precondition: is_item( ) returns true.
+//     Postcondition: Field I of the current record has been set to value.
+//
+//   void reserve(size_type n)
+//     Postcondition: Every column has room for n records.
+//
+// CONSTANT MEMBER FUNCTIONS for the column_sequence class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//     Same as in sequence4.h.
+//
+//   value_type current( ) const
+//     Precondition: is_item( ) returns true.
+//     Postcondition: The return value is the whole current record.
+//
+//   template<std::size_t I> field_type<I> get( ) const
+//     Precondition: is_item( ) returns true.
+//     Postcondition: The return value is field I of the current record.
+//
+// COLUMN SCANS:
+//   These walk a column in slot order, not sequence order, so they are meant
+//   for order-independent work. The loops are plain contiguous array walks
+//   that the compiler can vectorize.
+//
+//   template<std::size_t I> field_type<I> sum_column( ) const
+//     Postcondition: The return value is the sum of field I over every
+//     record. (Free slots hold zero, so they are summed without a test.)
+//
+//   template<std::size_t I, class T, class BinaryOp>
+//   T reduce_column(T init, BinaryOp op) const
+//     Precondition: op is associative and commutative.
+//     Postcondition: The return value is op folded over init and field I of
+//     every record, in an unspecified order.
+//
+//   template<std::size_t I, class Predicate>
+//   size_type count_column_if(Predicate pred) const
+//     Postcondition: The return value is the number of records whose field I
+//     satisfies pred.
+//
+//   template<std::size_t I> const field_type<I>* column( ) const
+//   const unsigned char* live( ) const
+//   size_type capacity( ) const
+//     Postcondition: column<I>( ) points to the capacity( ) entries of column
+//     I, and live( )[s] is nonzero exactly when slot s holds a record. Both
+//     are invalidated by insert, attach and reserve.
+//
+// VALUE SEMANTICS for the column_sequence class:
+//   Assignments and the copy constructor may be used, and keep the cursor on
+//   the same record.
+//
+// DYNAMIC MEMORY usage by the column_sequence class:
+//   If there is insufficient dynamic memory, then insert, attach, reserve,
+//   the copy constructor and the assignment operator throw bad_alloc.
+
+#ifndef COEN_70_COLUMN_SEQUENCE_H
+#define COEN_70_COLUMN_SEQUENCE_H
+#include <cstdlib>      // Provides size_t
+#include <tuple>        // Provides tuple
+#include <type_traits>  // Provides is_trivially_copyable
+#include <utility>      // Provides index_sequence
+#include <vector>       // Provides the columns
+#include "index_chain.h" // Provides the shared index links
+
+namespace scu_coen70_6B
+{
+    template<class... Fields>
+    class column_sequence
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef std::tuple<Fields...> value_type;
+        typedef std::size_t size_type;
+        template<std::size_t I>
+        using field_type = typename std::tuple_element<I, value_type>::type;
+        static const std::size_t FIELDS = sizeof...(Fields);
+        // MODIFICATION MEMBER FUNCTIONS
+        void start( ) { chain.start( ); }
+        void advance( ) { chain.advance( ); }
+        void insert(const value_type& entry);
+        void attach(const value_type& entry);
+        void remove_current( );
+        template<std::size_t I>
+        void set(const field_type<I>& value);
+        void reserve(size_type n);
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return chain.size( ); }
+        bool is_item( ) const { return chain.is_item( ); }
+        value_type current( ) const;
+        template<std::size_t I>
+        field_type<I> get( ) const;
+        // COLUMN SCANS
+        template<std::size_t I>
+        field_type<I> sum_column( ) const;
+        template<std::size_t I, class T, class BinaryOp>
+        T reduce_column(T init, BinaryOp op) const;
+        template<std::size_t I, class Predicate>
+        size_type count_column_if(Predicate pred) const;
+        template<std::size_t I>
+        const field_type<I>* column( ) const { return std::get<I>(columns).data( ); }
+        const unsigned char* live( ) const { return live_flags.data( ); }
+        size_type capacity( ) const { return chain.capacity( ); }
+    private:
+        typedef std::index_sequence_for<Fields...> field_indices;
+
+        index_chain chain;
+        std::tuple<std::vector<Fields>...> columns;
+        std::vector<unsigned char> live_flags;
+
+        index_chain::index_type store(const value_type& entry);
+        template<std::size_t... I>
+        void store_fields(index_chain::index_type slot, const value_type& entry, std::index_sequence<I...>);
+        template<std::size_t... I>
+        void append_fields(const value_type& entry, std::index_sequence<I...>);
+        template<std::size_t... I>
+        void drop_last_fields(std::index_sequence<I...>);
+        template<std::size_t... I>
+        void clear_fields(index_chain::index_type slot, std::index_sequence<I...>);
+        template<std::size_t... I>
+        value_type load_fields(index_chain::index_type slot, std::index_sequence<I...>) const;
+        template<std::size_t... I>
+        void reserve_fields(size_type n, std::index_sequence<I...>);
+        template<class Vector>
+        static void make_room(Vector& v);
+    };
+}
+#include "column_sequence.cxx"
+#endif
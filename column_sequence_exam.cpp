@@ -0,0 +1,687 @@
+// FILE: column_sequence_exam.cpp
+// Non-interactive test program for the column_sequence class (see
+// column_sequence.h) and the index_chain class it shares with
+// compact_sequence (see index_chain.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the two classes, returning
+// some number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. The records of a
+// column_sequence<int, double, short> are checked against a vector of
+// tuples that models it, and the column scans against sums and counts over
+// the model; the raw columns must also agree with the live flags, with
+// free slots holding zero. The index_chain is checked on its own against a
+// vector of slot numbers. The last test replaces the global operator new
+// with one that can be told to fail, and checks that the columns are never
+// shorter than the chain, so the scans stay in bounds after a bad_alloc.
+// The program returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 column_sequence_exam.cpp -o column_sequence_exam
+//     ./column_sequence_exam
+
+#include <algorithm>            // Provides find, max.
+#include <iostream>             // Provides cout.
+#include <cstdlib>              // Provides size_t, malloc, free.
+#include <new>                  // Provides bad_alloc.
+#include <random>               // Provides mt19937 for the random edits.
+#include <tuple>                // Provides tuple, get.
+#include <vector>               // Provides vector for the expected records.
+#include "column_sequence.h"    // Provides the column_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the column_sequence and index_chain classes",
+    "Testing random edits, set and get against a vector of records",
+    "Testing the column scans, the raw columns and the live flags",
+    "Testing index_chain links, free slots and copies",
+    "Testing that the columns stay as long as the chain after bad_alloc"
+};
+
+typedef column_sequence<int, double, short> records;
+typedef records::value_type record;
+
+// The number of allocations operator new allows before it throws bad_alloc,
+// or -1 for no limit.
+long allocations_left = -1;
+
+void* operator new(size_t bytes)
+{
+    void* p;
+
+    if (allocations_left == 0)
+        throw bad_alloc( );
+    if (allocations_left > 0)
+        --allocations_left;
+    p = malloc((bytes == 0) ? 1 : bytes);
+    if (p == NULL)
+        throw bad_alloc( );
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+// **************************************************************************
+// record make_record(int x)
+//   Postcondition: The return value is a record made from x, whose double
+//   is exact so that sums of it do not depend on their order.
+// **************************************************************************
+record make_record(int x)
+{
+    return record(x, x * 0.5, short(x % 7));
+}
+
+
+// **************************************************************************
+// size_t spot_of(records test)
+//   Postcondition: The return value is the number of records before the
+//   current record of test, or test.size( ) if there is none. (test is a
+//   copy, which keeps the cursor on the same record.)
+// **************************************************************************
+size_t spot_of(records test)
+{
+    size_t after = 0;
+
+    for ( ; test.is_item( ); test.advance( ))
+        ++after;
+    return test.size( ) - after;
+}
+
+
+// **************************************************************************
+// bool matches(const records& test, const vector<record>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the records in items, in order, and that record [cursor_spot] is its
+//   current record (get<I> agreeing with current), or that it has no
+//   current record if cursor_spot >= items.size( ).
+// **************************************************************************
+bool matches(const records& test, const vector<record>& items, size_t cursor_spot)
+{
+    records walk(test);
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    walk.start( );
+    for (i = 0; i < items.size( ); ++i, walk.advance( ))
+    {
+        if (!walk.is_item( ) || (walk.current( ) != items[i]))
+            return false;
+    }
+    if (walk.is_item( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (spot_of(test) == test.size( ));
+    return test.is_item( ) && (spot_of(test) == cursor_spot)
+        && (test.current( ) == items[cursor_spot])
+        && (test.get<0>( ) == get<0>(items[cursor_spot]))
+        && (test.get<1>( ) == get<1>(items[cursor_spot]))
+        && (test.get<2>( ) == get<2>(items[cursor_spot]));
+}
+
+
+// **************************************************************************
+// bool random_edits(records& test, vector<record>& items, size_t& cursor_spot,
+//                   mt19937& random, int many)
+//   Precondition: test matches items with the cursor at cursor_spot.
+//   Postcondition: many random inserts, attaches, removes, sets and moves
+//   have been made to test and to the model, and the return value is true
+//   if test still matched the model after each one. Otherwise a message has
+//   been printed.
+// **************************************************************************
+bool random_edits(records& test, vector<record>& items, size_t& cursor_spot, mt19937& random, int many)
+{
+    for (int step = 0; step < many; ++step)
+    {
+        int choice = int(random( ) % 12);
+        record entry = make_record(int(random( ) % 2000) - 1000);
+
+        if (choice < 3)
+        {
+            // insert: before the current record, or at the front.
+            if (cursor_spot >= items.size( ))
+                cursor_spot = 0;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.insert(entry);
+        }
+        else if (choice < 6)
+        {
+            // attach: after the current record, or at the back.
+            cursor_spot = (cursor_spot >= items.size( )) ? items.size( ) : cursor_spot + 1;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.attach(entry);
+        }
+        else if (choice < 8)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                items.erase(items.begin( ) + cursor_spot);
+                test.remove_current( );
+            }
+        }
+        else if (choice < 10)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                // Change one field of the current record.
+                if (choice == 8)
+                {
+                    get<1>(items[cursor_spot]) = get<1>(entry);
+                    test.set<1>(get<1>(entry));
+                }
+                else
+                {
+                    get<2>(items[cursor_spot]) = get<2>(entry);
+                    test.set<2>(get<2>(entry));
+                }
+            }
+        }
+        else if (choice < 11)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                ++cursor_spot;
+                test.advance( );
+            }
+        }
+        else
+        {
+            cursor_spot = 0;
+            test.start( );
+        }
+        if (!matches(test, items, cursor_spot))
+        {
+            cout << "The sequence went wrong after " << step + 1 << " edits." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// bool scans_agree(const records& test, const vector<record>& items)
+//   Postcondition: A return value of true indicates that the column scans
+//   of test agree with the model, that the live flags mark exactly
+//   test.size( ) of the capacity( ) slots, that the live slots hold the
+//   model's fields, and that the free slots hold zero. Otherwise a message
+//   has been printed.
+// **************************************************************************
+bool scans_agree(const records& test, const vector<record>& items)
+{
+    const int* ints = test.column<0>( );
+    const double* doubles = test.column<1>( );
+    const short* shorts = test.column<2>( );
+    const unsigned char* flags = test.live( );
+    long int_sum = 0;
+    double double_sum = 0;
+    int short_sum = 0;
+    int largest = -1000000;
+    size_t threes = 0;
+    size_t live = 0;
+    size_t i;
+
+    for (i = 0; i < items.size( ); ++i)
+    {
+        int_sum += get<0>(items[i]);
+        double_sum += get<1>(items[i]);
+        short_sum += get<2>(items[i]);
+        largest = max(largest, get<0>(items[i]));
+        threes += (get<2>(items[i]) == 3) ? 1 : 0;
+    }
+    if ((long(test.sum_column<0>( )) != int_sum) || (test.sum_column<1>( ) != double_sum)
+        || (test.reduce_column<2>(0, [](int a, short b) { return a + b; }) != short_sum)
+        || (test.reduce_column<0>(-1000000, [](int a, int b) { return max(a, b); }) != largest)
+        || (test.count_column_if<2>([](short s) { return s == 3; }) != threes)
+        || (test.count_column_if<0>([](int) { return true; }) != items.size( )))
+    {
+        cout << "A column scan disagreed with the model." << endl;
+        return false;
+    }
+    for (i = 0; i < test.capacity( ); ++i)
+    {
+        if (flags[i])
+        {
+            record slot(ints[i], doubles[i], shorts[i]);
+            ++live;
+            if (find(items.begin( ), items.end( ), slot) == items.end( ))
+            {
+                cout << "Live slot " << i << " holds a record not in the model." << endl;
+                return false;
+            }
+        }
+        else if ((ints[i] != 0) || (doubles[i] != 0) || (shorts[i] != 0))
+        {
+            cout << "Free slot " << i << " does not hold zero." << endl;
+            return false;
+        }
+    }
+    if (live != items.size( ))
+    {
+        cout << live << " slots are marked live, for " << items.size( ) << " records." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Makes 12000 random edits and moves to a column_sequence and to a vector
+//   of records, and checks that they agree after each one, and that copies
+//   and assignment keep the cursor. Returns POINTS[1] if the tests are
+//   passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    mt19937 random(28);
+    records test;
+    vector<record> items;
+    size_t cursor_spot = 0;
+
+    cout << "Checking an empty sequence ... ";
+    cout.flush( );
+    if (!matches(test, items, 0) || (test.capacity( ) != 0) || (records::FIELDS != 3))
+    {
+        cout << "A new sequence was not empty." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking 12000 random edits, sets and moves ... ";
+    cout.flush( );
+    for (int round = 0; round < 6; ++round)
+    {
+        if (!random_edits(test, items, cursor_spot, random, 2000))
+            return 0;
+        if (round % 3 == 1)
+        {
+            for (test.start( ); test.is_item( ); )
+                test.remove_current( );
+            items.clear( );
+            cursor_spot = 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking copies and assignment ... ";
+    cout.flush( );
+    {
+        records copy(test);
+        records assigned;
+
+        assigned.attach(make_record(1));
+        assigned = test;
+        if (!matches(copy, items, cursor_spot) || !matches(assigned, items, cursor_spot))
+        {
+            cout << "A copy did not match its source." << endl;
+            return 0;
+        }
+        copy.attach(make_record(5));
+        assigned.start( );
+        if (assigned.is_item( ))
+            assigned.remove_current( );
+        if (!matches(test, items, cursor_spot))
+        {
+            cout << "Changing a copy changed the source." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Checks the column scans, column<I>( ), live( ) and capacity( ) against
+//   the model after each of 200 rounds of random edits, and that reserve
+//   leaves the records alone. Returns POINTS[2] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    mt19937 random(29);
+    records test;
+    vector<record> items;
+    size_t cursor_spot = 0;
+
+    cout << "Checking the scans of an empty sequence ... ";
+    cout.flush( );
+    if (!scans_agree(test, items))
+        return 0;
+    cout << "Passed." << endl;
+
+    cout << "Checking the scans after 200 rounds of edits ... ";
+    cout.flush( );
+    for (int round = 0; round < 200; ++round)
+    {
+        if (!random_edits(test, items, cursor_spot, random, 25) || !scans_agree(test, items))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking reserve ... ";
+    cout.flush( );
+    {
+        size_t slots = test.capacity( );
+
+        test.reserve(slots + 1000);
+        if (!matches(test, items, cursor_spot) || (test.capacity( ) != slots) || !scans_agree(test, items))
+        {
+            cout << "reserve changed the records or the number of slots." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// bool chain_matches(const index_chain& test, const vector<index_chain::index_type>& order,
+//                    size_t cursor_spot, size_t free_slots)
+//   Postcondition: A return value of true indicates that the linked slots
+//   of test are exactly order, in order, with slot [cursor_spot] current
+//   (none if cursor_spot >= order.size( )) and the precursor and tail to
+//   match, and that free_slots slots are free.
+// **************************************************************************
+bool chain_matches(const index_chain& test, const vector<index_chain::index_type>& order,
+                   size_t cursor_spot, size_t free_slots)
+{
+    const index_chain::index_type NIL = index_chain::NIL;
+    index_chain::index_type slot = test.head( );
+    size_t i;
+
+    if ((test.size( ) != order.size( )) || (test.capacity( ) != order.size( ) + free_slots)
+        || (test.has_free( ) != (free_slots > 0)))
+        return false;
+    for (i = 0; i < order.size( ); ++i, slot = test.link(slot))
+    {
+        if ((slot != order[i]) || (test.links( )[slot] != test.link(slot)))
+            return false;
+    }
+    if ((slot != NIL) || (test.tail( ) != (order.empty( ) ? NIL : order.back( ))))
+        return false;
+    if (cursor_spot >= order.size( ))
+        return !test.is_item( ) && (test.cursor( ) == NIL) && (test.precursor( ) == test.tail( ));
+    return test.is_item( ) && (test.cursor( ) == order[cursor_spot])
+        && (test.precursor( ) == ((cursor_spot == 0) ? NIL : order[cursor_spot - 1]));
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Makes 20000 random acquires, links, unlinks, releases and moves to an
+//   index_chain and to a vector of slot numbers, checking after each one,
+//   and checks that a copy keeps every slot number. Returns POINTS[3] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    typedef index_chain::index_type index_type;
+    mt19937 random(30);
+    index_chain test;
+    vector<index_type> order;
+    size_t cursor_spot = 0;
+    size_t free_slots = 0;
+
+    cout << "Checking 20000 random chain operations ... ";
+    cout.flush( );
+    if (!chain_matches(test, order, 0, 0))
+    {
+        cout << "A new chain was not empty." << endl;
+        return 0;
+    }
+    for (int step = 0; step < 20000; ++step)
+    {
+        int choice = int(random( ) % 10);
+
+        if (choice < 5)
+        {
+            bool recycled = test.has_free( );
+            size_t slots = test.capacity( );
+            index_type slot = test.acquire( );
+
+            // A new slot is numbered after the old ones; a recycled one is not.
+            if ((recycled && ((slot >= slots) || (test.capacity( ) != slots)))
+                || (!recycled && ((slot != slots) || (test.capacity( ) != slots + 1))))
+            {
+                cout << "acquire gave slot " << slot << " of " << test.capacity( ) << "." << endl;
+                return 0;
+            }
+            if (recycled)
+                --free_slots;
+            if (find(order.begin( ), order.end( ), slot) != order.end( ))
+            {
+                cout << "acquire gave slot " << slot << ", which is linked." << endl;
+                return 0;
+            }
+            if (choice == 0)
+            {
+                // As a failed store would.
+                test.release(slot);
+                ++free_slots;
+            }
+            else if (choice < 3)
+            {
+                if (cursor_spot >= order.size( ))
+                    cursor_spot = 0;
+                order.insert(order.begin( ) + cursor_spot, slot);
+                test.link_insert(slot);
+            }
+            else
+            {
+                cursor_spot = (cursor_spot >= order.size( )) ? order.size( ) : cursor_spot + 1;
+                order.insert(order.begin( ) + cursor_spot, slot);
+                test.link_attach(slot);
+            }
+        }
+        else if (choice < 8)
+        {
+            if (cursor_spot < order.size( ))
+            {
+                index_type removed = test.unlink_current( );
+                if (removed != order[cursor_spot])
+                {
+                    cout << "unlink_current returned the wrong slot." << endl;
+                    return 0;
+                }
+                order.erase(order.begin( ) + cursor_spot);
+                ++free_slots;
+            }
+        }
+        else if (choice < 9)
+        {
+            if (cursor_spot < order.size( ))
+            {
+                ++cursor_spot;
+                test.advance( );
+            }
+        }
+        else
+        {
+            cursor_spot = 0;
+            test.start( );
+        }
+        if (!chain_matches(test, order, cursor_spot, free_slots))
+        {
+            cout << "The chain went wrong after " << step + 1 << " operations." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking that a copy keeps every slot number ... ";
+    cout.flush( );
+    {
+        index_chain copy(test);
+        index_chain assigned;
+
+        assigned.link_attach(assigned.acquire( ));
+        assigned = test;
+        if (!chain_matches(copy, order, cursor_spot, free_slots)
+            || !chain_matches(assigned, order, cursor_spot, free_slots))
+        {
+            cout << "A copy did not match its source." << endl;
+            return 0;
+        }
+        for (index_type s = 0; s < test.capacity( ); ++s)
+        {
+            if (copy.links( )[s] != test.links( )[s])
+            {
+                cout << "A copy changed the link of slot " << s << "." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Lets operator new fail after 0, 1, 2, ... allocations while records are
+//   attached, inserted and removed, and checks after each bad_alloc that
+//   the sequence matches the model and its scans (which read capacity( )
+//   entries of every column) agree with it, then that it can still grow.
+//   Returns POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    int failures = 0;
+
+    cout << "Checking edits that run out of memory ... ";
+    cout.flush( );
+    for (long budget = 0; budget < 40; ++budget)
+    {
+        records test;
+        vector<record> items;
+        size_t cursor_spot = 0;
+        long left = budget;
+
+        try
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                record entry = make_record(i);
+
+                // Count the allocations of the edits alone, not the model's.
+                allocations_left = left;
+                if (i % 5 == 4)
+                    test.insert(entry);
+                else
+                    test.attach(entry);
+                left = allocations_left;
+                allocations_left = -1;
+                if (cursor_spot >= items.size( ))
+                    cursor_spot = (i % 5 == 4) ? 0 : items.size( );
+                else if (i % 5 != 4)
+                    ++cursor_spot;
+                items.insert(items.begin( ) + cursor_spot, entry);
+                if (i % 7 == 3)
+                {
+                    test.remove_current( );
+                    items.erase(items.begin( ) + cursor_spot);
+                }
+            }
+        }
+        catch (const bad_alloc&)
+        {
+            allocations_left = -1;
+            ++failures;
+        }
+        if (!matches(test, items, cursor_spot) || !scans_agree(test, items))
+        {
+            cout << "An edit that failed after " << budget << " allocations went wrong." << endl;
+            return 0;
+        }
+        for (int i = 0; i < 300; ++i)
+        {
+            test.attach(make_record(i));
+            items.insert(items.begin( ) + spot_of(test), make_record(i));
+        }
+        if (!scans_agree(test, items))
+        {
+            cout << "The sequence could not grow after running out of memory." << endl;
+            return 0;
+        }
+    }
+    if (failures == 0)
+    {
+        cout << "operator new never failed, so nothing was tested." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,84 @@
+// FILE: compact_sequence.cxx
+// CLASS IMPLEMENTED: compact_sequence (see compact_sequence.h for documentation)
+// INVARIANT for the compact_sequence class:
+//   1. chain holds the order of the items, the cursor and the free slots
+//      (see the invariant in index_chain.cxx).
+//
+//   2. items.size( ) == chain.capacity( ), and items[i] is the item in slot
+//      i. Free slots hold value_type( ).
+
+#include <cassert>    // Provides assert
+
+namespace scu_coen70_6B
+{
+    // Acquires a slot from the chain and copies entry into it. A new slot is
+    // added to items before the chain grows, so a throw from either one
+    // leaves items.size( ) == chain.capacity( ).
+    template<class Item>
+    typename compact_sequence<Item>::index_type
+    compact_sequence<Item>::store(const value_type& entry)
+    {
+        index_type slot;
+
+        if (chain.has_free( ))
+        {
+            slot = chain.acquire( );
+            try
+            {
+                items[slot] = entry;
+            }
+            catch (...)
+            {
+                chain.release(slot);
+                throw;
+            }
+            return slot;
+        }
+        items.push_back(entry);
+        try
+        {
+            slot = chain.acquire( );
+        }
+        catch (...)
+        {
+            items.pop_back( );
+            throw;
+        }
+        return slot;
+    }
+
+    template<class Item>
+    void compact_sequence<Item>::insert(const value_type& entry)
+    {
+        chain.link_insert(store(entry));
+    }
+
+    template<class Item>
+    void compact_sequence<Item>::attach(const value_type& entry)
+    {
+        chain.link_attach(store(entry));
+    }
+
+    template<class Item>
+    void compact_sequence<Item>::remove_current( )
+    {
+        assert(is_item( ));
+
+        items[chain.unlink_current( )] = value_type( );
+    }
+
+    template<class Item>
+    void compact_sequence<Item>::reserve(size_type n)
+    {
+        chain.reserve(n);
+        items.reserve(n);
+    }
+
+    template<class Item>
+    typename compact_sequence<Item>::value_type compact_sequence<Item>::current( ) const
+    {
+        assert(is_item( ));
+
+        return items[chain.cursor( )];
+    }
+}
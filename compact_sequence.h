@@ -0,0 +1,160 @@
+// FILE: compact_sequence.h
+// CLASS PROVIDED: compact_sequence (part of the namespace scu_coen70_6B)
+// A sequence with the same cursor interface as sequence<Item> (sequence4.h),
+// but whose nodes live in one contiguous arena and are linked by 32-bit
+// indices instead of pointers. A compact_sequence<int> spends 8 bytes per
+// item (4 of data and 4 of link) and does no per-item heap allocation,
+// against 16 bytes plus malloc overhead for a node<int>.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the compact_sequence class:
+//   typedef ____ value_type
+//     compact_sequence::value_type is the data type of the items. It may be
+//     any of the C++ built-in types (int, char, etc.), or a class with a
+//     default constructor, an assignment operator, and a copy constructor.
+//
+//   typedef ____ size_type
+//     compact_sequence::size_type is the data type of any variable that keeps
+//     track of how many items are in a compact_sequence.
+//
+//   typedef ____ index_type
+//     The 32-bit type of a link. The arena holds at most NIL slots.
+//
+//   static const index_type NIL
+//     The link value that means "no node".
+//
+// CONSTRUCTOR for the compact_sequence class:
+//   compact_sequence( )
+//     Postcondition: The compact_sequence is empty.
+//
+// The links, cursor and free slots are kept by an index_chain (see
+// index_chain.h); compact_sequence adds the array of items.
+//
+// MODIFICATION MEMBER FUNCTIONS for the compact_sequence class:
+//   void start( )
+//   void advance( )
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current( )
+//     Same preconditions and postconditions as in sequence4.h. A removed
+//     slot is reset to value_type( ) and reused by the next insert or attach.
+//
+//   void reserve(size_type n)
+//     Postcondition: The arena has room for at least n items, so the next
+//     n - size( ) insertions do not reallocate it.
+//
+// CONSTANT MEMBER FUNCTIONS for the compact_sequence class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//   value_type current( ) const
+//     Same as in sequence4.h.
+//
+//   size_type capacity( ) const
+//     Postcondition: The return value is the number of slots in the arena,
+//     including free ones.
+//
+// STANDARD ITERATOR MEMBER FUNCTIONS (provide a forward iterator):
+//   iterator begin( )
+//   const_iterator begin( ) const
+//   iterator end( )
+//   const_iterator end( ) const
+//   Iterators hold a pointer into the arena, so insert and attach (which may
+//   grow it) invalidate every iterator. The cursor itself is an index and is
+//   never invalidated.
+//
+// VALUE SEMANTICS for the compact_sequence class:
+//   Assignments and the copy constructor may be used. Because every link is
+//   an index, a copy is just a copy of the two arena arrays (a single memcpy
+//   each when value_type is trivially copyable), and the copy's cursor lands
+//   on the same item as the source's.
+//
+// DYNAMIC MEMORY usage by the compact_sequence class:
+//   If there is insufficient dynamic memory, then insert, attach, reserve,
+//   the copy constructor and the assignment operator throw bad_alloc. If the
+//   arena would need more than NIL slots, insert and attach throw
+//   length_error.
+
+#ifndef COEN_70_COMPACT_SEQUENCE_H
+#define COEN_70_COMPACT_SEQUENCE_H
+#include <cstdlib>  // Provides size_t
+#include <cstddef>  // Provides ptrdiff_t
+#include <cstdint>  // Provides uint32_t
+#include <iterator> // Provides forward_iterator_tag
+#include <vector>   // Provides the arena arrays
+#include "index_chain.h" // Provides the index links
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    class compact_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Item* pointer;
+        typedef Item& reference;
+
+        compact_iterator(Item* items = NULL, const std::uint32_t* links = NULL,
+                         std::uint32_t index = 0xFFFFFFFFu)
+        {
+            data = items;
+            link = links;
+            current = index;
+        }
+        Item& operator *( ) const { return data[current]; }
+        compact_iterator& operator ++( )
+        {
+            current = link[current];
+            return *this;
+        }
+        compact_iterator operator ++(int)
+        {
+            compact_iterator orig(*this);
+            current = link[current];
+            return orig;
+        }
+        bool operator ==(const compact_iterator& other) const { return current == other.current; }
+        bool operator !=(const compact_iterator& other) const { return current != other.current; }
+    private:
+        Item* data;
+        const std::uint32_t* link;
+        std::uint32_t current;
+    };
+
+    template<class Item>
+    class compact_sequence
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef Item value_type;
+        typedef std::size_t size_type;
+        typedef index_chain::index_type index_type;
+        typedef compact_iterator<Item> iterator;
+        typedef compact_iterator<const Item> const_iterator;
+        static const index_type NIL = index_chain::NIL;
+        // MODIFICATION MEMBER FUNCTIONS
+        void start( ) { chain.start( ); }
+        void advance( ) { chain.advance( ); }
+        void insert(const value_type& entry);
+        void attach(const value_type& entry);
+        void remove_current( );
+        void reserve(size_type n);
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return chain.size( ); }
+        bool is_item( ) const { return chain.is_item( ); }
+        value_type current( ) const;
+        size_type capacity( ) const { return chain.capacity( ); }
+        // FUNCTIONS TO PROVIDE ITERATORS
+        iterator begin( ) { return iterator(items.data( ), chain.links( ), chain.head( )); }
+        const_iterator begin( ) const { return const_iterator(items.data( ), chain.links( ), chain.head( )); }
+        iterator end( ) { return iterator( ); }
+        const_iterator end( ) const { return const_iterator( ); }
+    private:
+        index_chain chain;
+        std::vector<Item> items;
+
+        index_type store(const value_type& entry);
+    };
+}
+#include "compact_sequence.cxx"
+#endif
@@ -0,0 +1,614 @@
+// FILE: compact_sequence_exam.cpp
+// Non-interactive test program for the compact_sequence class (see
+// compact_sequence.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the compact_sequence class,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. The
+// cursor members are checked against a vector that models the sequence;
+// compact_sequence has no position( ), so the cursor's spot is found by
+// advancing a copy to the end, which also relies on copies keeping the
+// cursor. The last test stores items whose copies can be told to throw, and
+// checks that a failed insert or attach leaves the sequence unchanged and
+// usable. The program returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 compact_sequence_exam.cpp -o compact_sequence_exam
+//     ./compact_sequence_exam
+
+#include <iostream>             // Provides cout.
+#include <cstdlib>              // Provides size_t.
+#include <new>                  // Provides bad_alloc.
+#include <random>               // Provides mt19937 for the random edits.
+#include <string>               // Provides string, to_string.
+#include <vector>               // Provides vector for the expected items.
+#include "compact_sequence.h"   // Provides the compact_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the compact_sequence class",
+    "Testing random inserts, attaches, removes and moves against a vector",
+    "Testing slot reuse, reserve and capacity",
+    "Testing iterators, copies and assignment, with int and string items",
+    "Testing that a failed insert or attach leaves the sequence unchanged"
+};
+
+// An item whose copies throw bad_alloc once budget copies have been made
+// (never, while budget is negative). A store into a free slot assigns the
+// item, and a store into a new slot copy-constructs it at the end of the
+// item array.
+struct fragile
+{
+    static long budget;
+    int value;
+
+    fragile(int v = 0) : value(v) { }
+    fragile(const fragile& source) : value(source.value) { spend( ); }
+    fragile& operator =(const fragile& source)
+    {
+        spend( );
+        value = source.value;
+        return *this;
+    }
+    bool operator ==(const fragile& other) const { return value == other.value; }
+    static void spend( )
+    {
+        if (budget == 0)
+            throw bad_alloc( );
+        if (budget > 0)
+            --budget;
+    }
+};
+long fragile::budget = -1;
+
+
+// **************************************************************************
+// template<class Item>
+// size_t spot_of(compact_sequence<Item> test)
+//   Postcondition: The return value is the number of items before the
+//   current item of test, or test.size( ) if there is no current item.
+//   (test is a copy, which keeps the cursor on the same item.)
+// **************************************************************************
+template<class Item>
+size_t spot_of(compact_sequence<Item> test)
+{
+    size_t after = 0;
+
+    for ( ; test.is_item( ); test.advance( ))
+        ++after;
+    return test.size( ) - after;
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool matches(const compact_sequence<Item>& test, const vector<Item>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item, or
+//   that it has no current item if cursor_spot >= items.size( ).
+// **************************************************************************
+template<class Item>
+bool matches(const compact_sequence<Item>& test, const vector<Item>& items, size_t cursor_spot)
+{
+    typename compact_sequence<Item>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || !(*it == items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (spot_of(test) == test.size( ));
+    return test.is_item( ) && (spot_of(test) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// template<class Item>
+// void fill(compact_sequence<Item>& test, const vector<Item>& items,
+//           size_t cursor_spot)
+//   Precondition: test is empty.
+//   Postcondition: test holds the items, and item [cursor_spot] is its
+//   current item (or there is none, if cursor_spot >= items.size( )).
+// **************************************************************************
+template<class Item>
+void fill(compact_sequence<Item>& test, const vector<Item>& items, size_t cursor_spot)
+{
+    size_t i;
+
+    for (i = 0; i < items.size( ); ++i)
+        test.attach(items[i]);
+    test.start( );
+    for (i = 0; (i < cursor_spot) && test.is_item( ); ++i)
+        test.advance( );
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool random_edits(compact_sequence<Item>& test, vector<Item>& items,
+//                   size_t& cursor_spot, mt19937& random, int many,
+//                   Item make(int))
+//   Precondition: test matches items with the cursor at cursor_spot.
+//   Postcondition: many random edits and moves have been made to test and
+//   to the model, and the return value is true if test still matched the
+//   model after each one. Otherwise a message has been printed.
+// **************************************************************************
+template<class Item>
+bool random_edits(compact_sequence<Item>& test, vector<Item>& items, size_t& cursor_spot,
+                  mt19937& random, int many, Item make(int))
+{
+    for (int step = 0; step < many; ++step)
+    {
+        int choice = int(random( ) % 10);
+        Item entry = make(int(random( ) % 1000));
+
+        if (choice < 3)
+        {
+            // insert: before the current item, or at the front.
+            if (cursor_spot >= items.size( ))
+                cursor_spot = 0;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.insert(entry);
+        }
+        else if (choice < 6)
+        {
+            // attach: after the current item, or at the back.
+            cursor_spot = (cursor_spot >= items.size( )) ? items.size( ) : cursor_spot + 1;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.attach(entry);
+        }
+        else if (choice < 8)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                items.erase(items.begin( ) + cursor_spot);
+                test.remove_current( );
+            }
+        }
+        else if (choice < 9)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                ++cursor_spot;
+                test.advance( );
+            }
+        }
+        else
+        {
+            cursor_spot = 0;
+            test.start( );
+        }
+        if (!matches(test, items, cursor_spot))
+        {
+            cout << "The sequence went wrong after " << step + 1 << " edits." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int make_int(int x)
+// string make_string(int x)
+// fragile make_fragile(int x)
+//   Postcondition: The return value is an item made from x. The strings are
+//   long enough not to be stored inside the string object.
+// **************************************************************************
+int make_int(int x)
+{
+    return x;
+}
+
+string make_string(int x)
+{
+    return string(40, 's') + to_string(x);
+}
+
+fragile make_fragile(int x)
+{
+    return fragile(x);
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Makes 20000 random edits and moves to a compact_sequence<int> and to a
+//   vector, and checks that they agree after each one. Returns POINTS[1] if
+//   the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    mt19937 random(27);
+    compact_sequence<int> test;
+    vector<int> items;
+    size_t cursor_spot = 0;
+
+    cout << "Checking an empty sequence ... ";
+    cout.flush( );
+    if (!matches(test, items, 0) || (test.capacity( ) != 0))
+    {
+        cout << "A new sequence was not empty." << endl;
+        return 0;
+    }
+    test.start( );
+    if (test.is_item( ))
+    {
+        cout << "start( ) on an empty sequence made a current item." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking 20000 random edits and moves ... ";
+    cout.flush( );
+    for (int round = 0; round < 10; ++round)
+    {
+        if (!random_edits(test, items, cursor_spot, random, 2000, make_int))
+            return 0;
+        // Empty the sequence now and then, so that it grows again from free slots.
+        if (round % 3 == 2)
+        {
+            for (test.start( ); test.is_item( ); )
+                test.remove_current( );
+            items.clear( );
+            cursor_spot = 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Tests that removed slots are reused before the arena grows, that
+//   capacity( ) counts the free slots, and that reserve makes room without
+//   changing the items. Returns POINTS[2] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test2( )
+{
+    compact_sequence<int> test;
+    vector<int> items;
+    const int* first;
+    size_t i;
+
+    cout << "Checking that removed slots are reused ... ";
+    cout.flush( );
+    for (i = 0; i < 100; ++i)
+    {
+        items.push_back(int(i));
+        test.attach(int(i));
+    }
+    if (test.capacity( ) != 100)
+    {
+        cout << "100 attaches gave a capacity of " << test.capacity( ) << "." << endl;
+        return 0;
+    }
+    // Remove every other item, then put as many back.
+    test.start( );
+    for (i = 0; i < 50; ++i)
+    {
+        test.remove_current( );
+        test.advance( );
+    }
+    for (i = 0; i < 50; ++i)
+        items.erase(items.begin( ) + i);
+    if ((test.size( ) != 50) || (test.capacity( ) != 100) || !matches(test, items, 50))
+    {
+        cout << "Removing 50 items went wrong." << endl;
+        return 0;
+    }
+    test.start( );
+    for (i = 0; i < 50; ++i)
+    {
+        test.insert(-int(i));
+        test.advance( );
+        test.advance( );
+        items.insert(items.begin( ) + 2 * i, -int(i));
+    }
+    if ((test.size( ) != 100) || (test.capacity( ) != 100) || !matches(test, items, 100))
+    {
+        cout << "Inserting into the free slots grew the arena to ";
+        cout << test.capacity( ) << " slots." << endl;
+        return 0;
+    }
+    test.attach(1000);
+    items.push_back(1000);
+    if ((test.capacity( ) != 101) || !matches(test, items, 100))
+    {
+        cout << "An attach with no free slot did not add one slot." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking reserve ... ";
+    cout.flush( );
+    test.reserve(5000);
+    first = &*test.begin( );
+    if (!matches(test, items, 100) || (test.capacity( ) != 101))
+    {
+        cout << "reserve changed the items or the number of slots." << endl;
+        return 0;
+    }
+    for (i = 0; i < 4000; ++i)
+    {
+        test.attach(int(i));
+        items.push_back(int(i));
+    }
+    if ((&*test.begin( ) != first) || !matches(test, items, items.size( ) - 1))
+    {
+        cout << "Attaches within the reserved room moved the arena." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Tests writing through iterators, the copy constructor and assignment
+//   (which must keep the cursor on the same item and leave the source
+//   alone), self-assignment, and random edits with string items. Returns
+//   POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    mt19937 random(28);
+    vector<int> items;
+    size_t i;
+
+    cout << "Checking writes through iterators ... ";
+    cout.flush( );
+    {
+        compact_sequence<int> test;
+
+        for (i = 0; i < 10; ++i)
+        {
+            test.attach(int(i));
+            items.push_back(int(10 * i));
+        }
+        test.start( );
+        test.remove_current( );
+        test.insert(0);
+        for (compact_sequence<int>::iterator it = test.begin( ); it != test.end( ); it++)
+            *it *= 10;
+        if (!matches(test, items, 0))
+        {
+            cout << "The items written through iterators were wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking copies and assignment with the cursor at each spot ... ";
+    cout.flush( );
+    for (size_t spot = 0; spot <= items.size( ); ++spot)
+    {
+        compact_sequence<int> source;
+        compact_sequence<int> assigned;
+        size_t cursor_spot;
+
+        fill(source, items, spot);
+        // A free slot in the source must copy as a free slot.
+        source.attach(-1);
+        source.remove_current( );
+        cursor_spot = spot_of(source);
+        assigned.attach(99);
+        {
+            compact_sequence<int> copy(source);
+            assigned = source;
+            if (!matches(copy, items, cursor_spot) || !matches(assigned, items, cursor_spot))
+            {
+                cout << "A copy with the cursor at " << cursor_spot << " went wrong." << endl;
+                return 0;
+            }
+            copy.attach(7);
+            assigned.start( );
+            assigned.remove_current( );
+        }
+        if (!matches(source, items, cursor_spot))
+        {
+            cout << "Changing a copy changed the source." << endl;
+            return 0;
+        }
+        source = source;
+        if (!matches(source, items, cursor_spot))
+        {
+            cout << "Self-assignment changed the sequence." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking 6000 random edits with string items ... ";
+    cout.flush( );
+    {
+        compact_sequence<string> test;
+        vector<string> strings;
+        size_t cursor_spot = 0;
+
+        for (int round = 0; round < 3; ++round)
+        {
+            if (!random_edits(test, strings, cursor_spot, random, 2000, make_string))
+                return 0;
+            compact_sequence<string> copy(test);
+            if (!matches(copy, strings, cursor_spot))
+            {
+                cout << "A copy of a sequence of strings went wrong." << endl;
+                return 0;
+            }
+            test = copy;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Makes the 1st, 2nd, ... copy of the item fail during an insert or
+//   attach, with the cursor at each spot and with and without a free slot,
+//   and checks after each bad_alloc that the sequence is unchanged, that a
+//   free slot is still free, and that the sequence can still be edited. Returns POINTS[4] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test4( )
+{
+    mt19937 random(29);
+    vector<fragile> items;
+    int failures = 0;
+
+    for (int i = 0; i < 12; ++i)
+        items.push_back(fragile(i));
+
+    cout << "Checking inserts and attaches whose copies fail ... ";
+    cout.flush( );
+    for (long budget = 0; budget < 4; ++budget)
+    {
+        for (size_t spot = 0; spot <= items.size( ); ++spot)
+        {
+            for (int kind = 0; kind < 4; ++kind)
+            {
+                compact_sequence<fragile> test;
+                vector<fragile> after(items);
+                fragile entry(1000);
+                size_t cursor_spot = spot;
+                size_t slots;
+                bool attach = (kind % 2 == 1);
+                bool failed = false;
+
+                fill(test, items, spot);
+                if (kind >= 2)
+                {
+                    // Leave a free slot, so that the edit reuses it.
+                    test.attach(entry);
+                    test.remove_current( );
+                    cursor_spot = spot_of(test);
+                }
+                slots = test.capacity( );
+                fragile::budget = budget;
+                try
+                {
+                    if (attach)
+                        test.attach(entry);
+                    else
+                        test.insert(entry);
+                    fragile::budget = -1;
+                    if (cursor_spot >= after.size( ))
+                        cursor_spot = attach ? after.size( ) : 0;
+                    else if (attach)
+                        ++cursor_spot;
+                    after.insert(after.begin( ) + cursor_spot, entry);
+                }
+                catch (const bad_alloc&)
+                {
+                    fragile::budget = -1;
+                    failed = true;
+                    ++failures;
+                }
+                if (!matches(test, after, cursor_spot))
+                {
+                    cout << "An " << (attach ? "attach" : "insert") << " with the cursor at ";
+                    cout << spot << " and " << budget << " copies allowed went wrong." << endl;
+                    return 0;
+                }
+                // The slot of a failed store must still be free.
+                if (failed && (kind >= 2))
+                {
+                    test.start( );
+                    test.insert(entry);
+                    after.insert(after.begin( ), entry);
+                    cursor_spot = 0;
+                    if (test.capacity( ) != slots)
+                    {
+                        cout << "A failed store lost its free slot." << endl;
+                        return 0;
+                    }
+                }
+                if (!random_edits(test, after, cursor_spot, random, 50, make_fragile))
+                {
+                    cout << "The sequence could not be used after a failed copy." << endl;
+                    return 0;
+                }
+            }
+        }
+    }
+    if (failures == 0)
+    {
+        cout << "No copy ever failed, so nothing was tested." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
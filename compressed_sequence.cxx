@@ -0,0 +1,553 @@
+// FILE: compressed_sequence.cxx
+// CLASS IMPLEMENTED: compressed_sequence, and the bit_writer, bit_reader and
+// block_codec helpers (see compressed_sequence.h for documentation)
+// INVARIANT for the compressed_sequence class:
+//   1. The items, in order, are those of table[0], table[1], ..., each block
+//      holding between 1 and BLOCK_ITEMS of them (table[i].count), and
+//      many_items is the sum of the counts.
+//
+//   2. table[i].bytes is block i encoded by block_codec<Item>, except for
+//      the hot block when hot_dirty is true: then only hot is up to date.
+//
+//   3. hot_block is NO_BLOCK, or the index of a block whose items are hot
+//      (hot.size( ) == table[hot_block].count).
+//
+//   4. If there is a current item, it is item cursor_offset of block
+//      cursor_block, and cursor_offset < table[cursor_block].count.
+//      Otherwise cursor_block == table.size( ) and cursor_offset == 0.
+//      Either way cursor_index is the position of the cursor, as in
+//      sequence4.h.
+
+#include <algorithm>    // Provides copy
+#include <cassert>      // Provides assert
+#include <cstring>      // Provides memcpy
+
+namespace scu_coen70_6B
+{
+    inline void bit_writer::put(std::uint64_t value, unsigned bits)
+    {
+        unsigned take;
+
+        while (bits > 0)
+        {
+            if (used == 8)
+            {
+                bytes.push_back(0);
+                used = 0;
+            }
+            take = (8 - used < bits) ? 8 - used : bits;
+            bytes.back( ) |= static_cast<unsigned char>((value & ((1u << take) - 1)) << used);
+            value >>= take;
+            bits -= take;
+            used += take;
+        }
+    }
+
+    inline void bit_writer::finish( )
+    {
+        bytes.insert(bytes.end( ), 8, 0);
+        used = 8;
+    }
+
+    // The 8 bytes at p as a little-endian number.
+    inline std::uint64_t load_bits(const unsigned char* p)
+    {
+        std::uint64_t word = 0;
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        std::memcpy(&word, p, sizeof(word));
+#else
+        for (unsigned i = 0; i < 8; ++i)
+            word |= std::uint64_t(p[i]) << (8 * i);
+#endif
+        return word;
+    }
+
+    inline std::uint64_t bit_reader::get(unsigned bits)
+    {
+        std::uint64_t word;
+        std::uint64_t low;
+
+        if (bits == 0)
+            return 0;
+        if (bits > 56)
+        {
+            low = get(32);
+            return low | (get(bits - 32) << 32);
+        }
+
+        word = load_bits(bytes + (position >> 3)) >> (position & 7);
+        position += bits;
+        return word & ((std::uint64_t(1) << bits) - 1);
+    }
+
+    inline unsigned leading_zeros(std::uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return (x == 0) ? 64 : unsigned(__builtin_clzll(x));
+#else
+        unsigned n = 0;
+
+        while ((n < 64) && !(x & (std::uint64_t(1) << (63 - n))))
+            ++n;
+        return n;
+#endif
+    }
+
+    inline unsigned trailing_zeros(std::uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return (x == 0) ? 64 : unsigned(__builtin_ctzll(x));
+#else
+        unsigned n = 0;
+
+        while ((n < 64) && !(x & (std::uint64_t(1) << n)))
+            ++n;
+        return n;
+#endif
+    }
+
+    // Integers: width (7 bits), first item (64 bits), then each zigzagged
+    // difference in width bits.
+    template<class Item, bool Integral>
+    void block_codec<Item, Integral>::encode(const Item* items, std::size_t many,
+                                             std::vector<unsigned char>& bytes)
+    {
+        bit_writer out(bytes);
+        std::uint64_t previous;
+        std::uint64_t difference;
+        std::uint64_t any_bits = 0;
+        unsigned width;
+
+        bytes.clear( );
+        if (many > 0)
+        {
+            previous = std::uint64_t(items[0]);
+            for (std::size_t i = 1; i < many; ++i)
+            {
+                difference = std::uint64_t(items[i]) - previous;
+                any_bits |= (difference << 1) ^ (0 - (difference >> 63));
+                previous = std::uint64_t(items[i]);
+            }
+            width = 64 - leading_zeros(any_bits);
+
+            out.put(width, 7);
+            previous = std::uint64_t(items[0]);
+            out.put(previous, 64);
+            for (std::size_t i = 1; i < many; ++i)
+            {
+                difference = std::uint64_t(items[i]) - previous;
+                out.put((difference << 1) ^ (0 - (difference >> 63)), width);
+                previous = std::uint64_t(items[i]);
+            }
+        }
+        out.finish( );
+    }
+
+    template<class Item, bool Integral>
+    void block_codec<Item, Integral>::decode(const unsigned char* bytes, std::size_t many, Item* items)
+    {
+        const std::size_t CHUNK = 64;
+        bit_reader in(bytes);
+        std::uint64_t value;
+        std::uint64_t zigzag[CHUNK];
+        std::uint64_t mask;
+        std::size_t bit, done, chunk;
+        unsigned width;
+
+        if (many == 0)
+            return;
+        width = unsigned(in.get(7));
+        value = in.get(64);
+        items[0] = Item(value);
+        if (width > 56)
+        {
+            for (std::size_t i = 1; i < many; ++i)
+            {
+                zigzag[0] = in.get(width);
+                value += (zigzag[0] >> 1) ^ (0 - (zigzag[0] & 1));
+                items[i] = Item(value);
+            }
+            return;
+        }
+
+        // Unpack a chunk of differences (independent loads the compiler can
+        // vectorize), then add them up.
+        mask = (std::uint64_t(1) << width) - 1;
+        bit = 7 + 64;
+        for (done = 1; done < many; done += chunk)
+        {
+            chunk = (many - done < CHUNK) ? many - done : CHUNK;
+            for (std::size_t i = 0; i < chunk; ++i, bit += width)
+                zigzag[i] = (load_bits(bytes + (bit >> 3)) >> (bit & 7)) & mask;
+            for (std::size_t i = 0; i < chunk; ++i)
+            {
+                value += (zigzag[i] >> 1) ^ (0 - (zigzag[i] & 1));
+                items[done + i] = Item(value);
+            }
+        }
+    }
+
+    // double and float (Gorilla): the first item's bits (64), then for each
+    // item the XOR of its bits with the previous item's, as
+    //   0                              the same value again, or
+    //   1 0 <bits in the last window>  the XOR fits in the last window, or
+    //   1 1 <leading zeros: 5> <length - 1: 6> <length bits>  a new window.
+    template<class Item>
+    void block_codec<Item, false>::encode(const Item* items, std::size_t many,
+                                          std::vector<unsigned char>& bytes)
+    {
+        static_assert(sizeof(Item) <= sizeof(std::uint64_t),
+                      "compressed_sequence needs an integral or floating-point value_type");
+        bit_writer out(bytes);
+        std::uint64_t previous = 0;
+        std::uint64_t current;
+        std::uint64_t x;
+        unsigned lead, trail;
+        unsigned window_lead = 64;      // No window yet
+        unsigned window_trail = 0;
+
+        bytes.clear( );
+        if (many > 0)
+        {
+            std::memcpy(&previous, &items[0], sizeof(Item));
+            out.put(previous, 64);
+        }
+        for (std::size_t i = 1; i < many; ++i)
+        {
+            current = 0;
+            std::memcpy(&current, &items[i], sizeof(Item));
+            x = current ^ previous;
+            previous = current;
+            if (x == 0)
+            {
+                out.put(0, 1);
+                continue;
+            }
+            lead = leading_zeros(x);
+            if (lead > 31)
+                lead = 31;
+            trail = trailing_zeros(x);
+            if ((window_lead < 64) && (lead >= window_lead) && (trail >= window_trail))
+            {
+                out.put(1, 2);
+                out.put(x >> window_trail, 64 - window_lead - window_trail);
+            }
+            else
+            {
+                out.put(3, 2);
+                out.put(lead, 5);
+                out.put(64 - lead - trail - 1, 6);
+                out.put(x >> trail, 64 - lead - trail);
+                window_lead = lead;
+                window_trail = trail;
+            }
+        }
+        out.finish( );
+    }
+
+    template<class Item>
+    void block_codec<Item, false>::decode(const unsigned char* bytes, std::size_t many, Item* items)
+    {
+        bit_reader in(bytes);
+        std::uint64_t value;
+        unsigned window_lead = 0;
+        unsigned window_length = 0;
+        unsigned window_trail = 0;
+
+        if (many == 0)
+            return;
+        value = in.get(64);
+        std::memcpy(&items[0], &value, sizeof(Item));
+        for (std::size_t i = 1; i < many; ++i)
+        {
+            if (in.get(1) != 0)
+            {
+                if (in.get(1) != 0)
+                {
+                    window_lead = unsigned(in.get(5));
+                    window_length = unsigned(in.get(6)) + 1;
+                    window_trail = 64 - window_lead - window_length;
+                }
+                value ^= in.get(window_length) << window_trail;
+            }
+            std::memcpy(&items[i], &value, sizeof(Item));
+        }
+    }
+
+    template<class Item>
+    const typename compressed_sequence<Item>::size_type compressed_sequence<Item>::BLOCK_ITEMS;
+
+    template<class Item>
+    const typename compressed_sequence<Item>::size_type compressed_sequence<Item>::NO_BLOCK;
+
+    template<class Item>
+    compressed_sequence<Item>::compressed_sequence( )
+    {
+        many_items = 0;
+        cursor_block = 0;
+        cursor_offset = 0;
+        cursor_index = 0;
+        hot_block = NO_BLOCK;
+        hot_dirty = false;
+    }
+
+    // Encodes the hot block back into the table if it changed.
+    template<class Item>
+    void compressed_sequence<Item>::store_hot( ) const
+    {
+        std::vector<unsigned char> packed;
+
+        if ((hot_block == NO_BLOCK) || !hot_dirty)
+            return;
+        block_codec<Item>::encode(hot.data( ), hot.size( ), packed);
+        packed.shrink_to_fit( );
+        table[hot_block].bytes.swap(packed);
+        hot_dirty = false;
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::make_hot(size_type b) const
+    {
+        if (hot_block == b)
+            return;
+        store_hot( );
+        hot_block = NO_BLOCK;
+        hot.resize(table[b].count);
+        block_codec<Item>::decode(table[b].bytes.data( ), table[b].count, hot.data( ));
+        hot_block = b;
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::start( )
+    {
+        cursor_block = 0;
+        cursor_offset = 0;
+        cursor_index = 0;
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::advance( )
+    {
+        assert(is_item( ));
+
+        ++cursor_index;
+        if (++cursor_offset == table[cursor_block].count)
+        {
+            ++cursor_block;
+            cursor_offset = 0;
+        }
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::advance(size_type steps)
+    {
+        assert(steps <= many_items - cursor_index);
+
+        cursor_index += steps;
+        steps += cursor_offset;
+        while ((cursor_block < table.size( )) && (steps >= table[cursor_block].count))
+        {
+            steps -= table[cursor_block].count;
+            ++cursor_block;
+        }
+        cursor_offset = steps;
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::go_to(size_type k)
+    {
+        if (k >= many_items)
+            seek_end( );
+        else if (k >= cursor_index)
+            advance(k - cursor_index);
+        else
+        {
+            start( );
+            advance(k);
+        }
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::seek_end( )
+    {
+        cursor_block = table.size( );
+        cursor_offset = 0;
+        cursor_index = many_items;
+    }
+
+    template<class Item>
+    typename compressed_sequence<Item>::value_type compressed_sequence<Item>::current( ) const
+    {
+        assert(is_item( ));
+
+        make_hot(cursor_block);
+        return hot[cursor_offset];
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::insert(const value_type& entry)
+    {
+        if (is_item( ))
+            insert_at(cursor_block, cursor_offset, entry);
+        else
+        {
+            insert_at(0, 0, entry);
+            cursor_index = 0;
+        }
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::attach(const value_type& entry)
+    {
+        if (is_item( ))
+        {
+            insert_at(cursor_block, cursor_offset + 1, entry);
+            ++cursor_index;
+        }
+        else if (table.empty( ))
+        {
+            insert_at(0, 0, entry);
+            cursor_index = 0;
+        }
+        else
+        {
+            insert_at(table.size( ) - 1, table.back( ).count, entry);
+            cursor_index = many_items - 1;
+        }
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::insert_at(size_type b, size_type offset, const value_type& entry)
+    {
+        std::vector<unsigned char> packed;
+        size_type half;
+
+        table.reserve(table.size( ) + 1);
+        if (table.empty( ))
+        {
+            table.push_back(block( ));
+            table[0].count = 0;
+            hot.clear( );
+            hot_block = 0;
+            b = 0;
+            offset = 0;
+        }
+        make_hot(b);
+        hot.insert(hot.begin( ) + offset, entry);
+        hot_dirty = true;
+        ++table[b].count;
+        ++many_items;
+
+        if (hot.size( ) > BLOCK_ITEMS)
+        {
+            // Split the block. Appending to the last block starts a new one
+            // holding just the new item; otherwise the block is halved. The
+            // half without the cursor is encoded, the other stays hot.
+            if ((offset + 1 == hot.size( )) && (b + 1 == table.size( )))
+                half = BLOCK_ITEMS;
+            else
+                half = hot.size( ) / 2;
+            try
+            {
+                if (offset >= half)
+                    block_codec<Item>::encode(hot.data( ), half, packed);
+                else
+                    block_codec<Item>::encode(hot.data( ) + half, hot.size( ) - half, packed);
+                packed.shrink_to_fit( );
+            }
+            catch (...)
+            {
+                hot.erase(hot.begin( ) + offset);
+                --table[b].count;
+                --many_items;
+                throw;
+            }
+
+            // Nothing below can throw (table has room for one more block).
+            table.insert(table.begin( ) + b + 1, block( ));
+            table[b + 1].count = hot.size( ) - half;
+            table[b].count = half;
+            if (offset >= half)
+            {
+                table[b].bytes.swap(packed);
+                hot.erase(hot.begin( ), hot.begin( ) + half);
+                hot_block = b + 1;
+                ++b;
+                offset -= half;
+            }
+            else
+            {
+                table[b + 1].bytes.swap(packed);
+                hot.resize(half);
+            }
+        }
+        cursor_block = b;
+        cursor_offset = offset;
+    }
+
+    template<class Item>
+    void compressed_sequence<Item>::remove_current( )
+    {
+        assert(is_item( ));
+
+        if (table[cursor_block].count == 1)
+        {
+            // The next block moves into place.
+            if (hot_block == cursor_block)
+            {
+                hot_block = NO_BLOCK;
+                hot_dirty = false;
+            }
+            else if ((hot_block != NO_BLOCK) && (hot_block > cursor_block))
+                --hot_block;
+            table.erase(table.begin( ) + cursor_block);
+        }
+        else
+        {
+            make_hot(cursor_block);
+            hot.erase(hot.begin( ) + cursor_offset);
+            hot_dirty = true;
+            if (cursor_offset == --table[cursor_block].count)
+            {
+                ++cursor_block;
+                cursor_offset = 0;
+            }
+        }
+        --many_items;
+    }
+
+    template<class Item>
+    typename compressed_sequence<Item>::size_type compressed_sequence<Item>::memory_bytes( ) const
+    {
+        size_type answer = sizeof(*this);
+
+        answer += table.capacity( ) * sizeof(block);
+        for (size_type i = 0; i < table.size( ); ++i)
+            answer += table[i].bytes.capacity( );
+        answer += hot.capacity( ) * sizeof(Item);
+        return answer;
+    }
+
+    template<class Item>
+    template<class Visitor>
+    void compressed_sequence<Item>::for_each(Visitor visit) const
+    {
+        std::vector<Item> buffer;
+        const Item* items;
+
+        for (size_type i = 0; i < table.size( ); ++i)
+        {
+            if (i == hot_block)
+                items = hot.data( );
+            else
+            {
+                buffer.resize(table[i].count);
+                block_codec<Item>::decode(table[i].bytes.data( ), table[i].count, buffer.data( ));
+                items = buffer.data( );
+            }
+            for (size_type j = 0; j < table[i].count; ++j)
+                visit(items[j]);
+        }
+    }
+}
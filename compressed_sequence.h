@@ -0,0 +1,190 @@
+// FILE: compressed_sequence.h
+// CLASS PROVIDED: compressed_sequence (part of the namespace scu_coen70_6B)
+// A sequence of numbers with the same cursor interface as sequence<Item>
+// (sequence4.h), stored compressed. The items are kept as an unrolled list
+// of blocks of up to BLOCK_ITEMS items, each encoded on its own:
+//
+//   Integers (any built-in integral type): the first item, then the
+//   difference of each item from the one before it, zigzag-mapped (so small
+//   negative differences are small numbers too) and bit-packed at the
+//   smallest width that fits every difference in the block. Decoding unpacks
+//   64 differences at a time with one unaligned 64-bit load, shift and mask
+//   each (no branches that depend on the data, so the compiler can vectorize
+//   it), and then adds them up.
+//
+//   double and float: Gorilla encoding. Each item's bit pattern is XORed with
+//   the one before it; a zero result (a repeated value) costs 1 bit, and
+//   otherwise only the bits between the result's leading and trailing zeros
+//   are stored, reusing the previous item's window when they fit in it.
+//
+// A steadily ticking counter or timestamp then takes a few bits per item,
+// and a slowly changing measurement a few bits for each repeat and
+// about 20 to 40 bits per change, against 16 bytes (plus allocator overhead)
+// for a node of a sequence.
+//
+// The block holding the cursor is kept decoded (the "hot" block). Cursor
+// operations work on it directly, and it is encoded again only when the
+// cursor leaves it after a change, so a run of edits in one place costs one
+// decode and one encode. A scan with start( ), advance( ) and current( )
+// decodes each block once.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the compressed_sequence class:
+//   typedef ____ value_type
+//     compressed_sequence::value_type is the data type of the items: a
+//     built-in integral type, double or float.
+//
+//   typedef ____ size_type
+//     As in sequence4.h.
+//
+//   static const size_type BLOCK_ITEMS
+//     The most items a block holds (1024).
+//
+// CONSTRUCTOR for the compressed_sequence class:
+//   compressed_sequence( )
+//     Postcondition: The compressed_sequence is empty.
+//
+// MODIFICATION MEMBER FUNCTIONS for the compressed_sequence class:
+//   void start( )
+//   void advance( )
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current( )
+//   void advance(size_type steps)
+//   void go_to(size_type k)
+//   void seek_end( )
+//     Same preconditions and postconditions as in sequence4.h. insert and
+//     attach split a full block in two, except that attach at the end of the
+//     last block starts a new block, so blocks built by appending are full.
+//     A block is freed once its last item is removed; partly empty blocks
+//     are not merged. advance(steps) and go_to skip whole blocks by their
+//     counts, without decoding them.
+//
+// CONSTANT MEMBER FUNCTIONS for the compressed_sequence class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//   value_type current( ) const
+//   size_type position( ) const
+//     Same as in sequence4.h. current( ) may decode the cursor's block.
+//
+//   size_type blocks( ) const
+//     Postcondition: The return value is the number of blocks.
+//
+//   size_type memory_bytes( ) const
+//     Postcondition: The return value is the heap memory the sequence holds
+//     (encoded blocks, the block table and the hot block), plus its own size.
+//
+//   template<class Visitor> void for_each(Visitor visit) const
+//     Postcondition: visit(x) has been called for each item x, in order. Each
+//     block is decoded into a buffer as it is reached; the cursor and the hot
+//     block are unchanged.
+//
+// VALUE SEMANTICS for the compressed_sequence class:
+//   Assignments and the copy constructor may be used. A copy shares nothing
+//   with its source, and its cursor is at the same item.
+//
+// DYNAMIC MEMORY usage by the compressed_sequence class:
+//   If there is insufficient dynamic memory, the modification functions,
+//   current( ), for_each, the copy constructor and the assignment operator
+//   throw bad_alloc.
+
+#ifndef COEN_70_COMPRESSED_SEQUENCE_H
+#define COEN_70_COMPRESSED_SEQUENCE_H
+#include <cstdlib>      // Provides size_t
+#include <cstdint>      // Provides uint64_t
+#include <type_traits>  // Provides is_integral
+#include <vector>       // Provides vector
+
+namespace scu_coen70_6B
+{
+    // Appends values of up to 64 bits to a byte vector, low bits first.
+    class bit_writer
+    {
+    public:
+        explicit bit_writer(std::vector<unsigned char>& destination) : bytes(destination), used(8) { }
+        void put(std::uint64_t value, unsigned bits);
+        void finish( );
+    private:
+        std::vector<unsigned char>& bytes;
+        unsigned used;          // Bits used in bytes.back( ) (8: none free)
+    };
+
+    // Reads back what a bit_writer wrote. finish( ) pads the bytes so that
+    // get may always load 8 bytes at once.
+    class bit_reader
+    {
+    public:
+        explicit bit_reader(const unsigned char* source) : bytes(source), position(0) { }
+        std::uint64_t get(unsigned bits);
+    private:
+        const unsigned char* bytes;
+        std::size_t position;   // In bits
+    };
+
+    // Encodes and decodes one block of a compressed_sequence.
+    template<class Item, bool Integral = std::is_integral<Item>::value>
+    struct block_codec
+    {
+        static void encode(const Item* items, std::size_t many, std::vector<unsigned char>& bytes);
+        static void decode(const unsigned char* bytes, std::size_t many, Item* items);
+    };
+
+    template<class Item>
+    struct block_codec<Item, false>
+    {
+        static void encode(const Item* items, std::size_t many, std::vector<unsigned char>& bytes);
+        static void decode(const unsigned char* bytes, std::size_t many, Item* items);
+    };
+
+    template<class Item>
+    class compressed_sequence
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef Item value_type;
+        typedef std::size_t size_type;
+        static const size_type BLOCK_ITEMS = 1024;
+        // CONSTRUCTOR
+        compressed_sequence( );
+        // MODIFICATION MEMBER FUNCTIONS
+        void start( );
+        void advance( );
+        void insert(const value_type& entry);
+        void attach(const value_type& entry);
+        void remove_current( );
+        void advance(size_type steps);
+        void go_to(size_type k);
+        void seek_end( );
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return many_items; }
+        bool is_item( ) const { return cursor_block < table.size( ); }
+        value_type current( ) const;
+        size_type position( ) const { return cursor_index; }
+        size_type blocks( ) const { return table.size( ); }
+        size_type memory_bytes( ) const;
+        template<class Visitor>
+        void for_each(Visitor visit) const;
+    private:
+        struct block
+        {
+            mutable std::vector<unsigned char> bytes;  // Rewritten by store_hot
+            size_type count;
+        };
+
+        static const size_type NO_BLOCK = size_type(-1);
+
+        std::vector<block> table;
+        size_type many_items;
+        size_type cursor_block;
+        size_type cursor_offset;
+        size_type cursor_index;
+        mutable std::vector<Item> hot;
+        mutable size_type hot_block;
+        mutable bool hot_dirty;
+
+        void make_hot(size_type b) const;
+        void store_hot( ) const;
+        void insert_at(size_type b, size_type offset, const value_type& entry);
+    };
+}
+#include "compressed_sequence.cxx"
+#endif
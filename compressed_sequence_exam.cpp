@@ -0,0 +1,685 @@
+// FILE: compressed_sequence_exam.cpp
+// Non-interactive test program for the compressed_sequence class (see
+// compressed_sequence.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the compressed_sequence,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. Each
+// test compares the sequence with a vector edited the same way, reading the
+// items back both with for_each (which decodes every block, including the
+// hot one while it holds edits not yet encoded) and with the cursor: values
+// at the edges of each encoding, splits of full blocks at chosen offsets,
+// blocks dropped when their last item goes, and random cursor operations
+// with copies. The last test stores three synthetic telemetry series of a
+// million items each and checks that memory_bytes( ) is at most a fifth of
+// the 16 bytes per item that a node of a sequence takes, printing the bytes
+// per item and the for_each decode time per item of each. The program
+// returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 compressed_sequence_exam.cpp -o compressed_sequence_exam
+//     ./compressed_sequence_exam
+
+#include <chrono>           // Provides steady_clock.
+#include <cstdint>          // Provides int64_t, uint8_t, uint64_t.
+#include <cstdlib>          // Provides size_t.
+#include <cstring>          // Provides memcmp.
+#include <iostream>         // Provides cout.
+#include <limits>           // Provides numeric_limits.
+#include <random>           // Provides mt19937 for the random operations.
+#include <vector>           // Provides vector for the expected items.
+#include "compressed_sequence.h"  // Provides the compressed_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 5;
+const int POINTS[MANY_TESTS+1] = {
+    20,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4,  // Test 4 points
+     4   // Test 5 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the compressed_sequence class",
+    "Testing that values at the edges of each encoding come back exactly",
+    "Testing insert and attach into full blocks (splits)",
+    "Testing remove_current that empties blocks (drops)",
+    "Testing random cursor operations, copies and assignments",
+    "Testing memory_bytes( ) against a fifth of 16 bytes per item"
+};
+
+// A node of a sequence of 8-byte items, before any allocator overhead.
+const size_t NODE_BYTES = 16;
+
+
+// **************************************************************************
+// template<class Item> bool same(Item a, Item b)
+//   Postcondition: A return value of true indicates that a and b have the
+//   same bit pattern (so a NaN equals itself, and 0.0 differs from -0.0).
+// **************************************************************************
+template<class Item>
+bool same(Item a, Item b)
+{
+    return memcmp(&a, &b, sizeof(Item)) == 0;
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool matches(compressed_sequence<Item>& test, const vector<Item>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, as read by for_each and by a scan with the cursor,
+//   that no block holds more than BLOCK_ITEMS items or none, and that item
+//   [cursor_spot] is its current item (or that it has no current item and
+//   position( ) == size( ) if cursor_spot >= items.size( )). The cursor is
+//   moved by the scan and then put back with go_to(cursor_spot).
+// **************************************************************************
+template<class Item>
+bool matches(compressed_sequence<Item>& test, const vector<Item>& items, size_t cursor_spot)
+{
+    typedef compressed_sequence<Item> sequence_type;
+    bool good;
+    size_t seen = 0;
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        good = !test.is_item( ) && (test.position( ) == test.size( ));
+    else
+        good = test.is_item( ) && (test.position( ) == cursor_spot)
+            && same(test.current( ), items[cursor_spot]);
+    if ((test.blocks( ) > items.size( ))
+        || (test.blocks( ) * sequence_type::BLOCK_ITEMS < items.size( )))
+        good = false;
+    test.for_each([&](Item x) {
+        if ((seen >= items.size( )) || !same(x, items[seen]))
+            good = false;
+        ++seen;
+    });
+    if (seen != items.size( ))
+        good = false;
+    test.start( );
+    for (i = 0; good && (i < items.size( )); ++i)
+    {
+        if (!test.is_item( ) || (test.position( ) != i) || !same(test.current( ), items[i]))
+            good = false;
+        else
+            test.advance( );
+    }
+    if (good && test.is_item( ))
+        good = false;
+    test.go_to(cursor_spot);
+    return good;
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool round_trip(const char name[], const vector<Item>& items)
+//   Postcondition: A return value of true indicates that a sequence built
+//   by attaching the items, one made by inserting them at the front in
+//   reverse, and a copy of each, all hold exactly the items. Otherwise a
+//   message is printed.
+// **************************************************************************
+template<class Item>
+bool round_trip(const char name[], const vector<Item>& items)
+{
+    compressed_sequence<Item> appended;
+    compressed_sequence<Item> prepended;
+
+    cout << "Round trip of " << items.size( ) << " " << name << " values ... ";
+    cout.flush( );
+    for (size_t i = 0; i < items.size( ); ++i)
+        appended.attach(items[i]);
+    for (size_t i = items.size( ); i-- > 0; )
+    {
+        prepended.start( );
+        prepended.insert(items[i]);
+    }
+    appended.seek_end( );
+    {
+        compressed_sequence<Item> copy(appended);
+        compressed_sequence<Item> assigned;
+        assigned = prepended;
+        if (!matches(appended, items, items.size( )) || !matches(prepended, items, 0)
+            || !matches(copy, items, items.size( )) || !matches(assigned, items, 0))
+        {
+            cout << "the values read back were wrong." << endl;
+            return false;
+        }
+    }
+    cout << "Passed." << endl;
+    return true;
+}
+
+
+// **************************************************************************
+// template<class Item> vector<Item> edge_values(unsigned seed)
+//   Postcondition: The return value holds at least 5000 integers of Item's type:
+//   runs of the extremes, alternating minimum and maximum (the widest
+//   possible differences), constant runs, slow ramps and random values.
+// **************************************************************************
+template<class Item>
+vector<Item> edge_values(unsigned seed)
+{
+    const Item LOW = numeric_limits<Item>::min( );
+    const Item HIGH = numeric_limits<Item>::max( );
+    mt19937_64 random(seed);
+    vector<Item> answer;
+
+    while (answer.size( ) < 5000)
+    {
+        switch (random( ) % 5)
+        {
+        case 0:
+            for (int i = 0; i < 70; ++i)
+                answer.push_back((i % 2 == 0) ? LOW : HIGH);
+            break;
+        case 1:
+            for (int i = 0; i < 130; ++i)
+                answer.push_back(Item(random( )));
+            break;
+        case 2:
+            answer.insert(answer.end( ), 200, Item(random( )));
+            break;
+        case 3:
+            {
+                // Unsigned arithmetic, so that the ramp wraps instead of overflowing.
+                uint64_t start = random( );
+                for (uint64_t i = 0; i < 300; ++i)
+                    answer.push_back(Item(start + i));
+            }
+            break;
+        case 4:
+            answer.push_back(HIGH);
+            answer.push_back(LOW);
+            answer.push_back(0);
+            answer.push_back(Item(HIGH - 1));
+            answer.push_back(Item(LOW + 1));
+            break;
+        }
+    }
+    return answer;
+}
+
+
+// **************************************************************************
+// template<class Item> vector<Item> float_values(unsigned seed)
+//   Postcondition: The return value holds at least 5000 values of the
+//   floating-point type Item: repeats, signed zeros, infinities, NaNs, denormals, the
+//   extremes, slow steps and random bit patterns.
+// **************************************************************************
+template<class Item>
+vector<Item> float_values(unsigned seed)
+{
+    typedef numeric_limits<Item> limits;
+    const Item SPECIAL[] = {
+        Item(0), -Item(0), limits::infinity( ), -limits::infinity( ), limits::quiet_NaN( ),
+        limits::denorm_min( ), -limits::denorm_min( ), limits::min( ), limits::max( ),
+        limits::lowest( ), limits::epsilon( ), Item(1), Item(-1)
+    };
+    mt19937_64 random(seed);
+    vector<Item> answer;
+
+    while (answer.size( ) < 5000)
+    {
+        switch (random( ) % 4)
+        {
+        case 0:
+            for (const Item& x : SPECIAL)
+                answer.push_back(x);
+            break;
+        case 1:
+            answer.insert(answer.end( ), 100, Item(random( ) % 1000) / Item(10));
+            break;
+        case 2:
+            {
+                Item start = Item(random( ) % 400) / Item(10);
+                for (int i = 0; i < 200; ++i)
+                    answer.push_back(start + Item(i / 7) / Item(10));
+            }
+            break;
+        case 3:
+            for (int i = 0; i < 100; ++i)
+            {
+                unsigned char bytes[sizeof(Item)];
+                Item x;
+                for (size_t b = 0; b < sizeof(Item); ++b)
+                    bytes[b] = (unsigned char)(random( ));
+                memcpy(&x, bytes, sizeof(Item));
+                answer.push_back(x);
+            }
+            break;
+        }
+    }
+    return answer;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Round-trips edge values of each integral width, signed and unsigned,
+//   and of double and float. Returns POINTS[1] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    if (!round_trip("int8_t", edge_values<int8_t>(1))
+        || !round_trip("uint8_t", edge_values<uint8_t>(2))
+        || !round_trip("short", edge_values<short>(3))
+        || !round_trip("int", edge_values<int>(4))
+        || !round_trip("unsigned", edge_values<unsigned>(5))
+        || !round_trip("int64_t", edge_values<int64_t>(6))
+        || !round_trip("uint64_t", edge_values<uint64_t>(7))
+        || !round_trip("double", float_values<double>(8))
+        || !round_trip("float", float_values<float>(9)))
+        return 0;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// void fill(compressed_sequence<long>& test, vector<long>& items, size_t n)
+//   Postcondition: test and items hold n values that take a few bits each
+//   (a ramp with small noise), and test has no current item.
+// **************************************************************************
+void fill(compressed_sequence<long>& test, vector<long>& items, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        long value = long(3 * i) + long(i % 5);
+        test.attach(value);
+        items.push_back(value);
+    }
+    test.seek_end( );
+}
+
+
+// **************************************************************************
+// int test2( )
+//   With three full blocks, inserts and attaches one item at offsets at the
+//   ends and the middle of each block (and at none), checking the items, the
+//   cursor, and that exactly one block was added. A second edit at the same
+//   place must not split again. Returns POINTS[2] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    const size_t B = compressed_sequence<long>::BLOCK_ITEMS;
+    const size_t OFFSETS[] = { 0, 1, B/2 - 1, B/2, B/2 + 1, B - 2, B - 1 };
+    vector<size_t> spots;
+
+    for (size_t b = 0; b < 3; ++b)
+        for (size_t offset : OFFSETS)
+            spots.push_back(b * B + offset);
+    spots.push_back(3 * B);
+
+    cout << "Splitting full blocks ... ";
+    cout.flush( );
+    for (int inserting = 1; inserting >= 0; --inserting)
+    {
+        for (size_t spot : spots)
+        {
+            compressed_sequence<long> test;
+            vector<long> items;
+            size_t blocks;
+            size_t after;
+
+            fill(test, items, 3 * B);
+            blocks = test.blocks( );
+            test.go_to(spot);
+            if (inserting)
+            {
+                // A value far from its neighbours widens the block's deltas.
+                test.insert(-1000000007L);
+                after = (spot < 3 * B) ? spot : 0;
+            }
+            else
+            {
+                test.attach(-1000000007L);
+                after = (spot < 3 * B) ? spot + 1 : 3 * B;
+            }
+            items.insert(items.begin( ) + after, -1000000007L);
+            if (!matches(test, items, after))
+            {
+                cout << (inserting ? "insert" : "attach") << " with the cursor at ";
+                cout << spot << " went wrong." << endl;
+                return 0;
+            }
+            if (test.blocks( ) != blocks + 1)
+            {
+                cout << "a full block was not split." << endl;
+                return 0;
+            }
+            test.insert(5L);
+            items.insert(items.begin( ) + after, 5L);
+            if (!matches(test, items, after) || (test.blocks( ) != blocks + 1))
+            {
+                cout << "an insert after a split went wrong." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Removes every item of the first, a middle and the last of four full
+//   blocks, checking after each removal, and checks that the block was
+//   dropped; then refills the sequence and removes every item. Returns
+//   POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    const size_t B = compressed_sequence<long>::BLOCK_ITEMS;
+    const size_t FIRSTS[] = { 0, B, 3 * B };
+
+    cout << "Dropping emptied blocks ... ";
+    cout.flush( );
+    for (size_t first : FIRSTS)
+    {
+        compressed_sequence<long> test;
+        vector<long> items;
+
+        fill(test, items, 4 * B);
+        test.go_to(first);
+        for (size_t k = 0; k < B; ++k)
+        {
+            test.remove_current( );
+            items.erase(items.begin( ) + first);
+            // A full check costs a decode of every block, so check some.
+            if (((k % 97 == 0) || (k + 2 >= B)) && !matches(test, items, first))
+            {
+                cout << "removing item " << k << " of the block at " << first;
+                cout << " went wrong." << endl;
+                return 0;
+            }
+        }
+        if (test.blocks( ) != 3)
+        {
+            cout << "the emptied block at " << first << " was not dropped." << endl;
+            return 0;
+        }
+        // Refill through the cursor, then empty the sequence from the front.
+        size_t spot = first;
+        test.go_to(spot);
+        for (size_t i = 0; i < B + 3; ++i)
+        {
+            bool have = spot < items.size( );
+            test.attach(long(7 * i));
+            spot = have ? spot + 1 : items.size( );
+            items.insert(items.begin( ) + spot, long(7 * i));
+        }
+        if (!matches(test, items, spot))
+        {
+            cout << "refilling after a drop went wrong." << endl;
+            return 0;
+        }
+        test.start( );
+        while (test.size( ) > 0)
+            test.remove_current( );
+        items.clear( );
+        if (!matches(test, items, 0) || (test.blocks( ) != 0))
+        {
+            cout << "removing every item went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Makes 20000 random edits and moves on a sequence of longs with deltas
+//   of every width, checking the cursor after each step, every item every
+//   1000 steps, and a copy and an assignment every 2500 steps. Returns
+//   POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    mt19937_64 random(43);
+    compressed_sequence<long> test;
+    vector<long> items;
+    size_t spot = 0;
+
+    cout << "Making random edits ... ";
+    cout.flush( );
+    for (int step = 0; step < 20000; ++step)
+    {
+        bool have = spot < items.size( );
+        unsigned choice = random( ) % 10;
+        // Mostly small steps, sometimes a jump of any width.
+        long value = (random( ) % 8 == 0) ? long(random( )) : long(step) + long(random( ) % 16);
+
+        if ((step > 12000) && (choice < 4))
+            choice += 6;
+        switch (choice)
+        {
+        case 0:
+        case 1:
+            test.insert(value);
+            spot = have ? spot : 0;
+            items.insert(items.begin( ) + spot, value);
+            break;
+        case 2:
+        case 3:
+        case 4:
+            test.attach(value);
+            spot = have ? spot + 1 : items.size( );
+            items.insert(items.begin( ) + spot, value);
+            break;
+        case 5:
+            if (have)
+            {
+                test.advance( );
+                ++spot;
+            }
+            break;
+        case 6:
+            spot = random( ) % (items.size( ) + 1);
+            test.go_to(spot);
+            break;
+        case 7:
+            {
+                size_t steps = random( ) % (items.size( ) - spot + 1);
+                test.advance(steps);
+                spot += steps;
+            }
+            break;
+        case 8:
+        case 9:
+            if (have)
+            {
+                test.remove_current( );
+                items.erase(items.begin( ) + spot);
+            }
+            else
+            {
+                test.start( );
+                spot = 0;
+            }
+            break;
+        }
+        if (spot >= items.size( ))
+        {
+            if (test.is_item( ) || (test.position( ) != items.size( )))
+            {
+                cout << "step " << step << " left a current item at the end." << endl;
+                return 0;
+            }
+        }
+        else if (!test.is_item( ) || (test.position( ) != spot) || (test.current( ) != items[spot]))
+        {
+            cout << "step " << step << " left the cursor on the wrong item." << endl;
+            return 0;
+        }
+        if ((step % 1000 == 0) && !matches(test, items, spot))
+        {
+            cout << "after step " << step << " the items were wrong." << endl;
+            return 0;
+        }
+        if (step % 2500 == 1)
+        {
+            // The copies are taken while the hot block may hold edits.
+            compressed_sequence<long> copy(test);
+            compressed_sequence<long> assigned;
+            assigned.attach(1L);
+            assigned = test;
+            if (!matches(copy, items, spot) || !matches(assigned, items, spot))
+            {
+                cout << "a copy after step " << step << " was wrong." << endl;
+                return 0;
+            }
+        }
+    }
+    if (!matches(test, items, spot))
+    {
+        cout << "the items were wrong at the end." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool small_enough(const char name[], const vector<Item>& series)
+//   Postcondition: A return value of true indicates that a sequence built
+//   by attaching series holds it exactly and takes at most a fifth of
+//   NODE_BYTES per item. The bytes per item, and the time for_each takes to
+//   decode each item, are printed either way.
+// **************************************************************************
+template<class Item>
+bool small_enough(const char name[], const vector<Item>& series)
+{
+    compressed_sequence<Item> test;
+    double per_item;
+
+    cout << "Storing " << series.size( ) << " items of " << name << " ... ";
+    cout.flush( );
+    for (size_t i = 0; i < series.size( ); ++i)
+        test.attach(series[i]);
+    test.seek_end( );
+    per_item = double(test.memory_bytes( )) / double(series.size( ));
+    cout << per_item << " bytes per item, " << double(NODE_BYTES) / per_item << "x smaller, ";
+    {
+        chrono::steady_clock::time_point started = chrono::steady_clock::now( );
+        Item last = Item( );
+        test.for_each([&last](Item x) { last = x; });
+        cout << chrono::duration<double>(chrono::steady_clock::now( ) - started).count( ) * 1e9
+                / double(series.size( )) << " ns per item to decode ... ";
+        if (!same(last, series.back( )))
+            return false;
+    }
+    if (!matches(test, series, series.size( )))
+    {
+        cout << "the items read back were wrong." << endl;
+        return false;
+    }
+    if (5 * test.memory_bytes( ) > NODE_BYTES * series.size( ))
+    {
+        cout << "less than 5x smaller than a node per item." << endl;
+        return false;
+    }
+    cout << "Passed." << endl;
+    return true;
+}
+
+
+// **************************************************************************
+// int test5( )
+//   Checks memory_bytes( ) for three series of a million items: millisecond
+//   timestamps one second apart with a few milliseconds of jitter, a
+//   temperature in 0.1 degree steps that changes about one reading in ten,
+//   and a counter that goes up by 0 to 3 per item. Returns POINTS[5] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test5( )
+{
+    const size_t N = 1000000;
+    mt19937 random(2024);
+    vector<long long> timestamps(N);
+    vector<double> temperature(N);
+    vector<unsigned> counter(N);
+    long long tenths = 215;
+
+    cout.precision(2);
+    cout << fixed;
+    for (size_t i = 0; i < N; ++i)
+    {
+        timestamps[i] = 1700000000000LL + 1000LL * (long long)(i) + (long long)(random( ) % 7) - 3;
+        if (random( ) % 10 == 0)
+            tenths += (random( ) % 2 == 0) ? 1 : -1;
+        temperature[i] = double(tenths) / 10.0;
+        counter[i] = (i == 0) ? 0 : counter[i-1] + unsigned(random( ) % 4);
+    }
+    if (!small_enough("timestamps", timestamps)
+        || !small_enough("temperature", temperature)
+        || !small_enough("counter", counter))
+        return 0;
+
+    cout << "All tests of this fifth function have been passed." << endl;
+    return POINTS[5];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+    sum += run_a_test(5, DESCRIPTION[5], test5, POINTS[5]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,84 @@
+// FILE: disk_bench.cpp
+// Benchmark for disk_sequence (see disk_sequence.h).
+//
+// DESCRIPTION:
+// Appends megabytes MB of doubles to a disk_sequence that caches
+// cache_blocks 64 KiB blocks, then scans them with start( )/advance( ) and
+// current( ), and reports the rate of each pass in MB/s with the blocks
+// read and written. The file is created in $TMPDIR (or /tmp) and is
+// usually still in the page cache when the scan reads it back, so the scan
+// rate is that of pread from the page cache plus the cursor, not of the
+// disk; to time the disk, run with a data set larger than free memory, or
+// drop the page cache between the passes of a modified copy.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 disk_bench.cpp -o disk_bench
+//     ./disk_bench 400 16
+// The optional arguments are megabytes (default 400) and cache_blocks
+// (default 16).
+
+#include <chrono>           // Provides steady_clock
+#include <cstdlib>          // Provides size_t, strtoul, EXIT_FAILURE
+#include <iostream>         // Provides cout, cerr
+#include "disk_sequence.h"  // Provides the disk_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Timer returning the seconds since construction.
+class stopwatch
+{
+public:
+    stopwatch( ) : started(chrono::steady_clock::now( )) { }
+    double seconds( ) const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now( ) - started).count( );
+    }
+private:
+    chrono::steady_clock::time_point started;
+};
+
+void report(const char* name, double seconds, size_t bytes, const disk_sequence<double>& data)
+{
+    cout.width(10);
+    cout << left << name << right;
+    cout.width(10);
+    cout << double(bytes) / 1e6 / seconds << " MB/s   ";
+    cout << data.block_reads( ) << " blocks read, " << data.block_writes( ) << " written" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = (argc > 1) ? strtoul(argv[1], NULL, 10) : 400;
+    size_t cache_blocks = (argc > 2) ? strtoul(argv[2], NULL, 10) : 16;
+    size_t n = megabytes * 1000000 / sizeof(double);
+    double checksum = 0;
+
+    if ((n == 0) || (cache_blocks < 2))
+    {
+        cerr << "usage: " << argv[0] << " [megabytes (at least 1)] [cache_blocks (at least 2)]" << endl;
+        return EXIT_FAILURE;
+    }
+    disk_sequence<double> data(cache_blocks);
+
+    cout.precision(1);
+    cout << fixed;
+    cout << megabytes << " MB of doubles, " << cache_blocks << " cached blocks" << endl;
+
+    {
+        stopwatch timer;
+        for (size_t i = 0; i < n; ++i)
+            data.attach(double(i));
+        data.flush( );
+        report("append", timer.seconds( ), n * sizeof(double), data);
+    }
+
+    {
+        stopwatch timer;
+        for (data.start( ); data.is_item( ); data.advance( ))
+            checksum += data.current( );
+        report("scan", timer.seconds( ), n * sizeof(double), data);
+    }
+
+    cout << "checksum " << checksum << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,448 @@
+// FILE: disk_sequence.cxx
+// CLASS IMPLEMENTED: disk_sequence (see disk_sequence.h for documentation)
+// INVARIANT for the disk_sequence class:
+//   1. The items, in order, are the first table[i].count items of block i
+//      for i = 0, 1, ..., table.size( ) - 1. Every block holds between 1 and
+//      BLOCK_ITEMS items, and many_items is the sum of the counts.
+//
+//   2. Block i lives in the file at table[i].slot * BLOCK_BYTES. Slots not
+//      used by any block are below next_slot and listed in free_slots.
+//
+//   3. cache holds at most cache_limit blocks, most recently used first, and
+//      cached maps the slot of each to its place in cache. A cached block's
+//      items replace what the file holds for it; dirty says whether they
+//      differ. spare is an empty vector or a block's worth of storage kept
+//      from the last eviction for the next block read.
+//
+//   4. If hot_items is not NULL, it is the items of the block at the front of
+//      cache, whose slot is hot_slot; a scan within one block then skips
+//      the hash lookup.
+//
+//   5. If there is a current item, it is item cursor_offset of block
+//      cursor_block, and cursor_offset < table[cursor_block].count.
+//      Otherwise cursor_block == table.size( ) and cursor_offset == 0.
+//      Either way cursor_index is the position of the cursor, as in
+//      sequence4.h.
+
+#include <algorithm>      // Provides copy, copy_backward
+#include <cassert>        // Provides assert
+#include <cerrno>         // Provides errno
+#include <cstdlib>        // Provides getenv
+#include <string>         // Provides string
+#include <system_error>   // Provides system_error
+#include <type_traits>    // Provides is_trivially_copyable
+#include <fcntl.h>        // Provides posix_fadvise
+#include <stdlib.h>       // Provides mkstemp
+#include <unistd.h>       // Provides pread, pwrite, close, unlink
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    const typename disk_sequence<Item>::size_type disk_sequence<Item>::BLOCK_BYTES;
+
+    template<class Item>
+    const typename disk_sequence<Item>::size_type disk_sequence<Item>::BLOCK_ITEMS;
+
+    template<class Item>
+    const typename disk_sequence<Item>::size_type disk_sequence<Item>::READAHEAD;
+
+    template<class Item>
+    disk_sequence<Item>::disk_sequence(size_type cache_blocks, const char* directory)
+    {
+        static_assert(std::is_trivially_copyable<Item>::value,
+                      "disk_sequence needs a trivially copyable value_type");
+        static_assert(BLOCK_ITEMS >= 2, "disk_sequence needs at least two items per block");
+        assert(cache_blocks >= 2);
+        std::string path;
+
+        if (directory == NULL)
+            directory = std::getenv("TMPDIR");
+        path = (directory != NULL) ? directory : "/tmp";
+        path += "/disk_sequence.XXXXXX";
+        std::vector<char> name(path.begin( ), path.end( ));
+        name.push_back('\0');
+
+        file = mkstemp(name.data( ));
+        if (file < 0)
+            throw std::system_error(errno, std::generic_category( ), "disk_sequence: mkstemp");
+        unlink(name.data( ));
+        posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        next_slot = 0;
+        many_items = 0;
+        cursor_block = 0;
+        cursor_offset = 0;
+        cursor_index = 0;
+        cache_limit = cache_blocks;
+        hot_items = NULL;
+        hot_slot = 0;
+        reads = 0;
+        writes = 0;
+    }
+
+    template<class Item>
+    disk_sequence<Item>::~disk_sequence( )
+    {
+        // The file is already unlinked, so nothing needs writing back.
+        close(file);
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::start( )
+    {
+        cursor_block = 0;
+        cursor_offset = 0;
+        cursor_index = 0;
+        prefetch(0);
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::advance( )
+    {
+        assert(is_item( ));
+
+        ++cursor_index;
+        if (++cursor_offset == table[cursor_block].count)
+        {
+            ++cursor_block;
+            cursor_offset = 0;
+            prefetch(cursor_block);
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::advance(size_type steps)
+    {
+        assert(steps <= many_items - cursor_index);
+        size_type block = cursor_block;
+
+        cursor_index += steps;
+        steps += cursor_offset;
+        while ((cursor_block < table.size( )) && (steps >= table[cursor_block].count))
+        {
+            steps -= table[cursor_block].count;
+            ++cursor_block;
+        }
+        cursor_offset = steps;
+        if (cursor_block != block)
+            prefetch(cursor_block);
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::go_to(size_type k)
+    {
+        if (k >= many_items)
+            seek_end( );
+        else if (k >= cursor_index)
+            advance(k - cursor_index);
+        else
+        {
+            start( );
+            advance(k);
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::seek_end( )
+    {
+        cursor_block = table.size( );
+        cursor_offset = 0;
+        cursor_index = many_items;
+    }
+
+    template<class Item>
+    typename disk_sequence<Item>::value_type disk_sequence<Item>::current( ) const
+    {
+        assert(is_item( ));
+
+        return load(cursor_block, false)[cursor_offset];
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::insert(const value_type& entry)
+    {
+        if (is_item( ))
+            insert_at(cursor_block, cursor_offset, entry);
+        else
+        {
+            insert_at(0, 0, entry);
+            cursor_index = 0;
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::attach(const value_type& entry)
+    {
+        if (is_item( ))
+        {
+            insert_at(cursor_block, cursor_offset + 1, entry);
+            ++cursor_index;
+        }
+        else if (table.empty( ))
+        {
+            insert_at(0, 0, entry);
+            cursor_index = 0;
+        }
+        else
+        {
+            insert_at(table.size( ) - 1, table.back( ).count, entry);
+            cursor_index = many_items - 1;
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::insert_at(size_type block, size_type offset, const value_type& entry)
+    {
+        const size_type keep = BLOCK_ITEMS / 2;
+        Item* data;
+        Item* full;
+
+        if (table.empty( ))
+        {
+            block = 0;
+            offset = 0;
+            data = fresh_block(0);
+        }
+        else if (table[block].count < BLOCK_ITEMS)
+            data = load(block, true);
+        else if ((offset == BLOCK_ITEMS) && (block + 1 == table.size( )))
+        {
+            // Appending to a full last block: start a new one, so that blocks
+            // written by a run of attaches stay full and in file order.
+            ++block;
+            offset = 0;
+            data = fresh_block(block);
+        }
+        else
+        {
+            // Split the full block in half. full is the most recently used
+            // block, so making the new one (cache_limit >= 2) cannot evict it.
+            full = load(block, true);
+            data = fresh_block(block + 1);
+            std::copy(full + keep, full + BLOCK_ITEMS, data);
+            table[block + 1].count = BLOCK_ITEMS - keep;
+            table[block].count = keep;
+            if (offset > keep)
+            {
+                ++block;
+                offset -= keep;
+            }
+            else
+                data = full;
+        }
+
+        std::copy_backward(data + offset, data + table[block].count, data + table[block].count + 1);
+        data[offset] = entry;
+        ++table[block].count;
+        ++many_items;
+        cursor_block = block;
+        cursor_offset = offset;
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::remove_current( )
+    {
+        assert(is_item( ));
+        block_entry& here = table[cursor_block];
+        Item* data;
+
+        if (here.count == 1)
+            drop_block(cursor_block);       // The next block moves into place
+        else
+        {
+            data = load(cursor_block, true);
+            std::copy(data + cursor_offset + 1, data + here.count, data + cursor_offset);
+            --here.count;
+            if (cursor_offset == here.count)
+            {
+                ++cursor_block;
+                cursor_offset = 0;
+            }
+        }
+        --many_items;
+        if (cursor_block < table.size( ))
+            prefetch(cursor_block);
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::flush( )
+    {
+        for (cache_position it = cache.begin( ); it != cache.end( ); ++it)
+        {
+            if (it->dirty)
+                write_back(*it);
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::make_room( ) const
+    {
+        while (cache.size( ) >= cache_limit)
+        {
+            cached_block& victim = cache.back( );
+
+            if (victim.dirty)
+                write_back(victim);
+            if (victim.slot == hot_slot)
+                hot_items = NULL;
+            cached.erase(victim.slot);
+            spare.swap(victim.items);
+            cache.pop_back( );
+        }
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::write_back(cached_block& victim) const
+    {
+        const char* bytes = reinterpret_cast<const char*>(victim.items.data( ));
+        off_t where = off_t(victim.slot * BLOCK_BYTES);
+        size_type done = 0;
+        ssize_t written;
+
+        while (done < BLOCK_ITEMS * sizeof(Item))
+        {
+            written = pwrite(file, bytes + done, BLOCK_ITEMS * sizeof(Item) - done, where + off_t(done));
+            if ((written < 0) && (errno == EINTR))
+                continue;
+            if (written <= 0)
+                throw std::system_error((written < 0) ? errno : ENOSPC, std::generic_category( ),
+                                        "disk_sequence: pwrite");
+            done += size_type(written);
+        }
+        ++writes;
+        victim.dirty = false;
+    }
+
+    template<class Item>
+    Item* disk_sequence<Item>::load(size_type block, bool for_writing) const
+    {
+        size_type slot = table[block].slot;
+        typename std::unordered_map<size_type, cache_position>::iterator found;
+        std::vector<Item> loaded;
+        char* bytes;
+        size_type done = 0;
+        ssize_t got;
+
+        if ((hot_items != NULL) && (hot_slot == slot))
+        {
+            cache.front( ).dirty = cache.front( ).dirty || for_writing;
+            return hot_items;
+        }
+        found = cached.find(slot);
+        if (found != cached.end( ))
+        {
+            cache.splice(cache.begin( ), cache, found->second);
+            cache.front( ).dirty = cache.front( ).dirty || for_writing;
+            hot_slot = slot;
+            hot_items = cache.front( ).items.data( );
+            return hot_items;
+        }
+
+        make_room( );
+        loaded.swap(spare);
+        loaded.resize(BLOCK_ITEMS);
+        bytes = reinterpret_cast<char*>(loaded.data( ));
+        while (done < table[block].count * sizeof(Item))
+        {
+            got = pread(file, bytes + done, table[block].count * sizeof(Item) - done,
+                        off_t(slot * BLOCK_BYTES + done));
+            if ((got < 0) && (errno == EINTR))
+                continue;
+            if (got <= 0)
+            {
+                spare.swap(loaded);
+                throw std::system_error((got < 0) ? errno : EIO, std::generic_category( ),
+                                        "disk_sequence: pread");
+            }
+            done += size_type(got);
+        }
+        ++reads;
+
+        cache.push_front(cached_block( ));
+        cache.front( ).slot = slot;
+        cache.front( ).dirty = for_writing;
+        cache.front( ).items.swap(loaded);
+        try
+        {
+            cached[slot] = cache.begin( );
+        }
+        catch (...)
+        {
+            cache.pop_front( );
+            throw;
+        }
+        hot_slot = slot;
+        hot_items = cache.front( ).items.data( );
+        return hot_items;
+    }
+
+    template<class Item>
+    Item* disk_sequence<Item>::fresh_block(size_type block)
+    {
+        block_entry added;
+        std::vector<Item> storage;
+
+        make_room( );
+        storage.swap(spare);
+        storage.resize(BLOCK_ITEMS);
+        added.slot = free_slots.empty( ) ? next_slot : free_slots.back( );
+        added.count = 0;
+        table.reserve(table.size( ) + 1);
+
+        cache.push_front(cached_block( ));
+        cache.front( ).slot = added.slot;
+        cache.front( ).dirty = true;
+        cache.front( ).items.swap(storage);
+        try
+        {
+            cached[added.slot] = cache.begin( );
+        }
+        catch (...)
+        {
+            cache.pop_front( );
+            throw;
+        }
+
+        // Nothing below can throw.
+        table.insert(table.begin( ) + block, added);
+        if (free_slots.empty( ))
+            ++next_slot;
+        else
+            free_slots.pop_back( );
+        hot_slot = added.slot;
+        hot_items = cache.front( ).items.data( );
+        return hot_items;
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::drop_block(size_type block)
+    {
+        size_type slot = table[block].slot;
+        typename std::unordered_map<size_type, cache_position>::iterator found;
+
+        free_slots.push_back(slot);
+        if (slot == hot_slot)
+            hot_items = NULL;
+        found = cached.find(slot);
+        if (found != cached.end( ))
+        {
+            // Its items are gone, so it is never written back.
+            spare.swap(found->second->items);
+            cache.erase(found->second);
+            cached.erase(found);
+        }
+        table.erase(table.begin( ) + block);
+        posix_fadvise(file, off_t(slot * BLOCK_BYTES), off_t(BLOCK_BYTES), POSIX_FADV_DONTNEED);
+    }
+
+    template<class Item>
+    void disk_sequence<Item>::prefetch(size_type block) const
+    {
+        for (size_type i = block + 1; (i <= block + READAHEAD) && (i < table.size( )); ++i)
+        {
+            if (cached.find(table[i].slot) == cached.end( ))
+                posix_fadvise(file, off_t(table[i].slot * BLOCK_BYTES), off_t(BLOCK_BYTES),
+                              POSIX_FADV_WILLNEED);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+// FILE: disk_sequence.h
+// CLASS PROVIDED: disk_sequence (part of the namespace scu_coen70_6B)
+// A sequence with the same cursor interface as sequence<Item> (sequence4.h)
+// for data sets larger than memory. The items are kept in a temporary file
+// as an unrolled list: blocks of up to BLOCK_ITEMS items each, linked in
+// order by a small table in memory (about 16 bytes per block). At most
+// cache_blocks( ) blocks are held in memory at a time. A block is read
+// with pread when the cursor reaches it, and the least recently used one is
+// written back with pwrite (if it changed) to make room. POSIX only.
+//
+// Blocks filled by attach at the end are placed one after another in the
+// file, so a scan from start( ) to the end reads the file sequentially. The
+// file is opened with POSIX_FADV_SEQUENTIAL, and each time the cursor moves
+// into a new block the next READAHEAD blocks are requested with
+// POSIX_FADV_WILLNEED, so the kernel reads ahead of the scan.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the disk_sequence class:
+//   typedef ____ value_type
+//     disk_sequence::value_type is the data type of the items. It must be
+//     trivially copyable, since items are written to the file byte for byte.
+//
+//   typedef ____ size_type
+//     As in sequence4.h.
+//
+//   static const size_type BLOCK_BYTES
+//     The size of a block in the file (64 KiB).
+//
+//   static const size_type BLOCK_ITEMS
+//     The number of items a block holds: BLOCK_BYTES / sizeof(value_type).
+//
+//   static const size_type READAHEAD
+//     How many blocks past the cursor are prefetched (4).
+//
+// CONSTRUCTOR for the disk_sequence class:
+//   disk_sequence(size_type cache_blocks = 64, const char* directory = NULL)
+//     Precondition: cache_blocks >= 2.
+//     Postcondition: The disk_sequence is empty. Its file has been created in
+//     directory (or in $TMPDIR, or /tmp, if directory is NULL) and already
+//     unlinked, so it disappears when the disk_sequence is destroyed or the
+//     program ends. At most cache_blocks blocks (cache_blocks * BLOCK_BYTES
+//     bytes) will be held in memory.
+//
+// MODIFICATION MEMBER FUNCTIONS for the disk_sequence class:
+//   void start( )
+//   void advance( )
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//   void remove_current( )
+//   void advance(size_type steps)
+//   void go_to(size_type k)
+//   void seek_end( )
+//     Same preconditions and postconditions as in sequence4.h. insert and
+//     attach shift the items after the cursor within its block, and split
+//     the block in two when it is full (except that attach at the end of
+//     the last block starts a new block, so appended blocks stay full).
+//     remove_current frees a block once its last item is removed; partly
+//     empty blocks are not merged. advance(steps) and go_to skip whole
+//     blocks by their counts, without reading them.
+//
+//   void flush( )
+//     Postcondition: Every changed block held in memory has been written to
+//     the file.
+//
+// CONSTANT MEMBER FUNCTIONS for the disk_sequence class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//   value_type current( ) const
+//   size_type position( ) const
+//     Same as in sequence4.h. current( ) may read the cursor's block from
+//     the file (the cache is mutable).
+//
+//   size_type blocks( ) const
+//   size_type cache_blocks( ) const
+//     Postcondition: The return values are the number of blocks in use and
+//     the most that are held in memory at a time.
+//
+//   size_type block_reads( ) const
+//   size_type block_writes( ) const
+//     Postcondition: The return values are the number of blocks read from
+//     and written to the file so far.
+//
+// VALUE SEMANTICS for the disk_sequence class:
+//   A disk_sequence owns its file, so it may not be copied or assigned.
+//
+// DYNAMIC MEMORY AND FILE ERRORS:
+//   If there is insufficient dynamic memory, the modification functions and
+//   current( ) throw bad_alloc. If the file cannot be created, read or
+//   written (for example, when the disk is full), they throw system_error.
+//   A failed write-back leaves the block in memory and marked as changed.
+
+#ifndef COEN_70_DISK_SEQUENCE_H
+#define COEN_70_DISK_SEQUENCE_H
+#include <cstdlib>        // Provides size_t
+#include <list>           // Provides list
+#include <unordered_map>  // Provides unordered_map
+#include <vector>         // Provides vector
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    class disk_sequence
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef Item value_type;
+        typedef std::size_t size_type;
+        static const size_type BLOCK_BYTES = 64 * 1024;
+        static const size_type BLOCK_ITEMS = BLOCK_BYTES / sizeof(Item);
+        static const size_type READAHEAD = 4;
+        // CONSTRUCTOR and DESTRUCTOR
+        disk_sequence(size_type cache_blocks = 64, const char* directory = NULL);
+        disk_sequence(const disk_sequence&) = delete;
+        disk_sequence& operator =(const disk_sequence&) = delete;
+        ~disk_sequence( );
+        // MODIFICATION MEMBER FUNCTIONS
+        void start( );
+        void advance( );
+        void insert(const value_type& entry);
+        void attach(const value_type& entry);
+        void remove_current( );
+        void advance(size_type steps);
+        void go_to(size_type k);
+        void seek_end( );
+        void flush( );
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return many_items; }
+        bool is_item( ) const { return cursor_block < table.size( ); }
+        value_type current( ) const;
+        size_type position( ) const { return cursor_index; }
+        size_type blocks( ) const { return table.size( ); }
+        size_type cache_blocks( ) const { return cache_limit; }
+        size_type block_reads( ) const { return reads; }
+        size_type block_writes( ) const { return writes; }
+    private:
+        struct block_entry
+        {
+            size_type slot;     // Where the block lives in the file
+            size_type count;    // How many items it holds
+        };
+        struct cached_block
+        {
+            size_type slot;
+            bool dirty;
+            std::vector<Item> items;
+        };
+        typedef typename std::list<cached_block>::iterator cache_position;
+
+        int file;
+        std::vector<block_entry> table;
+        std::vector<size_type> free_slots;
+        size_type next_slot;
+        size_type many_items;
+        size_type cursor_block;
+        size_type cursor_offset;
+        size_type cursor_index;
+        size_type cache_limit;
+        mutable std::list<cached_block> cache;
+        mutable std::unordered_map<size_type, cache_position> cached;
+        mutable std::vector<Item> spare;
+        mutable size_type hot_slot;
+        mutable Item* hot_items;
+        mutable size_type reads;
+        mutable size_type writes;
+
+        Item* load(size_type block, bool for_writing) const;
+        Item* fresh_block(size_type block);
+        void drop_block(size_type block);
+        void make_room( ) const;
+        void write_back(cached_block& victim) const;
+        void prefetch(size_type block) const;
+        void insert_at(size_type block, size_type offset, const value_type& entry);
+    };
+}
+#include "disk_sequence.cxx"
+#endif
@@ -0,0 +1,504 @@
+// FILE: disk_sequence_exam.cpp
+// Non-interactive test program for the disk_sequence class (see
+// disk_sequence.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the disk_sequence, returning
+// some number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. The items are
+// 4 KiB pages, so a 64 KiB block holds only 16 of them and a few hundred
+// items already span dozens of blocks; the cache holds two or three blocks,
+// so nearly every move reads a block back from the file and writes another
+// one out. Each test compares the sequence with a vector edited the same
+// way: appends, splits of full blocks at every offset, blocks dropped when
+// their last item goes, and random cursor operations. The program returns
+// EXIT_FAILURE unless every test passes.
+//
+// Build and run (POSIX only; the file is made in $TMPDIR or /tmp):
+//     g++ -std=c++17 -O2 disk_sequence_exam.cpp -o disk_sequence_exam
+//     ./disk_sequence_exam
+
+#include <iostream>         // Provides cout.
+#include <cstdlib>          // Provides size_t.
+#include <random>           // Provides mt19937 for the random operations.
+#include <vector>           // Provides vector for the expected items.
+#include "disk_sequence.h"  // Provides the disk_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// An item the size of a page, so that blocks are short.
+struct page
+{
+    long value;
+    char padding[4096 - sizeof(long)];
+};
+
+typedef disk_sequence<page> pages;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the disk_sequence class",
+    "Testing attach at the end, a full scan, and the block counts",
+    "Testing insert and attach into full blocks at every offset (splits)",
+    "Testing remove_current that empties blocks (drops)",
+    "Testing random cursor operations with a cache of two and three blocks"
+};
+
+
+// **************************************************************************
+// page make_page(long value)
+//   Postcondition: The return value is a page holding value, whose padding
+//   is filled with a pattern made from value.
+// **************************************************************************
+page make_page(long value)
+{
+    page answer;
+
+    answer.value = value;
+    for (size_t i = 0; i < sizeof(answer.padding); ++i)
+        answer.padding[i] = char(value + long(i));
+    return answer;
+}
+
+
+// **************************************************************************
+// bool intact(const page& p)
+//   Postcondition: A return value of true indicates that the padding of p
+//   still holds the pattern made by make_page(p.value).
+// **************************************************************************
+bool intact(const page& p)
+{
+    for (size_t i = 0; i < sizeof(p.padding); i += 509)
+    {
+        if (p.padding[i] != char(p.value + long(i)))
+            return false;
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// bool matches(pages& test, const vector<long>& items, size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds pages
+//   of exactly the items, in order, each intact, that no block holds more
+//   than BLOCK_ITEMS items or none, and that item [cursor_spot] is its
+//   current item (or that it has no current item and position( ) == size( )
+//   if cursor_spot >= items.size( )). The cursor is moved by the scan and
+//   then put back with go_to(cursor_spot).
+// **************************************************************************
+bool matches(pages& test, const vector<long>& items, size_t cursor_spot)
+{
+    bool good = true;
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        good = !test.is_item( ) && (test.position( ) == test.size( ));
+    else
+        good = test.is_item( ) && (test.position( ) == cursor_spot)
+            && (test.current( ).value == items[cursor_spot]);
+    if ((test.blocks( ) > items.size( ))
+        || (test.blocks( ) * pages::BLOCK_ITEMS < items.size( )))
+        good = false;
+    test.start( );
+    for (i = 0; good && (i < items.size( )); ++i)
+    {
+        page here;
+
+        if (!test.is_item( ) || (test.position( ) != i))
+            good = false;
+        else
+        {
+            here = test.current( );
+            good = (here.value == items[i]) && intact(here);
+            test.advance( );
+        }
+    }
+    if (good && test.is_item( ))
+        good = false;
+    test.go_to(cursor_spot);
+    return good;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Attaches 1000 pages at the end, checks that they fill ceil(1000 / 16)
+//   blocks, and that a scan with a cache of 2 blocks reads each block once.
+//   Returns POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    pages test(2);
+    vector<long> items;
+    size_t reads;
+
+    cout << "Attaching 1000 pages ... ";
+    cout.flush( );
+    for (long i = 0; i < 1000; ++i)
+    {
+        test.attach(make_page(i));
+        items.push_back(i);
+        if ((test.position( ) != size_t(i)) || (test.current( ).value != i))
+        {
+            cout << "attach left the cursor at the wrong item." << endl;
+            return 0;
+        }
+    }
+    if (test.blocks( ) != (1000 + pages::BLOCK_ITEMS - 1) / pages::BLOCK_ITEMS)
+    {
+        cout << "appended blocks were not left full." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Scanning them with a cache of 2 blocks ... ";
+    cout.flush( );
+    test.seek_end( );
+    reads = test.block_reads( );
+    if (!matches(test, items, items.size( )))
+    {
+        cout << "the pages read back were wrong." << endl;
+        return 0;
+    }
+    if (test.block_reads( ) - reads != test.blocks( ))
+    {
+        cout << "the scan read " << test.block_reads( ) - reads << " blocks, not ";
+        cout << test.blocks( ) << "." << endl;
+        return 0;
+    }
+    test.flush( );
+    test.go_to(500);
+    if (!matches(test, items, 500))
+    {
+        cout << "flush( ) changed the pages." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   For every offset in a full middle block (and at none), inserts and
+//   attaches one page there, checking the items, the cursor and that the
+//   block was split in two. Returns POINTS[2] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    const size_t FULL = 3 * pages::BLOCK_ITEMS;
+
+    cout << "Splitting full blocks ... ";
+    cout.flush( );
+    for (int inserting = 1; inserting >= 0; --inserting)
+    {
+        for (size_t spot = 0; spot <= FULL; ++spot)
+        {
+            pages test(2);
+            vector<long> items;
+            size_t blocks;
+            size_t after;
+
+            for (size_t i = 0; i < FULL; ++i)
+            {
+                test.attach(make_page(long(i)));
+                items.push_back(long(i));
+            }
+            blocks = test.blocks( );
+            test.go_to(spot);
+            if (inserting)
+            {
+                test.insert(make_page(-1));
+                after = (spot < FULL) ? spot : 0;
+            }
+            else
+            {
+                test.attach(make_page(-1));
+                after = (spot < FULL) ? spot + 1 : FULL;
+            }
+            items.insert(items.begin( ) + after, -1);
+            if (!matches(test, items, after))
+            {
+                cout << (inserting ? "insert" : "attach") << " with the cursor at ";
+                cout << spot << " went wrong." << endl;
+                return 0;
+            }
+            // Every edit of a full block adds one: a split, or a new last block.
+            if (test.blocks( ) != blocks + 1)
+            {
+                cout << "a full block was not split." << endl;
+                return 0;
+            }
+            // A second edit at the same place goes into the half-empty block.
+            test.insert(make_page(-2));
+            items.insert(items.begin( ) + after, -2);
+            if (!matches(test, items, after) || (test.blocks( ) != blocks + 1))
+            {
+                cout << "an insert after a split went wrong." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Removes every page of the first, a middle and the last block (from
+//   their first item, so the cursor stays in the block until it is dropped)
+//   and checks the items, the cursor and the block count; then refills the
+//   sequence to check that the freed slots are used again correctly.
+//   Returns POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    const size_t B = pages::BLOCK_ITEMS;
+    const size_t FIRSTS[] = { 0, 2 * B, 4 * B };
+
+    cout << "Dropping emptied blocks ... ";
+    cout.flush( );
+    for (size_t first : FIRSTS)
+    {
+        pages test(3);
+        vector<long> items;
+
+        for (size_t i = 0; i < 5 * B; ++i)
+        {
+            test.attach(make_page(long(i)));
+            items.push_back(long(i));
+        }
+        test.go_to(first);
+        for (size_t k = 0; k < B; ++k)
+        {
+            test.remove_current( );
+            items.erase(items.begin( ) + first);
+            if (!matches(test, items, first))
+            {
+                cout << "removing item " << k << " of the block at " << first;
+                cout << " went wrong." << endl;
+                return 0;
+            }
+        }
+        if (test.blocks( ) != 4)
+        {
+            cout << "the emptied block at " << first << " was not dropped." << endl;
+            return 0;
+        }
+        // Refill: new blocks take the freed slot, and must not see old data.
+        test.seek_end( );
+        for (size_t i = 0; i < 2 * B; ++i)
+        {
+            test.attach(make_page(long(1000 + i)));
+            items.push_back(long(1000 + i));
+        }
+        test.go_to(first);
+        for (size_t i = 0; i < B; ++i)
+        {
+            test.insert(make_page(long(2000 + i)));
+            items.insert(items.begin( ) + first, long(2000 + i));
+        }
+        if (!matches(test, items, first))
+        {
+            cout << "refilling after a drop went wrong." << endl;
+            return 0;
+        }
+    }
+    {
+        // Removing the last item leaves no current item.
+        pages test(2);
+        vector<long> items;
+
+        for (size_t i = 0; i < B + 1; ++i)
+        {
+            test.attach(make_page(long(i)));
+            items.push_back(long(i));
+        }
+        test.go_to(B);
+        test.remove_current( );
+        items.pop_back( );
+        if (!matches(test, items, items.size( )) || (test.blocks( ) != 1))
+        {
+            cout << "removing the only item of the last block went wrong." << endl;
+            return 0;
+        }
+        while (test.size( ) > 0)
+        {
+            test.start( );
+            test.remove_current( );
+            items.erase(items.begin( ));
+        }
+        if (!matches(test, items, 0) || (test.blocks( ) != 0))
+        {
+            cout << "removing every item went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Makes 6000 random edits and moves with caches of 2 and 3 blocks,
+//   checking the cursor after each and every item every 250 steps. Returns
+//   POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    for (size_t cache = 2; cache <= 3; ++cache)
+    {
+        mt19937 random(42 + unsigned(cache));
+        pages test(cache);
+        vector<long> items;
+        size_t spot = 0;
+        long next = 0;
+
+        cout << "Making random edits with a cache of " << cache << " blocks ... ";
+        cout.flush( );
+        for (int step = 0; step < 6000; ++step)
+        {
+            bool have = spot < items.size( );
+            unsigned choice = random( ) % 10;
+
+            // Grow for the first half, then mostly shrink.
+            if ((step > 3000) && (choice < 4))
+                choice += 6;
+            switch (choice)
+            {
+            case 0:
+            case 1:
+                test.insert(make_page(next));
+                spot = have ? spot : 0;
+                items.insert(items.begin( ) + spot, next++);
+                break;
+            case 2:
+            case 3:
+            case 4:
+                test.attach(make_page(next));
+                spot = have ? spot + 1 : items.size( );
+                items.insert(items.begin( ) + spot, next++);
+                break;
+            case 5:
+                if (have)
+                {
+                    test.advance( );
+                    ++spot;
+                }
+                break;
+            case 6:
+                spot = random( ) % (items.size( ) + 1);
+                test.go_to(spot);
+                break;
+            case 7:
+                {
+                    size_t steps = random( ) % (items.size( ) - spot + 1);
+                    test.advance(steps);
+                    spot += steps;
+                }
+                break;
+            case 8:
+            case 9:
+                if (have)
+                {
+                    test.remove_current( );
+                    items.erase(items.begin( ) + spot);
+                }
+                else
+                {
+                    test.start( );
+                    spot = 0;
+                }
+                break;
+            }
+            if (spot >= items.size( ))
+            {
+                if (test.is_item( ) || (test.position( ) != items.size( )))
+                {
+                    cout << "step " << step << " left a current item at the end." << endl;
+                    return 0;
+                }
+            }
+            else if (!test.is_item( ) || (test.position( ) != spot)
+                     || (test.current( ).value != items[spot]))
+            {
+                cout << "step " << step << " left the cursor on the wrong item." << endl;
+                return 0;
+            }
+            if ((step % 250 == 0) && !matches(test, items, spot))
+            {
+                cout << "after step " << step << " the items were wrong." << endl;
+                return 0;
+            }
+        }
+        if (!matches(test, items, spot))
+        {
+            cout << "the items were wrong at the end." << endl;
+            return 0;
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+// FILE: fixed_sequence.cxx
+// CLASS IMPLEMENTED: fixed_sequence (see fixed_sequence.h for documentation)
+// INVARIANT for the fixed_sequence class:
+//   1. items[i] and links[i] form slot i. Slots used, used+1, ..., N-1 have
+//      never held an item. The number of items is stored in many_nodes.
+//
+//   2. head and tail are the first and last slots in sequence order, linked
+//      through links[]; both are NIL (which is N) for an empty sequence.
+//
+//   3. Slots below used that are not in the sequence form a chain through
+//      links[], starting at free_head (NIL if there are none).
+//
+//   4. cursor is the slot of the current item, or NIL if there is none;
+//      precursor is the slot before it, or NIL if there is none. When there
+//      is no current item in a non-empty sequence, precursor is tail.
+
+#include <cassert>    // Provides assert
+
+namespace scu_coen70_6B
+{
+    template<class Item, std::size_t N>
+    constexpr fixed_sequence<Item, N>::fixed_sequence( )
+        : items( ), links( ), head(NIL), tail(NIL), cursor(NIL), precursor(NIL),
+          free_head(NIL), used(0), many_nodes(0)
+    {
+    }
+
+    // Takes a free slot (a recycled one first) and stores entry in it.
+    template<class Item, std::size_t N>
+    constexpr typename fixed_sequence<Item, N>::index_type
+    fixed_sequence<Item, N>::new_slot(const value_type& entry)
+    {
+        index_type answer = free_head;
+
+        assert(many_nodes < CAPACITY);
+        if (answer != NIL)
+            free_head = links[answer];
+        else
+            answer = used++;
+        items[answer] = entry;
+        return answer;
+    }
+
+    template<class Item, std::size_t N>
+    constexpr void fixed_sequence<Item, N>::start( )
+    {
+        cursor = head;
+        precursor = NIL;
+    }
+
+    template<class Item, std::size_t N>
+    constexpr void fixed_sequence<Item, N>::advance( )
+    {
+        assert(is_item( ));
+
+        precursor = cursor;
+        cursor = links[cursor];
+    }
+
+    template<class Item, std::size_t N>
+    constexpr void fixed_sequence<Item, N>::insert(const value_type& entry)
+    {
+        index_type added = new_slot(entry);
+
+        if ((precursor == NIL) || (!is_item( )))
+        {
+            // No current item (or it is the head): the entry becomes the head.
+            links[added] = head;
+            head = added;
+            precursor = NIL;
+            if (many_nodes == 0)
+                tail = added;
+        }
+        else
+        {
+            links[added] = cursor;
+            links[precursor] = added;
+        }
+        cursor = added;
+
+        ++many_nodes;
+    }
+
+    template<class Item, std::size_t N>
+    constexpr void fixed_sequence<Item, N>::attach(const value_type& entry)
+    {
+        index_type added = new_slot(entry);
+
+        if (is_item( ))
+        {
+            links[added] = links[cursor];
+            links[cursor] = added;
+            precursor = cursor;
+            if (tail == cursor)
+                tail = added;
+        }
+        else if (tail == NIL)
+        {
+            links[added] = NIL;
+            head = added;
+            tail = added;
+            precursor = NIL;
+        }
+        else
+        {
+            // No current item: attach at the end of the sequence.
+            links[added] = NIL;
+            links[tail] = added;
+            precursor = tail;
+            tail = added;
+        }
+        cursor = added;
+
+        ++many_nodes;
+    }
+
+    template<class Item, std::size_t N>
+    constexpr void fixed_sequence<Item, N>::remove_current( )
+    {
+        index_type removed = cursor;
+
+        assert(is_item( ));
+
+        cursor = links[removed];
+        // precursor is NIL exactly when the removed item is the head.
+        if (precursor == NIL)
+            head = cursor;
+        else
+            links[precursor] = cursor;
+        if (removed == tail)
+            tail = precursor;
+
+        // Return the slot to the free chain.
+        items[removed] = value_type( );
+        links[removed] = free_head;
+        free_head = removed;
+
+        --many_nodes;
+    }
+
+    template<class Item, std::size_t N>
+    constexpr typename fixed_sequence<Item, N>::value_type fixed_sequence<Item, N>::current( ) const
+    {
+        assert(is_item( ));
+
+        return items[cursor];
+    }
+}
@@ -0,0 +1,163 @@
+// FILE: fixed_sequence.h
+// CLASS PROVIDED: fixed_sequence (part of the namespace scu_coen70_6B)
+// A sequence with room for at most N items, stored inline in the object with
+// no dynamic memory at all. It has the cursor interface of sequence<Item>
+// (sequence4.h), and every member function is constexpr, so a table can be
+// built by a constexpr function and placed in read-only data, costing no
+// work at startup:
+//
+//     constexpr fixed_sequence<int, 8> make_primes( )
+//     {
+//         fixed_sequence<int, 8> answer;
+//         answer.attach(2); answer.attach(3); answer.attach(5);
+//         return answer;
+//     }
+//     constexpr fixed_sequence<int, 8> PRIMES = make_primes( );
+//     static_assert(PRIMES.size( ) == 3, "");
+//
+// Compile-time use needs C++17 and a value_type that is a literal type (the
+// built-in types, and simple aggregates of them). Any other value_type with a
+// default constructor still works at run time.
+//
+// TYPEDEFS and MEMBER CONSTANTS for the fixed_sequence class:
+//   typedef ____ value_type
+//     fixed_sequence::value_type is the data type of the items.
+//
+//   typedef ____ size_type
+//     The data type of any variable that counts items.
+//
+//   typedef ____ index_type
+//     The smallest unsigned type that can hold N (unsigned char, unsigned
+//     short, or std::uint32_t); the slots are linked by these indices.
+//
+//   static const size_type CAPACITY
+//     The maximum number of items, N.
+//
+// CONSTRUCTOR for the fixed_sequence class:
+//   fixed_sequence( )
+//     Postcondition: The fixed_sequence is empty.
+//
+// MODIFICATION MEMBER FUNCTIONS for the fixed_sequence class:
+//   void start( )
+//   void advance( )
+//   void remove_current( )
+//     Same as in sequence4.h.
+//
+//   void insert(const value_type& entry)
+//   void attach(const value_type& entry)
+//     Precondition: size( ) < CAPACITY.
+//     Postcondition: Same as in sequence4.h.
+//
+// CONSTANT MEMBER FUNCTIONS for the fixed_sequence class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//   value_type current( ) const
+//     Same as in sequence4.h.
+//
+// STANDARD ITERATOR MEMBER FUNCTIONS (provide a forward iterator):
+//   iterator begin( )
+//   const_iterator begin( ) const
+//   iterator end( )
+//   const_iterator end( ) const
+//
+// VALUE SEMANTICS for the fixed_sequence class:
+//   Assignments and the copy constructor may be used; both copy the inline
+//   storage, and the copy's cursor lands on the same item.
+
+#ifndef COEN_70_FIXED_SEQUENCE_H
+#define COEN_70_FIXED_SEQUENCE_H
+#include <cstdlib>      // Provides size_t
+#include <cstddef>      // Provides ptrdiff_t
+#include <cstdint>      // Provides uint32_t
+#include <iterator>     // Provides forward_iterator_tag
+#include <type_traits>  // Provides conditional
+
+namespace scu_coen70_6B
+{
+    template<std::size_t N>
+    struct fixed_index
+    {
+        typedef typename std::conditional<(N < 0xFFu), unsigned char,
+                typename std::conditional<(N < 0xFFFFu), unsigned short,
+                std::uint32_t>::type>::type type;
+    };
+
+    template<class Item, class Index, std::size_t N>
+    class fixed_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Item* pointer;
+        typedef Item& reference;
+
+        constexpr fixed_iterator(Item* items = NULL, const Index* links = NULL, Index index = Index(N))
+            : data(items), link(links), current(index) { }
+        constexpr Item& operator *( ) const { return data[current]; }
+        constexpr fixed_iterator& operator ++( )
+        {
+            current = link[current];
+            return *this;
+        }
+        constexpr fixed_iterator operator ++(int)
+        {
+            fixed_iterator orig(*this);
+            current = link[current];
+            return orig;
+        }
+        constexpr bool operator ==(const fixed_iterator& other) const { return current == other.current; }
+        constexpr bool operator !=(const fixed_iterator& other) const { return current != other.current; }
+    private:
+        Item* data;
+        const Index* link;
+        Index current;
+    };
+
+    template<class Item, std::size_t N>
+    class fixed_sequence
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef Item value_type;
+        typedef std::size_t size_type;
+        typedef typename fixed_index<N>::type index_type;
+        typedef fixed_iterator<Item, index_type, N> iterator;
+        typedef fixed_iterator<const Item, index_type, N> const_iterator;
+        static const size_type CAPACITY = N;
+        // CONSTRUCTOR
+        constexpr fixed_sequence( );
+        // MODIFICATION MEMBER FUNCTIONS
+        constexpr void start( );
+        constexpr void advance( );
+        constexpr void insert(const value_type& entry);
+        constexpr void attach(const value_type& entry);
+        constexpr void remove_current( );
+        // CONSTANT MEMBER FUNCTIONS
+        constexpr size_type size( ) const { return many_nodes; }
+        constexpr bool is_item( ) const { return cursor != NIL; }
+        constexpr value_type current( ) const;
+        // FUNCTIONS TO PROVIDE ITERATORS
+        constexpr iterator begin( ) { return iterator(items, links, head); }
+        constexpr const_iterator begin( ) const { return const_iterator(items, links, head); }
+        constexpr iterator end( ) { return iterator( ); }
+        constexpr const_iterator end( ) const { return const_iterator( ); }
+    private:
+        static_assert((N > 0) && (N < 0xFFFFFFFFu), "fixed_sequence capacity out of range");
+        static const index_type NIL = index_type(N);
+
+        Item items[N];
+        index_type links[N];
+        index_type head;
+        index_type tail;
+        index_type cursor;
+        index_type precursor;
+        index_type free_head;
+        index_type used;
+        index_type many_nodes;
+
+        constexpr index_type new_slot(const value_type& entry);
+    };
+}
+#include "fixed_sequence.cxx"
+#endif
@@ -0,0 +1,524 @@
+// FILE: fixed_sequence_exam.cpp
+// Non-interactive test program for the fixed_sequence class (see
+// fixed_sequence.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the fixed_sequence class,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. The
+// first test is mostly done by the compiler: the static_asserts below build
+// sequences in constexpr functions, so this program does not compile
+// unless every member used there works at compile time. The other tests
+// check the cursor members against a vector that models the sequence, up
+// to CAPACITY items and with each index_type; fixed_sequence has no
+// position( ), so the cursor's spot is found by advancing a copy to the
+// end, which also relies on copies keeping the cursor. The program returns
+// EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 fixed_sequence_exam.cpp -o fixed_sequence_exam
+//     ./fixed_sequence_exam
+
+#include <iostream>             // Provides cout.
+#include <cstdlib>              // Provides size_t.
+#include <cstdint>              // Provides uint32_t.
+#include <random>               // Provides mt19937 for the random edits.
+#include <string>               // Provides string, to_string.
+#include <type_traits>          // Provides is_same.
+#include <vector>               // Provides vector for the expected items.
+#include "fixed_sequence.h"     // Provides the fixed_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 3;
+const int POINTS[MANY_TESTS+1] = {
+    12,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4   // Test 3 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the fixed_sequence class",
+    "Testing sequences built at compile time",
+    "Testing random edits up to CAPACITY items against a vector",
+    "Testing iterators, copies, the index types and string items"
+};
+
+
+// **************************************************************************
+// constexpr fixed_sequence<int, 8> make_table( )
+//   Postcondition: The return value holds 2, 3, 5, 7, 11, 13, built with
+//   every modification member (including a remove, whose slot is reused),
+//   and 7 is its current item.
+// **************************************************************************
+constexpr fixed_sequence<int, 8> make_table( )
+{
+    fixed_sequence<int, 8> answer;
+
+    answer.attach(3);       // 3
+    answer.insert(2);       // 2 3
+    answer.advance( );
+    answer.attach(4);       // 2 3 4
+    answer.remove_current( );
+    answer.attach(5);       // 2 3 5 (no current item, so at the end)
+    answer.attach(11);      // 2 3 5 11
+    answer.insert(7);       // 2 3 5 7 11
+    answer.advance( );
+    answer.attach(13);      // 2 3 5 7 11 13
+    answer.start( );
+    answer.advance( );
+    answer.advance( );
+    answer.advance( );
+    return answer;
+}
+
+// **************************************************************************
+// template<class Sequence>
+// constexpr int weighted_sum(const Sequence& s)
+//   Postcondition: The return value is the sum of (i + 1) * item [i] over
+//   the items of s, read through const_iterators, so that it depends on
+//   their order.
+// **************************************************************************
+template<class Sequence>
+constexpr int weighted_sum(const Sequence& s)
+{
+    int answer = 0;
+    int i = 1;
+
+    for (typename Sequence::const_iterator it = s.begin( ); it != s.end( ); ++it, ++i)
+        answer += i * (*it);
+    return answer;
+}
+
+// **************************************************************************
+// constexpr bool fill_and_empty( )
+//   Postcondition: The return value is true if a fixed_sequence<int, 4> can
+//   be filled, emptied from its middle, refilled and edited through an
+//   iterator, with the cursor behaving as in sequence4.h throughout.
+// **************************************************************************
+constexpr bool fill_and_empty( )
+{
+    fixed_sequence<int, 4> test;
+    fixed_sequence<int, 4> copy;
+
+    for (int i = 1; i <= 4; ++i)
+        test.attach(i);
+    if ((test.size( ) != 4) || (test.current( ) != 4))
+        return false;
+    test.start( );
+    test.advance( );
+    test.remove_current( );             // 1 3 4
+    test.remove_current( );             // 1 4
+    if ((test.size( ) != 2) || (test.current( ) != 4))
+        return false;
+    test.remove_current( );             // 1, no current item
+    if (test.is_item( ))
+        return false;
+    test.insert(9);                     // 9 1
+    test.attach(8);                     // 9 8 1
+    test.attach(7);                     // 9 8 7 1
+    copy = test;
+    *copy.begin( ) = 6;                 // 6 8 7 1 in the copy only
+    return (test.size( ) == 4) && (test.current( ) == 7) && (copy.current( ) == 7)
+        && (weighted_sum(test) == 9 + 16 + 21 + 4) && (weighted_sum(copy) == 6 + 16 + 21 + 4);
+}
+
+constexpr fixed_sequence<int, 8> TABLE = make_table( );
+static_assert(TABLE.size( ) == 6, "make_table gave the wrong size");
+static_assert(TABLE.is_item( ) && (TABLE.current( ) == 7), "make_table left the wrong current item");
+static_assert(weighted_sum(TABLE) == 2 + 6 + 15 + 28 + 55 + 78, "make_table gave the wrong items");
+static_assert(fill_and_empty( ), "fill_and_empty failed at compile time");
+static_assert(is_same<fixed_sequence<int, 254>::index_type, unsigned char>::value
+              && is_same<fixed_sequence<int, 255>::index_type, unsigned short>::value
+              && is_same<fixed_sequence<int, 70000>::index_type, uint32_t>::value,
+              "fixed_sequence picked the wrong index_type");
+
+
+// **************************************************************************
+// template<class Sequence>
+// size_t spot_of(Sequence test)
+//   Postcondition: The return value is the number of items before the
+//   current item of test, or test.size( ) if there is no current item.
+//   (test is a copy, which keeps the cursor on the same item.)
+// **************************************************************************
+template<class Sequence>
+size_t spot_of(Sequence test)
+{
+    size_t after = 0;
+
+    for ( ; test.is_item( ); test.advance( ))
+        ++after;
+    return test.size( ) - after;
+}
+
+
+// **************************************************************************
+// template<class Sequence>
+// bool matches(const Sequence& test,
+//              const vector<typename Sequence::value_type>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item, or
+//   that it has no current item if cursor_spot >= items.size( ).
+// **************************************************************************
+template<class Sequence>
+bool matches(const Sequence& test, const vector<typename Sequence::value_type>& items, size_t cursor_spot)
+{
+    typename Sequence::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || !(*it == items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (spot_of(test) == test.size( ));
+    return test.is_item( ) && (spot_of(test) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// template<class Sequence>
+// bool random_edits(Sequence& test, vector<typename Sequence::value_type>& items,
+//                   size_t& cursor_spot, mt19937& random, int many,
+//                   typename Sequence::value_type make(int))
+//   Precondition: test matches items with the cursor at cursor_spot.
+//   Postcondition: many random edits and moves have been made to test and
+//   to the model, adding items only while there is room, and the return
+//   value is true if test still matched the model after each one. Otherwise
+//   a message has been printed.
+// **************************************************************************
+template<class Sequence>
+bool random_edits(Sequence& test, vector<typename Sequence::value_type>& items, size_t& cursor_spot,
+                  mt19937& random, int many, typename Sequence::value_type make(int))
+{
+    for (int step = 0; step < many; ++step)
+    {
+        int choice = int(random( ) % 10);
+        typename Sequence::value_type entry = make(int(random( ) % 1000));
+
+        if ((choice < 6) && (items.size( ) == Sequence::CAPACITY))
+            choice = 6;
+        if (choice < 3)
+        {
+            // insert: before the current item, or at the front.
+            if (cursor_spot >= items.size( ))
+                cursor_spot = 0;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.insert(entry);
+        }
+        else if (choice < 6)
+        {
+            // attach: after the current item, or at the back.
+            cursor_spot = (cursor_spot >= items.size( )) ? items.size( ) : cursor_spot + 1;
+            items.insert(items.begin( ) + cursor_spot, entry);
+            test.attach(entry);
+        }
+        else if (choice < 8)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                items.erase(items.begin( ) + cursor_spot);
+                test.remove_current( );
+            }
+        }
+        else if (choice < 9)
+        {
+            if (cursor_spot < items.size( ))
+            {
+                ++cursor_spot;
+                test.advance( );
+            }
+        }
+        else
+        {
+            cursor_spot = 0;
+            test.start( );
+        }
+        if (!matches(test, items, cursor_spot))
+        {
+            cout << "The sequence went wrong after " << step + 1 << " edits." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int make_int(int x)
+// string make_string(int x)
+//   Postcondition: The return value is an item made from x. The strings are
+//   long enough not to be stored inside the string object.
+// **************************************************************************
+int make_int(int x)
+{
+    return x;
+}
+
+string make_string(int x)
+{
+    return string(40, 'f') + to_string(x);
+}
+
+
+// **************************************************************************
+// template<class Sequence>
+// bool fill_to_capacity(Sequence& test, mt19937& random)
+//   Precondition: test is empty.
+//   Postcondition: Random edits have been made until test held CAPACITY
+//   items, then it has been emptied and filled again, and the return value
+//   is true if it matched a model throughout. Otherwise a message has been
+//   printed.
+// **************************************************************************
+template<class Sequence>
+bool fill_to_capacity(Sequence& test, mt19937& random)
+{
+    vector<int> items;
+    size_t cursor_spot = 0;
+
+    for (int round = 0; round < 2; ++round)
+    {
+        while (items.size( ) < Sequence::CAPACITY)
+        {
+            if (!random_edits(test, items, cursor_spot, random, 1, make_int))
+                return false;
+        }
+        // Emptying from the front puts every slot on the free chain.
+        for (test.start( ); test.is_item( ); )
+            test.remove_current( );
+        items.clear( );
+        cursor_spot = 0;
+        if (!matches(test, items, 0))
+        {
+            cout << "Emptying a full sequence went wrong." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Checks at run time the sequences built at compile time above (so a
+//   wrong constexpr result cannot hide behind a skipped static_assert), and
+//   that the same functions agree when run at run time. Returns POINTS[1] if
+//   the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    const vector<int> PRIMES = { 2, 3, 5, 7, 11, 13 };
+    fixed_sequence<int, 8> built = make_table( );
+
+    cout << "Checking the table built at compile time ... ";
+    cout.flush( );
+    if (!matches(TABLE, PRIMES, 3))
+    {
+        cout << "TABLE does not hold 2, 3, 5, 7, 11, 13 with 7 current." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking the same functions run at run time ... ";
+    cout.flush( );
+    if (!matches(built, PRIMES, 3) || !fill_and_empty( ) || (weighted_sum(built) != weighted_sum(TABLE)))
+    {
+        cout << "A constexpr function gave a different answer at run time." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Makes random edits to sequences of 1, 7, 254, 255 and 300 items until
+//   each is full, twice, and 20000 random edits to one of 50 items, checking
+//   against a vector after each one. Returns POINTS[2] if the tests are
+//   passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    mt19937 random(31);
+
+    cout << "Checking sequences filled to CAPACITY and emptied ... ";
+    cout.flush( );
+    {
+        fixed_sequence<int, 1> one;
+        fixed_sequence<int, 7> seven;
+        fixed_sequence<int, 254> small_index;
+        fixed_sequence<int, 255> short_index;
+        fixed_sequence<int, 300> three_hundred;
+
+        if (!fill_to_capacity(one, random) || !fill_to_capacity(seven, random)
+            || !fill_to_capacity(small_index, random) || !fill_to_capacity(short_index, random)
+            || !fill_to_capacity(three_hundred, random))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking 20000 random edits and moves ... ";
+    cout.flush( );
+    {
+        fixed_sequence<int, 50> test;
+        vector<int> items;
+        size_t cursor_spot = 0;
+
+        if (!random_edits(test, items, cursor_spot, random, 20000, make_int))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Tests writing through iterators, the copy constructor and assignment
+//   with the cursor at each spot (the copy must keep the cursor and be
+//   independent of its source), self-assignment, and random edits with
+//   string items, which are not literal types. Returns POINTS[3] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    mt19937 random(32);
+    vector<int> items;
+    size_t i;
+
+    cout << "Checking writes through iterators ... ";
+    cout.flush( );
+    {
+        fixed_sequence<int, 10> test;
+
+        for (i = 0; i < 10; ++i)
+        {
+            test.attach(int(i));
+            items.push_back(int(10 * i));
+        }
+        for (fixed_sequence<int, 10>::iterator it = test.begin( ); it != test.end( ); it++)
+            *it *= 10;
+        if (!matches(test, items, 9))
+        {
+            cout << "The items written through iterators were wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking copies and assignment with the cursor at each spot ... ";
+    cout.flush( );
+    for (size_t spot = 0; spot <= items.size( ); ++spot)
+    {
+        fixed_sequence<int, 12> source;
+        fixed_sequence<int, 12> assigned;
+
+        for (i = 0; i < items.size( ); ++i)
+            source.attach(items[i]);
+        source.start( );
+        for (i = 0; i < spot; ++i)
+            source.advance( );
+        assigned.attach(99);
+        {
+            fixed_sequence<int, 12> copy(source);
+            assigned = source;
+            if (!matches(copy, items, spot) || !matches(assigned, items, spot))
+            {
+                cout << "A copy with the cursor at " << spot << " went wrong." << endl;
+                return 0;
+            }
+            copy.attach(7);
+            *assigned.begin( ) = -1;
+        }
+        if (!matches(source, items, spot))
+        {
+            cout << "Changing a copy changed the source." << endl;
+            return 0;
+        }
+        source = source;
+        if (!matches(source, items, spot))
+        {
+            cout << "Self-assignment changed the sequence." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking 6000 random edits with string items ... ";
+    cout.flush( );
+    {
+        fixed_sequence<string, 40> test;
+        vector<string> strings;
+        size_t cursor_spot = 0;
+
+        for (int round = 0; round < 3; ++round)
+        {
+            if (!random_edits(test, strings, cursor_spot, random, 2000, make_string))
+                return 0;
+            fixed_sequence<string, 40> copy(test);
+            if (!matches(copy, strings, cursor_spot))
+            {
+                cout << "A copy of a sequence of strings went wrong." << endl;
+                return 0;
+            }
+            test = copy;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+// FILE: index_chain.cxx
+// CLASS IMPLEMENTED: index_chain (see index_chain.h for documentation)
+// INVARIANT for the index_chain class:
+//   1. link_array[i] is the link of slot i. The number of linked slots is
+//      stored in many_nodes.
+//
+//   2. head_index and tail_index are the first and last linked slots; both
+//      are NIL for an empty chain, and link_array[tail_index] is NIL.
+//
+//   3. Slots that are not linked form a second chain through link_array,
+//      starting at free_head (NIL if there are none).
+//
+//   4. cursor_index is the current slot, or NIL if there is none;
+//      precursor_index is the slot before it, or NIL if there is none. When
+//      there is no current item in a non-empty chain, precursor_index is
+//      tail_index.
+
+#include <cassert>    // Provides assert
+#include <stdexcept>  // Provides length_error
+
+namespace scu_coen70_6B
+{
+    inline index_chain::index_chain( )
+    {
+        head_index = NIL;
+        tail_index = NIL;
+        cursor_index = NIL;
+        precursor_index = NIL;
+        free_head = NIL;
+        many_nodes = 0;
+    }
+
+    inline void index_chain::advance( )
+    {
+        assert(is_item( ));
+
+        precursor_index = cursor_index;
+        cursor_index = link_array[cursor_index];
+    }
+
+    inline index_chain::index_type index_chain::acquire( )
+    {
+        index_type answer;
+
+        if (free_head != NIL)
+        {
+            answer = free_head;
+            free_head = link_array[answer];
+            return answer;
+        }
+        if (link_array.size( ) >= NIL)
+            throw std::length_error("index_chain: every slot is in use");
+        answer = index_type(link_array.size( ));
+        link_array.push_back(index_type(NIL));
+        return answer;
+    }
+
+    inline void index_chain::release(index_type slot)
+    {
+        link_array[slot] = free_head;
+        free_head = slot;
+    }
+
+    inline void index_chain::link_insert(index_type slot)
+    {
+        if ((precursor_index == NIL) || (!is_item( )))
+        {
+            // No current item (or it is the head): the slot becomes the head.
+            link_array[slot] = head_index;
+            head_index = slot;
+            precursor_index = NIL;
+            if (many_nodes == 0)
+                tail_index = slot;
+        }
+        else
+        {
+            link_array[slot] = cursor_index;
+            link_array[precursor_index] = slot;
+        }
+        cursor_index = slot;
+
+        ++many_nodes;
+    }
+
+    inline void index_chain::link_attach(index_type slot)
+    {
+        if (is_item( ))
+        {
+            link_array[slot] = link_array[cursor_index];
+            link_array[cursor_index] = slot;
+            precursor_index = cursor_index;
+            if (tail_index == cursor_index)
+                tail_index = slot;
+        }
+        else if (head_index == NIL)
+        {
+            link_array[slot] = NIL;
+            head_index = slot;
+            tail_index = slot;
+            precursor_index = NIL;
+        }
+        else
+        {
+            // No current item: attach at the end of the chain.
+            link_array[slot] = NIL;
+            link_array[tail_index] = slot;
+            precursor_index = tail_index;
+            tail_index = slot;
+        }
+        cursor_index = slot;
+
+        ++many_nodes;
+    }
+
+    inline index_chain::index_type index_chain::unlink_current( )
+    {
+        index_type removed;
+
+        assert(is_item( ));
+
+        removed = cursor_index;
+        cursor_index = link_array[removed];
+        if (removed == head_index)
+            head_index = cursor_index;
+        else
+            link_array[precursor_index] = cursor_index;
+        if (removed == tail_index)
+            tail_index = precursor_index;
+        release(removed);
+
+        --many_nodes;
+        return removed;
+    }
+}
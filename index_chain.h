@@ -0,0 +1,141 @@
+// FILE: index_chain.h
+// CLASS PROVIDED: index_chain (part of the namespace scu_coen70_6B)
+// The link structure shared by the arena-backed sequences (compact_sequence
+// and column_sequence). An index_chain owns only the 32-bit links, the head,
+// tail, cursor and precursor indices, and the chain of free slots; the owner
+// keeps the item data in its own arrays, indexed by the same slot numbers.
+//
+// Adding an item is a two-step protocol so that the owner's arrays and the
+// links stay consistent even if storing the data throws. If has_free( ) is
+// true, acquire recycles a slot and cannot throw:
+//   index_type slot = chain.acquire( );
+//   ...store the item at slot, calling chain.release(slot) if that throws...
+// Otherwise the owner's arrays grow first, so they are never shorter than
+// the link array:
+//   ...append the item to the owner's arrays...
+//   index_type slot = chain.acquire( );   // grows the link array
+//   ...remove the appended item again if acquire throws...
+// and then, either way:
+//   chain.link_insert(slot);              // or chain.link_attach(slot)
+//
+// TYPEDEFS and MEMBER CONSTANTS for the index_chain class:
+//   typedef ____ index_type
+//     The 32-bit type of a link.
+//
+//   static const index_type NIL
+//     The link value that means "no slot". At most NIL slots can exist.
+//
+// CONSTRUCTOR for the index_chain class:
+//   index_chain( )
+//     Postcondition: The chain is empty and has no slots.
+//
+// MODIFICATION MEMBER FUNCTIONS for the index_chain class:
+//   void start( )
+//   void advance( )
+//     Same as the sequence member functions of the same names.
+//
+//   index_type acquire( )
+//     Postcondition: The return value is a slot that is not in the chain.
+//     It is a recycled slot if there is one; otherwise it equals the old
+//     capacity( ), and the link array has grown by one. Throws bad_alloc if
+//     the link array cannot grow, or length_error if NIL slots are in use.
+//
+//   void release(index_type slot)
+//     Precondition: slot came from acquire and was not linked.
+//     Postcondition: The slot is free again.
+//
+//   void link_insert(index_type slot)
+//   void link_attach(index_type slot)
+//     Precondition: slot came from acquire.
+//     Postcondition: The slot has been linked before (link_insert) or after
+//     (link_attach) the current item, following the rules of
+//     sequence::insert and sequence::attach, and is now the current item.
+//
+//   index_type unlink_current( )
+//     Precondition: is_item( ) returns true.
+//     Postcondition: The current slot has been removed from the chain and
+//     put on the free chain, and its index is returned. The slot after it
+//     (if any) is the new current item.
+//
+//   void reserve(size_type n)
+//     Postcondition: The link array has room for n slots.
+//
+// CONSTANT MEMBER FUNCTIONS for the index_chain class:
+//   size_type size( ) const
+//   bool is_item( ) const
+//     Same as the sequence member functions of the same names.
+//
+//   index_type head( ) const
+//   index_type tail( ) const
+//   index_type cursor( ) const
+//   index_type precursor( ) const
+//     Postcondition: The return value is the named slot, or NIL.
+//
+//   index_type link(index_type slot) const
+//     Postcondition: The return value is the slot after the given one.
+//
+//   const index_type* links( ) const
+//     Postcondition: The return value points to the link array, which has
+//     capacity( ) entries. It is invalidated by acquire.
+//
+//   size_type capacity( ) const
+//     Postcondition: The return value is the number of slots, free or not.
+//
+//   bool has_free( ) const
+//     Postcondition: The return value is true if there is a free slot, so
+//     that the next acquire recycles it (and cannot throw) rather than
+//     growing the link array.
+//
+// VALUE SEMANTICS for the index_chain class:
+//   Assignments and the copy constructor may be used, and preserve every
+//   slot number.
+
+#ifndef COEN_70_INDEX_CHAIN_H
+#define COEN_70_INDEX_CHAIN_H
+#include <cstdlib>  // Provides size_t
+#include <cstdint>  // Provides uint32_t
+#include <vector>   // Provides the link array
+
+namespace scu_coen70_6B
+{
+    class index_chain
+    {
+    public:
+        // TYPEDEFS and MEMBER CONSTANTS
+        typedef std::uint32_t index_type;
+        typedef std::size_t size_type;
+        static const index_type NIL = 0xFFFFFFFFu;
+        // CONSTRUCTOR
+        index_chain( );
+        // MODIFICATION MEMBER FUNCTIONS
+        void start( ) { cursor_index = head_index; precursor_index = NIL; }
+        void advance( );
+        index_type acquire( );
+        void release(index_type slot);
+        void link_insert(index_type slot);
+        void link_attach(index_type slot);
+        index_type unlink_current( );
+        void reserve(size_type n) { link_array.reserve(n); }
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return many_nodes; }
+        bool is_item( ) const { return cursor_index != NIL; }
+        index_type head( ) const { return head_index; }
+        index_type tail( ) const { return tail_index; }
+        index_type cursor( ) const { return cursor_index; }
+        index_type precursor( ) const { return precursor_index; }
+        index_type link(index_type slot) const { return link_array[slot]; }
+        const index_type* links( ) const { return link_array.data( ); }
+        size_type capacity( ) const { return link_array.size( ); }
+        bool has_free( ) const { return free_head != NIL; }
+    private:
+        std::vector<index_type> link_array;
+        index_type head_index;
+        index_type tail_index;
+        index_type cursor_index;
+        index_type precursor_index;
+        index_type free_head;
+        size_type many_nodes;
+    };
+}
+#include "index_chain.cxx"
+#endif
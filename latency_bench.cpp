@@ -0,0 +1,192 @@
+// FILE: latency_bench.cpp
+// Tail-latency benchmark for the sequence class (see sequence4.h), with and
+// without its low-latency configuration.
+//
+// DESCRIPTION:
+// A single thread runs a mixed workload on two sequences of orders:
+//   book   about book_size orders, edited in place: the cursor wanders
+//          through the book, and each step inserts an order there, removes
+//          the current one, or moves the cursor a few items on.
+//   log    every step also attaches one order to the end of a log, and when
+//          the log reaches log_size orders it is cleared, as a log shipped
+//          off in batches would be.
+//   copy   every copy_every steps the book is copied into a snapshot with
+//          operator=, as a reader taking a consistent view would.
+// Every insert, attach, remove_current, clear and copy is timed on its own, into a
+// latency_histogram (see seq_stats.h) per operation, and the run prints the
+// 50th, 99th and 99.9th percentiles and the maximum for each, in ns.
+//
+// The workload runs twice: first with the default configuration, then
+// after book.reserve (enough nodes for the book, its snapshot and the log,
+// so none of them grows the pool) and defer_frees on the book and the log.
+// The second run should show a lower p99.9 and maximum for attach (no slab
+// is taken from the system in the middle of the run), a clear that takes
+// O(1) instead of O(log_size), and a copy that builds the snapshot from the
+// reserved blocks instead of new slabs.
+// The medians should be about the same; the timer itself adds some 20 ns.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread latency_bench.cpp -o latency_bench
+//     ./latency_bench
+// The optional arguments are the number of steps (default 2000000), the
+// book size (default 100000), the log size (default 250000), the random
+// seed and the steps between copies (default 100000).
+
+#include <chrono>       // Provides steady_clock
+#include <cstdint>      // Provides uint64_t
+#include <cstdlib>      // Provides size_t, strtoul
+#include <iostream>     // Provides cout
+#include <random>       // Provides mt19937
+#include "seq_stats.h"  // Provides latency_histogram
+#include "sequence4.h"  // Provides the sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+struct order
+{
+    long id;
+    double price;
+    long quantity;
+    int side;
+};
+
+struct latencies
+{
+    latency_histogram insert;
+    latency_histogram attach;
+    latency_histogram remove;
+    latency_histogram clear;
+    latency_histogram copy;
+};
+
+typedef chrono::steady_clock::time_point instant;
+
+inline uint64_t nanoseconds(instant from, instant to)
+{
+    return uint64_t(chrono::duration_cast<chrono::nanoseconds>(to - from).count( ));
+}
+
+void report(const char* name, const latency_histogram& h)
+{
+    cout.width(16);
+    cout << left << name << right;
+    cout.width(10);
+    cout << h.count( );
+    cout.width(10);
+    cout << h.percentile(50);
+    cout.width(10);
+    cout << h.percentile(99);
+    cout.width(10);
+    cout << h.percentile(99.9);
+    cout.width(12);
+    cout << h.max( ) << endl;
+}
+
+// **************************************************************************
+// void run(size_t steps, size_t book_size, size_t log_size, unsigned seed,
+//          size_t copy_every, bool low_latency, latencies& timed)
+//   Postcondition: The workload described above has been run for steps
+//   steps, and the latency of each operation has been recorded in timed.
+//   With low_latency, the sequences were set up with reserve and
+//   defer_frees first.
+// **************************************************************************
+void run(size_t steps, size_t book_size, size_t log_size, unsigned seed,
+         size_t copy_every, bool low_latency, latencies& timed)
+{
+    sequence<order> book;
+    sequence<order> log;
+    sequence<order> snapshot;
+    mt19937 random(seed);
+    order entry = { 0, 100.0, 1, 0 };
+    instant before;
+    instant after;
+
+    if (low_latency)
+    {
+        // All three sequences share the pool for their node size. The
+        // snapshot's old nodes are freed before its copy is made.
+        book.reserve(3 * book_size + log_size);
+        book.defer_frees( );
+        log.defer_frees( );
+    }
+    for (size_t i = 0; i < book_size; ++i, ++entry.id)
+        book.attach(entry);
+    book.start( );
+
+    for (size_t i = 0; i < steps; ++i, ++entry.id)
+    {
+        entry.price = 100.0 + double(random( ) % 1000) / 100.0;
+        entry.side = int(random( ) % 2);
+        switch (random( ) % 4)
+        {
+        case 0:
+            before = chrono::steady_clock::now( );
+            book.insert(entry);
+            after = chrono::steady_clock::now( );
+            timed.insert.record(nanoseconds(before, after));
+            break;
+        case 1:
+            if (book.is_item( ) && (book.size( ) > book_size / 2))
+            {
+                before = chrono::steady_clock::now( );
+                book.remove_current( );
+                after = chrono::steady_clock::now( );
+                timed.remove.record(nanoseconds(before, after));
+            }
+            break;
+        default:
+            if (book.size( ) - book.position( ) > 8)
+                book.advance(random( ) % 8);
+            else
+                book.start( );
+            break;
+        }
+
+        before = chrono::steady_clock::now( );
+        log.attach(entry);
+        after = chrono::steady_clock::now( );
+        timed.attach.record(nanoseconds(before, after));
+        if (log.size( ) >= log_size)
+        {
+            before = chrono::steady_clock::now( );
+            log.clear( );
+            after = chrono::steady_clock::now( );
+            timed.clear.record(nanoseconds(before, after));
+        }
+        if ((i + 1) % copy_every == 0)
+        {
+            before = chrono::steady_clock::now( );
+            snapshot = book;
+            after = chrono::steady_clock::now( );
+            timed.copy.record(nanoseconds(before, after));
+        }
+    }
+    // The sequences are destroyed here, outside the timed region.
+}
+
+int main(int argc, char *argv[])
+{
+    size_t steps = (argc > 1) ? strtoul(argv[1], NULL, 10) : 2000000;
+    size_t book_size = (argc > 2) ? strtoul(argv[2], NULL, 10) : 100000;
+    size_t log_size = (argc > 3) ? strtoul(argv[3], NULL, 10) : 250000;
+    unsigned seed = (argc > 4) ? unsigned(strtoul(argv[4], NULL, 10)) : 42;
+    size_t copy_every = (argc > 5) ? strtoul(argv[5], NULL, 10) : 100000;
+    const char* names[2] = { "default", "reserve + defer_frees" };
+
+    cout << steps << " steps, book of " << book_size << ", log of " << log_size << endl;
+    for (int low_latency = 0; low_latency < 2; ++low_latency)
+    {
+        latencies timed;
+
+        run(steps, book_size, log_size, seed, copy_every, low_latency != 0, timed);
+        node_reclaimer::instance( ).drain( );
+        cout << endl << names[low_latency] << " (ns)" << endl;
+        cout << "operation          count       p50       p99     p99.9         max" << endl;
+        report("insert", timed.insert);
+        report("attach", timed.attach);
+        report("remove_current", timed.remove);
+        report("clear", timed.clear);
+        report("operator =", timed.copy);
+    }
+    return EXIT_SUCCESS;
+}
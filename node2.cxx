@@ -8,6 +8,8 @@
 //#include "node<Item>.h"
 #include <cassert>    // Provides assert
 #include <cstdlib>    // Provides NULL and size_t
+#include <new>        // Provides placement new
+#include <type_traits> // Provides is_trivially_copyable, is_trivially_destructible
 
 using namespace std;
 
@@ -30,6 +32,7 @@ namespace scu_coen70_6B
     void list_head_insert(node<Item>*& head_ptr, const Item& entry)
     {
     	head_ptr = new node<Item>(entry, head_ptr);
+    	SEQ_COUNT(node_allocs);
     }
     template<class Item>
     void list_insert(node<Item>* previous_ptr, const Item& entry)
@@ -38,30 +41,43 @@ namespace scu_coen70_6B
 
     	insert_ptr = new node<Item>(entry, previous_ptr->link( ));
     	previous_ptr->set_link(insert_ptr);
+    	SEQ_COUNT(node_allocs);
     }
     template<class Item>
     node<Item>* list_search(node<Item>* head_ptr, const Item& target)
     // Library facilities used: cstdlib
     {
     	node<Item> *cursor;
+    	size_t hops = 0;
 
-    	for (cursor = head_ptr; cursor != NULL; cursor = cursor->link( ))
+    	for (cursor = head_ptr; cursor != NULL; cursor = cursor->link( ), ++hops)
+    	{
+    	    node_prefetch(cursor->link( ));
     	    if (target == cursor->data( ))
-        		return cursor;
+    	        break;
+    	}
 
-    	return NULL;
+    	SEQ_COUNT_N(pointer_hops, hops);
+    	SEQ_PROBE(search, hops);
+    	return cursor;
     }
     template<class Item>
     const node<Item>* list_search(const node<Item>* head_ptr, const  Item& target)
     // Library facilities used: cstdlib
     {
     	const node<Item> *cursor;
+    	size_t hops = 0;
 
-    	for (cursor = head_ptr; cursor != NULL; cursor = cursor->link( ))
+    	for (cursor = head_ptr; cursor != NULL; cursor = cursor->link( ), ++hops)
+    	{
+    	    node_prefetch(cursor->link( ));
     	    if (target == cursor->data( ))
-        		return cursor;
+    	        break;
+    	}
 
-    	return NULL;
+    	SEQ_COUNT_N(pointer_hops, hops);
+    	SEQ_PROBE(search, hops);
+    	return cursor;
     }
     template<class Item>
     node<Item>* list_locate(node<Item>* head_ptr, size_t position)
@@ -75,6 +91,8 @@ namespace scu_coen70_6B
     	for (i = 1; (i < position) && (cursor != NULL); i++)
     	    cursor = cursor->link( );
 
+    	SEQ_COUNT_N(pointer_hops, i-1);
+    	SEQ_PROBE(locate, i-1);
     	return cursor;
     }
     template<class Item>
@@ -89,6 +107,8 @@ namespace scu_coen70_6B
     	for (i = 1; (i < position) && (cursor != NULL); i++)
     	    cursor = cursor->link( );
 
+    	SEQ_COUNT_N(pointer_hops, i-1);
+    	SEQ_PROBE(locate, i-1);
     	return cursor;
     }
     template<class Item>
@@ -99,6 +119,7 @@ namespace scu_coen70_6B
     	remove_ptr = head_ptr;
     	head_ptr = head_ptr->link( );
     	delete remove_ptr;
+    	SEQ_COUNT(node_frees);
     }
     template<class Item>
     void list_remove(node<Item>* previous_ptr)
@@ -108,18 +129,89 @@ namespace scu_coen70_6B
     	remove_ptr = previous_ptr->link( );
     	previous_ptr->set_link( remove_ptr->link( ) );
     	delete remove_ptr;
+    	SEQ_COUNT(node_frees);
     }
     template<class Item>
     void list_clear(node<Item>*& head_ptr)
-    // Library facilities used: cstdlib
+    // Library facilities used: cstdlib, type_traits
     {
+    	// Destroy each node in place and return the storage to the pool in
+    	// batches, so the pool is locked once per BATCH nodes, not per node.
+    	const size_t BATCH = 256;
+    	node<Item> *batch[BATCH];
+    	node<Item> *next;
+    	size_t count = 0;
+
     	while (head_ptr != NULL)
-    	    list_head_remove(head_ptr);
+    	{
+    	    next = head_ptr->link( );
+    	    if (!std::is_trivially_destructible<Item>::value)
+    	        head_ptr->~node( );
+    	    batch[count++] = head_ptr;
+    	    head_ptr = next;
+    	    if ((count == BATCH) || (head_ptr == NULL))
+    	    {
+    	        node<Item>::release_batch(batch, count);
+    	        SEQ_COUNT_N(node_frees, count);
+    	        count = 0;
+    	    }
+    	}
+    }
+    // Copies the nodes from source_ptr up to (not including) end_ptr, but no
+    // more than many of them, into blocks from node<Item>::allocate_run, and
+    // returns how many it copied. Used for trivially copyable Items.
+    template<class Item>
+    size_t list_copy_block(const node<Item>* source_ptr, const node<Item>* end_ptr, size_t many,
+                           node<Item>*& head_ptr, node<Item>*& tail_ptr)
+    // Library facilities used: cstdlib, new
+    {
+    	const size_t RUN = 256;
+    	void *run = NULL;
+    	size_t run_left = 0;
+    	size_t copied = 0;
+    	node<Item> *fresh;
+
+    	head_ptr = NULL;
+    	tail_ptr = NULL;
+    	try
+    	{
+    	    for (; (source_ptr != NULL) && (source_ptr != end_ptr) && (copied < many);
+    	         source_ptr = source_ptr->link( ), ++copied)
+    	    {
+    	        node_prefetch(source_ptr->link( ));
+    	        if (run_left == 0)
+    	            run_left = node<Item>::allocate_run(run, RUN);
+    	        fresh = new (run) node<Item>(source_ptr->data( ));
+    	        run = fresh + 1;
+    	        --run_left;
+    	        SEQ_COUNT(node_allocs);
+    	        if (tail_ptr == NULL)
+    	            head_ptr = fresh;
+    	        else
+    	            tail_ptr->set_link(fresh);
+    	        tail_ptr = fresh;
+    	    }
+    	}
+    	catch (...)
+    	{
+    	    // Only allocate_run can throw here; nothing of the copy survives.
+    	    list_clear(head_ptr);
+    	    tail_ptr = NULL;
+    	    throw;
+    	}
+    	node<Item>::release_run(run, run_left);
+    	return copied;
     }
     template<class Item>
     void list_copy(const node<Item>* source_ptr, node<Item>*& head_ptr, node<Item>*& tail_ptr)
     // Library facilities used: cstdlib
     {
+    	if (std::is_trivially_copyable<Item>::value)
+    	{
+    	    list_copy_block(source_ptr, (const node<Item>*)NULL, size_t(-1), head_ptr, tail_ptr);
+    	    return;
+    	}
+
     	head_ptr = NULL;
     	tail_ptr = NULL;
 
@@ -135,6 +227,7 @@ namespace scu_coen70_6B
     	source_ptr = source_ptr->link( );
     	while (source_ptr != NULL)
     	{
+    	    node_prefetch(source_ptr->link( ));
     	    list_insert(tail_ptr, source_ptr->data( ));
     	    tail_ptr = tail_ptr->link( );
     	    source_ptr = source_ptr->link( );
@@ -144,6 +237,13 @@ namespace scu_coen70_6B
     void list_piece(node<Item>* start_ptr, node<Item>* end_ptr, node<Item>*& head_ptr, node<Item>*& tail_ptr)
     // Library facilities used: stdlib.h
     {
+        if (std::is_trivially_copyable<Item>::value)
+        {
+            list_copy_block((const node<Item>*)start_ptr, (const node<Item>*)end_ptr, size_t(-1),
+                            head_ptr, tail_ptr);
+            return;
+        }
+
         head_ptr = NULL;
         tail_ptr = NULL;
 
@@ -162,24 +262,28 @@ namespace scu_coen70_6B
              start_ptr != NULL && start_ptr != end_ptr;
              start_ptr = start_ptr->link())
         {
+            node_prefetch(start_ptr->link());
             list_insert(tail_ptr, start_ptr->data());
             tail_ptr = tail_ptr->link();
         }
     }
     template<class Item>
-    size_t list_occurrences(node<Item>* head_ptr, const  typename node<Item>::Item& target)
+    size_t list_occurrences(node<Item>* head_ptr, const Item& target)
     {
         size_t answer = 0;
 
-        for (head_ptr = list_search(head_ptr, target);
-             head_ptr != NULL;
-    	     head_ptr = list_search(head_ptr->link(), target))
-    	answer++;
+        // One walk, counting as it goes (no restarted search after each match).
+        for (; head_ptr != NULL; head_ptr = head_ptr->link())
+        {
+            node_prefetch(head_ptr->link());
+            if (head_ptr->data() == target)
+                ++answer;
+        }
 
         return answer;
     }
     template<class Item>
-    void list_insert_at(node<Item>*& head_ptr, const typename  node<Item>::Item& entry, size_t position)
+    void list_insert_at(node<Item>*& head_ptr, const Item& entry, size_t position)
     {
         assert(position > 0);
         node<Item> *precursor;
@@ -194,11 +298,11 @@ namespace scu_coen70_6B
         }
     }
     template<class Item>
-   typename  node<Item>::Item list_remove_at(node<Item>*& head_ptr, size_t position)
+    Item list_remove_at(node<Item>*& head_ptr, size_t position)
     {
         assert(position > 0);
         node<Item> *precursor;
-         typename node<Item>::Item answer;
+        Item answer;
 
         if (position == 1)
         {
@@ -219,19 +323,288 @@ namespace scu_coen70_6B
 template<class Item>
     node<Item>* list_copy_segment(node<Item>* head_ptr, size_t start, size_t finish)
     {
-        node<Item> *start_ptr;
-        node<Item> *finish_ptr;
         node<Item> *new_head;
         node<Item> *new_tail;
+        size_t copied;
 
-        assert((1 <= start) && (start <= finish) && (finish <= list_length(head_ptr)));
-        ++finish;
-        
-
-        start_ptr = list_locate(head_ptr, start);
-        assert(start_ptr != NULL);
-        finish_ptr = list_locate(start_ptr, finish-start+1);
-        list_piece(start_ptr, finish_ptr, new_head, new_tail);
+        assert((1 <= start) && (start <= finish));
+        // A single pass; finish <= list_length(head_ptr) is checked by the count.
+        copied = list_copy_range((const node<Item>*)head_ptr, start, finish+1, new_head, new_tail);
+        assert(copied == finish-start+1);
+        (void)copied;
         return new_head;
     }
+
+    // STREAMING SEGMENTS
+
+    // Walks to position start, counting down; the result is NULL if the list is shorter.
+    template<class Item>
+    const node<Item>* list_skip(const node<Item>* head_ptr, size_t start)
+    {
+        for (; (head_ptr != NULL) && (start > 1); --start)
+            head_ptr = head_ptr->link();
+        return head_ptr;
+    }
+    template<class Item, class Visitor>
+    size_t list_visit_segment(const node<Item>* head_ptr, size_t start, size_t finish, Visitor visit)
+    {
+        assert(start > 0);
+        size_t visited = 0;
+
+        for (head_ptr = list_skip(head_ptr, start);
+             (head_ptr != NULL) && (start + visited < finish);
+             head_ptr = head_ptr->link(), ++visited)
+        {
+            node_prefetch(head_ptr->link());
+            visit(head_ptr->data());
+        }
+        return visited;
+    }
+    template<class Item>
+    size_t list_copy_range(const node<Item>* head_ptr, size_t start, size_t finish,
+                           node<Item>*& new_head, node<Item>*& new_tail)
+    // Library facilities used: cstdlib, type_traits
+    {
+        assert(start > 0);
+        size_t copied = 0;
+
+        new_head = NULL;
+        new_tail = NULL;
+        head_ptr = list_skip(head_ptr, start);
+        if ((head_ptr == NULL) || (finish <= start))
+            return 0;
+
+        if (std::is_trivially_copyable<Item>::value)
+            return list_copy_block(head_ptr, (const node<Item>*)NULL, finish-start, new_head, new_tail);
+
+        list_head_insert(new_head, head_ptr->data());
+        new_tail = new_head;
+        try
+        {
+            for (copied = 1, head_ptr = head_ptr->link();
+                 (head_ptr != NULL) && (copied < finish-start);
+                 head_ptr = head_ptr->link(), ++copied)
+            {
+                node_prefetch(head_ptr->link());
+                list_insert(new_tail, head_ptr->data());
+                new_tail = new_tail->link();
+            }
+        }
+        catch (...)
+        {
+            list_clear(new_head);
+            new_tail = NULL;
+            throw;
+        }
+        return copied;
+    }
+    template<class Item>
+    void list_count_each(const node<Item>* head_ptr, const Item* targets, size_t many_targets,
+                         size_t* counts)
+    {
+        for (size_t i = 0; i < many_targets; ++i)
+            counts[i] = 0;
+        for (; head_ptr != NULL; head_ptr = head_ptr->link())
+        {
+            node_prefetch(head_ptr->link());
+            for (size_t i = 0; i < many_targets; ++i)
+            {
+                if (head_ptr->data() == targets[i])
+                    ++counts[i];
+            }
+        }
+    }
+
+    // RELINKING
+
+    template<class Item, class Compare>
+    void list_merge(node<Item>*& head_ptr, node<Item>*& tail_ptr,
+                    node<Item>* other_head, node<Item>* other_tail, Compare less)
+    {
+        node<Item>* first = head_ptr;
+        node<Item>* last;
+
+        if (other_head == NULL)
+            return;
+        if (first == NULL)
+        {
+            head_ptr = other_head;
+            tail_ptr = other_tail;
+            return;
+        }
+
+        // Take from the other list only when its item is strictly less, so
+        // that equal items keep the first list's ones in front.
+        if (less(other_head->data(), first->data()))
+        {
+            head_ptr = other_head;
+            other_head = other_head->link();
+        }
+        else
+        {
+            head_ptr = first;
+            first = first->link();
+        }
+        last = head_ptr;
+        while ((first != NULL) && (other_head != NULL))
+        {
+            if (less(other_head->data(), first->data()))
+            {
+                last->set_link(other_head);
+                last = other_head;
+                other_head = other_head->link();
+            }
+            else
+            {
+                last->set_link(first);
+                last = first;
+                first = first->link();
+            }
+        }
+
+        // One list is used up; the rest of the other ends the merge.
+        if (first != NULL)
+            last->set_link(first);
+        else
+        {
+            last->set_link(other_head);
+            tail_ptr = other_tail;
+        }
+    }
+    template<class Item, class Compare>
+    void list_sort(node<Item>*& head_ptr, node<Item>*& tail_ptr, Compare less)
+    {
+        // bin_head[i] is NULL or a sorted run of 2^i nodes; a higher bin holds
+        // nodes from earlier in the list than a lower one.
+        node<Item>* bin_head[64];
+        node<Item>* bin_tail[64];
+        node<Item>* run_head;
+        node<Item>* run_tail;
+        size_t i, used = 0;
+
+        while (head_ptr != NULL)
+        {
+            run_head = head_ptr;
+            run_tail = head_ptr;
+            head_ptr = head_ptr->link();
+            run_tail->set_link(NULL);
+            for (i = 0; (i < used) && (bin_head[i] != NULL); ++i)
+            {
+                list_merge(bin_head[i], bin_tail[i], run_head, run_tail, less);
+                run_head = bin_head[i];
+                run_tail = bin_tail[i];
+                bin_head[i] = NULL;
+            }
+            if (i == used)
+                ++used;
+            bin_head[i] = run_head;
+            bin_tail[i] = run_tail;
+        }
+
+        head_ptr = NULL;
+        tail_ptr = NULL;
+        for (i = 0; i < used; ++i)
+        {
+            if (bin_head[i] != NULL)
+            {
+                list_merge(bin_head[i], bin_tail[i], head_ptr, tail_ptr, less);
+                head_ptr = bin_head[i];
+                tail_ptr = bin_tail[i];
+            }
+        }
+    }
+    template<class Item>
+    void list_reverse(node<Item>*& head_ptr, node<Item>*& tail_ptr)
+    {
+        node<Item>* done = NULL;
+        node<Item>* next;
+
+        tail_ptr = head_ptr;
+        while (head_ptr != NULL)
+        {
+            next = head_ptr->link();
+            head_ptr->set_link(done);
+            done = head_ptr;
+            head_ptr = next;
+        }
+        head_ptr = done;
+    }
+    template<class Item>
+    void list_rotate(node<Item>*& head_ptr, node<Item>*& tail_ptr, node<Item>* new_tail)
+    {
+        assert(new_tail != NULL);
+        if (new_tail == tail_ptr)
+            return;
+        tail_ptr->set_link(head_ptr);
+        head_ptr = new_tail->link();
+        tail_ptr = new_tail;
+        new_tail->set_link(NULL);
+    }
+    template<class Item, class Predicate>
+    size_t list_partition(node<Item>*& head_ptr, node<Item>*& tail_ptr, Predicate pred)
+    {
+        // The nodes are dealt onto two lists as they are tested, and the
+        // second is linked after the first at the end.
+        node<Item>* yes_head = NULL;
+        node<Item>* yes_tail = NULL;
+        node<Item>* no_head = NULL;
+        node<Item>* no_tail = NULL;
+        node<Item>* rest = head_ptr;
+        size_t answer = 0;
+
+        try
+        {
+            while (rest != NULL)
+            {
+                if (pred(rest->data()))
+                {
+                    if (yes_tail == NULL)
+                        yes_head = rest;
+                    else
+                        yes_tail->set_link(rest);
+                    yes_tail = rest;
+                    ++answer;
+                }
+                else
+                {
+                    if (no_tail == NULL)
+                        no_head = rest;
+                    else
+                        no_tail->set_link(rest);
+                    no_tail = rest;
+                }
+                rest = rest->link();
+            }
+        }
+        catch (...)
+        {
+            // Put the untested nodes (from the one pred threw on, so the
+            // tail is unchanged) back after the tested ones
+            if (no_tail != NULL)
+                no_tail->set_link(rest);
+            else
+                no_head = rest;
+            if (yes_tail != NULL)
+            {
+                yes_tail->set_link(no_head);
+                head_ptr = yes_head;
+            }
+            else
+                head_ptr = no_head;
+            throw;
+        }
+
+        if (yes_tail == NULL)
+            return 0;
+        head_ptr = yes_head;
+        yes_tail->set_link(no_head);
+        if (no_tail != NULL)
+        {
+            no_tail->set_link(NULL);
+            tail_ptr = no_tail;
+        }
+        else
+            tail_ptr = yes_tail;
+        return answer;
+    }
 }
@@ -20,6 +20,52 @@
 //     is also allowed for the built-in types, providing a default value of
 //     zero. The init_link has a default value of NULL.
 //
+// ALLOCATION for the node class:
+//   Nodes created with new come from the shared node_pool for their size
+//   (see node_pool.h), and delete returns them there. This replaces the
+//   global allocator for every node in the program, which is what makes
+//   compaction, reserve and the run copies below work; compiled with
+//   NODE2_HEAP_NODES, nodes use the global operator new and delete instead,
+//   allocate_run hands out one node at a time, and reserve does nothing.
+//
+//   static std::size_t allocate_run(void*& first, std::size_t wanted)
+//     Precondition: wanted > 0.
+//     Postcondition: first points to uninitialized storage for k adjacent
+//     nodes, where k (1 <= k <= wanted) is the return value. The caller
+//     constructs nodes there with placement new; each of them may later be
+//     deleted as usual, and the slots left unconstructed at the end of the
+//     run must be released with release_run.
+//
+//   static void release_run(void* first, std::size_t many)
+//     Precondition: first points to the many unconstructed slots at the end
+//     of a run from allocate_run.
+//     Postcondition: The slots have been returned to the pool.
+//
+//   static void release_batch(node* const* nodes, std::size_t many)
+//     Precondition: Each node came from new and has already been destroyed
+//     (by an explicit ~node( ) call, or not at all if Item is trivially
+//     destructible).
+//     Postcondition: The storage of all the nodes has been returned to the
+//     pool in one step.
+//
+//   static void reserve(std::size_t many)
+//     Postcondition: The pool for this node type holds at least many free
+//     nodes' storage, with its pages mapped, and keeps that much from now on
+//     (see node_pool::reserve). The pool is shared by every list of the same
+//     node size, so the reservation is too.
+//
+// TRIVIALLY COPYABLE AND TRIVIALLY DESTRUCTIBLE ITEMS:
+//   When Item is trivially copyable (int, double, plain structs), list_copy
+//   and list_piece build the copy from allocate_run blocks, so the new nodes
+//   are adjacent in memory and the pool is locked once per block instead of
+//   once per node. Other Item types take the node-by-node path, unchanged.
+//
+// BULK DEALLOCATION:
+//   list_clear runs each node's destructor in place (skipped when Item is
+//   trivially destructible) and hands the storage back to the pool through
+//   release_batch, 256 nodes per lock. To take even that work off a latency
+//   sensitive thread, hand the list to a node_reclaimer (node_reclaimer.h).
+//
 // NOTE:
 //   Some of the functions have a return value which is a pointer to a node.
 //   Each of these  functions comes in two versions: a non-const version (where
@@ -148,6 +194,109 @@
 //     the finish position in the list that head_ptr points to.
 //     (The head node is position 1, the next node is position 2, and so on.)
 //     The list pointed to by head_ptr is unchanged.
+//     The copy is made in the same single walk that finds the start.
+//
+// STREAMING SEGMENTS:
+//   These functions take a half-open range of positions [start, finish),
+//   that is, the nodes at positions start, start+1, ..., finish-1 (the head
+//   is position 1), and handle it in exactly one walk from head_ptr that
+//   stops at finish. They allocate nothing beyond what they copy. A range
+//   that runs past the end of the list simply stops at the end.
+//
+//   size_t list_visit_segment(const node* head_ptr, size_t start, size_t finish, Visitor visit)
+//     Precondition: head_ptr is the head pointer of a linked list, start > 0,
+//     and visit(item) can be called with a const Item&.
+//     Postcondition: visit has been called on each item of [start, finish)
+//     in order, and the return value is the number of calls.
+//
+//   size_t list_copy_range(
+//     const node* head_ptr, size_t start, size_t finish,
+//     node*& new_head, node*& new_tail
+//   )
+//     Precondition: head_ptr is the head pointer of a linked list, and start > 0.
+//     Postcondition: new_head and new_tail are the head and tail pointers for
+//     a new list that contains copies of the items of [start, finish) (both
+//     NULL if there are none), and the return value is their number.
+//
+//   void list_count_each(const node* head_ptr, const Item* targets, size_t many_targets, size_t* counts)
+//     Precondition: head_ptr is the head pointer of a linked list, and targets
+//     and counts are arrays of at least many_targets elements.
+//     Postcondition: counts[i] is the number of items equal to targets[i],
+//     all found in one walk (list_occurrences once per target would walk the
+//     list many_targets times). Each item is compared with every target, so
+//     the cost is O(length * many_targets) comparisons but only one pass over
+//     the nodes.
+//
+// RELINKING:
+//   These functions rearrange existing nodes by changing their links only: no
+//   node is allocated or freed, and no item is copied or assigned, so they
+//   cannot throw unless less does. Pointers to the nodes stay valid.
+//
+//   void list_merge(
+//     node*& head_ptr, node*& tail_ptr,
+//     node* other_head, node* other_tail, Compare less
+//   )
+//     Precondition: head_ptr and tail_ptr, and other_head and other_tail, are
+//     the head and tail pointers of two separate linked lists (either may be
+//     empty, with both pointers NULL), each sorted by less.
+//     Postcondition: head_ptr and tail_ptr are the head and tail pointers of
+//     one list holding the nodes of both, sorted by less. The merge is
+//     stable: an item of the first list comes before an equal item of the
+//     other. It takes one pass and never walks to find a tail.
+//
+//   void list_sort(node*& head_ptr, node*& tail_ptr, Compare less)
+//     Precondition: head_ptr is the head pointer of a linked list.
+//     Postcondition: The nodes have been relinked so that their items are in
+//     order by less, with equal items in their original order, and head_ptr
+//     and tail_ptr are the new head and tail pointers. This is a bottom-up
+//     merge sort: O(n log n) comparisons, with 64 pointers of extra space.
+//
+//   void list_reverse(node*& head_ptr, node*& tail_ptr)
+//     Precondition: head_ptr and tail_ptr are the head and tail pointers of a
+//     linked list.
+//     Postcondition: The nodes are linked in the opposite order, and head_ptr
+//     and tail_ptr are the new head and tail pointers. Each node is visited
+//     once.
+//
+//   void list_rotate(node*& head_ptr, node*& tail_ptr, node* new_tail)
+//     Precondition: head_ptr and tail_ptr are the head and tail pointers of a
+//     linked list, and new_tail points to one of its nodes.
+//     Postcondition: The nodes after new_tail have been moved, in order, to
+//     the front of the list, so that new_tail is now the tail. This takes
+//     O(1): the old tail is linked to the old head and the list is cut after
+//     new_tail.
+//
+//   size_t list_partition(node*& head_ptr, node*& tail_ptr, Predicate pred)
+//     Precondition: head_ptr and tail_ptr are the head and tail pointers of a
+//     linked list.
+//     Postcondition: The nodes whose items satisfy pred come first, followed
+//     by the others; within each group the nodes keep their original order.
+//     The return value is the size of the first group. Each node is visited
+//     once, and pred is called once per item. If pred throws, the list still
+//     holds every node (the ones already tested partitioned, then the rest in
+//     their original order) and the exception is passed on.
+//
+// PREFETCHING:
+//   When compiled with NODE2_PREFETCH (on GCC or Clang), the walkers that do
+//   real work at each node issue a software prefetch for the next node before
+//   doing that work, so the next cache miss overlaps with it: list_search
+//   (while comparing the data), list_copy and list_piece (while allocating
+//   the copy), and the ++ operators of both node iterators (while the caller
+//   uses the current item). list_length and list_locate do nothing at a node
+//   but load its link, so a prefetch could not run ahead of them and they are
+//   left alone. The switch only adds hints; results are identical. It is an
+//   experiment, not a speedup: a singly linked list cannot prefetch further
+//   ahead than the next node, whose address is the load each step already
+//   waits for, and traversal_bench.cpp has measured no gain from it.
+//
+//   void node_prefetch(const node* p)
+//     Postcondition: If prefetching is enabled, the cache line of *p has been
+//     requested. p may be NULL. Without NODE2_PREFETCH this does nothing.
+//
+// INSTRUMENTATION:
+//   When compiled with SEQ_INSTRUMENT (see seq_stats.h), list_head_insert and
+//   list_insert count node allocations, list_head_remove and list_remove count
+//   node frees, and list_search and list_locate count the links they follow.
 //
 // DYNAMIC MEMORY usage by the toolkit:
 //   If there is insufficient dynamic memory, then the following functions throw
@@ -157,8 +306,15 @@
 #ifndef COEN_70_NODE_H
 #define COEN_70_NODE_H
 #include <cstdlib> // Provides size_t and NULL
+#include <cstddef> // Provides ptrdiff_t
 #include <iterator>
 #include <cassert>
+#include <new>     // Provides placement new
+#include <type_traits> // Provides is_trivially_copyable
+#include "seq_stats.h" // Provides the optional instrumentation hooks
+#if !defined(NODE2_HEAP_NODES)
+#include "node_pool.h" // Provides the slab allocator behind new and delete
+#endif
 
 namespace scu_coen70_6B
 {
@@ -184,12 +340,72 @@ namespace scu_coen70_6B
         // CONST MEMBER FUNCTIONS
         const Item& data( ) const { return data_field; }
         const node* link( ) const { return link_field; }
+        // ALLOCATION
+#if defined(NODE2_HEAP_NODES)
+        static std::size_t allocate_run(void*& first, std::size_t wanted)
+        {
+            (void)wanted;
+            first = ::operator new(sizeof(node));
+            return 1;
+        }
+        static void release_run(void* first, std::size_t many)
+        {
+            if (many > 0)
+                ::operator delete(first);
+        }
+        static void release_batch(node* const* nodes, std::size_t many)
+        {
+            for (std::size_t i = 0; i < many; ++i)
+                ::operator delete(nodes[i]);
+        }
+        static void reserve(std::size_t many) { (void)many; }
+#else
+        static void* operator new(std::size_t bytes)
+        {
+            (void)bytes;
+            return node_pool<sizeof(node), alignof(node)>::instance( ).allocate( );
+        }
+        static void* operator new(std::size_t bytes, void* place) { (void)bytes; return place; }
+        static void operator delete(void* p)
+        {
+            if (p != NULL)
+                node_pool<sizeof(node), alignof(node)>::instance( ).deallocate(p);
+        }
+        static void operator delete(void*, void*) { }
+        static std::size_t allocate_run(void*& first, std::size_t wanted)
+        {
+            return node_pool<sizeof(node), alignof(node)>::instance( ).allocate_run(first, wanted);
+        }
+        static void release_run(void* first, std::size_t many)
+        {
+            node_pool<sizeof(node), alignof(node)>::instance( ).deallocate_run(first, many);
+        }
+        static void release_batch(node* const* nodes, std::size_t many)
+        {
+            node_pool<sizeof(node), alignof(node)>::instance( ).deallocate_batch(
+                reinterpret_cast<void* const*>(nodes), many);
+        }
+        static void reserve(std::size_t many)
+        {
+            node_pool<sizeof(node), alignof(node)>::instance( ).reserve(many);
+        }
+#endif
         
     private:
     	value_type data_field;
     	node* link_field;
     };
 
+    template<class Item>
+    inline void node_prefetch(const node<Item>* p)
+    {
+#if defined(NODE2_PREFETCH) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+
 #pragma mark - Linked List Functions
     
     // FUNCTIONS for the linked list toolkit
@@ -227,6 +443,25 @@ namespace scu_coen70_6B
     Item list_remove_at(node<Item>*& head_ptr, size_t position);
     template<class Item>
     node<Item>* list_copy_segment(node<Item>* head_ptr, size_t start, size_t finish);
+    template<class Item, class Visitor>
+    size_t list_visit_segment(const node<Item>* head_ptr, size_t start, size_t finish, Visitor visit);
+    template<class Item>
+    size_t list_copy_range(const node<Item>* head_ptr, size_t start, size_t finish,
+                           node<Item>*& new_head, node<Item>*& new_tail);
+    template<class Item>
+    void list_count_each(const node<Item>* head_ptr, const Item* targets, size_t many_targets,
+                         size_t* counts);
+    template<class Item, class Compare>
+    void list_merge(node<Item>*& head_ptr, node<Item>*& tail_ptr,
+                    node<Item>* other_head, node<Item>* other_tail, Compare less);
+    template<class Item, class Compare>
+    void list_sort(node<Item>*& head_ptr, node<Item>*& tail_ptr, Compare less);
+    template<class Item>
+    void list_reverse(node<Item>*& head_ptr, node<Item>*& tail_ptr);
+    template<class Item>
+    void list_rotate(node<Item>*& head_ptr, node<Item>*& tail_ptr, node<Item>* new_tail);
+    template<class Item, class Predicate>
+    size_t list_partition(node<Item>*& head_ptr, node<Item>*& tail_ptr, Predicate pred);
 
 
 
@@ -235,19 +470,24 @@ namespace scu_coen70_6B
 // * operator, so it may not be used with a const node. The
 // node_const_iterator cannot change the underlying linked list
 // through the * operator, so it may be used with a const node.
-// WARNING:
-// This classes use std::iterator as its base class;
-// Older compilers that do not support the std::iterator class can
-// delete everything after the word iterator in the second line:
+// Both classes declare the five standard iterator typedefs themselves
+// (std::iterator is deprecated), so they work with std::iterator_traits and
+// satisfy std::forward_iterator in C++20. A node_iterator converts to a
+// const_node_iterator, and get_node( ) returns the node an iterator is at.
 
 
 //You need to change these to template classes and implement the functions for these classes
 #pragma mark - Node Iterator
     template<class Item>
     class node_iterator
-    // : public std::iterator<std::forward_iterator_tag, Item>
     {
     public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Item* pointer;
+        typedef Item& reference;
+
         node_iterator(node<Item>* initial = NULL){
             current = initial;
         
@@ -259,6 +499,8 @@ namespace scu_coen70_6B
         node_iterator& operator ++( ){
             // Prefix ++
             current = current->link();
+            if (current != NULL)
+                node_prefetch(current->link());
             return *this;
             
         }
@@ -266,6 +508,8 @@ namespace scu_coen70_6B
             // Postfix ++
             node_iterator<Item> orig(current);
             current = current->link();
+            if (current != NULL)
+                node_prefetch(current->link());
             return orig;
         }
         bool operator ==(const node_iterator<Item> other) const{
@@ -277,6 +521,7 @@ namespace scu_coen70_6B
         
         
         }
+        node<Item>* get_node( ) const { return current; }
     private:
         node<Item>* current;
     };
@@ -284,12 +529,20 @@ namespace scu_coen70_6B
 #pragma mark - Node Iterator
     template<class Item>
     class const_node_iterator
-    // : public std::iterator<std::forward_iterator_tag, Item>
     {
     public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Item* pointer;
+        typedef const Item& reference;
+
         const_node_iterator(const node<Item>* initial = NULL){
             current = initial;
         }
+        const_node_iterator(const node_iterator<Item>& other){
+            current = other.get_node( );
+        }
         const Item& operator *( ) const{
             // Dereference, gets value of current
             return current->data();
@@ -297,24 +550,29 @@ namespace scu_coen70_6B
         const_node_iterator& operator ++( ){
             // Prefix ++
             current = current->link();
+            if (current != NULL)
+                node_prefetch(current->link());
             return *this;
             
         }
         const_node_iterator operator ++(int){
             // Postfix ++
-            node_iterator<Item> orig(current);
+            const_node_iterator orig(current);
             current = current->link();
+            if (current != NULL)
+                node_prefetch(current->link());
             return orig;
         }
-        bool operator ==(const node_iterator<Item> other) const{
+        bool operator ==(const const_node_iterator<Item> other) const{
             return current == other.current;
             
         }
-        bool operator !=(const node_iterator<Item> other) const{
+        bool operator !=(const const_node_iterator<Item> other) const{
             return !(current == other.current);
             
             
         }
+        const node<Item>* get_node( ) const { return current; }
     private:
         const node<Item>* current;
     };
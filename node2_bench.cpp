@@ -0,0 +1,417 @@
+// FILE: node2_bench.cpp
+// Regression benchmarks for the free functions of the linked list toolkit
+// (node2.h): list_length, list_search, list_locate, list_insert_at,
+// list_remove_at, list_copy, list_piece, list_occurrences and
+// list_copy_segment.
+//
+// DESCRIPTION:
+// Each primitive is timed in two variants:
+//   warm  A short list (4096 nodes) allocated in order, so it stays in the
+//         cache; each sample repeats the call enough times to last about a
+//         millisecond.
+//   cold  A long list (default 1048576 nodes) whose link order is a random
+//         permutation of the allocation order, with a buffer four times its
+//         size streamed through the cache before every sample.
+// Both lists hold values drawn from a fixed seed, so every run does the same
+// work. A result is in nanoseconds per node of the list (so the numbers of
+// different primitives are comparable), and it is the fastest of many
+// samples: the whole suite runs ROUNDS times (5 unless --rounds says
+// otherwise), rebuilding the lists each time, and each round takes several
+// samples of every primitive. Other work on the machine, a timer interrupt
+// or a page fault only ever makes a sample slower, so the minimum moves far
+// less from run to run than a median does. The cold lists still land on
+// different pages each round, and a cold walk's speed depends on that (by
+// up to 40% on a small VM), so the run also notes each result's spread: how
+// much slower its median round was than its fastest.
+//
+// BASELINE FILE:
+// One line per result, "name variant ns_per_node spread_percent"; lines
+// starting with # are comments. The results are compared with the baseline,
+// and a result slower than its baseline by more than the threshold (default
+// 25%) plus its recorded spread is reported as REGRESSED, in which case the
+// program exits with EXIT_FAILURE. The allowance is thus calibrated on the
+// recording machine: steady warm results keep a tight one, and cold results
+// get as much room as they needed there. A missing baseline, or a result
+// the baseline does not mention, is reported but does not fail.
+// The numbers only mean something on the machine that recorded them. The
+// committed node2_bench.baseline was recorded on one machine (its second
+// comment line says how); to use the comparison anywhere else, first record
+// a local baseline from the commit to compare against, then compare the
+// change with it:
+//     git stash; ./node2_bench --record --baseline /tmp/local.baseline
+//     git stash pop; ./node2_bench --baseline /tmp/local.baseline
+// Record and compare on an otherwise idle machine, with the same compiler
+// and flags. If the comparison still flags a result, rerun it with more
+// --rounds before believing it.
+//
+// USAGE:
+//     g++ -std=c++17 -O2 node2_bench.cpp -o node2_bench
+//     ./node2_bench                          compare with node2_bench.baseline
+//     ./node2_bench --record                 write node2_bench.baseline
+//     ./node2_bench --baseline FILE --threshold PERCENT --cold-nodes N --rounds R
+
+#include <algorithm>    // Provides shuffle, sort, min_element
+#include <chrono>       // Provides steady_clock
+#include <cstdlib>      // Provides size_t, strtoul, strtod, EXIT_SUCCESS
+#include <cstring>      // Provides strcmp
+#include <fstream>      // Provides ifstream, ofstream
+#include <iostream>     // Provides cout, cerr
+#include <map>          // Provides map
+#include <random>       // Provides mt19937
+#include <sstream>      // Provides istringstream
+#include <string>       // Provides string
+#include <vector>       // Provides vector
+#include "node2.h"      // Provides the node class and the list toolkit
+using namespace std;
+using namespace scu_coen70_6B;
+
+const unsigned SEED = 20240611;         // Seed for the list contents and order
+const size_t WARM_NODES = 4096;
+const size_t WARM_REPEATS = 256;        // Calls per warm sample
+const size_t WARM_SAMPLES = 15;
+const size_t COLD_SAMPLES = 7;
+const size_t ROUNDS = 5;                // Default times the suite is run
+const long VALUE_RANGE = 64;            // Values are 0 .. VALUE_RANGE-1
+const long COUNTED = 7;                 // Target of list_occurrences
+
+// Timer returning the seconds since construction.
+class stopwatch
+{
+public:
+    stopwatch( ) : started(chrono::steady_clock::now( )) { }
+    double seconds( ) const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now( ) - started).count( );
+    }
+private:
+    chrono::steady_clock::time_point started;
+};
+
+// The fastest sample of one primitive over all rounds, and the median of the
+// rounds' fastest samples, which shows how much it moves between rounds.
+struct timing
+{
+    double fastest;
+    double typical;
+    vector<double> rounds;
+};
+
+// One benchmark setting: the list under test and how to sample it.
+struct variant
+{
+    const char* name;
+    node<long>* head;
+    size_t n;
+    size_t repeats;                     // Calls per sample
+    size_t samples;
+    vector<long>* flush;                // Buffer to stream before each sample, or NULL
+};
+
+// **************************************************************************
+// node<long>* build_list(size_t n, bool scattered, unsigned seed)
+//   Postcondition: The return value is the head of a new list of n nodes
+//   holding values in [0, VALUE_RANGE) drawn from seed. If scattered is true,
+//   the nodes are linked in a random order relative to the order in which
+//   they were allocated; otherwise in allocation order.
+// **************************************************************************
+node<long>* build_list(size_t n, bool scattered, unsigned seed)
+{
+    vector<node<long>*> nodes(n);
+    mt19937 random(seed);
+
+    for (size_t i = 0; i < n; ++i)
+        nodes[i] = new node<long>(long(random( ) % VALUE_RANGE));
+    if (scattered)
+        shuffle(nodes.begin( ), nodes.end( ), random);
+    for (size_t i = 0; i < n; ++i)
+        nodes[i]->set_link(i+1 < n ? nodes[i+1] : NULL);
+    return n > 0 ? nodes[0] : NULL;
+}
+
+// **************************************************************************
+// void flush_cache(vector<long>* buffer)
+//   Postcondition: If buffer is not NULL, every element of it has been read
+//   and written, which evicts the list from the cache when buffer is larger
+//   than the list.
+// **************************************************************************
+void flush_cache(vector<long>* buffer)
+{
+    if (buffer == NULL)
+        return;
+    for (size_t i = 0; i < buffer->size( ); ++i)
+        (*buffer)[i] += 1;
+}
+
+// **************************************************************************
+// double fastest_ns(const variant& v, Setup setup, Operation op, Teardown teardown)
+//   Postcondition: Each of v.samples samples has flushed the cache (for a
+//   cold variant), then called setup( ), then timed op( ) v.repeats times,
+//   then called teardown( ) untimed. The return value is the fastest sample,
+//   in nanoseconds per call per node of the list.
+// **************************************************************************
+template<class Setup, class Operation, class Teardown>
+double fastest_ns(const variant& v, Setup setup, Operation op, Teardown teardown)
+{
+    vector<double> results;
+
+    for (size_t s = 0; s < v.samples; ++s)
+    {
+        flush_cache(v.flush);
+        setup( );
+        stopwatch timer;
+        for (size_t r = 0; r < v.repeats; ++r)
+            op( );
+        double elapsed = timer.seconds( );
+        teardown( );
+        results.push_back(elapsed * 1e9 / double(v.repeats) / double(v.n));
+    }
+    return *min_element(results.begin( ), results.end( ));
+}
+
+template<class Operation>
+double fastest_ns(const variant& v, Operation op)
+{
+    return fastest_ns(v, [ ]( ) { }, op, [ ]( ) { });
+}
+
+// **************************************************************************
+// void keep_round(map<string, timing>& results, const string& name, double ns)
+//   Postcondition: ns, one round's fastest sample of name, has been taken
+//   into results[name]: fastest is the smallest such value so far, and
+//   typical their median.
+// **************************************************************************
+void keep_round(map<string, timing>& results, const string& name, double ns)
+{
+    timing& t = results[name];
+
+    t.rounds.push_back(ns);
+    sort(t.rounds.begin( ), t.rounds.end( ));
+    t.fastest = t.rounds.front( );
+    t.typical = t.rounds[t.rounds.size( ) / 2];
+}
+
+// **************************************************************************
+// void run_variant(variant& v, map<string, timing>& results, long& checksum)
+//   Postcondition: Every primitive has been timed on v.head, and the fastest
+//   samples kept in results under "name variant" (see keep_round). The
+//   list is unchanged.
+//   checksum has absorbed the results of the calls, so that none of them can
+//   be optimized away.
+// **************************************************************************
+void run_variant(variant& v, map<string, timing>& results, long& checksum)
+{
+    node<long>*& head = v.head;
+    const size_t n = v.n;
+    const string suffix = string(" ") + v.name;
+    vector<node<long>*> copies;
+    node<long>* copy_head;
+    node<long>* copy_tail;
+    node<long>* piece_start = list_locate(head, n / 4 + 1);
+    node<long>* piece_end = list_locate(head, 3 * n / 4 + 1);
+    auto clear_copies = [&copies]( )
+    {
+        for (size_t i = 0; i < copies.size( ); ++i)
+            list_clear(copies[i]);
+        copies.clear( );
+    };
+
+    keep_round(results, "list_length" + suffix, fastest_ns(v, [&]( )
+        { checksum += long(list_length(head)); }));
+    keep_round(results, "list_search" + suffix, fastest_ns(v, [&]( )
+        { checksum += (list_search(head, -1L) == NULL); }));
+    keep_round(results, "list_locate" + suffix, fastest_ns(v, [&]( )
+        { checksum += list_locate(head, n)->data( ); }));
+    keep_round(results, "list_occurrences" + suffix, fastest_ns(v, [&]( )
+        { checksum += long(list_occurrences(head, COUNTED)); }));
+
+    // Inserting then removing at the middle leaves the list as it was.
+    keep_round(results, "list_insert_at" + suffix, fastest_ns(v, [ ]( ) { }, [&]( )
+        { list_insert_at(head, COUNTED, n / 2); },
+        [&]( ) { for (size_t r = 0; r < v.repeats; ++r) list_remove_at(head, n / 2); }));
+    keep_round(results, "list_remove_at" + suffix, fastest_ns(v,
+        [&]( ) { for (size_t r = 0; r < v.repeats; ++r) list_insert_at(head, COUNTED, n / 2); },
+        [&]( ) { checksum += list_remove_at(head, n / 2); }, [ ]( ) { }));
+
+    // The copies are freed outside the timed part.
+    keep_round(results, "list_copy" + suffix, fastest_ns(v, [ ]( ) { }, [&]( )
+        {
+            list_copy((const node<long>*)head, copy_head, copy_tail);
+            copies.push_back(copy_head);
+        }, clear_copies));
+    keep_round(results, "list_piece" + suffix, fastest_ns(v, [ ]( ) { }, [&]( )
+        {
+            list_piece(piece_start, piece_end, copy_head, copy_tail);
+            copies.push_back(copy_head);
+        }, clear_copies));
+    keep_round(results, "list_copy_segment" + suffix, fastest_ns(v, [ ]( ) { }, [&]( )
+        { copies.push_back(list_copy_segment(head, n / 4 + 1, 3 * n / 4)); }, clear_copies));
+}
+
+// **************************************************************************
+// double spread(const timing& t)
+//   Postcondition: The return value is how much slower the median round
+//   was than the fastest, in percent.
+// **************************************************************************
+double spread(const timing& t)
+{
+    return (t.typical / t.fastest - 1.0) * 100.0;
+}
+
+// **************************************************************************
+// bool read_baseline(const string& file, map<string, timing>& baseline)
+//   Postcondition: If file could be opened, baseline holds its results and
+//   the return value is true; otherwise the return value is false. A line
+//   without a spread (from an older baseline) has a spread of 0.
+// **************************************************************************
+bool read_baseline(const string& file, map<string, timing>& baseline)
+{
+    ifstream in(file.c_str( ));
+    string line, name, which;
+    double ns, percent;
+
+    if (!in)
+        return false;
+    while (getline(in, line))
+    {
+        if (line.empty( ) || (line[0] == '#'))
+            continue;
+        istringstream fields(line);
+        if (!(fields >> name >> which >> ns))
+            continue;
+        if (!(fields >> percent))
+            percent = 0.0;
+        timing& recorded = baseline[name + " " + which];
+        recorded.fastest = ns;
+        recorded.typical = ns * (1.0 + percent / 100.0);
+    }
+    return true;
+}
+
+bool write_baseline(const string& file, const map<string, timing>& results, size_t cold_nodes,
+                    size_t rounds)
+{
+    ofstream out(file.c_str( ));
+
+    out << "# node2_bench baseline: name variant ns_per_node spread_percent" << endl;
+    out << "# warm " << WARM_NODES << " nodes, cold " << cold_nodes << " nodes, seed " << SEED
+        << ", fastest of " << rounds << " rounds: ./node2_bench --record --rounds " << rounds << endl;
+    out.precision(4);
+    out << fixed;
+    for (map<string, timing>::const_iterator it = results.begin( ); it != results.end( ); ++it)
+    {
+        out << it->first << " " << it->second.fastest << " ";
+        out.precision(1);
+        out << spread(it->second) << endl;
+        out.precision(4);
+    }
+    return bool(out);
+}
+
+int main(int argc, char *argv[])
+{
+    string baseline_file = "node2_bench.baseline";
+    bool record = false;
+    double threshold = 25.0;
+    size_t cold_nodes = 1048576;
+    size_t rounds = ROUNDS;
+    map<string, timing> results, baseline;
+    long checksum = 0;
+    size_t regressed = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+            record = true;
+        else if ((strcmp(argv[i], "--baseline") == 0) && (i+1 < argc))
+            baseline_file = argv[++i];
+        else if ((strcmp(argv[i], "--threshold") == 0) && (i+1 < argc))
+            threshold = strtod(argv[++i], NULL);
+        else if ((strcmp(argv[i], "--cold-nodes") == 0) && (i+1 < argc))
+            cold_nodes = strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "--rounds") == 0) && (i+1 < argc))
+            rounds = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--record] [--baseline FILE]"
+                 << " [--threshold PERCENT] [--cold-nodes N] [--rounds R]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (cold_nodes < 16)
+        cold_nodes = 16;
+    if (rounds < 1)
+        rounds = 1;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        {
+            variant warm = { "warm", build_list(WARM_NODES, false, SEED), WARM_NODES,
+                             WARM_REPEATS, WARM_SAMPLES, NULL };
+            run_variant(warm, results, checksum);
+            list_clear(warm.head);
+        }
+        {
+            vector<long> buffer(cold_nodes * 4, 0);
+            variant cold = { "cold", build_list(cold_nodes, true, SEED), cold_nodes,
+                             1, COLD_SAMPLES, &buffer };
+            run_variant(cold, results, checksum);
+            list_clear(cold.head);
+        }
+    }
+
+    if (record)
+    {
+        if (!write_baseline(baseline_file, results, cold_nodes, rounds))
+        {
+            cerr << "could not write " << baseline_file << endl;
+            return EXIT_FAILURE;
+        }
+        cout << "recorded " << results.size( ) << " results in " << baseline_file << endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (!read_baseline(baseline_file, baseline))
+        cout << "no baseline in " << baseline_file << "; reporting results only" << endl;
+    cout.precision(3);
+    cout << fixed;
+    cout << "primitive               baseline   measured    change   allowed" << endl;
+    for (map<string, timing>::const_iterator it = results.begin( ); it != results.end( ); ++it)
+    {
+        map<string, timing>::const_iterator old = baseline.find(it->first);
+        cout.width(22);
+        cout << left << it->first << right;
+        if (old == baseline.end( ))
+        {
+            cout << "         -" << "  " << it->second.fastest << "  ns/node (new)" << endl;
+            continue;
+        }
+        double change = (it->second.fastest / old->second.fastest - 1.0) * 100.0;
+        // A result that moved between the recording's own rounds gets that much more room.
+        double allowed = threshold + spread(old->second);
+        cout.width(10);
+        cout << old->second.fastest;
+        cout.width(11);
+        cout << it->second.fastest;
+        cout.width(9);
+        cout.precision(1);
+        cout << change << "%";
+        cout.width(9);
+        cout << allowed << "%";
+        cout.precision(3);
+        if (change > allowed)
+        {
+            cout << "  REGRESSED";
+            ++regressed;
+        }
+        cout << endl;
+    }
+    cout << "checksum " << checksum << endl;
+
+    if (regressed > 0)
+    {
+        cout << regressed << " primitive(s) regressed by more than their allowance against "
+             << baseline_file << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
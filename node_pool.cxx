@@ -0,0 +1,860 @@
+// FILE: node_pool.cxx
+// CLASS IMPLEMENTED: node_pool (see node_pool.h for documentation)
+// INVARIANT for the node_pool class:
+//   1. Every slab is SLAB_BYTES bytes, aligned to SLAB_BYTES, and begins with
+//      its slab header. Its blocks start FIRST bytes in and are BLOCK bytes
+//      apart; the blocks from bump up to limit have never been handed out.
+//
+//   2. A freed block stores the address of the next freed block of the same
+//      slab in its first bytes; free_chain is the first of them (or NULL).
+//
+//   3. Each slab belongs to arenas[home]. An arena's partial list is a doubly
+//      linked list of exactly its slabs whose free_chain is not NULL; listed
+//      records whether a slab is on it.
+//
+//   4. An arena's bump_slab is the slab whose bump region is handed out next
+//      (NULL if there is none). Apart from bump slabs, a slab with live == 0
+//      is kept only while releasing it would leave fewer than reserved free
+//      blocks.
+//
+//   5. With NODE_POOL_CHUNKS, every slab is carved from a chunk of its arena
+//      (from points to it). A chunk's unused bits mark its slabs that are not
+//      in use; an arena's chunks list holds all of its chunks, those with
+//      unused slabs first, and a chunk with no slab in use is unmapped.
+//      Without NODE_POOL_CHUNKS, from is NULL and each slab is a separate
+//      aligned_alloc block.
+//
+//   6. slab_count, live_count, free_count, chunk_count and bound_count are
+//      the totals reported by stats( ), and every member is guarded by lock,
+//      except for the depot.
+//
+//   7. The depot is full_magazines (full_count magazines in all, each
+//      holding MAGAZINE free blocks that are live as far as their slabs
+//      know; full_magazines[i] holds only blocks of arena i) and
+//      empty_magazines, all stacks linked through next and guarded by
+//      depot_lock. A thread cache's magazines belong to its thread alone,
+//      and hold only blocks of the cache's home arena.
+
+#include <algorithm>  // Provides sort, lower_bound
+#include <cstdint>    // Provides uintptr_t
+#include <cstdio>     // Provides FILE, fopen, fgets, sscanf
+#include <new>        // Provides bad_alloc
+#include <vector>     // Provides vector
+#if defined(NODE_POOL_CHUNKS)
+#include <sys/mman.h>     // Provides mmap, munmap, madvise
+#include <sys/syscall.h>  // Provides SYS_getcpu, SYS_mbind
+#include <unistd.h>       // Provides syscall
+#endif
+
+namespace scu_coen70_6B
+{
+    template<std::size_t Size, std::size_t Align>
+    node_pool<Size, Align>& node_pool<Size, Align>::instance( )
+    {
+        // Deliberately leaked: nodes owned by static sequences may be freed
+        // after a function-local static pool would have been destroyed.
+        static node_pool* the_pool = new node_pool;
+        return *the_pool;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    node_pool<Size, Align>::node_pool( )
+    {
+        for (std::size_t i = 0; i < ARENAS; ++i)
+        {
+            arenas[i].partial = NULL;
+            arenas[i].bump_slab = NULL;
+            arenas[i].chunks = NULL;
+        }
+        for (std::size_t i = 0; i < ARENAS; ++i)
+            full_magazines[i] = NULL;
+        empty_magazines = NULL;
+        full_count = 0;
+        slab_count = 0;
+        live_count = 0;
+        free_count = 0;
+        reserved = 0;
+        chunk_count[SMALL_PAGES] = chunk_count[THP] = chunk_count[HUGETLB] = 0;
+        bound_count = 0;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    typename node_pool<Size, Align>::slab* node_pool<Size, Align>::owner(void* p)
+    {
+        return reinterpret_cast<slab*>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(SLAB_BYTES - 1));
+    }
+
+    // The NUMA node the calling thread first allocated on (0 without
+    // NODE_POOL_NUMA).
+    template<std::size_t Size, std::size_t Align>
+    unsigned node_pool<Size, Align>::current_node( )
+    {
+#if defined(NODE_POOL_NUMA) && defined(__linux__)
+        static thread_local int cached = -1;
+        unsigned cpu = 0;
+        unsigned numa_node = 0;
+
+        if (cached < 0)
+        {
+            if (syscall(SYS_getcpu, &cpu, &numa_node, NULL) != 0)
+                numa_node = 0;
+            cached = int(numa_node);
+        }
+        return unsigned(cached);
+#else
+        return 0;
+#endif
+    }
+
+    // The arena of that node. Node i has arena i to itself for i < ARENAS;
+    // the nodes from ARENAS on share arenas with those below them.
+    template<std::size_t Size, std::size_t Align>
+    unsigned char node_pool<Size, Align>::current_arena( )
+    {
+        return (unsigned char)(current_node( ) % ARENAS);
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    typename node_pool<Size, Align>::slab* node_pool<Size, Align>::new_slab(unsigned char home)
+    {
+        chunk* from;
+        void* memory = carve_slab(home, from);
+        slab* s;
+
+        s = static_cast<slab*>(memory);
+        s->from = from;
+        s->free_chain = NULL;
+        s->live = 0;
+        s->bump = static_cast<char*>(memory) + FIRST;
+        s->limit = s->bump + (SLAB_BYTES - FIRST) / BLOCK * BLOCK;
+        s->prev = NULL;
+        s->next = NULL;
+        s->listed = false;
+        s->home = home;
+        ++slab_count;
+        return s;
+    }
+
+    // Blocks of s handed out at some time: its bump region is never refilled.
+    template<std::size_t Size, std::size_t Align>
+    std::size_t node_pool<Size, Align>::used_blocks(const slab* s)
+    {
+        return std::size_t(s->bump - (reinterpret_cast<const char*>(s) + FIRST)) / BLOCK;
+    }
+
+    // Whether the empty slab s may go back to the system; the caller holds lock.
+    template<std::size_t Size, std::size_t Align>
+    bool node_pool<Size, Align>::may_release(slab* s) const
+    {
+        return (s->live == 0) && (s != arenas[s->home].bump_slab) && (free_count - used_blocks(s) >= reserved);
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::release_slab(slab* s)
+    {
+        // The slab is empty, so its free chain holds every block ever used.
+        free_count -= used_blocks(s);
+        if (s->listed)
+            unlist_partial(s);
+        return_slab(s);
+        --slab_count;
+    }
+
+    // Returns the memory for one slab of arena home: a free slab of one of
+    // its chunks (mapping a new chunk if need be), or an aligned_alloc block.
+    // from is set to the chunk, or NULL.
+    template<std::size_t Size, std::size_t Align>
+    void* node_pool<Size, Align>::carve_slab(unsigned char home, chunk*& from)
+    {
+#if defined(NODE_POOL_CHUNKS)
+        arena& a = arenas[home];
+        chunk* c = a.chunks;
+        unsigned index = 0;
+
+        if ((c == NULL) || (c->unused == 0))
+        {
+            c = map_chunk(home);
+            push_chunk(a, c, true);
+        }
+        while ((c->unused & (std::uint32_t(1) << index)) == 0)
+            ++index;
+        c->unused &= ~(std::uint32_t(1) << index);
+        if (c->unused == 0)
+        {
+            // Full chunks go to the back, so the front one always has room.
+            unlink_chunk(a, c);
+            push_chunk(a, c, false);
+        }
+        from = c;
+        return c->base + index * SLAB_BYTES;
+#else
+        void* memory = std::aligned_alloc(SLAB_BYTES, SLAB_BYTES);
+
+        (void)home;
+        from = NULL;
+        if (memory == NULL)
+            throw std::bad_alloc( );
+        return memory;
+#endif
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::return_slab(slab* s)
+    {
+#if defined(NODE_POOL_CHUNKS)
+        arena& a = arenas[s->home];
+        chunk* c = s->from;
+        unsigned index = unsigned((reinterpret_cast<char*>(s) - c->base) / SLAB_BYTES);
+
+        c->unused |= std::uint32_t(1) << index;
+        unlink_chunk(a, c);
+        if (c->unused == ALL_SLABS)
+        {
+            // Nothing of the chunk is in use: give it back to the system.
+            --chunk_count[c->backing];
+            if (c->bound)
+                --bound_count;
+            munmap(c->base, CHUNK_BYTES);
+            delete c;
+            return;
+        }
+        push_chunk(a, c, true);
+#else
+        std::free(s);
+#endif
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::push_chunk(arena& a, chunk* c, bool in_front)
+    {
+        chunk* last;
+
+        c->prev = NULL;
+        c->next = NULL;
+        if (a.chunks == NULL)
+        {
+            a.chunks = c;
+            return;
+        }
+        if (in_front)
+        {
+            c->next = a.chunks;
+            a.chunks->prev = c;
+            a.chunks = c;
+            return;
+        }
+        for (last = a.chunks; last->next != NULL; last = last->next)
+            ;
+        last->next = c;
+        c->prev = last;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::unlink_chunk(arena& a, chunk* c)
+    {
+        if (c->prev != NULL)
+            c->prev->next = c->next;
+        else
+            a.chunks = c->next;
+        if (c->next != NULL)
+            c->next->prev = c->prev;
+        c->prev = NULL;
+        c->next = NULL;
+    }
+
+    // Maps a new CHUNK_BYTES-aligned chunk for arena home, trying huge pages
+    // first if configured, and binds it to the arena's NUMA node.
+    template<std::size_t Size, std::size_t Align>
+    typename node_pool<Size, Align>::chunk* node_pool<Size, Align>::map_chunk(unsigned char home)
+    {
+#if defined(NODE_POOL_CHUNKS)
+        chunk* c = new chunk;
+        void* memory = MAP_FAILED;
+        char* start;
+        std::size_t lead;
+
+        c->backing = SMALL_PAGES;
+        c->bound = false;
+#if defined(NODE_POOL_HUGE_PAGES) && defined(MAP_HUGETLB)
+        // Reserved huge pages, if the administrator set any aside.
+        memory = mmap(NULL, CHUNK_BYTES, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED)
+            c->backing = HUGETLB;
+#endif
+        if (memory == MAP_FAILED)
+        {
+            // Map twice the size and trim it to an aligned chunk.
+            memory = mmap(NULL, 2 * CHUNK_BYTES, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                delete c;
+                throw std::bad_alloc( );
+            }
+            start = static_cast<char*>(memory);
+            lead = (CHUNK_BYTES - reinterpret_cast<std::uintptr_t>(start) % CHUNK_BYTES) % CHUNK_BYTES;
+            if (lead > 0)
+                munmap(start, lead);
+            munmap(start + lead + CHUNK_BYTES, CHUNK_BYTES - lead);
+            memory = start + lead;
+#if defined(NODE_POOL_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+            if (madvise(memory, CHUNK_BYTES, MADV_HUGEPAGE) == 0)
+                c->backing = THP;
+#endif
+        }
+#if defined(NODE_POOL_NUMA) && defined(SYS_mbind)
+        {
+            // MPOL_PREFERRED (1): place pages on this node while it has room.
+            // Only an arena that belongs to the calling thread's node alone
+            // is bound, to that node's real id; an arena shared with a node
+            // from ARENAS on would be remote for one of them, so its chunks
+            // are left to the default first-touch placement.
+            unsigned node = current_node( );
+            unsigned long mask;
+            if ((node == home) && (node < 8 * sizeof(mask)))
+            {
+                mask = 1UL << node;
+                if (syscall(SYS_mbind, memory, CHUNK_BYTES, 1, &mask, 8 * sizeof(mask) + 1, 0) == 0)
+                {
+                    c->bound = true;
+                    ++bound_count;
+                }
+            }
+        }
+#else
+        (void)home;
+#endif
+        c->base = static_cast<char*>(memory);
+        c->unused = ALL_SLABS;
+        c->prev = NULL;
+        c->next = NULL;
+        ++chunk_count[c->backing];
+        return c;
+#else
+        (void)home;
+        return NULL;
+#endif
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::list_partial(slab* s)
+    {
+        arena& a = arenas[s->home];
+
+        s->prev = NULL;
+        s->next = a.partial;
+        if (a.partial != NULL)
+            a.partial->prev = s;
+        a.partial = s;
+        s->listed = true;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::unlist_partial(slab* s)
+    {
+        arena& a = arenas[s->home];
+
+        if (s->prev != NULL)
+            s->prev->next = s->next;
+        else
+            a.partial = s->next;
+        if (s->next != NULL)
+            s->next->prev = s->prev;
+        s->listed = false;
+    }
+
+    // The calling thread's cache, or NULL once it has been destroyed (blocks
+    // freed by static destructors after the thread's exit land here).
+    template<std::size_t Size, std::size_t Align>
+    typename node_pool<Size, Align>::thread_cache* node_pool<Size, Align>::local_cache( )
+    {
+        if (cache_gone( ))
+            return NULL;
+        static thread_local thread_cache cache;
+        return &cache;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    bool& node_pool<Size, Align>::cache_gone( )
+    {
+        static thread_local bool gone = false;
+        return gone;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void* node_pool<Size, Align>::allocate( )
+    {
+#if !defined(NODE_POOL_NO_THREAD_CACHE)
+        thread_cache* cache = local_cache( );
+
+        if ((cache != NULL) && (cache->loaded != NULL) && (cache->loaded->count > 0))
+            return cache->loaded->blocks[--cache->loaded->count];
+        if (cache != NULL)
+            return allocate_slow(*cache);
+#endif
+        unsigned char home = current_arena( );
+        std::lock_guard<std::mutex> guard(lock);
+
+        return take_block(home);
+    }
+
+    // Both of the thread's magazines are empty (or missing): swap in the other
+    // one, trade an empty one for a full one from the depot, or fill one from
+    // the slabs.
+    template<std::size_t Size, std::size_t Align>
+    void* node_pool<Size, Align>::allocate_slow(thread_cache& cache)
+    {
+        magazine* m;
+
+        if ((cache.previous != NULL) && (cache.previous->count > 0))
+        {
+            m = cache.loaded;
+            cache.loaded = cache.previous;
+            cache.previous = m;
+            return cache.loaded->blocks[--cache.loaded->count];
+        }
+        {
+            std::lock_guard<std::mutex> guard(depot_lock);
+            if (full_magazines[cache.home] != NULL)
+            {
+                m = full_magazines[cache.home];
+                full_magazines[cache.home] = m->next;
+                --full_count;
+                if (cache.loaded != NULL)
+                {
+                    cache.loaded->next = empty_magazines;
+                    empty_magazines = cache.loaded;
+                }
+                cache.loaded = m;
+                return m->blocks[--m->count];
+            }
+            if (cache.loaded == NULL)
+            {
+                cache.loaded = empty_magazines;
+                if (cache.loaded != NULL)
+                    empty_magazines = cache.loaded->next;
+            }
+        }
+        if (cache.loaded == NULL)
+        {
+            cache.loaded = new magazine;
+            cache.loaded->count = 0;
+        }
+
+        // Fill the magazine from the slabs under one lock.
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            m = cache.loaded;
+            while (m->count < MAGAZINE)
+                m->blocks[m->count++] = take_block(cache.home);
+        }
+        return m->blocks[--m->count];
+    }
+
+    // Takes one block from the slabs of arena home; the caller holds lock.
+    template<std::size_t Size, std::size_t Align>
+    void* node_pool<Size, Align>::take_block(unsigned char home)
+    {
+        arena& a = arenas[home];
+        void* answer;
+        slab* s;
+
+        if (a.partial != NULL)
+        {
+            // Reuse a freed block first, to keep the number of slabs low.
+            s = a.partial;
+            answer = s->free_chain;
+            s->free_chain = *static_cast<void**>(answer);
+            if (s->free_chain == NULL)
+                unlist_partial(s);
+            --free_count;
+        }
+        else
+        {
+            if ((a.bump_slab == NULL) || (a.bump_slab->bump == a.bump_slab->limit))
+                a.bump_slab = new_slab(home);
+            s = a.bump_slab;
+            answer = s->bump;
+            s->bump += BLOCK;
+        }
+        ++s->live;
+        ++live_count;
+        return answer;
+    }
+
+    // Takes the first free block of s and those after it on the chain that
+    // sit just below it in memory, as reserve and a freed run leave them;
+    // the caller holds lock.
+    template<std::size_t Size, std::size_t Align>
+    std::size_t node_pool<Size, Align>::take_chain_run(slab* s, void*& first, std::size_t wanted)
+    {
+        char* low = static_cast<char*>(s->free_chain);
+        void* next = *static_cast<void**>(s->free_chain);
+        std::size_t many = 1;
+
+        while ((many < wanted) && (next == low - BLOCK))
+        {
+            low = static_cast<char*>(next);
+            next = *static_cast<void**>(next);
+            ++many;
+        }
+        s->free_chain = next;
+        if (next == NULL)
+            unlist_partial(s);
+        s->live += many;
+        live_count += many;
+        free_count -= many;
+        first = low;
+        return many;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    std::size_t node_pool<Size, Align>::allocate_run(void*& first, std::size_t wanted)
+    {
+        unsigned char home = current_arena( );
+        std::lock_guard<std::mutex> guard(lock);
+        arena& a = arenas[home];
+        std::size_t available;
+
+        if ((reserved > 0) && (a.partial != NULL))
+            return take_chain_run(a.partial, first, wanted);
+        if ((a.bump_slab == NULL) || (a.bump_slab->bump == a.bump_slab->limit))
+        {
+            slab* old = a.bump_slab;
+            a.bump_slab = new_slab(home);
+            // The old bump slab was only kept because of its bump region.
+            if ((old != NULL) && may_release(old))
+                release_slab(old);
+        }
+        available = std::size_t(a.bump_slab->limit - a.bump_slab->bump) / BLOCK;
+        if (wanted > available)
+            wanted = available;
+        first = a.bump_slab->bump;
+        a.bump_slab->bump += wanted * BLOCK;
+        a.bump_slab->live += wanted;
+        live_count += wanted;
+        return wanted;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::deallocate(void* p)
+    {
+#if !defined(NODE_POOL_NO_THREAD_CACHE)
+        thread_cache* cache = local_cache( );
+
+        // A block of another arena goes home rather than into this thread's magazines.
+        if ((ARENAS > 1) && (cache != NULL) && (owner(p)->home != cache->home))
+            cache = NULL;
+        if ((cache != NULL) && (cache->loaded != NULL) && (cache->loaded->count < MAGAZINE))
+        {
+            cache->loaded->blocks[cache->loaded->count++] = p;
+            return;
+        }
+        if (cache != NULL)
+        {
+            deallocate_slow(*cache, p);
+            return;
+        }
+#endif
+        std::lock_guard<std::mutex> guard(lock);
+
+        free_block(p);
+    }
+
+    // Both of the thread's magazines are full (or missing): swap in the other
+    // one, or hand the full one to the depot for an empty one. Never throws.
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::deallocate_slow(thread_cache& cache, void* p)
+    {
+        magazine* m;
+        magazine* spill = NULL;
+
+        if ((cache.previous == NULL) || (cache.previous->count < MAGAZINE))
+        {
+            m = cache.loaded;
+            cache.loaded = cache.previous;
+            cache.previous = m;
+            if ((cache.loaded != NULL) && (cache.loaded->count < MAGAZINE))
+            {
+                cache.loaded->blocks[cache.loaded->count++] = p;
+                return;
+            }
+        }
+
+        // cache.loaded is full (or NULL): trade it for an empty one.
+        {
+            std::lock_guard<std::mutex> guard(depot_lock);
+            if (cache.loaded != NULL)
+            {
+                cache.loaded->next = full_magazines[cache.home];
+                full_magazines[cache.home] = cache.loaded;
+                if (++full_count > DEPOT_LIMIT)
+                {
+                    // The depot is holding too much: one goes back to the slabs.
+                    spill = full_magazines[cache.home];
+                    full_magazines[cache.home] = spill->next;
+                    --full_count;
+                }
+            }
+            m = empty_magazines;
+            if (m != NULL)
+                empty_magazines = m->next;
+        }
+        cache.loaded = NULL;
+        if (spill != NULL)
+        {
+            drain_magazine(spill);
+            if (m == NULL)
+                m = spill;
+            else
+                delete spill;
+        }
+        if (m == NULL)
+            m = new (std::nothrow) magazine;
+        if (m == NULL)
+        {
+            // No memory for a magazine: free the block directly.
+            std::lock_guard<std::mutex> guard(lock);
+            free_block(p);
+            return;
+        }
+        m->count = 0;
+        m->blocks[m->count++] = p;
+        cache.loaded = m;
+    }
+
+    // Returns every block of m to its slab, leaving m empty.
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::drain_magazine(magazine* m)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (std::size_t i = 0; i < m->count; ++i)
+            free_block(m->blocks[i]);
+        m->count = 0;
+    }
+
+    // Drains m and keeps it on the depot's empty stack.
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::empty_magazine(magazine* m)
+    {
+        drain_magazine(m);
+        std::lock_guard<std::mutex> guard(depot_lock);
+        m->next = empty_magazines;
+        empty_magazines = m;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::release_cache(thread_cache& cache)
+    {
+        if (cache.loaded != NULL)
+            empty_magazine(cache.loaded);
+        if (cache.previous != NULL)
+            empty_magazine(cache.previous);
+        cache.loaded = NULL;
+        cache.previous = NULL;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::flush_thread_cache( )
+    {
+#if !defined(NODE_POOL_NO_THREAD_CACHE)
+        thread_cache* cache = local_cache( );
+
+        if (cache != NULL)
+            release_cache(*cache);
+#endif
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::trim( )
+    {
+        magazine* m;
+
+        for (std::size_t i = 0; i < ARENAS; ++i)
+        {
+            for (;;)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(depot_lock);
+                    m = full_magazines[i];
+                    if (m == NULL)
+                        break;
+                    full_magazines[i] = m->next;
+                    --full_count;
+                }
+                empty_magazine(m);
+            }
+        }
+    }
+
+    // Carves only the shortfall, blocks - free_count, from the arena's bump
+    // slab (and new slabs after it) onto the free chains; the free blocks
+    // already there are left alone. Writing each block's link maps its page.
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::reserve(std::size_t blocks)
+    {
+        unsigned char home = current_arena( );
+        std::lock_guard<std::mutex> guard(lock);
+        arena& a = arenas[home];
+        std::size_t previous = reserved;
+        void* p;
+        slab* s;
+        slab* next;
+
+        reserved = blocks;
+        try
+        {
+            while (free_count < blocks)
+            {
+                if ((a.bump_slab == NULL) || (a.bump_slab->bump == a.bump_slab->limit))
+                    a.bump_slab = new_slab(home);
+                s = a.bump_slab;
+                p = s->bump;
+                s->bump += BLOCK;
+                *static_cast<void**>(p) = s->free_chain;
+                s->free_chain = p;
+                if (!s->listed)
+                    list_partial(s);
+                ++free_count;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            reserved = previous;
+            throw;
+        }
+
+        // A lower reservation lets go of the empty slabs it no longer needs.
+        for (std::size_t i = 0; i < ARENAS; ++i)
+        {
+            for (s = arenas[i].partial; s != NULL; s = next)
+            {
+                next = s->next;
+                if (may_release(s))
+                    release_slab(s);
+            }
+        }
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::deallocate_batch(void* const* blocks, std::size_t many)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (std::size_t i = 0; i < many; ++i)
+            free_block(blocks[i]);
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::deallocate_run(void* first, std::size_t many)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        char* start = static_cast<char*>(first);
+        slab* s;
+
+        if (many == 0)
+            return;
+        s = owner(first);
+        if ((s == arenas[s->home].bump_slab) && (start + many * BLOCK == s->bump))
+        {
+            // Nothing was carved after this run: rewind the bump region.
+            s->bump = start;
+            s->live -= many;
+            live_count -= many;
+            return;
+        }
+        for (std::size_t i = 0; i < many; ++i)
+            free_block(start + i * BLOCK);
+    }
+
+    // Puts one block on its slab's free chain; the caller holds lock.
+    template<std::size_t Size, std::size_t Align>
+    void node_pool<Size, Align>::free_block(void* p)
+    {
+        slab* s = owner(p);
+
+        *static_cast<void**>(p) = s->free_chain;
+        s->free_chain = p;
+        if (!s->listed)
+            list_partial(s);
+        --s->live;
+        --live_count;
+        ++free_count;
+        if (may_release(s))
+            release_slab(s);
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    node_pool_stats node_pool<Size, Align>::stats( ) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        node_pool_stats answer;
+
+        answer.slabs = slab_count;
+        answer.live_blocks = live_count;
+        answer.free_blocks = free_count;
+        answer.block_bytes = BLOCK;
+        answer.chunks = chunk_count[SMALL_PAGES] + chunk_count[THP] + chunk_count[HUGETLB];
+        answer.hugetlb_chunks = chunk_count[HUGETLB];
+        answer.thp_chunks = chunk_count[THP];
+        answer.bound_chunks = bound_count;
+        {
+            std::lock_guard<std::mutex> depot_guard(depot_lock);
+            answer.depot_blocks = full_count * MAGAZINE;
+        }
+        answer.arenas = 0;
+        for (std::size_t i = 0; i < ARENAS; ++i)
+        {
+            if ((arenas[i].bump_slab != NULL) || (arenas[i].partial != NULL) || (arenas[i].chunks != NULL))
+                ++answer.arenas;
+        }
+        return answer;
+    }
+
+    template<std::size_t Size, std::size_t Align>
+    std::size_t node_pool<Size, Align>::huge_page_bytes( ) const
+    {
+        std::size_t answer = 0;
+#if defined(NODE_POOL_CHUNKS)
+        std::vector<std::uintptr_t> bases;
+        std::FILE* smaps;
+        char line[256];
+        unsigned long low, high, kib;
+        bool ours = false;
+
+        {
+            // Only the chunk addresses are read under the lock; the file is
+            // parsed without it, so allocations go on meanwhile.
+            std::lock_guard<std::mutex> guard(lock);
+            for (std::size_t i = 0; i < ARENAS; ++i)
+            {
+                for (chunk* c = arenas[i].chunks; c != NULL; c = c->next)
+                    bases.push_back(reinterpret_cast<std::uintptr_t>(c->base));
+            }
+        }
+        if (bases.empty( ))
+            return 0;
+        std::sort(bases.begin( ), bases.end( ));
+        smaps = std::fopen("/proc/self/smaps", "r");
+        if (smaps == NULL)
+            return 0;
+        while (std::fgets(line, sizeof(line), smaps) != NULL)
+        {
+            if (std::sscanf(line, "%lx-%lx ", &low, &high) == 2)
+            {
+                // A new mapping: is one of our chunks inside it?
+                std::vector<std::uintptr_t>::const_iterator first =
+                    std::lower_bound(bases.begin( ), bases.end( ), std::uintptr_t(low));
+                ours = (first != bases.end( )) && (*first < high);
+            }
+            else if (ours && ((std::sscanf(line, "AnonHugePages: %lu kB", &kib) == 1) ||
+                              (std::sscanf(line, "Private_Hugetlb: %lu kB", &kib) == 1)))
+                answer += std::size_t(kib) * 1024;
+        }
+        std::fclose(smaps);
+#endif
+        return answer;
+    }
+}
@@ -0,0 +1,300 @@
+// FILE: node_pool.h
+// CLASS PROVIDED: node_pool (part of the namespace scu_coen70_6B)
+// A slab allocator for fixed-size objects, used by node<Item> (node2.h) for
+// every node it creates and destroys. There is one pool for each object size
+// and alignment, shared by the whole program.
+//
+// Memory is taken from the system in slabs of SLAB_BYTES bytes, aligned to
+// SLAB_BYTES, so the slab that owns an object is found by masking its
+// address. Each slab keeps its own chain of freed slots and a count of live
+// objects; a slab whose last object is freed is returned to the system (or
+// to its chunk; see HUGE PAGES AND NUMA below).
+// New slots come first from freed slots, then from the unused tail of the
+// most recent slab (the "bump" region), then from a new slab.
+//
+// TEMPLATE PARAMETERS:
+//   node_pool<Size, Align> hands out blocks of Size bytes aligned to Align.
+//
+// MEMBER CONSTANTS for the node_pool class:
+//   static const std::size_t SLAB_BYTES
+//     The size and alignment of a slab (64 KiB).
+//
+// STATIC MEMBER FUNCTION for the node_pool class:
+//   static node_pool& instance( )
+//     Postcondition: The return value is the program-wide pool for this size
+//     and alignment. It is never destroyed, so objects may be freed during
+//     static destruction.
+//
+// MODIFICATION MEMBER FUNCTIONS for the node_pool class:
+//   void* allocate( )
+//     Postcondition: The return value is an uninitialized block of Size
+//     bytes. Throws bad_alloc if no memory is available.
+//
+//   void deallocate(void* p)
+//     Precondition: p came from allocate or allocate_run of this pool, and has
+//     not been freed since.
+//     Postcondition: The block has been returned to the pool.
+//
+//   void flush_thread_cache( )
+//     Postcondition: The blocks cached by the calling thread (see THREAD
+//     CACHES below) have been returned to their slabs.
+//
+//   void trim( )
+//     Postcondition: The blocks held in the shared depot have been returned
+//     to their slabs, so that empty slabs can go back to the system.
+//
+//   void reserve(std::size_t blocks)
+//     Postcondition: At least blocks free blocks wait in the pool's slabs,
+//     already written to, so their pages are mapped, and the pool keeps at
+//     least that many from now on: a slab that becomes empty goes back to the
+//     system only if as many free blocks would remain without it. Until more
+//     than blocks are live at once, allocating (or refilling a magazine)
+//     then never calls the system allocator or takes a page fault. A smaller
+//     value (0 ends the reservation) returns the empty slabs no longer
+//     needed. Throws bad_alloc, keeping the previous reservation, if the
+//     memory cannot be found.
+//
+//   void deallocate_batch(void* const* blocks, std::size_t many)
+//     Precondition: Each of the many blocks could be passed to deallocate.
+//     Postcondition: All of them have been returned, under a single lock.
+//
+//   std::size_t allocate_run(void*& first, std::size_t wanted)
+//     Precondition: wanted > 0.
+//     Postcondition: first points to k consecutive blocks, where k is the
+//     return value (1 <= k <= wanted), all taken from the bump region. Runs
+//     taken one after another with no other allocation in between are
+//     adjacent in memory unless a new slab had to be started, so a caller
+//     can lay out a long chain of objects in address order. Every block of
+//     the run must eventually be passed to deallocate (or deallocate_run).
+//     While a reservation is in force (see reserve) and the calling thread's
+//     arena has free blocks, the run is taken from them instead, so copies
+//     use the reserved blocks rather than new slabs: the blocks reserve
+//     carved come back in runs as long as it carved them, other free blocks
+//     possibly one at a time.
+//
+//   void deallocate_run(void* first, std::size_t many)
+//     Precondition: first points to many consecutive, unused blocks at the
+//     end of a run from allocate_run.
+//     Postcondition: The blocks have been returned. If nothing was taken from
+//     the bump region since, they go back to it, so the next run continues
+//     exactly where the used part of this one ended.
+//
+// CONSTANT MEMBER FUNCTIONS for the node_pool class:
+//   node_pool_stats stats( ) const
+//     Postcondition: The return value describes the slabs and blocks that
+//     the pool currently holds, and the chunks they were carved from.
+//
+//   std::size_t huge_page_bytes( ) const
+//     Postcondition: The return value is how many bytes the kernel currently
+//     backs with huge pages in the mappings that hold the pool's chunks,
+//     read from /proc/self/smaps (AnonHugePages plus hugetlb pages). The
+//     kernel may merge neighbouring chunks of several pools into one mapping,
+//     which is then counted whole. It is 0 without chunks, or where that
+//     file cannot be read. This scans a file, so it is slow, but the pool
+//     is locked only while the chunk addresses are copied out, not while
+//     the file is read. Throws bad_alloc if that copy cannot be made.
+//
+// HUGE PAGES AND NUMA (Linux only, both off by default):
+//   NODE_POOL_HUGE_PAGES
+//     Slabs are carved from 2 MiB chunks instead of being allocated one by
+//     one. A chunk is mapped with MAP_HUGETLB when the system has reserved
+//     huge pages; otherwise it is mapped 2 MiB aligned and marked with
+//     madvise(MADV_HUGEPAGE) so transparent huge pages can back it; if that
+//     is refused too, it stays on normal pages. A traversal of a large list
+//     then touches one TLB entry per 2 MiB instead of one per 4 KiB.
+//   NODE_POOL_NUMA
+//     The pool keeps a separate arena (partial list, bump region and
+//     chunks) for each NUMA node. A thread allocates from the arena of the
+//     node it first ran on, and new chunks of that arena are bound to that
+//     node with mbind (as a preference, so a full node still falls back to
+//     the others). There are 8 arenas: on a machine with more nodes, node i
+//     shares arena i % 8, and chunks mapped from a node of 8 or more are not
+//     bound (they take the default first-touch placement): binding them
+//     to the arena's own node would make them remote for the thread that
+//     asked for them. Slabs are carved from chunks as above, even without
+//     NODE_POOL_HUGE_PAGES. Freed blocks always return to their own arena.
+//   stats( ) reports how the chunks were obtained, so a program can check
+//   that the layout it asked for is the one it got.
+//
+// THREAD CACHES:
+//   allocate and deallocate normally do not lock the pool. Each thread keeps
+//   two "magazines" of up to MAGAZINE free blocks per pool: allocate pops a
+//   block from them and deallocate pushes one. Only when both are empty (or
+//   both full) does the thread trade a whole magazine with a shared depot
+//   of full magazines, under a short lock of its own, and only when the
+//   depot has none does it lock the pool to fill a magazine from the slabs
+//   (or, with more than DEPOT_LIMIT full magazines waiting, to empty one
+//   into them). So threads that each churn their own sequences rarely meet
+//   on a lock, and a block freed by another thread is reused through the
+//   depot. A thread's magazines are returned to the slabs when it exits.
+//   With NODE_POOL_NUMA, magazines never carry blocks between arenas: a
+//   thread's magazines hold blocks of its own arena only, the depot keeps
+//   one list of full magazines per arena, and a block freed by a thread of
+//   another arena goes straight back to its slab, under the pool's lock.
+//   That costs a read of the block's slab header on every deallocate, and
+//   a lock for each cross-node free, which a program that hands nodes
+//   between NUMA nodes pays instead of getting remote memory later.
+//   Blocks sitting in caches still count as live_blocks in stats( ); the
+//   depot's share is reported as depot_blocks. allocate_run, deallocate_run
+//   and deallocate_batch go to the slabs directly, as before.
+//   Compile with NODE_POOL_NO_THREAD_CACHE to turn the caches off (every
+//   allocate and deallocate then locks the pool, as before).
+//
+// THREAD SAFETY:
+//   Every member function may be called from any thread; the pool and its
+//   depot are guarded by mutexes, and each thread cache is used only by its
+//   own thread.
+
+#ifndef COEN_70_NODE_POOL_H
+#define COEN_70_NODE_POOL_H
+#include <cstdlib>  // Provides size_t
+#include <cstdint>  // Provides uint32_t
+#include <mutex>    // Provides mutex
+
+#if (defined(NODE_POOL_HUGE_PAGES) || defined(NODE_POOL_NUMA)) && defined(__linux__)
+#define NODE_POOL_CHUNKS 1
+#endif
+
+namespace scu_coen70_6B
+{
+    struct node_pool_stats
+    {
+        std::size_t slabs;          // Slabs currently held
+        std::size_t live_blocks;    // Blocks handed out and not yet freed
+        std::size_t free_blocks;    // Freed blocks waiting in slab free chains
+        std::size_t block_bytes;    // Bytes per block, including padding
+        std::size_t chunks;         // 2 MiB chunks mapped (0 unless configured)
+        std::size_t hugetlb_chunks; // ... of which are MAP_HUGETLB pages
+        std::size_t thp_chunks;     // ... of which are madvised for THP
+        std::size_t bound_chunks;   // ... of which are bound to a NUMA node
+        std::size_t arenas;         // Arenas (NUMA nodes) holding slabs
+        std::size_t depot_blocks;   // Free blocks in the depot's magazines
+    };
+
+    template<std::size_t Size, std::size_t Align>
+    class node_pool
+    {
+    public:
+        // MEMBER CONSTANTS
+        static const std::size_t SLAB_BYTES = 64 * 1024;
+        static const std::size_t MAGAZINE = 64;
+        static const std::size_t DEPOT_LIMIT = 256;
+        // STATIC MEMBER FUNCTION
+        static node_pool& instance( );
+        // MODIFICATION MEMBER FUNCTIONS
+        void* allocate( );
+        void deallocate(void* p);
+        void deallocate_batch(void* const* blocks, std::size_t many);
+        std::size_t allocate_run(void*& first, std::size_t wanted);
+        void deallocate_run(void* first, std::size_t many);
+        void flush_thread_cache( );
+        void trim( );
+        void reserve(std::size_t blocks);
+        // CONSTANT MEMBER FUNCTIONS
+        node_pool_stats stats( ) const;
+        std::size_t huge_page_bytes( ) const;
+    private:
+        struct chunk;
+        struct slab
+        {
+            void* free_chain;       // Freed blocks of this slab
+            std::size_t live;       // Blocks of this slab in use
+            char* bump;             // Next never-used block
+            char* limit;            // End of the usable blocks
+            slab* prev;             // Neighbours in the partial list
+            slab* next;
+            bool listed;            // On the partial list?
+            unsigned char home;     // Index of the arena it belongs to
+            chunk* from;            // Chunk it was carved from, or NULL
+        };
+        struct chunk
+        {
+            char* base;             // CHUNK_BYTES bytes, CHUNK_BYTES aligned
+            std::uint32_t unused;   // Bit i set: slab i of the chunk is free
+            chunk* prev;            // Neighbours in the arena's chunk list
+            chunk* next;
+            unsigned char backing;  // HUGETLB, THP or SMALL_PAGES
+            bool bound;             // Bound to the arena's NUMA node?
+        };
+        struct arena
+        {
+            slab* partial;          // Slabs with a non-empty free_chain
+            slab* bump_slab;        // Slab whose bump region is in use
+            chunk* chunks;          // Chunks with free slabs come first
+        };
+        struct magazine
+        {
+            magazine* next;         // Neighbour in a depot list
+            std::size_t count;      // blocks[0 .. count-1] are free blocks
+            void* blocks[MAGAZINE];
+        };
+        struct thread_cache
+        {
+            magazine* loaded;       // Magazine used first, or NULL
+            magazine* previous;     // The other one, or NULL
+            unsigned char home;     // Arena whose blocks the magazines hold
+            thread_cache( ) : loaded(NULL), previous(NULL), home(current_arena( )) { }
+            ~thread_cache( )
+            {
+                instance( ).release_cache(*this);
+                cache_gone( ) = true;
+            }
+        };
+        enum { SMALL_PAGES, THP, HUGETLB };
+
+        // Block size and offset of the first block, rounded up to Align.
+        static const std::size_t BLOCK = ((Size < sizeof(void*) ? sizeof(void*) : Size) + Align - 1) / Align * Align;
+        static const std::size_t FIRST = (sizeof(slab) + Align - 1) / Align * Align;
+        static const std::size_t CHUNK_BYTES = 2 * 1024 * 1024;
+        static const std::size_t SLABS_PER_CHUNK = CHUNK_BYTES / SLAB_BYTES;
+        static const std::uint32_t ALL_SLABS = 0xFFFFFFFFu >> (32 - SLABS_PER_CHUNK);
+#if defined(NODE_POOL_NUMA) && defined(__linux__)
+        static const std::size_t ARENAS = 8;
+#else
+        static const std::size_t ARENAS = 1;
+#endif
+
+        mutable std::mutex lock;
+        mutable std::mutex depot_lock;
+        magazine* full_magazines[ARENAS];   // Depot: full magazines by arena, guarded by depot_lock
+        magazine* empty_magazines;  // Depot: empty magazines, guarded by depot_lock
+        std::size_t full_count;
+        arena arenas[ARENAS];
+        std::size_t slab_count;
+        std::size_t live_count;
+        std::size_t free_count;
+        std::size_t reserved;       // Free blocks kept by reserve
+        std::size_t chunk_count[3]; // Chunks held, by backing
+        std::size_t bound_count;
+
+        node_pool( );
+        node_pool(const node_pool&);
+        void operator =(const node_pool&);
+        slab* new_slab(unsigned char home);
+        void release_slab(slab* s);
+        bool may_release(slab* s) const;
+        static std::size_t used_blocks(const slab* s);
+        void list_partial(slab* s);
+        void unlist_partial(slab* s);
+        void free_block(void* p);
+        void* take_block(unsigned char home);
+        std::size_t take_chain_run(slab* s, void*& first, std::size_t wanted);
+        void* allocate_slow(thread_cache& cache);
+        void deallocate_slow(thread_cache& cache, void* p);
+        void release_cache(thread_cache& cache);
+        void empty_magazine(magazine* m);
+        void drain_magazine(magazine* m);
+        static thread_cache* local_cache( );
+        static bool& cache_gone( );
+        void* carve_slab(unsigned char home, chunk*& from);
+        void return_slab(slab* s);
+        chunk* map_chunk(unsigned char home);
+        void unlink_chunk(arena& a, chunk* c);
+        void push_chunk(arena& a, chunk* c, bool in_front);
+        static slab* owner(void* p);
+        static unsigned current_node( );
+        static unsigned char current_arena( );
+    };
+}
+#include "node_pool.cxx"
+#endif
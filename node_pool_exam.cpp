@@ -0,0 +1,565 @@
+// FILE: node_pool_exam.cpp
+// Non-interactive test program for the node_pool class (see node_pool.h),
+// including its thread caches and, when they are compiled in, its huge-page
+// chunks and NUMA arenas.
+//
+// DESCRIPTION:
+// Each function of this program tests part of the node_pool class,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. Every
+// pool used here has a block size that nothing else in the program uses,
+// so the counts stats( ) reports belong to the test alone. Blocks are
+// written with a tag of their owner when handed out and checked before
+// they are freed, so a block handed to two owners at once is caught. The
+// same program checks whichever configuration it is compiled in:
+//     g++ -std=c++17 -O2 -pthread node_pool_exam.cpp -o node_pool_exam
+//     g++ -std=c++17 -O2 -pthread -DNODE_POOL_HUGE_PAGES -DNODE_POOL_NUMA node_pool_exam.cpp -o node_pool_exam
+//     g++ -std=c++17 -O2 -pthread -DNODE_POOL_NO_THREAD_CACHE node_pool_exam.cpp -o node_pool_exam
+// With chunks, the layout they got (huge pages, NUMA binding) depends on
+// the machine, so it is printed rather than required; what is required is
+// that every slab lies in a chunk and that empty chunks are unmapped. The
+// program returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     (one of the lines above)
+//     ./node_pool_exam
+
+#include <iostream>         // Provides cout.
+#include <cstdlib>          // Provides size_t.
+#include <cstdint>          // Provides uintptr_t.
+#include <mutex>            // Provides mutex, lock_guard.
+#include <random>           // Provides mt19937 for the random frees.
+#include <set>              // Provides set, for counting distinct regions.
+#include <thread>           // Provides thread.
+#include <vector>           // Provides vector for the blocks.
+#include "node_pool.h"      // Provides the node_pool class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the node_pool class",
+    "Testing allocate, deallocate, the stats and the thread caches",
+    "Testing reserve, allocate_run and deallocate_run",
+    "Testing the chunks of the huge-page and NUMA builds",
+    "Testing many threads allocating, and freeing each other's blocks"
+};
+
+// The pools under test, one per test, each with a size of its own.
+typedef node_pool<40, 8> pool1;
+typedef node_pool<56, 8> pool2;
+typedef node_pool<64, 64> pool3;
+typedef node_pool<104, 8> pool4;
+
+const size_t CHUNK_BYTES = 2 * 1024 * 1024;
+
+
+// **************************************************************************
+// void tag(void* block, size_t owner)
+// bool tagged(const void* block, size_t owner)
+//   Postcondition: tag writes owner into the first word of block and its
+//   complement into the second; tagged returns true if block still holds
+//   what tag(block, owner) wrote.
+// **************************************************************************
+void tag(void* block, size_t owner)
+{
+    static_cast<size_t*>(block)[0] = owner;
+    static_cast<size_t*>(block)[1] = ~owner;
+}
+
+bool tagged(const void* block, size_t owner)
+{
+    return (static_cast<const size_t*>(block)[0] == owner) && (static_cast<const size_t*>(block)[1] == ~owner);
+}
+
+
+// **************************************************************************
+// template<class Pool>
+// bool all_returned(Pool& pool)
+//   Postcondition: The calling thread's cache and the depot have been
+//   returned to the slabs, and the return value is true if nothing is live
+//   and at most one slab (the bump slab) and one chunk are kept. Otherwise
+//   a message has been printed.
+// **************************************************************************
+template<class Pool>
+bool all_returned(Pool& pool)
+{
+    node_pool_stats now;
+
+    pool.flush_thread_cache( );
+    pool.trim( );
+    now = pool.stats( );
+    if ((now.live_blocks != 0) || (now.depot_blocks != 0) || (now.slabs > 1) || (now.chunks > 1))
+    {
+        cout << "After every block was freed, " << now.live_blocks << " were live, ";
+        cout << now.depot_blocks << " in the depot, and " << now.slabs << " slabs and ";
+        cout << now.chunks << " chunks kept." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Allocates 50000 blocks and checks that they are aligned, distinct and
+//   counted by stats( ); frees them and checks that the slabs go back; and
+//   checks that the thread cache takes a whole magazine from the slabs,
+//   keeps freed blocks, and trades full magazines with the depot. Returns
+//   POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    pool1& pool = pool1::instance( );
+    vector<void*> blocks;
+    node_pool_stats now;
+    size_t i;
+
+    cout << "Checking 50000 blocks ... ";
+    cout.flush( );
+    for (i = 0; i < 50000; ++i)
+    {
+        blocks.push_back(pool.allocate( ));
+        if (reinterpret_cast<uintptr_t>(blocks.back( )) % 8 != 0)
+        {
+            cout << "Block " << i << " is not aligned to 8 bytes." << endl;
+            return 0;
+        }
+        tag(blocks.back( ), i);
+    }
+    now = pool.stats( );
+    if ((now.block_bytes != 40) || (now.live_blocks < 50000) || (now.live_blocks > 50000 + 2 * pool1::MAGAZINE)
+        || (now.slabs * pool1::SLAB_BYTES < 50000 * 40) || (now.arenas != 1))
+    {
+        cout << "stats( ) reported " << now.live_blocks << " live blocks of " << now.block_bytes;
+        cout << " bytes in " << now.slabs << " slabs and " << now.arenas << " arenas." << endl;
+        return 0;
+    }
+    for (i = 0; i < blocks.size( ); ++i)
+    {
+        if (!tagged(blocks[i], i))
+        {
+            cout << "Block " << i << " was handed out twice." << endl;
+            return 0;
+        }
+    }
+    for (i = 0; i < blocks.size( ); ++i)
+        pool.deallocate(blocks[i]);
+    blocks.clear( );
+    if (!all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+
+#if !defined(NODE_POOL_NO_THREAD_CACHE)
+    cout << "Checking the magazines ... ";
+    cout.flush( );
+    {
+        const size_t MAGAZINE = pool1::MAGAZINE;
+
+        blocks.push_back(pool.allocate( ));
+        if (pool.stats( ).live_blocks != MAGAZINE)
+        {
+            cout << "One allocate took " << pool.stats( ).live_blocks << " blocks from the slabs." << endl;
+            return 0;
+        }
+        pool.deallocate(blocks.back( ));
+        blocks.clear( );
+        if (pool.stats( ).live_blocks != MAGAZINE)
+        {
+            cout << "A freed block did not stay in the thread's magazine." << endl;
+            return 0;
+        }
+        for (i = 0; i < 5 * MAGAZINE; ++i)
+            blocks.push_back(pool.allocate( ));
+        for (i = 0; i < blocks.size( ); ++i)
+            pool.deallocate(blocks[i]);
+        blocks.clear( );
+        // Two magazines stay with the thread; the others went to the depot.
+        if ((pool.stats( ).depot_blocks == 0) || (pool.stats( ).depot_blocks % MAGAZINE != 0))
+        {
+            cout << "Freeing " << 5 * MAGAZINE << " blocks left " << pool.stats( ).depot_blocks;
+            cout << " in the depot." << endl;
+            return 0;
+        }
+    }
+    if (!all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+#else
+    cout << "Checking that allocate takes one block at a time ... ";
+    cout.flush( );
+    blocks.push_back(pool.allocate( ));
+    if (pool.stats( ).live_blocks != 1)
+    {
+        cout << "Without thread caches, one allocate took " << pool.stats( ).live_blocks << " blocks." << endl;
+        return 0;
+    }
+    pool.deallocate(blocks.back( ));
+    blocks.clear( );
+    if (!all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+#endif
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Reserves 20000 blocks and checks that they are free and stay in the
+//   pool through a round of allocating and freeing them; that allocate_run
+//   gives consecutive blocks, taken from the reserve while it lasts; that
+//   deallocate_run returns them; and that reserve(0) gives the empty slabs
+//   back. Returns POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    pool2& pool = pool2::instance( );
+    const size_t BLOCK = 56;
+    vector<void*> blocks;
+    node_pool_stats now;
+    size_t slabs;
+    size_t i;
+
+    cout << "Checking reserve ... ";
+    cout.flush( );
+    pool.reserve(20000);
+    now = pool.stats( );
+    slabs = now.slabs;
+    if ((now.free_blocks < 20000) || (now.live_blocks != 0))
+    {
+        cout << "reserve(20000) left " << now.free_blocks << " free blocks." << endl;
+        return 0;
+    }
+    for (i = 0; i < 20000; ++i)
+    {
+        blocks.push_back(pool.allocate( ));
+        tag(blocks.back( ), i);
+    }
+    if (pool.stats( ).slabs != slabs)
+    {
+        cout << "Allocating the reserved blocks took new slabs." << endl;
+        return 0;
+    }
+    for (i = 0; i < blocks.size( ); ++i)
+    {
+        if (!tagged(blocks[i], i))
+        {
+            cout << "A reserved block was handed out twice." << endl;
+            return 0;
+        }
+        pool.deallocate(blocks[i]);
+    }
+    blocks.clear( );
+    pool.flush_thread_cache( );
+    pool.trim( );
+    now = pool.stats( );
+    if ((now.slabs != slabs) || (now.free_blocks < 20000))
+    {
+        cout << "Freeing the reserved blocks gave " << slabs - now.slabs << " slabs back." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking allocate_run and deallocate_run ... ";
+    cout.flush( );
+    {
+        size_t total = 0;
+        vector<pair<void*, size_t> > runs;
+
+        while (total < 5000)
+        {
+            void* first = NULL;
+            size_t many = pool.allocate_run(first, 700);
+
+            if ((many < 1) || (many > 700) || (reinterpret_cast<uintptr_t>(first) % 8 != 0))
+            {
+                cout << "allocate_run gave a run of " << many << " blocks." << endl;
+                return 0;
+            }
+            for (i = 0; i < many; ++i)
+                tag(static_cast<char*>(first) + i * BLOCK, total + i);
+            runs.push_back(pair<void*, size_t>(first, many));
+            total += many;
+        }
+        if (pool.stats( ).slabs != slabs)
+        {
+            cout << "Runs taken while the reserve lasted took new slabs." << endl;
+            return 0;
+        }
+        total = 0;
+        for (i = 0; i < runs.size( ); ++i)
+        {
+            for (size_t j = 0; j < runs[i].second; ++j)
+            {
+                if (!tagged(static_cast<char*>(runs[i].first) + j * BLOCK, total + j))
+                {
+                    cout << "Two runs overlapped." << endl;
+                    return 0;
+                }
+            }
+            total += runs[i].second;
+            pool.deallocate_run(runs[i].first, runs[i].second);
+        }
+        if (pool.stats( ).live_blocks != 0)
+        {
+            cout << "deallocate_run left " << pool.stats( ).live_blocks << " blocks live." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking reserve(0) ... ";
+    cout.flush( );
+    pool.reserve(0);
+    if (!all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Allocates 48 MiB of blocks. With chunks, checks that the blocks lie in
+//   no more 2 MiB regions than there are chunks (so every slab was carved
+//   from an aligned chunk), that the backing counts add up, and prints the
+//   layout the machine gave; then frees the blocks and checks that empty
+//   chunks were unmapped. Without chunks, checks that none are reported.
+//   Returns POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    pool3& pool = pool3::instance( );
+    const size_t MANY = 48 * 1024 * 1024 / 64;
+    vector<void*> blocks;
+    set<uintptr_t> regions;
+    node_pool_stats now;
+    size_t i;
+
+    cout << "Checking the chunks holding 48 MiB of blocks ... ";
+    cout.flush( );
+    for (i = 0; i < MANY; ++i)
+    {
+        blocks.push_back(pool.allocate( ));
+        if (reinterpret_cast<uintptr_t>(blocks.back( )) % 64 != 0)
+        {
+            cout << "Block " << i << " is not aligned to 64 bytes." << endl;
+            return 0;
+        }
+        tag(blocks.back( ), i);
+        regions.insert(reinterpret_cast<uintptr_t>(blocks.back( )) / CHUNK_BYTES);
+    }
+    now = pool.stats( );
+#if defined(NODE_POOL_CHUNKS)
+    if ((now.chunks < MANY * 64 / CHUNK_BYTES) || (regions.size( ) > now.chunks)
+        || (now.hugetlb_chunks + now.thp_chunks > now.chunks) || (now.bound_chunks > now.chunks)
+        || (now.slabs > now.chunks * (CHUNK_BYTES / pool3::SLAB_BYTES)))
+    {
+        cout << now.slabs << " slabs in " << regions.size( ) << " regions of 2 MiB do not fit ";
+        cout << now.chunks << " chunks." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+    cout << "    " << now.chunks << " chunks: " << now.hugetlb_chunks << " hugetlb, ";
+    cout << now.thp_chunks << " madvised for THP, " << now.bound_chunks << " bound to a NUMA node; ";
+    cout << pool.huge_page_bytes( ) / (1024 * 1024) << " MiB on huge pages now." << endl;
+#else
+    if ((now.chunks != 0) || (now.hugetlb_chunks != 0) || (now.thp_chunks != 0) || (now.bound_chunks != 0)
+        || (pool.huge_page_bytes( ) != 0))
+    {
+        cout << "A build without chunks reported " << now.chunks << " chunks." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+    cout << "    (Built without NODE_POOL_HUGE_PAGES or NODE_POOL_NUMA, so there are no chunks.)" << endl;
+#endif
+
+    cout << "Checking that empty chunks are unmapped ... ";
+    cout.flush( );
+    for (i = 0; i < blocks.size( ); ++i)
+    {
+        if (!tagged(blocks[i], i))
+        {
+            cout << "Block " << i << " was handed out twice." << endl;
+            return 0;
+        }
+        pool.deallocate(blocks[i]);
+    }
+    blocks.clear( );
+    if (!all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// A mailbox through which the threads of test4 pass blocks to each other.
+struct mailbox
+{
+    mutex lock;
+    vector<pair<void*, size_t> > blocks;
+};
+
+
+// **************************************************************************
+// void churn(mailbox& mail, size_t id, bool& failed)
+//   Postcondition: The calling thread has allocated 200000 blocks of pool4,
+//   tagged each with a number unique to the thread and the block, and freed
+//   each block itself or put it in the mailbox for another thread; it has
+//   freed the blocks other threads put there, checking their tags. failed
+//   has been set to true if a tag was wrong.
+// **************************************************************************
+void churn(mailbox& mail, size_t id, bool& failed)
+{
+    pool4& pool = pool4::instance( );
+    mt19937 dice(static_cast<unsigned>(id));
+    vector<pair<void*, size_t> > mine;
+
+    for (size_t i = 0; i < 200000; ++i)
+    {
+        size_t owner = (id << 32) | i;
+        void* block = pool.allocate( );
+
+        tag(block, owner);
+        mine.push_back(pair<void*, size_t>(block, owner));
+        if ((mine.size( ) > 500) || (dice( ) % 4 == 0))
+        {
+            size_t k = dice( ) % mine.size( );
+            pair<void*, size_t> chosen = mine[k];
+
+            mine[k] = mine.back( );
+            mine.pop_back( );
+            if (dice( ) % 2 == 0)
+            {
+                if (!tagged(chosen.first, chosen.second))
+                    failed = true;
+                pool.deallocate(chosen.first);
+            }
+            else
+            {
+                lock_guard<mutex> guard(mail.lock);
+                mail.blocks.push_back(chosen);
+            }
+        }
+        if (i % 64 == 0)
+        {
+            vector<pair<void*, size_t> > received;
+            {
+                lock_guard<mutex> guard(mail.lock);
+                received.swap(mail.blocks);
+            }
+            for (size_t j = 0; j < received.size( ); ++j)
+            {
+                if (!tagged(received[j].first, received[j].second))
+                    failed = true;
+                pool.deallocate(received[j].first);
+            }
+        }
+    }
+    for (size_t j = 0; j < mine.size( ); ++j)
+    {
+        if (!tagged(mine[j].first, mine[j].second))
+            failed = true;
+        pool.deallocate(mine[j].first);
+    }
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Runs 8 threads that allocate blocks and free them, about half of them
+//   in another thread, checking every tag; then checks that once the
+//   threads have exited (returning their caches) every block is back.
+//   Returns POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    pool4& pool = pool4::instance( );
+    mailbox mail;
+    vector<thread> threads;
+    bool failed[8] = { false, false, false, false, false, false, false, false };
+    size_t i;
+
+    cout << "Checking 8 threads passing blocks to each other ... ";
+    cout.flush( );
+    for (i = 0; i < 8; ++i)
+        threads.push_back(thread(churn, ref(mail), i + 1, ref(failed[i])));
+    for (i = 0; i < threads.size( ); ++i)
+        threads[i].join( );
+    for (i = 0; i < mail.blocks.size( ); ++i)
+    {
+        if (!tagged(mail.blocks[i].first, mail.blocks[i].second))
+            failed[0] = true;
+        pool.deallocate(mail.blocks[i].first);
+    }
+    for (i = 0; i < 8; ++i)
+    {
+        if (failed[i])
+        {
+            cout << "Thread " << i + 1 << " found a block that another owner had written." << endl;
+            return 0;
+        }
+    }
+    if ((pool.stats( ).arenas < 1) || !all_returned(pool))
+        return 0;
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
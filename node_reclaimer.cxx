@@ -0,0 +1,142 @@
+// FILE: node_reclaimer.cxx
+// CLASS IMPLEMENTED: node_reclaimer (see node_reclaimer.h for documentation)
+// INVARIANT for the node_reclaimer class:
+//   1. queue holds the lists retired since the thread last looked; working
+//      holds the lists the thread is freeing now (only the thread touches it
+//      while lock is released).
+//
+//   2. list_count and node_count cover the lists in both vectors; they drop
+//      only after a whole batch has been freed, and work_done is then
+//      notified.
+//
+//   3. Once stopping is true, the thread empties queue and then returns.
+//      Every member except working is guarded by lock.
+
+#include <new>        // Provides bad_alloc
+#if defined(__linux__)
+#include <sys/resource.h>  // Provides setpriority
+#include <sys/syscall.h>   // Provides SYS_gettid
+#include <unistd.h>        // Provides syscall
+#endif
+
+namespace scu_coen70_6B
+{
+    inline node_reclaimer::node_reclaimer( )
+    {
+        list_count = 0;
+        node_count = 0;
+        stopping = false;
+        worker = std::thread(&node_reclaimer::run, this);
+    }
+
+    inline node_reclaimer::~node_reclaimer( )
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        work_ready.notify_one( );
+        worker.join( );
+    }
+
+    inline node_reclaimer& node_reclaimer::instance( )
+    {
+        // Deliberately leaked, like node_pool::instance( ): sequences cleared
+        // during static destruction may still retire lists to it.
+        static node_reclaimer* the_reclaimer = new node_reclaimer;
+        return *the_reclaimer;
+    }
+
+    template<class Item>
+    void node_reclaimer::clear_list(void* head)
+    {
+        node<Item>* head_ptr = static_cast<node<Item>*>(head);
+
+        list_clear(head_ptr);
+    }
+
+    template<class Item>
+    void node_reclaimer::retire(node<Item>*& head_ptr, std::size_t many)
+    {
+        job retired;
+
+        if (head_ptr == NULL)
+            return;
+        retired.head = head_ptr;
+        retired.many = many;
+        retired.clear = &clear_list<Item>;
+        try
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back(retired);
+            ++list_count;
+            node_count += many;
+        }
+        catch (const std::bad_alloc&)
+        {
+            // No room to queue it: free it here instead.
+            list_clear(head_ptr);
+            return;
+        }
+        head_ptr = NULL;
+        work_ready.notify_one( );
+    }
+
+    inline void node_reclaimer::drain( )
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        while (list_count > 0)
+            work_done.wait(guard);
+    }
+
+    inline std::size_t node_reclaimer::pending_lists( ) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        return list_count;
+    }
+
+    inline std::size_t node_reclaimer::pending_nodes( ) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        return node_count;
+    }
+
+    inline void node_reclaimer::run( )
+    {
+        std::size_t freed_nodes;
+
+#if defined(__linux__)
+        // Yield the CPU to the threads whose frees this one takes over (on
+        // Linux, a nice value applies to a single thread).
+        setpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)), 19);
+#endif
+        std::unique_lock<std::mutex> guard(lock);
+
+        for (;;)
+        {
+            while (queue.empty( ) && !stopping)
+                work_ready.wait(guard);
+            if (queue.empty( ))
+                return;
+
+            // Take the whole queue and free it without holding the lock.
+            working.swap(queue);
+            guard.unlock( );
+            freed_nodes = 0;
+            for (std::size_t i = 0; i < working.size( ); ++i)
+            {
+                working[i].clear(working[i].head);
+                freed_nodes += working[i].many;
+            }
+            guard.lock( );
+
+            list_count -= working.size( );
+            node_count -= freed_nodes;
+            working.clear( );
+            work_done.notify_all( );
+        }
+    }
+}
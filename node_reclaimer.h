@@ -0,0 +1,109 @@
+// FILE: node_reclaimer.h
+// CLASS PROVIDED: node_reclaimer (part of the namespace scu_coen70_6B)
+// A background thread that frees whole linked lists (node2.h) handed to it,
+// so that a thread which must not stall can drop a list of any length in
+// O(1): it gives up the head pointer, and the reclaimer's thread later runs
+// list_clear on it. The usual way in is sequence::clear_deferred( ):
+//
+//     sequence<order> book;                // millions of orders
+//     ...
+//     book.clear_deferred( );              // O(1); book is now empty
+//
+// Destroying a sequence that has been cleared this way is O(1) as well, so
+// calling clear_deferred( ) just before a large sequence goes out of scope
+// moves its whole teardown off the calling thread.
+//
+// CONSTRUCTOR and DESTRUCTOR for the node_reclaimer class:
+//   node_reclaimer( )
+//     Postcondition: The reclaimer's thread has been started, with nothing
+//     to free.
+//
+//   ~node_reclaimer( )
+//     Postcondition: Every list retired to this reclaimer has been freed, and
+//     its thread has finished.
+//
+// STATIC MEMBER FUNCTION for the node_reclaimer class:
+//   static node_reclaimer& instance( )
+//     Postcondition: The return value is a program-wide reclaimer, started
+//     on first use. Like node_pool::instance( ) it is never destroyed, so
+//     lists still waiting when the program exits are not freed; call drain( )
+//     first if their Item destructors must run.
+//
+// MODIFICATION MEMBER FUNCTIONS for the node_reclaimer class:
+//   template<class Item>
+//   void retire(node<Item>*& head_ptr, std::size_t many = 0)
+//     Precondition: head_ptr is the head pointer of a linked list that no
+//     other code will use again. many is its length if known (it is only
+//     used by pending_nodes( )).
+//     Postcondition: The list will be freed by the reclaimer's thread, and
+//     head_ptr is NULL. This takes O(1) and does not wait for the thread.
+//     (If no memory can be found to queue the list, it is freed at once.)
+//
+//   void drain( )
+//     Postcondition: Every list retired before the call has been freed.
+//
+// CONSTANT MEMBER FUNCTIONS for the node_reclaimer class:
+//   std::size_t pending_lists( ) const
+//   std::size_t pending_nodes( ) const
+//     Postcondition: The return value is the number of retired lists (or the
+//     sum of their many arguments) that have not been freed yet.
+//
+// THREAD SAFETY:
+//   Every member function may be called from any thread. Item's destructor
+//   runs on the reclaimer's thread. On Linux that thread runs at nice 19, so
+//   on a busy machine it waits for the threads it frees nodes for instead of
+//   preempting them.
+
+#ifndef COEN_70_NODE_RECLAIMER_H
+#define COEN_70_NODE_RECLAIMER_H
+#include <cstdlib>              // Provides size_t
+#include <condition_variable>   // Provides condition_variable
+#include <mutex>                // Provides mutex
+#include <thread>               // Provides thread
+#include <vector>               // Provides vector
+#include "node2.h"              // Provides node and list_clear
+
+namespace scu_coen70_6B
+{
+    class node_reclaimer
+    {
+    public:
+        // CONSTRUCTOR and DESTRUCTOR
+        node_reclaimer( );
+        ~node_reclaimer( );
+        // STATIC MEMBER FUNCTION
+        static node_reclaimer& instance( );
+        // MODIFICATION MEMBER FUNCTIONS
+        template<class Item>
+        void retire(node<Item>*& head_ptr, std::size_t many = 0);
+        void drain( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::size_t pending_lists( ) const;
+        std::size_t pending_nodes( ) const;
+    private:
+        struct job
+        {
+            void* head;                 // Head of the list, as a node<Item>*
+            std::size_t many;           // Its length, as given to retire
+            void (*clear)(void* head);  // list_clear for the right Item
+        };
+
+        mutable std::mutex lock;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+        std::vector<job> queue;         // Retired lists not yet picked up
+        std::vector<job> working;       // Lists the thread is freeing
+        std::size_t list_count;
+        std::size_t node_count;
+        bool stopping;
+        std::thread worker;
+
+        node_reclaimer(const node_reclaimer&);
+        void operator =(const node_reclaimer&);
+        void run( );
+        template<class Item>
+        static void clear_list(void* head);
+    };
+}
+#include "node_reclaimer.cxx"
+#endif
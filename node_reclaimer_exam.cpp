@@ -0,0 +1,523 @@
+// FILE: node_reclaimer_exam.cpp
+// Non-interactive test program for the node_reclaimer class (see
+// node_reclaimer.h), list_clear (see node2.h), and the members of the
+// sequence class that hand nodes to a reclaimer (clear_deferred and
+// defer_frees; see sequence4.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the deferred teardown,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. The
+// items count their constructions and destructions, and note which thread
+// destroys them, so the tests can tell that every item is destroyed exactly
+// once and whether that happened on the calling thread or the reclaimer's.
+// While hold is true, an item destroyed off the main thread waits in its
+// destructor; that stalls the reclaimer's thread, so a test can check that
+// a call returned before anything was freed, with no timing involved. Each
+// test uses reclaimers of its own, so the counts are not shared with
+// node_reclaimer::instance( ). The program returns EXIT_FAILURE unless every
+// test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread node_reclaimer_exam.cpp -o node_reclaimer_exam
+//     ./node_reclaimer_exam
+
+#include <atomic>           // Provides atomic.
+#include <iostream>         // Provides cout.
+#include <cstdlib>          // Provides size_t.
+#include <thread>           // Provides thread, this_thread.
+#include <vector>           // Provides vector for the threads.
+#include "sequence4.h"      // Provides sequence, node_reclaimer and list_clear
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for node_reclaimer, list_clear and deferred teardown of sequences",
+    "Testing retire, drain, the pending counts and the reclaimer's destructor",
+    "Testing list_clear on lists around each batch boundary",
+    "Testing sequence::clear_deferred against sequence::clear",
+    "Testing sequence::defer_frees with remove_current, assignment and destruction"
+};
+
+// The id of the thread that runs main.
+thread::id main_thread;
+
+// An item that counts its constructions and destructions. While hold is
+// true, a destructor that runs off the main thread waits until it is false.
+struct tracked
+{
+    static atomic<long> made;
+    static atomic<long> destroyed;
+    static atomic<long> destroyed_elsewhere;
+    static atomic<bool> hold;
+    int value;
+
+    tracked(int v = 0) : value(v) { ++made; }
+    tracked(const tracked& source) : value(source.value) { ++made; }
+    tracked& operator =(const tracked& source)
+    {
+        value = source.value;
+        return *this;
+    }
+    ~tracked( )
+    {
+        if (this_thread::get_id( ) != main_thread)
+        {
+            while (hold)
+                this_thread::yield( );
+            ++destroyed_elsewhere;
+        }
+        ++destroyed;
+    }
+    bool operator ==(const tracked& other) const { return value == other.value; }
+    static long alive( ) { return made - destroyed; }
+};
+atomic<long> tracked::made(0);
+atomic<long> tracked::destroyed(0);
+atomic<long> tracked::destroyed_elsewhere(0);
+atomic<bool> tracked::hold(false);
+
+
+// **************************************************************************
+// template<class Item>
+// node<Item>* make_list(size_t n)
+//   Postcondition: The return value is the head pointer of a new linked list
+//   of n nodes holding 0, 1, ..., n - 1.
+// **************************************************************************
+template<class Item>
+node<Item>* make_list(size_t n)
+{
+    node<Item>* head_ptr = NULL;
+
+    while (n > 0)
+        list_head_insert(head_ptr, Item(int(--n)));
+    return head_ptr;
+}
+
+
+// **************************************************************************
+// bool holds(const sequence<tracked>& test, int low, int high)
+//   Postcondition: A return value of true indicates that test holds low,
+//   low + 1, ..., high - 1, in order.
+// **************************************************************************
+bool holds(const sequence<tracked>& test, int low, int high)
+{
+    sequence<tracked>::const_iterator it = test.begin( );
+
+    if (test.size( ) != size_t(high - low))
+        return false;
+    for (int i = low; i < high; ++i, ++it)
+    {
+        if ((it == test.end( )) || ((*it).value != i))
+            return false;
+    }
+    return it == test.end( );
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Retires lists to a reclaimer whose thread is held, checks that retire
+//   returned at once with the head pointer NULL and the pending counts up,
+//   then that drain frees them on the reclaimer's thread. Also checks that
+//   destroying a reclaimer frees what is still pending, and that many
+//   threads may retire to one reclaimer at once. Returns POINTS[1] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    cout << "Checking retire and drain ... ";
+    cout.flush( );
+    {
+        node_reclaimer reclaimer;
+        node<tracked>* empty = NULL;
+        long elsewhere = tracked::destroyed_elsewhere;
+
+        reclaimer.retire(empty);
+        reclaimer.drain( );
+        if ((reclaimer.pending_lists( ) != 0) || (reclaimer.pending_nodes( ) != 0))
+        {
+            cout << "Retiring an empty list left something pending." << endl;
+            return 0;
+        }
+        tracked::hold = true;
+        for (size_t i = 1; i <= 5; ++i)
+        {
+            node<tracked>* list = make_list<tracked>(100 * i);
+            reclaimer.retire(list, 100 * i);
+            if (list != NULL)
+            {
+                tracked::hold = false;
+                cout << "retire did not set the head pointer to NULL." << endl;
+                return 0;
+            }
+        }
+        if ((tracked::alive( ) != 1500) || (reclaimer.pending_lists( ) != 5)
+            || (reclaimer.pending_nodes( ) != 1500))
+        {
+            tracked::hold = false;
+            cout << "With the reclaimer's thread held, " << reclaimer.pending_lists( );
+            cout << " lists and " << tracked::alive( ) << " items were left." << endl;
+            return 0;
+        }
+        tracked::hold = false;
+        reclaimer.drain( );
+        if ((tracked::alive( ) != 0) || (tracked::destroyed_elsewhere - elsewhere != 1500)
+            || (reclaimer.pending_lists( ) != 0) || (reclaimer.pending_nodes( ) != 0))
+        {
+            cout << "drain did not free every retired item on the reclaimer's thread." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking that a reclaimer frees its lists when destroyed ... ";
+    cout.flush( );
+    {
+        node_reclaimer reclaimer;
+
+        for (size_t i = 0; i < 20; ++i)
+        {
+            node<tracked>* list = make_list<tracked>(300);
+            reclaimer.retire(list);
+        }
+    }
+    if (tracked::alive( ) != 0)
+    {
+        cout << tracked::alive( ) << " items were left after the reclaimer was destroyed." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking eight threads retiring to one reclaimer ... ";
+    cout.flush( );
+    {
+        node_reclaimer reclaimer;
+        vector<thread> threads;
+
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.push_back(thread([&reclaimer]( )
+            {
+                for (size_t i = 0; i < 200; ++i)
+                {
+                    node<tracked>* list = make_list<tracked>(i % 50);
+                    reclaimer.retire(list, i % 50);
+                }
+            }));
+        }
+        for (size_t t = 0; t < threads.size( ); ++t)
+            threads[t].join( );
+        reclaimer.drain( );
+        if ((tracked::alive( ) != 0) || (reclaimer.pending_lists( ) != 0) || (reclaimer.pending_nodes( ) != 0))
+        {
+            cout << tracked::alive( ) << " items were left after drain." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Runs list_clear on lists just around each multiple of its batch of 256
+//   nodes, of tracked items and of ints, checking that every item is
+//   destroyed once, on the calling thread, and that new lists built from
+//   the returned storage hold what was put in them. Returns POINTS[2] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    const size_t LENGTHS[] = { 0, 1, 2, 255, 256, 257, 511, 512, 513, 5000 };
+
+    cout << "Checking list_clear on lists of 0 to 5000 nodes ... ";
+    cout.flush( );
+    for (size_t n : LENGTHS)
+    {
+        long elsewhere = tracked::destroyed_elsewhere;
+        node<tracked>* list = make_list<tracked>(n);
+        node<int>* numbers = make_list<int>(n);
+
+        list_clear(list);
+        list_clear(numbers);
+        if ((list != NULL) || (numbers != NULL) || (tracked::alive( ) != 0)
+            || (tracked::destroyed_elsewhere != elsewhere))
+        {
+            cout << "list_clear of " << n << " nodes left " << tracked::alive( ) << " items." << endl;
+            return 0;
+        }
+        // The storage just returned is used again here.
+        list = make_list<tracked>(n);
+        numbers = make_list<int>(n);
+        {
+            const node<tracked>* cursor = list;
+            const node<int>* number = numbers;
+
+            for (size_t i = 0; i < n; ++i, cursor = cursor -> link( ), number = number -> link( ))
+            {
+                if ((cursor -> data( ).value != int(i)) || (number -> data( ) != int(i)))
+                {
+                    cout << "A list built after list_clear of " << n << " nodes went wrong." << endl;
+                    return 0;
+                }
+            }
+        }
+        list_clear(list);
+        list_clear(numbers);
+    }
+    if (tracked::alive( ) != 0)
+    {
+        cout << "list_clear left " << tracked::alive( ) << " items." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Calls clear_deferred with the reclaimer's thread held, and checks that
+//   the sequence is empty and usable at once, that the sequence can be
+//   destroyed before the items are freed, and that drain then frees them on
+//   the reclaimer's thread; then checks that clear frees on the calling
+//   thread. Returns POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    node_reclaimer reclaimer;
+    long elsewhere;
+    int i;
+
+    cout << "Checking clear_deferred ... ";
+    cout.flush( );
+    {
+        sequence<tracked> test;
+
+        for (i = 0; i < 10000; ++i)
+            test.attach(tracked(i));
+        elsewhere = tracked::destroyed_elsewhere;
+        tracked::hold = true;
+        test.clear_deferred(reclaimer);
+        if ((test.size( ) != 0) || test.is_item( ) || (test.begin( ) != test.end( ))
+            || (tracked::alive( ) != 10000) || (reclaimer.pending_lists( ) != 1)
+            || (reclaimer.pending_nodes( ) != 10000))
+        {
+            tracked::hold = false;
+            cout << "clear_deferred did not hand over all 10000 nodes at once." << endl;
+            return 0;
+        }
+        for (i = 0; i < 10; ++i)
+            test.attach(tracked(i));
+        if (!holds(test, 0, 10))
+        {
+            tracked::hold = false;
+            cout << "The sequence could not be used after clear_deferred." << endl;
+            return 0;
+        }
+        test.clear_deferred(reclaimer);
+    }
+    // The sequence is gone, and its items are still waiting.
+    if (tracked::alive( ) != 10010)
+    {
+        tracked::hold = false;
+        cout << "Destroying the cleared sequence freed items on the calling thread." << endl;
+        return 0;
+    }
+    tracked::hold = false;
+    reclaimer.drain( );
+    if ((tracked::alive( ) != 0) || (tracked::destroyed_elsewhere - elsewhere != 10010))
+    {
+        cout << "drain did not free the cleared items on the reclaimer's thread." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking clear ... ";
+    cout.flush( );
+    {
+        sequence<tracked> test;
+
+        for (i = 0; i < 10000; ++i)
+            test.attach(tracked(i));
+        elsewhere = tracked::destroyed_elsewhere;
+        test.clear( );
+        if ((test.size( ) != 0) || (tracked::alive( ) != 0) || (tracked::destroyed_elsewhere != elsewhere))
+        {
+            cout << "clear did not free every item on the calling thread." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   After defer_frees, checks that remove_current hands nodes over only in
+//   batches of SEQUENCE_RETIRE_BATCH, that defer_frees(NULL) hands over a
+//   partial batch and frees later removes on the calling thread, and that
+//   assignment and the destructor hand over the list they drop. Returns
+//   POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    const int BATCH = SEQUENCE_RETIRE_BATCH;
+    node_reclaimer reclaimer;
+    long elsewhere = tracked::destroyed_elsewhere;
+    int i;
+
+    cout << "Checking remove_current after defer_frees ... ";
+    cout.flush( );
+    {
+        sequence<tracked> test;
+
+        for (i = 0; i < 4 * BATCH; ++i)
+            test.attach(tracked(i));
+        test.defer_frees(&reclaimer);
+        test.start( );
+        for (i = 0; i < BATCH - 1; ++i)
+            test.remove_current( );
+        reclaimer.drain( );
+        if ((tracked::alive( ) != 4 * BATCH) || !holds(test, BATCH - 1, 4 * BATCH)
+            || (test.current( ).value != BATCH - 1))
+        {
+            cout << "Removes short of a batch were freed, or the sequence went wrong." << endl;
+            return 0;
+        }
+        test.remove_current( );
+        reclaimer.drain( );
+        if ((tracked::alive( ) != 3 * BATCH) || (tracked::destroyed_elsewhere - elsewhere != BATCH))
+        {
+            cout << "A full batch of removes was not freed on the reclaimer's thread." << endl;
+            return 0;
+        }
+        for (i = 0; i < 10; ++i)
+            test.remove_current( );
+        test.defer_frees(NULL);
+        reclaimer.drain( );
+        if ((tracked::alive( ) != 3 * BATCH - 10) || (tracked::destroyed_elsewhere - elsewhere != BATCH + 10))
+        {
+            cout << "defer_frees(NULL) did not hand over the partial batch." << endl;
+            return 0;
+        }
+        elsewhere = tracked::destroyed_elsewhere;
+        test.remove_current( );
+        if ((tracked::alive( ) != 3 * BATCH - 11) || (tracked::destroyed_elsewhere != elsewhere)
+            || !holds(test, BATCH + 11, 4 * BATCH))
+        {
+            cout << "A remove after defer_frees(NULL) was not freed on the calling thread." << endl;
+            return 0;
+        }
+    }
+    if (tracked::alive( ) != 0)
+    {
+        cout << tracked::alive( ) << " items were left." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking assignment and destruction after defer_frees ... ";
+    cout.flush( );
+    elsewhere = tracked::destroyed_elsewhere;
+    tracked::hold = true;
+    {
+        sequence<tracked> test;
+        sequence<tracked> other;
+
+        test.defer_frees(&reclaimer);
+        for (i = 0; i < 1000; ++i)
+            test.attach(tracked(i));
+        test.start( );
+        test.remove_current( );
+        for (i = 0; i < 5; ++i)
+            other.attach(tracked(i));
+        test = other;
+        if (!holds(test, 0, 5) || (tracked::alive( ) != 1010))
+        {
+            tracked::hold = false;
+            cout << "Assignment after defer_frees freed the old items on the calling thread." << endl;
+            return 0;
+        }
+        for (i = 5; i < 2000; ++i)
+            test.attach(tracked(i));
+    }
+    // Only other's five items are gone; test's were handed over.
+    if (tracked::alive( ) != 3000)
+    {
+        tracked::hold = false;
+        cout << "Destroying a sequence after defer_frees freed items on the calling thread." << endl;
+        return 0;
+    }
+    tracked::hold = false;
+    reclaimer.drain( );
+    if ((tracked::alive( ) != 0) || (tracked::destroyed_elsewhere - elsewhere != 3000))
+    {
+        cout << "drain did not free the dropped lists on the reclaimer's thread." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    main_thread = this_thread::get_id( );
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+// FILE: pool_scaling_bench.cpp
+// Benchmark for the thread caches of node_pool (see node_pool.h).
+//
+// DESCRIPTION:
+// For 1, 2, 4, ... up to max_threads threads, each thread fills its own
+// sequence<long> with list_nodes items and then repeatedly removes the first
+// item and attaches a new one at the end, so every operation is one node
+// freed and one node allocated from the shared pool. The run prints the
+// total operations per second for each thread count; with the thread
+// caches, the pool lock is taken about once per MAGAZINE operations instead
+// of on every one, so the total should keep growing with the thread count
+// up to the number of cores.
+//
+// The thread caches are a compile-time switch, so the comparison is two
+// builds of this file:
+//     g++ -std=c++17 -O2 -pthread pool_scaling_bench.cpp -o pool_cached
+//     g++ -std=c++17 -O2 -pthread -DNODE_POOL_NO_THREAD_CACHE pool_scaling_bench.cpp -o pool_locked
+//     ./pool_cached 64; ./pool_locked 64
+// The optional arguments are the largest thread count (default 64), the
+// operations per thread (default 2000000) and the items each thread's
+// sequence holds (default 1000).
+
+#include <chrono>       // Provides steady_clock
+#include <cstdlib>      // Provides size_t, strtoul
+#include <iostream>     // Provides cout
+#include <thread>       // Provides thread
+#include <vector>       // Provides vector
+#include "sequence4.h"  // Provides the sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Timer returning the seconds since construction.
+class stopwatch
+{
+public:
+    stopwatch( ) : started(chrono::steady_clock::now( )) { }
+    double seconds( ) const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now( ) - started).count( );
+    }
+private:
+    chrono::steady_clock::time_point started;
+};
+
+// **************************************************************************
+// void churn(size_t operations, size_t list_nodes, long& checksum)
+//   Postcondition: A sequence of list_nodes items has had its first item
+//   removed and a new item attached at its end, operations times, and then
+//   been destroyed. checksum is the sum of its final items.
+// **************************************************************************
+void churn(size_t operations, size_t list_nodes, long& checksum)
+{
+    sequence<long> items;
+    long sum = 0;
+
+    for (size_t i = 0; i < list_nodes; ++i)
+        items.attach(long(i));
+    for (size_t i = 0; i < operations; ++i)
+    {
+        items.start( );
+        items.remove_current( );
+        items.seek_end( );
+        items.attach(long(i));
+    }
+    for (sequence<long>::iterator it = items.begin( ); it != items.end( ); ++it)
+        sum += *it;
+    checksum = sum;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_threads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64;
+    size_t operations = (argc > 2) ? strtoul(argv[2], NULL, 10) : 2000000;
+    size_t list_nodes = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1000;
+    long checksum = 0;
+
+#if defined(NODE_POOL_NO_THREAD_CACHE)
+    cout << "mode: NODE_POOL_NO_THREAD_CACHE, ";
+#else
+    cout << "mode: thread caches, ";
+#endif
+    cout << operations << " operations per thread, "
+         << thread::hardware_concurrency( ) << " cores" << endl;
+    cout.precision(1);
+    cout << fixed;
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        vector<thread> workers;
+        vector<long> sums(threads, 0);
+        double seconds;
+
+        {
+            stopwatch timer;
+            for (size_t t = 0; t < threads; ++t)
+                workers.push_back(thread(churn, operations, list_nodes, ref(sums[t])));
+            for (size_t t = 0; t < threads; ++t)
+                workers[t].join( );
+            seconds = timer.seconds( );
+        }
+        for (size_t t = 0; t < threads; ++t)
+            checksum += sums[t];
+
+        cout.width(4);
+        cout << threads << " threads";
+        cout.width(12);
+        cout << double(threads * operations) / seconds / 1e6 << " Mops/s" << endl;
+    }
+
+    cout << "checksum " << checksum << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+// FILE: seq_stats.cxx
+// IMPLEMENTS: latency_histogram and the instrumentation snapshot functions
+// (see seq_stats.h for documentation).
+// INVARIANT for the latency_histogram class:
+//   counts[i] is the number of recorded values v with bucket_index(v) == i.
+//   Bucket i < SUB_BUCKETS holds exactly the value i. For larger i, with
+//   m = i / SUB_BUCKETS + 3, the bucket holds values whose most significant
+//   bit is m and whose next four bits equal i % SUB_BUCKETS.
+
+#include <cstddef>    // Provides size_t
+
+namespace scu_coen70_6B
+{
+    inline std::size_t latency_histogram::bucket_index(std::uint64_t value)
+    {
+        std::size_t msb = 0;
+
+        if (value < SUB_BUCKETS)
+            return std::size_t(value);
+        for (std::uint64_t v = value; v > 1; v >>= 1)
+            ++msb;
+        return ((msb - 3) << 4) + std::size_t((value >> (msb - 4)) & (SUB_BUCKETS - 1));
+    }
+
+    inline std::uint64_t latency_histogram::bucket_limit(std::size_t index)
+    {
+        std::size_t msb;
+        std::uint64_t lower;
+
+        if (index < SUB_BUCKETS)
+            return index;
+        msb = (index >> 4) + 3;
+        lower = std::uint64_t(SUB_BUCKETS + (index & (SUB_BUCKETS - 1))) << (msb - 4);
+        return lower + ((std::uint64_t(1) << (msb - 4)) - 1);
+    }
+
+    inline void latency_histogram::merge(const latency_histogram& other)
+    {
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            counts[i] += other.counts[i];
+    }
+
+    inline void latency_histogram::reset( )
+    {
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            counts[i] = 0;
+    }
+
+    inline std::uint64_t latency_histogram::count( ) const
+    {
+        std::uint64_t answer = 0;
+
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            answer += counts[i];
+        return answer;
+    }
+
+    inline std::uint64_t latency_histogram::max( ) const
+    {
+        for (std::size_t i = BUCKETS; i > 0; --i)
+            if (counts[i-1] != 0)
+                return bucket_limit(i-1);
+        return 0;
+    }
+
+    inline std::uint64_t latency_histogram::percentile(double p) const
+    {
+        std::uint64_t total = count( );
+        std::uint64_t rank;
+        std::uint64_t seen = 0;
+
+        if (total == 0)
+            return 0;
+        // The rank is rounded up so that percentile(100) is the last value.
+        rank = std::uint64_t(p / 100.0 * double(total) + 0.999999);
+        if (rank < 1)
+            rank = 1;
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return bucket_limit(i);
+        }
+        return max( );
+    }
+
+#ifdef SEQ_INSTRUMENT
+    namespace seq_stats_detail
+    {
+        inline state_type& state( )
+        {
+            // Zero-initialized because it has static storage duration.
+            static state_type the_state;
+            return the_state;
+        }
+
+        inline scope_timer::~scope_timer( )
+        {
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now( ) - started;
+            std::uint64_t ns = std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count( ));
+
+            hist.counts[latency_histogram::bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void load(const atomic_histogram& from, latency_histogram& to)
+        {
+            to.reset( );
+            for (std::size_t i = 0; i < latency_histogram::BUCKETS; ++i)
+                to.add(i, from.counts[i].load(std::memory_order_relaxed));
+        }
+
+        inline void clear(atomic_histogram& h)
+        {
+            for (std::size_t i = 0; i < latency_histogram::BUCKETS; ++i)
+                h.counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    inline seq_stats seq_stats_snapshot( )
+    {
+        seq_stats answer;
+
+        answer.inserts = answer.attaches = answer.removals = answer.copies = 0;
+        answer.node_allocs = answer.node_frees = answer.pointer_hops = 0;
+#ifdef SEQ_INSTRUMENT
+        seq_stats_detail::state_type& s = seq_stats_detail::state( );
+        answer.inserts = s.inserts.load(std::memory_order_relaxed);
+        answer.attaches = s.attaches.load(std::memory_order_relaxed);
+        answer.removals = s.removals.load(std::memory_order_relaxed);
+        answer.copies = s.copies.load(std::memory_order_relaxed);
+        answer.node_allocs = s.node_allocs.load(std::memory_order_relaxed);
+        answer.node_frees = s.node_frees.load(std::memory_order_relaxed);
+        answer.pointer_hops = s.pointer_hops.load(std::memory_order_relaxed);
+        seq_stats_detail::load(s.insert_latency, answer.insert_latency);
+        seq_stats_detail::load(s.attach_latency, answer.attach_latency);
+        seq_stats_detail::load(s.remove_latency, answer.remove_latency);
+        seq_stats_detail::load(s.copy_latency, answer.copy_latency);
+#endif
+        return answer;
+    }
+
+    inline void seq_stats_reset( )
+    {
+#ifdef SEQ_INSTRUMENT
+        seq_stats_detail::state_type& s = seq_stats_detail::state( );
+        s.inserts.store(0, std::memory_order_relaxed);
+        s.attaches.store(0, std::memory_order_relaxed);
+        s.removals.store(0, std::memory_order_relaxed);
+        s.copies.store(0, std::memory_order_relaxed);
+        s.node_allocs.store(0, std::memory_order_relaxed);
+        s.node_frees.store(0, std::memory_order_relaxed);
+        s.pointer_hops.store(0, std::memory_order_relaxed);
+        seq_stats_detail::clear(s.insert_latency);
+        seq_stats_detail::clear(s.attach_latency);
+        seq_stats_detail::clear(s.remove_latency);
+        seq_stats_detail::clear(s.copy_latency);
+#endif
+    }
+}
@@ -0,0 +1,184 @@
+// FILE: seq_stats.h
+// PROVIDES: Optional instrumentation for the sequence class and the linked
+// list toolkit, all within the namespace scu_coen70_6B.
+//
+// COMPILE-TIME SWITCHES:
+//   SEQ_INSTRUMENT
+//     When defined, the toolkit and the sequence class count their operations
+//     and record per-call latencies. When it is not defined, every hook
+//     expands to an expression with no effect, so no code or data is added
+//     to the hot paths.
+//
+//   SEQ_USDT
+//     When defined (and <sys/sdt.h> is available), USDT trace points are
+//     emitted under the provider "scu_seq" so that perf, bpftrace or
+//     SystemTap can attach to them. The probes are independent of
+//     SEQ_INSTRUMENT, and without <sys/sdt.h> they quietly compile to nothing.
+//       scu_seq:insert(size)       scu_seq:attach(size)
+//       scu_seq:remove(size)       scu_seq:copy(size)
+//       scu_seq:search(hops)       scu_seq:locate(hops)
+//
+// CLASS PROVIDED: latency_histogram
+//   A log-linear histogram of nanosecond latencies. Values below 16 have a
+//   bucket of their own; above that each power of two is split into 16
+//   buckets, so a recorded value is reported to within about 6%.
+//
+//   void record(std::uint64_t nanoseconds)
+//     Postcondition: The value has been counted in its bucket.
+//
+//   void merge(const latency_histogram& other)
+//     Postcondition: The counts of other have been added to this histogram.
+//
+//   void reset( )
+//     Postcondition: All counts are zero.
+//
+//   std::uint64_t count( ) const
+//     Postcondition: The return value is the number of recorded values.
+//
+//   std::uint64_t max( ) const
+//     Postcondition: The return value is the upper bound of the highest
+//     non-empty bucket (zero if nothing was recorded).
+//
+//   std::uint64_t percentile(double p) const
+//     Precondition: 0 <= p <= 100.
+//     Postcondition: The return value is the upper bound of the bucket that
+//     holds the p-th percentile of the recorded values (zero if empty).
+//
+//   static std::size_t bucket_index(std::uint64_t value)
+//   static std::uint64_t bucket_limit(std::size_t index)
+//     Postcondition: bucket_index maps a value to its bucket, and
+//     bucket_limit is the largest value that maps to the given bucket.
+//
+// STRUCT PROVIDED: seq_stats
+//   A plain snapshot of the counters, with one latency_histogram for each of
+//   insert, attach, remove_current and operator=. pointer_hops counts the
+//   links followed by list_search and list_locate.
+//
+// FUNCTIONS PROVIDED:
+//   seq_stats seq_stats_snapshot( )
+//     Postcondition: The return value holds the counters accumulated since
+//     the program started or since the last seq_stats_reset. Without
+//     SEQ_INSTRUMENT every field is zero.
+//
+//   void seq_stats_reset( )
+//     Postcondition: All counters and histograms are zero.
+//
+// THREAD SAFETY:
+//   The counters are relaxed atomics that are shared by every sequence in the
+//   program. A snapshot taken while other threads are working is not an
+//   atomic cut across the fields, but each field is itself consistent.
+
+#ifndef COEN_70_SEQ_STATS_H
+#define COEN_70_SEQ_STATS_H
+#include <cstddef>  // Provides size_t
+#include <cstdint>  // Provides uint64_t
+#ifdef SEQ_INSTRUMENT
+#include <atomic>   // Provides atomic counters
+#include <chrono>   // Provides steady_clock
+#endif
+#if defined(SEQ_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SEQ_PROBE(name, arg) DTRACE_PROBE1(scu_seq, name, arg)
+#endif
+#endif
+#ifndef SEQ_PROBE
+#define SEQ_PROBE(name, arg) ((void)(arg))
+#endif
+
+namespace scu_coen70_6B
+{
+    class latency_histogram
+    {
+    public:
+        // MEMBER CONSTANTS
+        static const std::size_t SUB_BUCKETS = 16;
+        static const std::size_t BUCKETS = 61 * SUB_BUCKETS;
+        // CONSTRUCTOR
+        latency_histogram( ) { reset( ); }
+        // MODIFICATION MEMBER FUNCTIONS
+        void record(std::uint64_t nanoseconds) { ++counts[bucket_index(nanoseconds)]; }
+        void add(std::size_t index, std::uint64_t how_many) { counts[index] += how_many; }
+        void merge(const latency_histogram& other);
+        void reset( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::uint64_t count( ) const;
+        std::uint64_t max( ) const;
+        std::uint64_t percentile(double p) const;
+        std::uint64_t bucket_count(std::size_t index) const { return counts[index]; }
+        static std::size_t bucket_index(std::uint64_t value);
+        static std::uint64_t bucket_limit(std::size_t index);
+    private:
+        std::uint64_t counts[BUCKETS];
+    };
+
+    struct seq_stats
+    {
+        std::uint64_t inserts;
+        std::uint64_t attaches;
+        std::uint64_t removals;
+        std::uint64_t copies;
+        std::uint64_t node_allocs;
+        std::uint64_t node_frees;
+        std::uint64_t pointer_hops;
+        latency_histogram insert_latency;
+        latency_histogram attach_latency;
+        latency_histogram remove_latency;
+        latency_histogram copy_latency;
+    };
+
+    inline seq_stats seq_stats_snapshot( );
+    inline void seq_stats_reset( );
+
+#ifdef SEQ_INSTRUMENT
+    namespace seq_stats_detail
+    {
+        struct atomic_histogram
+        {
+            std::atomic<std::uint64_t> counts[latency_histogram::BUCKETS];
+        };
+
+        struct state_type
+        {
+            std::atomic<std::uint64_t> inserts;
+            std::atomic<std::uint64_t> attaches;
+            std::atomic<std::uint64_t> removals;
+            std::atomic<std::uint64_t> copies;
+            std::atomic<std::uint64_t> node_allocs;
+            std::atomic<std::uint64_t> node_frees;
+            std::atomic<std::uint64_t> pointer_hops;
+            atomic_histogram insert_latency;
+            atomic_histogram attach_latency;
+            atomic_histogram remove_latency;
+            atomic_histogram copy_latency;
+        };
+
+        inline state_type& state( );
+
+        // Records the lifetime of the enclosing scope into a histogram.
+        class scope_timer
+        {
+        public:
+            explicit scope_timer(atomic_histogram& h)
+                : hist(h), started(std::chrono::steady_clock::now( )) { }
+            ~scope_timer( );
+        private:
+            atomic_histogram& hist;
+            std::chrono::steady_clock::time_point started;
+        };
+    }
+
+#define SEQ_COUNT_N(field, n) \
+    (::scu_coen70_6B::seq_stats_detail::state( ).field.fetch_add((n), std::memory_order_relaxed))
+#define SEQ_COUNT(field) SEQ_COUNT_N(field, 1)
+#define SEQ_TIMED(hist) \
+    ::scu_coen70_6B::seq_stats_detail::scope_timer seq_timer_##hist(::scu_coen70_6B::seq_stats_detail::state( ).hist)
+#else
+#define SEQ_COUNT_N(field, n) ((void)(n))
+#define SEQ_COUNT(field) ((void)0)
+#define SEQ_TIMED(hist) ((void)0)
+#endif
+
+}
+#include "seq_stats.cxx"
+#endif
@@ -12,6 +12,22 @@
 //
 //  4. If there is a previous item, then it lies in precursor*.  If there is no previous
 //       item, then precursor equals NULL.
+//
+//  5. compact_mark is the last node moved by the current compaction pass, or NULL if
+//       the next compact_step starts at head_ptr.
+//
+//  6. cursor_index is the index of *cursor counting from 0 at head_ptr, or many_nodes
+//       if there is no current item. Every member function that moves the cursor or
+//       adds or removes a node in front of it updates it in O(1).
+//
+//  7. journal is NULL unless journal_start has been called; then it holds every edit
+//       since version journal->from_version(), and journal->to_version() == version().
+//
+//  8. deferred_to is the reclaimer given to defer_frees, or NULL. retired is a list of
+//       many_retired nodes unlinked by remove_current and not yet handed to it
+//       (always fewer than SEQUENCE_RETIRE_BATCH, and none when deferred_to is NULL).
+//
+//  9. observer is the watcher given to observe, or NULL.
 
 #include <iostream>
 #include <algorithm>//Provides copy function
@@ -20,6 +36,12 @@
 //#include "sequence.h"//Header file for class
 #include "node2.h" // Provides node class
 
+#include <exception>//Provides exception_ptr for the parallel copy
+#include <system_error>//Provides system_error, thrown when a thread cannot start
+#include <thread>//Provides thread for the parallel copy
+#include <unordered_set>//Provides unordered_set for unique
+#include <vector>//Provides vector for the parallel copy
+
 using namespace std;//For copy function
 
 namespace scu_coen70_6B
@@ -35,6 +57,8 @@ namespace scu_coen70_6B
         precursor = NULL;
         //Initializing many_nodes (or our counter) to 0
         many_nodes = 0;
+        compact_mark = NULL;
+        cursor_index = 0;
     }
 
     //CONSTRUCTOR IMPLEMENTATION for default constructor
@@ -42,6 +66,11 @@ namespace scu_coen70_6B
     sequence<Item> :: sequence ()
     {
         init();
+        journal = NULL;
+        deferred_to = NULL;
+        retired = NULL;
+        many_retired = 0;
+        observer = NULL;
     }
 
     //Copy Constructor
@@ -49,6 +78,11 @@ namespace scu_coen70_6B
     sequence<Item> :: sequence(const sequence<Item>& source)
     {
         init();
+        journal = NULL;
+        deferred_to = NULL;
+        retired = NULL;
+        many_retired = 0;
+        observer = NULL;
         *this = source;
     }
 
@@ -56,8 +90,10 @@ namespace scu_coen70_6B
      template<class Item>
     sequence<Item> :: ~sequence()
     {
-        list_clear(head_ptr);//Returning data to the freestore
+        free_list(head_ptr, many_nodes);//Returning data to the freestore
+        free_list(retired, many_retired);
         many_nodes = 0;
+        delete journal;
 
         return;
     }
@@ -66,6 +102,7 @@ namespace scu_coen70_6B
     {
         cursor = head_ptr;
         precursor = NULL;
+        cursor_index = 0;
 
         return;
     }
@@ -77,6 +114,50 @@ namespace scu_coen70_6B
 
         precursor = cursor;
         cursor = cursor -> link();
+        ++cursor_index;
+
+        return;
+    }
+
+    //Moves the cursor steps items forward without starting over at the head
+    template<class Item>
+    void sequence<Item> :: advance(size_type steps)
+    {
+        assert(steps <= many_nodes - cursor_index);
+
+        cursor_index += steps;
+        for (; steps > 0; --steps)
+        {
+            precursor = cursor;
+            cursor = cursor -> link();
+        }
+
+        return;
+    }
+
+    //Makes item k current, walking from the cursor when it is not past k
+    template<class Item>
+    void sequence<Item> :: go_to(size_type k)
+    {
+        if (k >= many_nodes)
+        {
+            seek_end();
+            return;
+        }
+        if (k < cursor_index)
+            start();
+        advance(k - cursor_index);
+
+        return;
+    }
+
+    //Leaves no current item with the precursor on the tail, as advancing past it would
+    template<class Item>
+    void sequence<Item> :: seek_end()
+    {
+        cursor = NULL;
+        precursor = tail_ptr;
+        cursor_index = many_nodes;
 
         return;
     }
@@ -85,6 +166,8 @@ namespace scu_coen70_6B
      template<class Item>
     void sequence<Item> :: insert(const value_type& entry)
     {
+        SEQ_TIMED(insert_latency);
+        SEQ_COUNT(inserts);
         //Testing precursor precondition, essentially at front of sequence if this is true
         if ((precursor == NULL) || (!is_item()))
         {
@@ -92,6 +175,7 @@ namespace scu_coen70_6B
             list_head_insert(head_ptr, entry);
             cursor = head_ptr;
             precursor = NULL;
+            cursor_index = 0;
 
             //Setting tail pointer if adding a link to an empty list
             if (many_nodes == 0)
@@ -106,6 +190,11 @@ namespace scu_coen70_6B
         }
 
         ++many_nodes;
+        if (journal != NULL)
+            journal -> record_insert(cursor_index, entry);
+        if (observer != NULL)
+            observer -> added(entry);
+        SEQ_PROBE(insert, many_nodes);
 
         return;
     }
@@ -114,6 +203,8 @@ namespace scu_coen70_6B
      template<class Item>
     void sequence<Item> :: attach(const value_type& entry)
     {
+        SEQ_TIMED(attach_latency);
+        SEQ_COUNT(attaches);
         if (is_item())
         {
             // Check if tail_ptr needs to be updated
@@ -122,6 +213,7 @@ namespace scu_coen70_6B
             precursor = cursor;
             list_insert(precursor, entry);
             cursor = cursor -> link();
+            ++cursor_index;
             // Update tail_ptr if necessary
             if (wasAtEnd)
                 tail_ptr = tail_ptr -> link();
@@ -145,9 +237,16 @@ namespace scu_coen70_6B
                 cursor = precursor -> link();
                 tail_ptr = tail_ptr -> link();
             }
+            //The new item is the last one, whichever branch added it
+            cursor_index = many_nodes;
         }
 
         ++many_nodes;
+        if (journal != NULL)
+            journal -> record_insert(cursor_index, entry);
+        if (observer != NULL)
+            observer -> added(entry);
+        SEQ_PROBE(attach, many_nodes);
 
         return;
     }
@@ -157,9 +256,24 @@ namespace scu_coen70_6B
     void sequence<Item> :: remove_current()
     {
         assert (is_item());//Checking precondition
+        SEQ_TIMED(remove_latency);
+        SEQ_COUNT(removals);
+
+        if (journal != NULL)
+            journal -> record_remove(cursor_index);
+        if (observer != NULL)
+            observer -> removed(cursor -> data());
+
+        //A compaction pass that just moved the doomed node resumes after its precursor
+        if (cursor == compact_mark)
+            compact_mark = precursor;
+
+        //With deferred frees the node is only unlinked here
+        if (deferred_to != NULL)
+            retire_current();
 
         //Removing item from list if at head of list
-        if (cursor == head_ptr)
+        else if (cursor == head_ptr)
         {
             if (many_nodes > 1)
             {
@@ -187,66 +301,829 @@ namespace scu_coen70_6B
         }
 
         --many_nodes;
+        SEQ_PROBE(remove, many_nodes);
 
         return;
     }
- template<class Item>
+    //Copies in parallel once the source is large enough to pay for the threads
+    template<class Item>
     void sequence<Item> :: operator =(const sequence<Item>& source)
     {
+        assign_parallel(source, parallel_workers(source.many_nodes));
+    }
+
+    template<class Item>
+    void sequence<Item> :: assign_parallel(const sequence<Item>& source, unsigned workers)
+    {
+        assert(workers > 0);
+
         //Checking for self assignment
         if (this == &source)
             return;
+        SEQ_TIMED(copy_latency);
+        SEQ_COUNT(copies);
 
         // Clear the list to free the memory and avoid memory leaks!
-        list_clear(head_ptr);
+        free_list(head_ptr, many_nodes);
         init();
 
-        //If head_ptr = NULL implementation, copying using the null class member list_copy
-        if (source.head_ptr == NULL)
+        //The old list is gone, so a failed copy leaves the sequence empty
+        try
         {
-            list_copy(source.head_ptr, head_ptr, tail_ptr);
-            cursor = NULL;
+            //A large list is copied in pieces by several threads
+            if ((workers > 1) && (source.many_nodes > 1))
+                copy_pieces(source, workers);
+            //If head_ptr = NULL implementation, copying using the null class member list_copy
+            else if (source.head_ptr == NULL)
+            {
+                list_copy(source.head_ptr, head_ptr, tail_ptr);
+                cursor = NULL;
+                precursor = NULL;
+            }
+            //If the cursor is on the first item on the list
+            else if (source.many_nodes == 1 || source.cursor == source.head_ptr)
+            {
+                list_copy(source.head_ptr, head_ptr, tail_ptr);
+                // Figure out which cursor-precursor state the original, was in.
+                if (source.cursor == source.head_ptr)
+                {
+                    cursor = head_ptr;
+                    precursor = NULL;
+                }
+                else
+                {
+                    cursor = NULL;
+                    precursor = head_ptr;
+                }
+
+            }
+            //If the source cursor is not at the first item in the list and greater than 0
+            else if (source.many_nodes > 1)
+            {
+                //Copying values in two pieces
+                list_piece(source.head_ptr, source.cursor, head_ptr, precursor);
+                if (source.cursor != NULL)
+                    list_piece(source.cursor, (node<Item>*)NULL, cursor, tail_ptr);
+                else
+                {
+                    cursor = NULL;
+                    tail_ptr = precursor;
+                }
+                //Putting the two separate pieces together
+                precursor->set_link(cursor);
+            }
+        }
+        catch (...)
+        {
+            //Free whatever was copied: the first piece, and a second one not yet linked to it
+            if (cursor != head_ptr)
+                list_clear(cursor);
+            list_clear(head_ptr);
+            init();
+            //A journal and an observer hear that the old contents are gone
+            journal_rewrite();
+            if (observer != NULL)
+                observer -> reset();
+            throw;
+        }
+
+        //Setting many_nodes variable
+        many_nodes = source.many_nodes;
+        cursor_index = source.cursor_index;
+
+        //A journal sees the assignment as a clear followed by every new item
+        journal_rewrite();
+        //An observer is told once the new contents are in place
+        if (observer != NULL)
+            observer -> reset();
+        SEQ_PROBE(copy, many_nodes);
+
+        return;
+    }
+
+    //The number of threads operator= and sort use for a list of many nodes
+    template<class Item>
+    unsigned sequence<Item> :: parallel_workers(size_type many)
+    {
+        //A short list never asks for the core count, which is a system call
+        if (many < SEQUENCE_PARALLEL_COPY_MIN)
+            return 1;
+
+        static const unsigned cores = std::thread::hardware_concurrency();
+        size_type most = many / (SEQUENCE_PARALLEL_COPY_MIN / 4 + 1);
+
+        if ((cores < 2) || (most < 2))
+            return 1;
+        return (most < cores) ? unsigned(most) : cores;
+    }
+
+    //Runs job on a new thread added to threads (which has room for it), or
+    //here if here is true or no thread can be started
+    template<class Job>
+    void start_job(vector<thread>& threads, bool here, Job job)
+    {
+        if (!here)
+        {
+            try
+            {
+                threads.push_back(thread(job));
+                return;
+            }
+            catch (const system_error&)
+            {
+            }
+        }
+        job();
+    }
+
+    //Records the whole sequence as a clear followed by every item, in order
+    template<class Item>
+    void sequence<Item> :: journal_rewrite()
+    {
+        size_type index = 0;
+
+        if (journal == NULL)
+            return;
+        journal -> record_clear();
+        for (node<Item> *p = head_ptr; p != NULL; p = p -> link())
+            journal -> record_insert(index++, p -> data());
+    }
+
+    //Sorts by relinking, on parallel_workers threads for a large list
+    template<class Item>
+    template<class Compare>
+    void sequence<Item> :: sort(Compare less)
+    {
+        sort_parallel(less, parallel_workers(many_nodes));
+    }
+
+    template<class Item>
+    template<class Compare>
+    void sequence<Item> :: sort_parallel(Compare less, unsigned workers)
+    {
+        assert(workers > 0);
+        vector<node<Item>*> heads;
+        vector<node<Item>*> tails;
+        vector<thread> threads;
+        node<Item>* walk = head_ptr;
+        size_type runs;
+        size_type length;
+
+        if (many_nodes < 2)
+            return;
+        if (workers > many_nodes / 2)
+            workers = unsigned(many_nodes / 2);
+
+        if (workers == 1)
+            list_sort(head_ptr, tail_ptr, less);
+        else
+        {
+            //Cut the list into workers runs of about equal length
+            heads.resize(workers);
+            tails.resize(workers);
+            for (unsigned k = 0; k < workers; ++k)
+            {
+                length = many_nodes * (k + 1) / workers - many_nodes * k / workers;
+                heads[k] = walk;
+                for (; length > 1; --length)
+                    walk = walk -> link();
+                tails[k] = walk;
+                walk = walk -> link();
+                tails[k] -> set_link(NULL);
+            }
+
+            //Sort each run on a thread of its own (the last one here), then
+            //merge neighbouring runs in pairs, each pair on a thread of its
+            //own, until one run is left. Merging only neighbours, the earlier
+            //run first, keeps the sort stable.
+            threads.reserve(workers);
+            for (size_type k = 0; k < workers; ++k)
+                start_job(threads, k + 1 == workers,
+                          [&heads, &tails, &less, k]() { list_sort(heads[k], tails[k], less); });
+            for (size_type k = 0; k < threads.size(); ++k)
+                threads[k].join();
+            threads.clear();
+
+            for (runs = workers; runs > 1; runs = (runs + 1) / 2)
+            {
+                for (size_type i = 0; i + 1 < runs; i += 2)
+                    start_job(threads, i + 3 >= runs, [&heads, &tails, &less, i]() {
+                        list_merge(heads[i], tails[i], heads[i+1], tails[i+1], less);
+                    });
+                for (size_type k = 0; k < threads.size(); ++k)
+                    threads[k].join();
+                threads.clear();
+                for (size_type i = 0; 2 * i < runs; ++i)
+                {
+                    heads[i] = heads[2*i];
+                    tails[i] = tails[2*i];
+                }
+            }
+            head_ptr = heads[0];
+            tail_ptr = tails[0];
+        }
+
+        find_cursor();
+        journal_rewrite();
+    }
+
+    //After the nodes were relinked, the cursor is the same node somewhere
+    //else: finds its precursor and index again. With no current item the
+    //index is many_nodes (invariant 6), which unique may just have changed
+    template<class Item>
+    void sequence<Item> :: find_cursor()
+    {
+        compact_mark = NULL;
+        if (cursor == NULL)
+        {
+            precursor = tail_ptr;
+            cursor_index = many_nodes;
+            return;
+        }
+        precursor = NULL;
+        cursor_index = 0;
+        for (node<Item> *walk = head_ptr; walk != cursor; walk = walk -> link())
+        {
+            precursor = walk;
+            ++cursor_index;
+        }
+    }
+
+    //Relinks the nodes back to front; the cursor's old successor is now its
+    //precursor
+    template<class Item>
+    void sequence<Item> :: reverse()
+    {
+        if (many_nodes < 2)
+            return;
+        if (cursor != NULL)
+        {
+            precursor = cursor -> link();
+            cursor_index = many_nodes - 1 - cursor_index;
+        }
+        list_reverse(head_ptr, tail_ptr);
+        if (cursor == NULL)
+            precursor = tail_ptr;
+        compact_mark = NULL;
+        journal_rewrite();
+    }
+
+    //Cuts the list after item k - 1 and links the old tail to the old head
+    template<class Item>
+    void sequence<Item> :: rotate(size_type k)
+    {
+        node<Item> *new_tail;
+        size_type at;
+
+        if (many_nodes == 0)
+            return;
+        k %= many_nodes;
+        if (k == 0)
+            return;
+        if ((cursor != NULL) && (cursor_index < k))
+        {
+            new_tail = cursor;
+            at = cursor_index;
+        }
+        else
+        {
+            new_tail = head_ptr;
+            at = 0;
+        }
+        for (; at + 1 < k; ++at)
+            new_tail = new_tail -> link();
+
+        if (cursor == NULL)
+            precursor = new_tail;
+        else if (cursor == head_ptr)
+            precursor = tail_ptr;
+        else if (precursor == new_tail)
             precursor = NULL;
+        if (cursor != NULL)
+            cursor_index = (cursor_index >= k) ? cursor_index - k : cursor_index + (many_nodes - k);
+        list_rotate(head_ptr, tail_ptr, new_tail);
+        compact_mark = NULL;
+        journal_rewrite();
+    }
+
+    template<class Item>
+    template<class Predicate>
+    typename sequence<Item>::size_type sequence<Item> :: partition(Predicate pred)
+    {
+        return stable_partition(pred);
+    }
+
+    //Deals the nodes onto two lists (see list_partition), then finds the
+    //cursor again
+    template<class Item>
+    template<class Predicate>
+    typename sequence<Item>::size_type sequence<Item> :: stable_partition(Predicate pred)
+    {
+        size_type answer;
+
+        try
+        {
+            answer = list_partition(head_ptr, tail_ptr, pred);
         }
-        //If the cursor is on the first item on the list
-        if (source.many_nodes == 1 || source.cursor == source.head_ptr)
+        catch (...)
         {
-            list_copy(source.head_ptr, head_ptr, tail_ptr);
-            // Figure out which cursor-precursor state the original, was in.
-            if (source.cursor == source.head_ptr)
+            find_cursor();
+            journal_rewrite();
+            throw;
+        }
+        find_cursor();
+        journal_rewrite();
+        return answer;
+    }
+
+    //Unlinks every item equal to one kept before it, then frees them together
+    template<class Item>
+    typename sequence<Item>::size_type sequence<Item> :: unique()
+    {
+        unordered_set<const Item*, item_pointer_hash<Item>, item_pointer_equal<Item>> seen;
+        node<Item> *kept = head_ptr;
+        node<Item> *walk;
+        node<Item> *doomed_head = NULL;
+        node<Item> *doomed_tail = NULL;
+        size_type index = 1;
+        size_type removed = 0;
+        bool sorted = true;
+        bool moving = false;
+        exception_ptr failure;
+
+        if (many_nodes < 2)
+            return 0;
+        for (walk = head_ptr; sorted && (walk -> link() != NULL); walk = walk -> link())
+            sorted = !(walk -> link() -> data() < walk -> data());
+
+        //kept is the last node left so far, and index the number left so far
+        try
+        {
+            if (!sorted)
             {
-                cursor = head_ptr;
-                precursor = NULL;
+                seen.reserve(many_nodes);
+                seen.insert(&head_ptr -> data());
             }
-            else
+            while ((walk = kept -> link()) != NULL)
             {
-                cursor = NULL;
-                precursor = head_ptr;
+                if (sorted ? (kept -> data() < walk -> data()) : seen.insert(&walk -> data()).second)
+                {
+                    kept = walk;
+                    ++index;
+                    if (moving)
+                    {
+                        cursor = walk;
+                        moving = false;
+                    }
+                    continue;
+                }
+                kept -> set_link(walk -> link());
+                walk -> set_link(NULL);
+                if (doomed_tail == NULL)
+                    doomed_head = walk;
+                else
+                    doomed_tail -> set_link(walk);
+                doomed_tail = walk;
+                ++removed;
+                if (walk == cursor)
+                    moving = true;
+                if (journal != NULL)
+                    journal -> record_remove(index);
+                if (observer != NULL)
+                    observer -> removed(walk -> data());
             }
+        }
+        catch (...)
+        {
+            failure = current_exception();
+        }
 
+        //A removed cursor moves to the next node left, tested or not
+        if (moving)
+            cursor = kept -> link();
+        if (kept -> link() == NULL)
+            tail_ptr = kept;
+        free_list(doomed_head, removed);
+        many_nodes -= removed;
+        find_cursor();
+        SEQ_COUNT_N(removals, removed);
+        if (failure)
+            rethrow_exception(failure);
+        return removed;
+    }
+
+    //Copies [start, start + many) into a new list; run by each copying thread
+    template<class Item>
+    void sequence<Item> :: copy_piece(const node<Item>* start, size_type many,
+                                      node<Item>** piece_head, node<Item>** piece_tail,
+                                      std::exception_ptr* failure)
+    {
+        try
+        {
+            list_copy_range(start, 1, many + 1, *piece_head, *piece_tail);
         }
-        //If the source cursor is not at the first item in the list and greater than 0
-        else if (source.many_nodes > 1)
+        catch (...)
         {
-            //Copying values in two pieces
-            list_piece(source.head_ptr, source.cursor, head_ptr, precursor);
-            if (source.cursor != NULL)
-                list_piece(source.cursor, (node<Item>*)NULL, cursor, tail_ptr);
-            else
+            *failure = std::current_exception();
+        }
+    }
+
+    //Copies source (with at least two nodes) into this empty list as up to
+    //workers pieces copied at once, plus a cut at the cursor, then links them
+    template<class Item>
+    void sequence<Item> :: copy_pieces(const sequence<Item>& source, unsigned workers)
+    {
+        size_type n = source.many_nodes;
+        vector<size_type> starts;
+        vector<node<Item>*> heads;
+        vector<node<Item>*> tails;
+        vector<exception_ptr> failures;
+        vector<thread> threads;
+        const node<Item>* start = source.head_ptr;
+        size_type at = 0;
+        size_type length;
+        size_type cut;
+
+        //Piece i copies [starts[i], starts[i+1]). The cursor starts a piece
+        //of its own, so the copy's cursor and precursor are a piece's head
+        //and the tail of the piece before it, as with list_piece above.
+        if (workers > n)
+            workers = unsigned(n);
+        for (unsigned k = 0; k < workers; ++k)
+            starts.push_back(n * k / workers);
+        if ((source.cursor_index > 0) && (source.cursor_index < n))
+        {
+            starts.push_back(source.cursor_index);
+            std::sort(starts.begin(), starts.end());
+            starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+        }
+        heads.assign(starts.size(), (node<Item>*)NULL);
+        tails.assign(starts.size(), (node<Item>*)NULL);
+        failures.resize(starts.size());
+        threads.reserve(starts.size());
+
+        //Walk to each piece's first node and hand the piece to a thread; the
+        //last piece is copied here once the walk is over
+        for (size_type i = 0; i < starts.size(); ++i)
+        {
+            for (; at < starts[i]; ++at)
+                start = start->link();
+            length = ((i + 1 < starts.size()) ? starts[i+1] : n) - starts[i];
+            if (i + 1 < starts.size())
             {
-                cursor = NULL;
-                tail_ptr = precursor;
+                try
+                {
+                    threads.push_back(thread(copy_piece, start, length, &heads[i], &tails[i], &failures[i]));
+                    continue;
+                }
+                catch (...)
+                {
+                    //No thread to be had: copy this piece here instead
+                }
             }
-            //Putting the two separate pieces together
-            precursor->set_link(cursor);
+            copy_piece(start, length, &heads[i], &tails[i], &failures[i]);
         }
+        for (size_type i = 0; i < threads.size(); ++i)
+            threads[i].join();
 
-        //Setting many_nodes variable
-        many_nodes = source.many_nodes;
+        for (size_type i = 0; i < starts.size(); ++i)
+        {
+            if (failures[i])
+            {
+                for (size_type j = 0; j < starts.size(); ++j)
+                    list_clear(heads[j]);
+                rethrow_exception(failures[i]);
+            }
+        }
+
+        for (size_type i = 0; i + 1 < starts.size(); ++i)
+            tails[i]->set_link(heads[i+1]);
+        head_ptr = heads.front();
+        tail_ptr = tails.back();
+        if (source.cursor_index == 0)
+        {
+            cursor = head_ptr;
+            precursor = NULL;
+        }
+        else if (source.cursor_index == n)
+        {
+            cursor = NULL;
+            precursor = tail_ptr;
+        }
+        else
+        {
+            cut = size_type(lower_bound(starts.begin(), starts.end(), source.cursor_index) - starts.begin());
+            cursor = heads[cut];
+            precursor = tails[cut-1];
+        }
+    }
+
+    //Adds copies of [first, last) at the end of the sequence in one splice
+    template<class Item>
+    template<class InputIterator>
+    void sequence<Item> :: append(InputIterator first, InputIterator last)
+    {
+        node<Item> *new_head = NULL;
+        node<Item> *new_tail = NULL;
+        size_type added = 0;
+
+        //Build the new items as a separate chain, so a throwing copy leaves us untouched
+        try
+        {
+            for (; first != last; ++first, ++added)
+            {
+                if (new_tail == NULL)
+                {
+                    list_head_insert(new_head, Item(*first));
+                    new_tail = new_head;
+                }
+                else
+                {
+                    list_insert(new_tail, Item(*first));
+                    new_tail = new_tail -> link();
+                }
+            }
+        }
+        catch (...)
+        {
+            list_clear(new_head);
+            throw;
+        }
+        if (new_head == NULL)
+            return;
+
+        //Splice the chain after the tail
+        if (tail_ptr == NULL)
+            head_ptr = new_head;
+        else
+            tail_ptr -> set_link(new_head);
+        tail_ptr = new_tail;
+        //With no current item, the precursor stays on the tail so attach still appends
+        if (journal != NULL)
+        {
+            size_type index = many_nodes;
+            for (node<Item> *p = new_head; p != NULL; p = p -> link())
+                journal -> record_insert(index++, p -> data());
+        }
+        if (observer != NULL)
+        {
+            for (node<Item> *p = new_head; p != NULL; p = p -> link())
+                observer -> added(p -> data());
+        }
+        many_nodes += added;
+        if (!is_item())
+        {
+            precursor = tail_ptr;
+            cursor_index = many_nodes;
+        }
+        SEQ_COUNT_N(attaches, added);
+
+        return;
+    }
+
+    //Relinks every node of other after the tail; only the journals and observers look at the items
+    template<class Item>
+    void sequence<Item> :: splice_back(sequence<Item>& other)
+    {
+        assert(&other != this);
+        node<Item> *new_head = other.head_ptr;
+        size_type added = other.many_nodes;
+
+        if (new_head == NULL)
+            return;
+        if (tail_ptr == NULL)
+            head_ptr = new_head;
+        else
+            tail_ptr -> set_link(new_head);
+        tail_ptr = other.tail_ptr;
+        many_nodes += added;
+        if (!is_item())
+        {
+            precursor = tail_ptr;
+            cursor_index = many_nodes;
+        }
+        //other keeps its journal, observer and retired batch, but no nodes
+        other.init();
+
+        //Both sequences are whole before anyone is told, so a throwing journal or observer cannot leave nodes owned twice
+        if (other.journal != NULL)
+            other.journal -> record_clear();
+        if (other.observer != NULL)
+            other.observer -> reset();
+        if (journal != NULL)
+        {
+            size_type index = many_nodes - added;
+            for (node<Item> *p = new_head; p != NULL; p = p -> link())
+                journal -> record_insert(index++, p -> data());
+        }
+        if (observer != NULL)
+        {
+            for (node<Item> *p = new_head; p != NULL; p = p -> link())
+                observer -> added(p -> data());
+        }
+
+        return;
+    }
+
+    //Frees every node now, in batches
+    template<class Item>
+    void sequence<Item> :: clear()
+    {
+        free_list(head_ptr, many_nodes);
+        init();
+        if (journal != NULL)
+            journal -> record_clear();
+        if (observer != NULL)
+            observer -> reset();
+
+        return;
+    }
+
+    //Hands every node to a reclaimer thread and returns at once
+    template<class Item>
+    void sequence<Item> :: clear_deferred(node_reclaimer& reclaimer)
+    {
+        reclaimer.retire(head_ptr, many_nodes);
+        //retire may have freed the list itself, but either way head_ptr is NULL now
+        init();
+        if (journal != NULL)
+            journal -> record_clear();
+        if (observer != NULL)
+            observer -> reset();
+
+        return;
+    }
+
+    template<class Item>
+    void sequence<Item> :: observe(sequence_observer<Item>* watcher)
+    {
+        observer = watcher;
+    }
+
+    //Has the pool keep storage for n nodes, so inserting does not stall in it
+    template<class Item>
+    void sequence<Item> :: reserve(size_type n)
+    {
+        node<Item>::reserve(n);
+    }
+
+    template<class Item>
+    void sequence<Item> :: defer_frees(node_reclaimer* reclaimer)
+    {
+        if (deferred_to != NULL)
+        {
+            deferred_to -> retire(retired, many_retired);
+            many_retired = 0;
+        }
+        deferred_to = reclaimer;
+    }
+
+    //Frees a dropped list here, or hands it over after defer_frees
+    template<class Item>
+    void sequence<Item> :: free_list(node<Item>*& list, size_type many)
+    {
+        if (deferred_to != NULL)
+            deferred_to -> retire(list, many);
+        else
+            list_clear(list);
+    }
+
+    //Unlinks the current node for remove_current and gathers it into the
+    //batch of retired nodes, handing the batch over once it is full
+    template<class Item>
+    void sequence<Item> :: retire_current()
+    {
+        node<Item> *doomed = cursor;
+
+        if (cursor == head_ptr)
+            head_ptr = cursor -> link();
+        else
+            precursor -> set_link(cursor -> link());
+        if (cursor == tail_ptr)
+            tail_ptr = precursor;
+        cursor = cursor -> link();
+
+        doomed -> set_link(retired);
+        retired = doomed;
+        if (++many_retired >= SEQUENCE_RETIRE_BATCH)
+        {
+            deferred_to -> retire(retired, many_retired);
+            many_retired = 0;
+        }
+    }
+
+    //Starts recording edits at version 0
+    template<class Item>
+    void sequence<Item> :: journal_start()
+    {
+        if (journal == NULL)
+            journal = new sequence_delta<Item>;
+
+        return;
+    }
+
+    template<class Item>
+    void sequence<Item> :: journal_stop()
+    {
+        delete journal;
+        journal = NULL;
+
+        return;
+    }
+
+    template<class Item>
+    typename sequence<Item> :: size_type sequence<Item> :: version() const
+    {
+        return (journal == NULL) ? 0 : journal -> to_version();
+    }
+
+    //Copies the recorded edits after version, plus where the cursor is now
+    template<class Item>
+    sequence_delta<Item> sequence<Item> :: delta_since(size_type version) const
+    {
+        assert(journal != NULL);
+        sequence_delta<Item> answer = journal -> since(version);
+
+        answer.set_cursor(cursor_index);
+        return answer;
+    }
+
+    template<class Item>
+    void sequence<Item> :: journal_trim(size_type version)
+    {
+        assert(journal != NULL);
+
+        journal -> trim(version);
+
+        return;
+    }
+
+    //Moves every node to fresh, adjacent pool storage in sequence order
+    template<class Item>
+    void sequence<Item> :: compact()
+    {
+        //Start a new pass from the head and run it to the end
+        compact_mark = NULL;
+        if (many_nodes > 0)
+            compact_step(many_nodes);
 
         return;
     }
 
+    //Moves up to budget nodes of the current compaction pass
+    template<class Item>
+    bool sequence<Item> :: compact_step(size_type budget)
+    {
+        assert(budget > 0);
+        node<Item> *previous = compact_mark;//Last moved node, or NULL at the head
+        node<Item> *old_node = (previous == NULL) ? head_ptr : previous -> link();
+        node<Item> *new_node;
+        void *run = NULL;//Unconstructed slots of the current run
+        size_type run_left = 0;
+
+        while ((budget > 0) && (old_node != NULL))
+        {
+            if (run_left == 0)
+                run_left = node<Item>::allocate_run(run, std::min(budget, many_nodes));
+
+            //Copy the node into the next slot; if this throws, the list is untouched
+            try
+            {
+                new_node = new (run) node<Item>(old_node -> data(), old_node -> link());
+            }
+            catch (...)
+            {
+                node<Item>::release_run(run, run_left);
+                throw;
+            }
+            run = new_node + 1;
+            --run_left;
+
+            //Splice the copy in place of the original
+            if (previous == NULL)
+                head_ptr = new_node;
+            else
+                previous -> set_link(new_node);
+            if (old_node == tail_ptr)
+                tail_ptr = new_node;
+            if (old_node == cursor)
+                cursor = new_node;
+            if (old_node == precursor)
+                precursor = new_node;
+            delete old_node;
+
+            previous = new_node;
+            old_node = new_node -> link();
+            --budget;
+        }
+
+        //Return the slots this call did not use
+        node<Item>::release_run(run, run_left);
+
+        compact_mark = (old_node == NULL) ? NULL : previous;
+        return (old_node == NULL);
+    }
+
     //CONSTANT MEMBER FUNCTIONS
      template<class Item>
      typename sequence<Item> :: size_type sequence<Item> :: size() const
@@ -265,4 +1142,9 @@ template<class Item>
 
         return cursor -> data();
     }
+template<class Item>
+    typename sequence<Item> :: size_type sequence<Item> :: position() const
+    {
+        return cursor_index;
+    }
 }
@@ -48,6 +48,53 @@
 //     Postcondition: The current item has been removed from the sequence, and
 //     the item after this (if there is one) is now the new current item.
 //
+//   void advance(size_type steps)
+//     Precondition: steps <= size( ) - position( ).
+//     Postcondition: The cursor has moved steps items forward, exactly as if
+//     advance( ) had been called steps times (so it costs O(steps), not a
+//     walk from the head). If it passed the last item, there is no current
+//     item.
+//
+//   void go_to(size_type k)
+//     Postcondition: If k < size( ), item number k (counting from 0) is the
+//     current item; otherwise there is no current item, as after seek_end( ).
+//     The walk starts at the cursor when k >= position( ) and at the head
+//     otherwise, so it costs O(k - position( )) or O(k). Paging forward
+//     through the sequence with go_to is therefore linear overall.
+//
+//   void seek_end( )
+//     Postcondition: There is no current item, and position( ) == size( ).
+//     A following attach adds at the end of the sequence (insert, as usual
+//     with no current item, adds at the front). This takes O(1); making the
+//     last item current instead would need a walk to find its precursor.
+//
+//   void clear( )
+//     Postcondition: The sequence is empty. The nodes are destroyed in place
+//     and handed back to the node pool in batches (see list_clear), or
+//     retired after defer_frees.
+//
+//   void clear_deferred(node_reclaimer& reclaimer = node_reclaimer::instance( ))
+//     Postcondition: The sequence is empty, in O(1): its nodes have been
+//     handed to reclaimer, whose thread frees them later (see
+//     node_reclaimer.h). Calling this before a large sequence is destroyed
+//     makes the destruction O(1) too.
+//
+//   void compact( )
+//     Postcondition: Every node has been moved to fresh node_pool storage laid
+//     out in sequence order, so that a traversal reads memory sequentially.
+//     The items, their order and the current item are unchanged, but pointers
+//     to the old nodes (including iterators) are no longer valid.
+//
+//   bool compact_step(size_type budget)
+//     Precondition: budget > 0.
+//     Postcondition: Up to budget more nodes of the current compaction pass
+//     have been moved as compact( ) would move them. The pass resumes after
+//     the last node moved by the previous call, and insertions or removals in
+//     between are allowed (nodes inserted before that point are simply not
+//     moved in this pass). The return value is true if the pass reached the
+//     end of the sequence, in which case the next call starts a new pass.
+//     Each call costs O(budget), so a caller can bound the pause.
+//
 // CONSTANT MEMBER FUNCTIONS for the sequence class:
 //   size_type size( ) const
 //     Postcondition: The return value is the number of items in the sequence.
@@ -62,22 +109,257 @@
 //     Precondition: is_item( ) returns true.
 //     Postcondition: The item returned is the current item in the sequence.
 //
+//   size_type position( ) const
+//     Postcondition: The return value is the index of the current item
+//     (counting from 0 at the front), or size( ) if there is no current item.
+//     It is kept up to date by every modification, so this takes O(1).
+//
 // STANDARD ITERATOR MEMBER FUNCTIONS (provide a forward iterator):
 //   iterator begin( )
 //   const_iterator begin( ) const
 //   iterator end( )
 //   const iterator end( ) const
 //
+//   iterator at_current( )
+//   const_iterator at_current( ) const
+//     Postcondition: The return value is an iterator at the current item, or
+//     end( ) if there is no current item. [at_current( ), end( )) is the
+//     rest of the sequence from the cursor on (see slice in sequence_view.h).
+//
+// BULK MODIFICATION:
+//   template<class InputIterator>
+//   void append(InputIterator first, InputIterator last)
+//     Postcondition: Copies of the items in [first, last) have been added to
+//     the end of the sequence, in order, by one splice after tail_ptr. The
+//     current item is unchanged; if there was none, there still is none (and
+//     a following attach still adds at the very end). If copying an item
+//     throws, the sequence is unchanged.
+//
+//   void splice_back(sequence& other)
+//     Precondition: other is not this sequence.
+//     Postcondition: The items of other have been moved to the end of this
+//     sequence, in order, and other is empty. No item is copied and no node
+//     allocated: other's list is linked after tail_ptr in O(1) (plus O(1)
+//     per item for a journal or observer of either sequence, which record
+//     the move as other's items added here and other cleared). The current
+//     item of this sequence is unchanged, as for append. The nodes are moved
+//     before any journal or observer is told, so if one of them throws, the
+//     move is still complete and the exception is passed on.
+//
+// SORTING:
+//   template<class Compare = std::less<value_type>>
+//   void sort(Compare less = Compare( ))
+//     Precondition: less is a strict weak ordering on value_type that does
+//     not throw.
+//     Postcondition: The items are in order by less, equal items keeping
+//     their original order. The nodes are relinked (see list_sort in
+//     node2.h); no item is copied, so every iterator and the cursor stay on
+//     the same item, and position( ) is that item's new index. A list of
+//     SEQUENCE_PARALLEL_COPY_MIN items or more is sorted by several threads,
+//     chosen as for a parallel copy. A journaled sequence records the sort
+//     as a clear followed by every item.
+//
+//   template<class Compare>
+//   void sort_parallel(Compare less, unsigned workers)
+//     Precondition: As for sort, and workers > 0.
+//     Postcondition: As for sort. The list is cut into up to workers runs of
+//     about equal length, each sorted on a thread of its own, and then
+//     neighbouring runs are merged in pairs, each pair on a thread of its
+//     own, until one is left (log2(workers) rounds; the last merge is one
+//     thread's O(n) pass). With workers == 1 this is list_sort on the whole
+//     list.
+//
+// REARRANGING:
+//   These relink the nodes (see RELINKING in node2.h) instead of removing
+//   and inserting items, so they allocate and free nothing and copy no item.
+//   The cursor and every iterator stay on the same item, and position( ) is
+//   that item's new index; with no current item there still is none. A
+//   journaled sequence records each of them as a clear followed by every
+//   item, as for sort.
+//
+//   void reverse( )
+//     Postcondition: The items are in the opposite order. This takes O(n).
+//
+//   void rotate(size_type k)
+//     Postcondition: Item number k % size( ) (counting from 0) is now the
+//     first item: the items from it to the end have been moved, in order, in
+//     front of the items before it (as std::rotate does), so rotate(0) and
+//     rotate(size( )) change nothing. An empty sequence is unchanged. It
+//     costs O(k % size( )) to find the item before the new first one
+//     (walking from the cursor when it is no later than that), then O(1) to
+//     relink.
+//
+//   template<class Predicate>
+//   size_type partition(Predicate pred)
+//   template<class Predicate>
+//   size_type stable_partition(Predicate pred)
+//     Postcondition: The items for which pred returns true come first,
+//     followed by the others. The return value is the number of the first
+//     group, so go_to(answer) makes the first of the others current. Each
+//     takes one O(n) pass that calls pred once per item. Dealing nodes onto
+//     two lists keeps both groups in their original order, so partition is
+//     stable too; it is the same function under std::partition's name. If
+//     pred throws, the sequence still holds every item (those already tested
+//     partitioned, followed by the rest in order) and the exception is
+//     passed on.
+//
+// DEDUPLICATION (see also sequence_set.h):
+//   size_type unique( )
+//     Precondition: value_type has operator <, operator == and a std::hash
+//     specialization, which agree on which items are equal.
+//     Postcondition: Only the first copy of each item is left, in its
+//     original order, and the return value is the number of items removed.
+//     The removed nodes are unlinked as the list is walked and freed
+//     together at the end (see list_clear). If the current item was
+//     removed, the next item left is current (or none, if there is none).
+//     One pass checks whether the items are in order by operator <; if so,
+//     each item is compared with the last one kept, in O(n) with no extra
+//     memory. Otherwise the items seen so far are kept in a hash set of
+//     pointers to them, in O(n) expected time and O(n) memory. If that set
+//     runs out of memory, the duplicates found so far are removed and
+//     bad_alloc is thrown.
+//
+// CHANGE JOURNAL (see sequence_delta.h):
+//   void journal_start( )
+//     Postcondition: From now on the sequence records its edits, starting
+//     at version( ) == 0 (if it was already recording, nothing changes).
+//
+//   void journal_stop( )
+//     Postcondition: The journal has been discarded, and edits are no longer
+//     recorded.
+//
+//   size_type version( ) const
+//     Postcondition: The return value is the number of edits recorded since
+//     journal_start( ) (0 if the sequence is not recording).
+//
+//   sequence_delta<Item> delta_since(size_type version) const
+//     Precondition: The sequence is recording, and version is between the
+//     version given to the last journal_trim (or 0) and version( ).
+//     Postcondition: The return value holds the edits made after version,
+//     with the current position as its cursor. Applying it to a copy taken
+//     at version makes that copy equal to this sequence.
+//
+//   void journal_trim(size_type version)
+//     Precondition: As for delta_since.
+//     Postcondition: The edits before version are no longer kept, so the
+//     journal's memory stays bounded once every replica has been synced.
+//
 // VALUE SEMANTICS for the sequence class:
 //    Assignments and the copy constructor may be used with sequence objects.
+//    A copy is not journaled, whether or not the source is. A source of at
+//    least SEQUENCE_PARALLEL_COPY_MIN items (default 1 << 20; define it
+//    before including this file to change it) is copied by several threads
+//    at once, as by assign_parallel with one worker per core (but no more
+//    than one per SEQUENCE_PARALLEL_COPY_MIN / 4 items).
+//
+//   void assign_parallel(const sequence& source, unsigned workers)
+//     Precondition: workers > 0.
+//     Postcondition: The sequence is a copy of source, as after operator=.
+//     The source is cut into up to workers pieces of about equal length
+//     (and once more at its cursor). Every piece but the last is copied by
+//     a thread of its own while this thread walks to the next cut, and this
+//     thread copies the last. Then the pieces are linked, so the copy's
+//     cursor and precursor match the source's exactly. The nodes of each
+//     piece come from allocate_run (see node_pool.h), so every thread lays
+//     its piece out in a run of its own. With workers == 1 this is the
+//     serial copy. If a thread cannot be started, its piece is copied on the
+//     calling thread instead; if copying any piece throws (on any number of
+//     workers), every piece is freed and the exception is rethrown with the
+//     sequence empty, and its journal and observer told that it was cleared.
+//
+// OBSERVER (see sequence_sketch.h):
+//   void observe(sequence_observer<value_type>* watcher)
+//     Postcondition: From now on watcher is told of each change to the
+//     sequence's contents (NULL stops that; there is one observer at a
+//     time): added(x) after x was inserted by insert, attach or append,
+//     removed(x) before x is removed by remove_current or unique, and
+//     reset( ) after clear, clear_deferred or an assignment replaced the
+//     contents wholesale (the observer may then rescan them). Reordering
+//     (sort, reverse, rotate, partition) is not reported. Each call costs a
+//     test of one pointer when there is no observer. The watcher must stop
+//     observing (or be destroyed after) the sequence; copies do not inherit
+//     it.
+//
+// LOW-LATENCY CONFIGURATION:
+//   By default an insert or attach may stall in the allocator (taking a new
+//   slab from the system and faulting in its pages), and a remove_current
+//   runs Item's destructor and returns the node; clear, the assignment
+//   operator and the destructor free the whole old list before returning. A
+//   thread with a latency budget can move all of that off its path:
+//       sequence<order> book;
+//       book.reserve(1000000);   // storage for a million nodes, pages mapped
+//       book.defer_frees( );     // nodes are freed by the reclaimer's thread
+//   after which insert and attach take nodes from the reserve, and the
+//   other calls only unlink nodes. latency_bench.cpp measures the effect.
+//
+//   void reserve(size_type n)
+//     Postcondition: The node pool for this Item type holds storage for at
+//     least n nodes, with its pages mapped, and keeps it (see
+//     node::reserve). The pool is shared with every list of the same node
+//     size. Throws bad_alloc if the memory cannot be found.
+//
+//   void defer_frees(node_reclaimer* reclaimer = &node_reclaimer::instance( ))
+//     Precondition: reclaimer (unless NULL) outlives the sequence.
+//     Postcondition: From now on every node the sequence lets go of is
+//     handed to reclaimer (see node_reclaimer.h) instead of being freed on
+//     the calling thread. remove_current gathers the nodes it unlinks and
+//     retires SEQUENCE_RETIRE_BATCH of them at a time (default 64; define it
+//     before including this file to change it), and clear, unique, the
+//     assignment operator and the destructor retire the whole list they drop
+//     in O(1), as clear_deferred does. With NULL, nodes are freed here again
+//     (a partly gathered batch is retired first). Copies do not inherit the
+//     setting.
+//
+// INSTRUMENTATION:
+//    When compiled with SEQ_INSTRUMENT, insert, attach, remove_current and
+//    the assignment operator are counted and timed; see seq_stats.h for the
+//    snapshot API and the SEQ_USDT trace points.
 
 #ifndef COEN_70_SEQUENCE_H
 #define COEN_70_SEQUENCE_H
 #include <cstdlib>  // Provides size_t
 #include "node2.h"  // Provides node class
+#include "node_reclaimer.h"  // Provides node_reclaimer for clear_deferred and defer_frees
+#include <exception>  // Provides exception_ptr
+#include <functional> // Provides less
+
+#ifndef SEQUENCE_PARALLEL_COPY_MIN
+#define SEQUENCE_PARALLEL_COPY_MIN (1 << 20)
+#endif
+#ifndef SEQUENCE_RETIRE_BATCH
+#define SEQUENCE_RETIRE_BATCH 64
+#endif
 
 namespace scu_coen70_6B
 {
+    template<class Item>
+    class sequence_delta;
+
+    // Told of every change to a sequence's contents (see observe).
+    template<class Item>
+    class sequence_observer
+    {
+    public:
+        virtual ~sequence_observer( ) { }
+        virtual void added(const Item& entry) = 0;
+        virtual void removed(const Item& entry) = 0;
+        virtual void reset( ) = 0;
+    };
+
+    // Hash and compare items through pointers to them, so that a hash set of
+    // pointers can tell whether an item was seen without copying it.
+    template<class Item>
+    struct item_pointer_hash
+    {
+        std::size_t operator ( )(const Item* p) const { return std::hash<Item>( )(*p); }
+    };
+
+    template<class Item>
+    struct item_pointer_equal
+    {
+        bool operator ( )(const Item* a, const Item* b) const { return *a == *b; }
+    };
+
     template<class Item>
     class sequence
     {
@@ -94,14 +376,23 @@ namespace scu_coen70_6B
         // MODIFICATION MEMBER FUNCTIONS
         void start( );
         void advance( );
+        void advance(size_type steps);
+        void go_to(size_type k);
+        void seek_end( );
         void insert(const value_type& entry);
         void attach(const value_type& entry);
         void operator =(const sequence& source);
+        void assign_parallel(const sequence& source, unsigned workers);
 	    void remove_current( );
+        void clear( );
+        void clear_deferred(node_reclaimer& reclaimer = node_reclaimer::instance( ));
+        void compact( );
+        bool compact_step(size_type budget);
         // CONSTANT MEMBER FUNCTIONS
         size_type size( ) const;
         bool is_item( ) const;
         value_type current( ) const;
+        size_type position( ) const;
         // FUNCTIONS TO PROVIDE ITERATORS
         iterator begin( ){
             return iterator(head_ptr);
@@ -120,16 +411,68 @@ namespace scu_coen70_6B
         
         
         }
+        iterator at_current( ){
+            return iterator(cursor);
+        }
+        const_iterator at_current( ) const{
+            return const_iterator(cursor);
+        }
+        // BULK MODIFICATION
+        template<class InputIterator>
+        void append(InputIterator first, InputIterator last);
+        void splice_back(sequence& other);
+        // SORTING
+        template<class Compare = std::less<Item>>
+        void sort(Compare less = Compare( ));
+        template<class Compare>
+        void sort_parallel(Compare less, unsigned workers);
+        // REARRANGING
+        void reverse( );
+        void rotate(size_type k);
+        template<class Predicate>
+        size_type partition(Predicate pred);
+        template<class Predicate>
+        size_type stable_partition(Predicate pred);
+        // DEDUPLICATION
+        size_type unique( );
+        // OBSERVER
+        void observe(sequence_observer<Item>* watcher);
+        // LOW-LATENCY CONFIGURATION
+        void reserve(size_type n);
+        void defer_frees(node_reclaimer* reclaimer = &node_reclaimer::instance( ));
+        // CHANGE JOURNAL
+        void journal_start( );
+        void journal_stop( );
+        size_type version( ) const;
+        sequence_delta<Item> delta_since(size_type version) const;
+        void journal_trim(size_type version);
     private:
     	node<Item> *head_ptr;
     	node<Item> *tail_ptr;
     	node<Item> *cursor;
     	node<Item> *precursor;
     	size_type many_nodes;
+    	node<Item> *compact_mark;
+    	size_type cursor_index;
+    	sequence_delta<Item> *journal;
+    	node_reclaimer *deferred_to;
+    	node<Item> *retired;
+    	size_type many_retired;
+    	sequence_observer<Item> *observer;
 
         void init();
+        void copy_pieces(const sequence& source, unsigned workers);
+        void journal_rewrite();
+        void find_cursor();
+        void free_list(node<Item>*& list, size_type many);
+        void retire_current();
+        static unsigned parallel_workers(size_type many);
+        static void copy_piece(const node<Item>* start, size_type many,
+                               node<Item>** piece_head, node<Item>** piece_tail,
+                               std::exception_ptr* failure);
     };
 }
+#include "sequence_delta.h"  // Provides the journal's sequence_delta class
 #include"sequence4.cxx"
 
 #endif
@@ -0,0 +1,129 @@
+// FILE: sequence_channel.cxx
+// CLASSES IMPLEMENTED: sequence_channel, channel_task (see sequence_channel.h
+// for documentation)
+// INVARIANT for the sequence_channel class:
+//   1. buffer holds the items pushed and not yet popped, oldest first, and
+//      buffer.size( ) <= limit. peak is the largest buffer.size( ) so far.
+//
+//   2. producers holds the suspended pushes, oldest first; there are none
+//      unless buffer is full. consumers holds the suspended pops, oldest
+//      first; there are none unless buffer is empty. Both are empty once
+//      closed is true.
+
+#include <cassert>    // Provides assert
+
+namespace scu_coen70_6B
+{
+    inline channel_task::~channel_task( )
+    {
+        if (frame)
+            frame.destroy( );
+    }
+
+    inline void channel_task::get( ) const
+    {
+        assert(done( ));
+        if (frame.promise( ).failure)
+            std::rethrow_exception(frame.promise( ).failure);
+    }
+
+    template<class Item>
+    sequence_channel<Item>::sequence_channel(size_type high_water)
+    {
+        assert(high_water > 0);
+        limit = high_water;
+        peak = 0;
+        closed = false;
+    }
+
+    template<class Item>
+    sequence_channel<Item>::~sequence_channel( )
+    {
+        assert(producers.empty( ) && consumers.empty( ));
+    }
+
+    template<class Item>
+    void sequence_channel<Item>::put(const Item& entry)
+    {
+        buffer.seek_end( );
+        buffer.attach(entry);
+        if (buffer.size( ) > peak)
+            peak = buffer.size( );
+    }
+
+    template<class Item>
+    bool sequence_channel<Item>::push_awaiter::await_ready( )
+    {
+        std::coroutine_handle<> consumer;
+
+        if (channel->closed)
+            return true;
+        if (channel->buffer.size( ) >= channel->limit)
+            return false;
+
+        channel->put(item);
+        accepted = true;
+        if (!channel->consumers.empty( ))
+        {
+            // The buffer was empty, so this is the only item: hand it over.
+            consumer = channel->consumers.front( );
+            channel->consumers.pop_front( );
+            consumer.resume( );
+        }
+        return true;
+    }
+
+    template<class Item>
+    void sequence_channel<Item>::push_awaiter::await_suspend(std::coroutine_handle<> waiting)
+    {
+        handle = waiting;
+        channel->producers.push_back(this);
+    }
+
+    template<class Item>
+    std::optional<Item> sequence_channel<Item>::pop_awaiter::await_resume( )
+    {
+        sequence<Item>& buffer = channel->buffer;
+        push_awaiter* producer;
+
+        if (buffer.size( ) == 0)
+            return std::optional<Item>( );   // Closed and drained
+
+        buffer.start( );
+        std::optional<Item> answer(buffer.current( ));
+
+        if (channel->producers.empty( ))
+        {
+            buffer.remove_current( );
+            return answer;
+        }
+
+        // The buffer is full: add the oldest waiting push's item before
+        // removing the first one, so that a bad_alloc leaves both in place,
+        // and resume that push only once its item is in.
+        producer = channel->producers.front( );
+        buffer.seek_end( );
+        buffer.attach(producer->item);
+        channel->producers.pop_front( );
+        buffer.start( );
+        buffer.remove_current( );
+        producer->accepted = true;
+        producer->handle.resume( );
+        return answer;
+    }
+
+    template<class Item>
+    void sequence_channel<Item>::close( )
+    {
+        std::deque<push_awaiter*> stalled_producers;
+        std::deque<std::coroutine_handle<>> stalled_consumers;
+
+        closed = true;
+        stalled_producers.swap(producers);
+        stalled_consumers.swap(consumers);
+        for (std::size_t i = 0; i < stalled_producers.size( ); ++i)
+            stalled_producers[i]->handle.resume( );
+        for (std::size_t i = 0; i < stalled_consumers.size( ); ++i)
+            stalled_consumers[i].resume( );
+    }
+}
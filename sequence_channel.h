@@ -0,0 +1,221 @@
+// FILE: sequence_channel.h
+// CLASSES PROVIDED: sequence_channel, channel_task (part of the namespace
+// scu_coen70_6B). Requires C++20 coroutines; without them (when
+// __cpp_impl_coroutine is not defined) this header provides nothing.
+//
+// A sequence_channel passes items from producer coroutines to consumer
+// coroutines through a sequence (sequence4.h) used as a queue: push attaches
+// at the end of the sequence and pop removes its first item. A producer
+// that finds high_water( ) items already waiting is suspended until a
+// consumer takes one, and a consumer that finds none is suspended until a
+// producer pushes one, so the stages of a pipeline run interleaved and the
+// channel never holds more than high_water( ) items:
+//
+//     channel_task produce(sequence_channel<int>& out)
+//     {
+//         for (int i = 0; i < 1000000; ++i)
+//             co_await out.push(i);
+//         out.close( );
+//     }
+//     channel_task consume(sequence_channel<int>& in, long& sum)
+//     {
+//         while (std::optional<int> x = co_await in.pop( ))
+//             sum += *x;
+//     }
+//     ...
+//     sequence_channel<int> pipe(64);
+//     long sum = 0;
+//     channel_task reader = consume(pipe, sum);  // runs until pipe is empty
+//     channel_task writer = produce(pipe);       // runs both to the end
+//
+// There is no scheduler and no thread: a suspended coroutine is resumed,
+// on the calling thread, by the push or pop that lets it continue. A
+// channel and the coroutines that use it must therefore stay on one thread.
+//
+// TYPEDEFS for the sequence_channel class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//     As in sequence4.h.
+//
+// CONSTRUCTOR for the sequence_channel class:
+//   sequence_channel(size_type high_water = 64)
+//     Precondition: high_water > 0.
+//     Postcondition: The channel is empty and open, and holds at most
+//     high_water items at a time.
+//
+// DESTRUCTOR for the sequence_channel class:
+//   ~sequence_channel( )
+//     Precondition: No coroutine is suspended in push or pop on this channel
+//     (close( ) resumes them all).
+//
+// MODIFICATION MEMBER FUNCTIONS for the sequence_channel class:
+//   co_await push(const value_type& entry)  (returns bool)
+//     Postcondition: If the channel was closed before entry could be added,
+//     the result is false and entry was dropped. Otherwise entry has been
+//     added after the items pushed before it and the result is true; the
+//     calling coroutine was suspended first if the channel was full, and a
+//     consumer suspended in pop has been resumed to take the first item.
+//
+//   co_await pop( )  (returns std::optional<value_type>)
+//     Postcondition: If the channel held an item, or one was pushed while the
+//     calling coroutine was suspended, the first item has been removed and is
+//     the result, and the first producer suspended in push (if any) has
+//     added its item and been resumed. If the channel is closed and empty,
+//     the result is empty.
+//
+//   void close( )
+//     Postcondition: The channel is closed: later pushes fail, and pops fail
+//     once the items still held have been taken. Every coroutine suspended
+//     on the channel has been resumed (their push or pop fails).
+//
+// CONSTANT MEMBER FUNCTIONS for the sequence_channel class:
+//   size_type size( ) const
+//   size_type high_water( ) const
+//   bool is_closed( ) const
+//     Postcondition: The return values are the number of items the channel
+//     holds, the most it may hold, and whether close( ) has been called.
+//
+//   size_type peak_size( ) const
+//     Postcondition: The return value is the largest size( ) so far.
+//
+// THE channel_task CLASS:
+//   A coroutine that returns channel_task starts running when it is called
+//   and runs until its first suspension; the channels it uses resume it
+//   from then on. The task object owns the coroutine's frame.
+//
+//   bool done( ) const
+//     Postcondition: The return value is true if the coroutine has finished
+//     (returned, or thrown an exception).
+//
+//   void get( ) const
+//     Precondition: done( ).
+//     Postcondition: If the coroutine ended with an exception, it has been
+//     rethrown here.
+//
+//   ~channel_task( )
+//     Precondition: The coroutine has finished, or is not suspended on a
+//     channel that will be used again. Its frame is destroyed.
+//
+// DYNAMIC MEMORY USAGE by sequence_channel:
+//   push allocates a node (from the shared node_pool) and may grow the list
+//   of waiting coroutines; if either fails it throws bad_alloc and the
+//   channel is unchanged. A pop that resumes a suspended producer adds that
+//   producer's item first, so a bad_alloc there is thrown from pop with the
+//   channel unchanged and the producer still suspended.
+
+#ifndef COEN_70_SEQUENCE_CHANNEL_H
+#define COEN_70_SEQUENCE_CHANNEL_H
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>      // Provides __cpp_impl_coroutine
+#endif
+#endif
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SEQUENCE_CHANNEL_AVAILABLE
+#endif
+#endif
+
+#if defined(SEQUENCE_CHANNEL_AVAILABLE)
+#include <coroutine>    // Provides coroutine_handle, suspend_always, suspend_never
+#include <cstdlib>      // Provides size_t
+#include <deque>        // Provides deque
+#include <exception>    // Provides exception_ptr
+#include <optional>     // Provides optional
+#include "sequence4.h"  // Provides the sequence class
+
+namespace scu_coen70_6B
+{
+    class channel_task
+    {
+    public:
+        struct promise_type
+        {
+            std::exception_ptr failure;
+
+            channel_task get_return_object( )
+            {
+                return channel_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_never initial_suspend( ) noexcept { return std::suspend_never( ); }
+            std::suspend_always final_suspend( ) noexcept { return std::suspend_always( ); }
+            void return_void( ) { }
+            void unhandled_exception( ) { failure = std::current_exception( ); }
+        };
+
+        channel_task(channel_task&& source) noexcept : frame(source.frame) { source.frame = NULL; }
+        channel_task(const channel_task&) = delete;
+        channel_task& operator =(const channel_task&) = delete;
+        ~channel_task( );
+        bool done( ) const { return frame.done( ); }
+        void get( ) const;
+    private:
+        explicit channel_task(std::coroutine_handle<promise_type> started) : frame(started) { }
+
+        std::coroutine_handle<promise_type> frame;
+    };
+
+    template<class Item>
+    class sequence_channel
+    {
+    public:
+        // TYPEDEFS
+        typedef Item value_type;
+        typedef typename sequence<Item>::size_type size_type;
+
+        class push_awaiter
+        {
+        public:
+            push_awaiter(sequence_channel* owner, const Item& entry)
+                : channel(owner), item(entry), accepted(false) { }
+            bool await_ready( );
+            void await_suspend(std::coroutine_handle<> waiting);
+            bool await_resume( ) const { return accepted; }
+        private:
+            friend class sequence_channel;
+
+            sequence_channel* channel;
+            Item item;
+            bool accepted;
+            std::coroutine_handle<> handle;
+        };
+
+        class pop_awaiter
+        {
+        public:
+            explicit pop_awaiter(sequence_channel* owner) : channel(owner) { }
+            bool await_ready( ) const { return (channel->buffer.size( ) > 0) || channel->closed; }
+            void await_suspend(std::coroutine_handle<> waiting) { channel->consumers.push_back(waiting); }
+            std::optional<Item> await_resume( );
+        private:
+            sequence_channel* channel;
+        };
+
+        // CONSTRUCTOR and DESTRUCTOR
+        sequence_channel(size_type high_water = 64);
+        sequence_channel(const sequence_channel&) = delete;
+        sequence_channel& operator =(const sequence_channel&) = delete;
+        ~sequence_channel( );
+        // MODIFICATION MEMBER FUNCTIONS
+        push_awaiter push(const value_type& entry) { return push_awaiter(this, entry); }
+        pop_awaiter pop( ) { return pop_awaiter(this); }
+        void close( );
+        // CONSTANT MEMBER FUNCTIONS
+        size_type size( ) const { return buffer.size( ); }
+        size_type high_water( ) const { return limit; }
+        size_type peak_size( ) const { return peak; }
+        bool is_closed( ) const { return closed; }
+    private:
+        sequence<Item> buffer;
+        size_type limit;
+        size_type peak;
+        bool closed;
+        std::deque<push_awaiter*> producers;
+        std::deque<std::coroutine_handle<>> consumers;
+
+        void put(const Item& entry);
+    };
+}
+#include "sequence_channel.cxx"
+#endif
+#endif
@@ -0,0 +1,489 @@
+// FILE: sequence_channel_exam.cpp
+// Non-interactive test program for the sequence_channel class (see
+// sequence_channel.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the channel, returning some
+// number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. The coroutines
+// are driven by the channel alone, so each test starts them in a chosen
+// order and then checks, after every step, which of them are suspended,
+// what the channel holds and what has been received: that items arrive in
+// order, that a producer is held back at high_water( ) items and let go one
+// item at a time, and that close( ) wakes every waiting coroutine with a
+// failed push or pop while the items already held are still delivered. The
+// program returns EXIT_FAILURE unless every test passes.
+//
+// Build and run (the channel needs C++20 coroutines):
+//     g++ -std=c++20 -O2 sequence_channel_exam.cpp -o sequence_channel_exam
+//     ./sequence_channel_exam
+
+#include <iostream>         // Provides cout.
+#include <cstdlib>          // Provides size_t.
+#include <optional>         // Provides optional.
+#include <stdexcept>        // Provides runtime_error.
+#include <vector>           // Provides vector for the received items.
+#include "sequence_channel.h"  // Provides the sequence_channel and channel_task classes
+using namespace std;
+
+#if defined(SEQUENCE_CHANNEL_AVAILABLE)
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the sequence_channel class",
+    "Testing that items pass in order, with either side started first",
+    "Testing that a producer is held at high_water( ) items (backpressure)",
+    "Testing close( ) with items held and coroutines waiting on both sides",
+    "Testing a coroutine that throws, and pops that resume a producer"
+};
+
+
+// **************************************************************************
+// channel_task produce(sequence_channel<int>& out, int first, int many,
+//                      int& pushed, int& refused, bool closing)
+//   Pushes first, first+1, ..., first+many-1, counting the pushes accepted
+//   in pushed and those refused (because the channel was closed) in
+//   refused. Closes the channel at the end if closing is true.
+// **************************************************************************
+channel_task produce(sequence_channel<int>& out, int first, int many,
+                     int& pushed, int& refused, bool closing)
+{
+    for (int i = first; i < first + many; ++i)
+    {
+        if (co_await out.push(i))
+            ++pushed;
+        else
+            ++refused;
+    }
+    if (closing)
+        out.close( );
+}
+
+
+// **************************************************************************
+// channel_task consume(sequence_channel<int>& in, vector<int>& received,
+//                      int most)
+//   Pops up to most items (or until a pop fails) into received.
+// **************************************************************************
+channel_task consume(sequence_channel<int>& in, vector<int>& received, int most)
+{
+    for (int i = 0; i < most; ++i)
+    {
+        optional<int> x = co_await in.pop( );
+        if (!x)
+            co_return;
+        received.push_back(*x);
+    }
+}
+
+
+// **************************************************************************
+// channel_task explode(sequence_channel<int>& in)
+//   Pops one item and then throws runtime_error.
+// **************************************************************************
+channel_task explode(sequence_channel<int>& in)
+{
+    co_await in.pop( );
+    throw runtime_error("explode");
+}
+
+
+// **************************************************************************
+// bool counts_up(const vector<int>& items, int first, size_t many)
+//   Postcondition: A return value of true indicates that items holds
+//   exactly first, first+1, ..., first+many-1.
+// **************************************************************************
+bool counts_up(const vector<int>& items, int first, size_t many)
+{
+    if (items.size( ) != many)
+        return false;
+    for (size_t i = 0; i < many; ++i)
+    {
+        if (items[i] != first + int(i))
+            return false;
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Passes 1000 items through channels with high_water 1, 2, 7 and 64,
+//   starting the consumer first and then the producer first. Returns
+//   POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    const size_t LIMITS[] = { 1, 2, 7, 64 };
+
+    for (size_t limit : LIMITS)
+    {
+        cout << "Passing 1000 items with high_water " << limit << " ... ";
+        cout.flush( );
+        for (int consumer_first = 1; consumer_first >= 0; --consumer_first)
+        {
+            sequence_channel<int> pipe(limit);
+            vector<int> received;
+            int pushed = 0;
+            int refused = 0;
+
+            if (consumer_first)
+            {
+                channel_task reader = consume(pipe, received, 2000);
+                channel_task writer = produce(pipe, 0, 1000, pushed, refused, true);
+                if (!reader.done( ) || !writer.done( ))
+                {
+                    cout << "a coroutine was left suspended." << endl;
+                    return 0;
+                }
+            }
+            else
+            {
+                channel_task writer = produce(pipe, 0, 1000, pushed, refused, true);
+                channel_task reader = consume(pipe, received, 2000);
+                if (!reader.done( ) || !writer.done( ))
+                {
+                    cout << "a coroutine was left suspended." << endl;
+                    return 0;
+                }
+            }
+            if (!counts_up(received, 0, 1000) || (pushed != 1000) || (refused != 0))
+            {
+                cout << "the items arrived wrong." << endl;
+                return 0;
+            }
+            if ((pipe.size( ) != 0) || !pipe.is_closed( ) || (pipe.peak_size( ) > limit))
+            {
+                cout << "the channel was left in the wrong state." << endl;
+                return 0;
+            }
+            if (!consumer_first && (pipe.peak_size( ) != limit))
+            {
+                cout << "a producer started first did not fill the channel." << endl;
+                return 0;
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Starts a producer of 20 items on a channel holding at most 5, then
+//   takes the items out with consumers of a few items each, checking after
+//   each that the producer has topped the channel up to exactly 5. Returns
+//   POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    sequence_channel<int> pipe(5);
+    vector<int> received;
+    int pushed = 0;
+    int refused = 0;
+    size_t taken = 0;
+
+    cout << "Holding back a producer of 20 items at 5 ... ";
+    cout.flush( );
+    channel_task writer = produce(pipe, 0, 20, pushed, refused, false);
+    if (writer.done( ) || (pipe.size( ) != 5) || (pushed != 5))
+    {
+        cout << "the producer was not stopped at 5 items." << endl;
+        return 0;
+    }
+    while (taken < 20)
+    {
+        size_t most = (taken % 3) + 1;
+        size_t left;
+
+        most = (taken + most > 20) ? 20 - taken : most;
+        {
+            channel_task reader = consume(pipe, received, int(most));
+            if (!reader.done( ))
+            {
+                cout << "a consumer waited although items were held." << endl;
+                return 0;
+            }
+        }
+        taken += most;
+        left = 20 - taken;
+        // Each pop let the producer add one item, until it ran out.
+        if ((pipe.size( ) != (left < 5 ? left : 5)) || (size_t(pushed) != taken + pipe.size( )))
+        {
+            cout << "after " << taken << " pops the channel held " << pipe.size( );
+            cout << " items." << endl;
+            return 0;
+        }
+        if (writer.done( ) != (pushed == 20))
+        {
+            cout << "the producer was resumed at the wrong time." << endl;
+            return 0;
+        }
+    }
+    if (!counts_up(received, 0, 20) || (pipe.peak_size( ) != 5) || (refused != 0))
+    {
+        cout << "the items arrived wrong." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Closes a channel while three producers wait on it, then one while three
+//   consumers wait on it, and checks that every one of them finishes with a
+//   failed push or pop, that held items are still delivered after the close,
+//   and that pushes after the close are refused. Returns POINTS[3] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    cout << "Closing a full channel with three producers waiting ... ";
+    cout.flush( );
+    {
+        sequence_channel<int> pipe(4);
+        vector<int> received;
+        int pushed[3] = { 0, 0, 0 };
+        int refused[3] = { 0, 0, 0 };
+        channel_task first = produce(pipe, 0, 6, pushed[0], refused[0], false);
+        channel_task second = produce(pipe, 100, 3, pushed[1], refused[1], false);
+        channel_task third = produce(pipe, 200, 3, pushed[2], refused[2], false);
+
+        if ((pipe.size( ) != 4) || (pushed[0] != 4) || first.done( ) || second.done( ) || third.done( ))
+        {
+            cout << "the producers were not held back." << endl;
+            return 0;
+        }
+        pipe.close( );
+        // Each waiting push failed; the first producer then had one more to try.
+        if (!first.done( ) || !second.done( ) || !third.done( ))
+        {
+            cout << "close( ) left a producer suspended." << endl;
+            return 0;
+        }
+        if ((refused[0] != 2) || (refused[1] != 3) || (refused[2] != 3) || (pushed[1] + pushed[2] != 0))
+        {
+            cout << "the refused pushes were miscounted." << endl;
+            return 0;
+        }
+        {
+            channel_task reader = consume(pipe, received, 100);
+            if (!reader.done( ) || !counts_up(received, 0, 4) || (pipe.size( ) != 0))
+            {
+                cout << "the items held at the close were not delivered." << endl;
+                return 0;
+            }
+        }
+        {
+            int late_pushed = 0;
+            int late_refused = 0;
+            channel_task late = produce(pipe, 300, 2, late_pushed, late_refused, false);
+            if (!late.done( ) || (late_pushed != 0) || (late_refused != 2) || (pipe.size( ) != 0))
+            {
+                cout << "a push after the close was accepted." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Closing an empty channel with three consumers waiting ... ";
+    cout.flush( );
+    {
+        sequence_channel<int> pipe(4);
+        vector<int> received[3];
+        channel_task first = consume(pipe, received[0], 10);
+        channel_task second = consume(pipe, received[1], 10);
+        channel_task third = consume(pipe, received[2], 10);
+        int pushed = 0;
+        int refused = 0;
+
+        if (first.done( ) || second.done( ) || third.done( ))
+        {
+            cout << "a consumer of an empty channel did not wait." << endl;
+            return 0;
+        }
+        {
+            // Three items go one to each waiting consumer, in the order they waited.
+            channel_task writer = produce(pipe, 7, 3, pushed, refused, false);
+            if (!writer.done( ) || (pushed != 3) || (pipe.size( ) != 0))
+            {
+                cout << "the pushes to waiting consumers went wrong." << endl;
+                return 0;
+            }
+        }
+        if (!counts_up(received[0], 7, 1) || !counts_up(received[1], 8, 1) || !counts_up(received[2], 9, 1))
+        {
+            cout << "the waiting consumers were not served in order." << endl;
+            return 0;
+        }
+        pipe.close( );
+        if (!first.done( ) || !second.done( ) || !third.done( ))
+        {
+            cout << "close( ) left a consumer suspended." << endl;
+            return 0;
+        }
+        if ((received[0].size( ) != 1) || (received[1].size( ) != 1) || (received[2].size( ) != 1))
+        {
+            cout << "a consumer received an item after the close." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Checks that a coroutine that throws finishes and rethrows from get( ),
+//   and that a pop made while a producer waits adds the producer's item in
+//   the same step. Returns POINTS[4] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test4( )
+{
+    cout << "Throwing from a consumer ... ";
+    cout.flush( );
+    {
+        sequence_channel<int> pipe(2);
+        int pushed = 0;
+        int refused = 0;
+        channel_task bomb = explode(pipe);
+        bool caught = false;
+
+        if (bomb.done( ))
+        {
+            cout << "the consumer did not wait for an item." << endl;
+            return 0;
+        }
+        {
+            channel_task writer = produce(pipe, 1, 1, pushed, refused, false);
+        }
+        if (!bomb.done( ))
+        {
+            cout << "the consumer was not resumed." << endl;
+            return 0;
+        }
+        try
+        {
+            bomb.get( );
+        }
+        catch (const runtime_error&)
+        {
+            caught = true;
+        }
+        if (!caught || (pipe.size( ) != 0))
+        {
+            cout << "get( ) did not rethrow the consumer's exception." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Popping from a full channel with a producer waiting ... ";
+    cout.flush( );
+    {
+        sequence_channel<int> pipe(1);
+        vector<int> received;
+        int pushed = 0;
+        int refused = 0;
+        channel_task writer = produce(pipe, 0, 2, pushed, refused, true);
+
+        if (writer.done( ) || (pipe.size( ) != 1))
+        {
+            cout << "the producer was not held back." << endl;
+            return 0;
+        }
+        {
+            channel_task reader = consume(pipe, received, 1);
+        }
+        // The pop took item 0 and let item 1 in; the producer then closed.
+        if (!writer.done( ) || !counts_up(received, 0, 1) || (pipe.size( ) != 1) || !pipe.is_closed( ))
+        {
+            cout << "the waiting producer's item was not added by the pop." << endl;
+            return 0;
+        }
+        {
+            channel_task reader = consume(pipe, received, 5);
+            if (!reader.done( ) || !counts_up(received, 0, 2) || (pipe.peak_size( ) != 1))
+            {
+                cout << "the last item was lost." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main( )
+{
+    cout << "sequence_channel needs C++20 coroutines: build with -std=c++20." << endl;
+    return EXIT_FAILURE;
+}
+
+#endif
@@ -0,0 +1,443 @@
+// FILE: sequence_copy_exam.cpp
+// Non-interactive test program for sequence::assign_parallel (see
+// sequence4.h), the copy that operator= uses for large sequences.
+//
+// DESCRIPTION:
+// Each function of this program tests part of the parallel copy, returning
+// some number of points to indicate how much of the test was passed.
+// A description and result of each test is printed to cout.
+// The tests copy sequences of several sizes with the cursor at every index
+// (and with no current item), by assign_parallel with 1 to 64 workers, and
+// check that the copy has the source's items and current item, as the
+// serial copy does, and that insert and attach afterwards land where the
+// documentation says (which they do only if the copy's precursor and
+// tail_ptr are right). The last test makes copying an item throw part way
+// through, and checks that the sequence is left empty, with its journal and
+// observer told so (built with -fsanitize=address, it also shows that no
+// piece of the copy leaks). The program returns EXIT_FAILURE unless every
+// test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_copy_exam.cpp -o sequence_copy_exam
+//     ./sequence_copy_exam
+
+#include <iostream>     // Provides cout.
+#include <cstdlib>      // Provides size_t.
+#include <new>          // Provides bad_alloc.
+#include <vector>       // Provides vector for the expected items.
+#include "sequence4.h"  // Provides the template sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the parallel copy of the sequence class",
+    "Testing assign_parallel's items and cursor, and attach after it",
+    "Testing insert, and attach at the end, after assign_parallel",
+    "Testing assign_parallel onto a sequence that already has items",
+    "Testing assign_parallel when copying an item throws"
+};
+
+// The sizes of the sequences copied, and the most workers used.
+const size_t SIZES[] = { 0, 1, 2, 3, 7, 33, 70 };
+const size_t MANY_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+const unsigned MOST_WORKERS = 64;
+
+
+// **************************************************************************
+// bool matches(const sequence<int>& test, const vector<int>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item (at
+//   position cursor_spot), or that it has no current item and position( ) ==
+//   size( ) if cursor_spot >= items.size( ). The cursor is not moved.
+// **************************************************************************
+bool matches(const sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+{
+    sequence<int>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || (*it != items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// void fill(sequence<int>& test, size_t n, size_t cursor_spot)
+//   Postcondition: test holds 0, 1, ..., n-1, and item [cursor_spot] is its
+//   current item (no item, if cursor_spot >= n).
+// **************************************************************************
+void fill(sequence<int>& test, size_t n, size_t cursor_spot)
+{
+    for (size_t i = 0; i < n; ++i)
+        test.attach(int(i));
+    test.go_to(cursor_spot);
+}
+
+
+// **************************************************************************
+// void expect_edit(vector<int>& items, size_t& spot, bool inserting)
+//   Postcondition: -1 has been added to items where insert (or attach, if
+//   inserting is false) puts it in a sequence holding items with the cursor
+//   at [spot], and spot is where the new current item is, as documented in
+//   sequence4.h.
+// **************************************************************************
+void expect_edit(vector<int>& items, size_t& spot, bool inserting)
+{
+    if (inserting)
+        spot = (spot < items.size( )) ? spot : 0;
+    else
+        spot = (spot < items.size( )) ? spot + 1 : items.size( );
+    items.insert(items.begin( ) + spot, -1);
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Copies every size with every cursor spot by 1 to MOST_WORKERS workers,
+//   checks the copy and the source, and then checks an attach on the copy.
+//   Returns POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+        vector<int> items;
+
+        for (size_t i = 0; i < n; ++i)
+            items.push_back(int(i));
+        cout << "Copying a sequence of " << n << " items and attaching ... ";
+        cout.flush( );
+        for (size_t spot = 0; spot <= n; ++spot)
+        {
+            sequence<int> source;
+            sequence<int> serial;
+            vector<int> attached = items;
+            size_t attached_spot = spot;
+
+            fill(source, n, spot);
+            serial = source;
+            if (!matches(serial, items, spot))
+            {
+                cout << "Failed: the serial copy is wrong with the cursor at [" << spot << "]." << endl;
+                return 0;
+            }
+            expect_edit(attached, attached_spot, false);
+            for (unsigned workers = 1; workers <= MOST_WORKERS; ++workers)
+            {
+                sequence<int> copy;
+
+                copy.assign_parallel(source, workers);
+                if (!matches(copy, items, spot) || !matches(source, items, spot))
+                {
+                    cout << "Failed with the cursor at [" << spot << "] and ";
+                    cout << workers << " workers." << endl;
+                    return 0;
+                }
+                copy.attach(-1);
+                if (!matches(copy, attached, attached_spot))
+                {
+                    cout << "Failed: attach with the cursor at [" << spot << "] and ";
+                    cout << workers << " workers." << endl;
+                    return 0;
+                }
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Copies as test1 does, then calls insert on the copy, and then seek_end
+//   and attach, checking that each new item lands where it does in the
+//   expected items. Returns POINTS[2] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test2( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+
+        cout << "Copying a sequence of " << n << " items and inserting ... ";
+        cout.flush( );
+        for (size_t spot = 0; spot <= n; ++spot)
+        {
+            sequence<int> source;
+            vector<int> inserted;
+            vector<int> appended;
+            size_t inserted_spot = spot;
+            size_t appended_spot;
+
+            for (size_t i = 0; i < n; ++i)
+                inserted.push_back(int(i));
+            fill(source, n, spot);
+            expect_edit(inserted, inserted_spot, true);
+            appended = inserted;
+            appended_spot = appended.size( );
+            expect_edit(appended, appended_spot, false);
+
+            for (unsigned workers = 1; workers <= MOST_WORKERS; ++workers)
+            {
+                sequence<int> copy;
+
+                copy.assign_parallel(source, workers);
+                copy.insert(-1);
+                if (!matches(copy, inserted, inserted_spot))
+                {
+                    cout << "Failed: insert with the cursor at [" << spot << "] and ";
+                    cout << workers << " workers." << endl;
+                    return 0;
+                }
+                copy.seek_end( );
+                copy.attach(-1);
+                if (!matches(copy, appended, appended_spot))
+                {
+                    cout << "Failed: attach at the end with the cursor at [" << spot << "] and ";
+                    cout << workers << " workers." << endl;
+                    return 0;
+                }
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Copies onto sequences that already hold items (with a current item and
+//   without), and copies a sequence onto itself. Returns POINTS[3] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    const size_t n = 70;
+    vector<int> items;
+
+    for (size_t i = 0; i < n; ++i)
+        items.push_back(int(i));
+
+    cout << "Copying onto sequences of 5 and 200 items ... ";
+    cout.flush( );
+    for (size_t spot = 0; spot <= n; spot += 7)
+    {
+        sequence<int> source;
+
+        fill(source, n, spot);
+        for (unsigned workers = 1; workers <= MOST_WORKERS; workers += 7)
+        {
+            sequence<int> small;
+            sequence<int> large;
+
+            fill(small, 5, 2);
+            fill(large, 200, 200);
+            small.assign_parallel(source, workers);
+            large.assign_parallel(source, workers);
+            if (!matches(small, items, spot) || !matches(large, items, spot))
+            {
+                cout << "Failed with the cursor at [" << spot << "] and ";
+                cout << workers << " workers." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Copying a sequence onto itself ... ";
+    cout.flush( );
+    {
+        sequence<int> source;
+
+        fill(source, n, 40);
+        source.assign_parallel(source, 8);
+        if (!matches(source, items, 40))
+        {
+            cout << "Failed." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// An item whose assignment throws bad_alloc once budget assignments have
+// been made (never, while budget is negative). Nodes copy an item by
+// assigning it, and it is not trivially copyable, so list_copy and
+// list_piece copy it node by node.
+struct fragile
+{
+    static long budget;
+    int value;
+
+    fragile(int v = 0) : value(v) { }
+    fragile(const fragile& source) : value(source.value) { }
+    fragile& operator =(const fragile& source)
+    {
+        if (budget == 0)
+            throw bad_alloc( );
+        if (budget > 0)
+            --budget;
+        value = source.value;
+        return *this;
+    }
+};
+long fragile::budget = -1;
+
+// Counts the resets it is told of.
+class reset_counter : public sequence_observer<fragile>
+{
+public:
+    reset_counter( ) : resets(0) { }
+    void added(const fragile&) { }
+    void removed(const fragile&) { }
+    void reset( ) { ++resets; }
+    size_t resets;
+};
+
+
+// **************************************************************************
+// int test4( )
+//   Copies sequences of up to 9 items, with the cursor at every spot, by 1
+//   and 4 workers, making the copy of each item in turn throw. Each time the
+//   target (which held items, a journal and an observer) must be empty, its
+//   observer told of one reset, a replica synced from its journal empty, and
+//   the target usable afterwards. Returns POINTS[4] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    const unsigned WORKERS[] = { 1, 4 };
+
+    cout << "Copying sequences whose items fail to copy ... ";
+    cout.flush( );
+    for (size_t n = 1; n < 10; ++n)
+    {
+        for (size_t spot = 0; spot <= n; ++spot)
+        {
+            for (size_t w = 0; w < 2; ++w)
+            {
+                for (size_t failing = 0; failing < n; ++failing)
+                {
+                    sequence<fragile> source;
+                    sequence<fragile> target;
+                    reset_counter watch;
+                    bool thrown = false;
+
+                    for (size_t i = 0; i < n; ++i)
+                        source.attach(fragile(int(i)));
+                    source.go_to(spot);
+                    target.attach(fragile(-1));
+                    target.attach(fragile(-2));
+                    target.journal_start( );
+                    sequence<fragile> replica(target);
+                    target.observe(&watch);
+
+                    fragile::budget = long(failing);
+                    try
+                    {
+                        target.assign_parallel(source, WORKERS[w]);
+                    }
+                    catch (const bad_alloc&)
+                    {
+                        thrown = true;
+                    }
+                    fragile::budget = -1;
+                    target.observe(NULL);
+                    target.delta_since(0).apply_delta(replica);
+                    if (!thrown || (target.size( ) != 0) || target.is_item( )
+                        || (target.begin( ) != target.end( )) || (watch.resets != 1)
+                        || (replica.size( ) != 0))
+                    {
+                        cout << "Failed with " << n << " items, the cursor at [" << spot;
+                        cout << "], " << WORKERS[w] << " workers and item " << failing;
+                        cout << " failing." << endl;
+                        return 0;
+                    }
+                    target.attach(fragile(7));
+                    if ((target.size( ) != 1) || (target.current( ).value != 7))
+                    {
+                        cout << "Failed: attach after the failed copy." << endl;
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+// FILE: sequence_delta.cxx
+// CLASS IMPLEMENTED: sequence_delta (see sequence_delta.h for documentation)
+// INVARIANT for the sequence_delta class:
+//   1. edits[i] is the edit that took the source from version
+//      first_version + i to first_version + i + 1.
+//
+//   2. cursor_index is where apply_delta leaves the target's cursor.
+
+#include <cassert>      // Provides assert
+#include <type_traits>  // Provides is_trivially_copyable
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    sequence_delta<Item>::sequence_delta(size_type version)
+    {
+        first_version = version;
+        cursor_index = 0;
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::record_insert(size_type index, const value_type& entry)
+    {
+        edit e;
+
+        e.op = INSERT_AT;
+        e.index = index;
+        e.value = entry;
+        edits.push_back(e);
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::record_remove(size_type index)
+    {
+        edit e;
+
+        e.op = REMOVE_AT;
+        e.index = index;
+        edits.push_back(e);
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::record_clear( )
+    {
+        edit e;
+
+        e.op = CLEAR;
+        e.index = 0;
+        edits.push_back(e);
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::trim(size_type version)
+    {
+        assert((first_version <= version) && (version <= to_version( )));
+
+        edits.erase(edits.begin( ), edits.begin( ) + (version - first_version));
+        first_version = version;
+    }
+
+    template<class Item>
+    sequence_delta<Item> sequence_delta<Item>::since(size_type version) const
+    {
+        assert((first_version <= version) && (version <= to_version( )));
+        sequence_delta answer(version);
+
+        answer.edits.assign(edits.begin( ) + (version - first_version), edits.end( ));
+        answer.cursor_index = cursor_index;
+        return answer;
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::apply_delta(sequence<Item>& target) const
+    {
+        for (std::size_t i = 0; i < edits.size( ); ++i)
+        {
+            const edit& e = edits[i];
+
+            switch (e.op)
+            {
+            case INSERT_AT:
+                assert(e.index <= target.size( ));
+                if (e.index < target.size( ))
+                {
+                    target.go_to(e.index);
+                    target.insert(e.value);
+                }
+                else
+                {
+                    // A new last item: attach after the tail.
+                    target.seek_end( );
+                    target.attach(e.value);
+                }
+                break;
+            case REMOVE_AT:
+                assert(e.index < target.size( ));
+                target.go_to(e.index);
+                target.remove_current( );
+                break;
+            case CLEAR:
+                target.clear( );
+                break;
+            }
+        }
+        target.go_to(cursor_index);
+    }
+
+    // Writes number 7 bits at a time, low bits first; the high bit of each
+    // byte says whether another byte follows.
+    template<class Item>
+    void sequence_delta<Item>::write_number(std::ostream& out, size_type number)
+    {
+        while (number >= 0x80)
+        {
+            out.put(char((number & 0x7F) | 0x80));
+            number >>= 7;
+        }
+        out.put(char(number));
+    }
+
+    template<class Item>
+    bool sequence_delta<Item>::read_number(std::istream& in, size_type& number)
+    {
+        int byte;
+        unsigned shift = 0;
+
+        number = 0;
+        do
+        {
+            byte = in.get( );
+            if ((byte == std::istream::traits_type::eof( )) || (shift >= 8 * sizeof(size_type)))
+                return false;
+            number |= size_type(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return true;
+    }
+
+    template<class Item>
+    void sequence_delta<Item>::write(std::ostream& out) const
+    {
+        static_assert(std::is_trivially_copyable<Item>::value,
+                      "sequence_delta::write needs a trivially copyable value_type");
+
+        out.write("SQD1", 4);
+        write_number(out, from_version( ));
+        write_number(out, to_version( ));
+        write_number(out, cursor_index);
+        for (std::size_t i = 0; i < edits.size( ); ++i)
+        {
+            out.put(char(edits[i].op));
+            write_number(out, edits[i].index);
+            if (edits[i].op == INSERT_AT)
+                out.write(reinterpret_cast<const char*>(&edits[i].value), sizeof(Item));
+        }
+    }
+
+    template<class Item>
+    bool sequence_delta<Item>::read(std::istream& in)
+    {
+        static_assert(std::is_trivially_copyable<Item>::value,
+                      "sequence_delta::read needs a trivially copyable value_type");
+        char magic[4];
+        size_type from, to, cursor_at;
+        sequence_delta answer;
+        edit e;
+        int op;
+
+        if (!in.read(magic, 4) || (magic[0] != 'S') || (magic[1] != 'Q') || (magic[2] != 'D') || (magic[3] != '1'))
+            return false;
+        if (!read_number(in, from) || !read_number(in, to) || !read_number(in, cursor_at) || (to < from))
+            return false;
+        answer.first_version = from;
+        answer.cursor_index = cursor_at;
+        for (size_type i = from; i < to; ++i)
+        {
+            op = in.get( );
+            if (((op != INSERT_AT) && (op != REMOVE_AT) && (op != CLEAR)) || !read_number(in, e.index))
+                return false;
+            e.op = static_cast<unsigned char>(op);
+            if ((op == INSERT_AT) && !in.read(reinterpret_cast<char*>(&e.value), sizeof(Item)))
+                return false;
+            answer.edits.push_back(e);
+        }
+        *this = answer;
+        return true;
+    }
+}
@@ -0,0 +1,139 @@
+// FILE: sequence_delta.h
+// CLASS PROVIDED: sequence_delta (part of the namespace scu_coen70_6B)
+// A list of edits to a sequence (sequence4.h), addressed by item index, that
+// brings a stale copy of the sequence up to date without copying the whole
+// thing. A sequence records its own edits once journal_start( ) has been
+// called, and delta_since(v) returns the edits made after its version v:
+//
+//     sequence<double> master;
+//     master.journal_start( );
+//     sequence<double> replica(master);                // both at version 0
+//     size_t synced = master.version( );
+//     ... edit master ...
+//     master.delta_since(synced).apply_delta(replica);  // replica == master
+//     synced = master.version( );
+//
+// A delta can also be written to a stream (a file, a socket) in a compact
+// binary form and read back on the other side.
+//
+// Every insert, attach and remove_current is one edit, as is each item added
+// by append, and clear( ) (which empties the sequence) is one edit. Assigning
+// another sequence to a journaled one is recorded as a clear followed by
+// every new item. Changing an item through an iterator is NOT recorded.
+//
+// TYPEDEFS for the sequence_delta class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//     As in sequence4.h.
+//
+// CONSTRUCTOR for the sequence_delta class:
+//   sequence_delta(size_type version = 0)
+//     Postcondition: The delta holds no edits and starts at version.
+//
+// MODIFICATION MEMBER FUNCTIONS for the sequence_delta class:
+//   void record_insert(size_type index, const value_type& entry)
+//   void record_remove(size_type index)
+//   void record_clear( )
+//     Postcondition: The edit "entry is now item number index", "item
+//     number index was removed", or "every item was removed" has been added
+//     at the end of the delta. (sequence calls these for its journal.)
+//
+//   void set_cursor(size_type index)
+//     Postcondition: apply_delta will leave the target's cursor at item
+//     number index (no current item if index is the target's size).
+//
+//   void trim(size_type version)
+//     Precondition: from_version( ) <= version <= to_version( ).
+//     Postcondition: The edits before version have been dropped, and
+//     from_version( ) is version.
+//
+//   bool read(std::istream& in)
+//     Precondition: value_type is trivially copyable.
+//     Postcondition: If in held a delta written by write (on a machine with
+//     the same byte order and value_type), this delta is now a copy of it
+//     and the return value is true. Otherwise the return value is false and
+//     this delta is unchanged.
+//
+// CONSTANT MEMBER FUNCTIONS for the sequence_delta class:
+//   size_type from_version( ) const
+//   size_type to_version( ) const
+//     Postcondition: The return values are the versions the delta starts and
+//     ends at; to_version( ) - from_version( ) is the number of edits.
+//
+//   size_type cursor( ) const
+//     Postcondition: The return value is the index given to set_cursor.
+//
+//   sequence_delta since(size_type version) const
+//     Precondition: from_version( ) <= version <= to_version( ).
+//     Postcondition: The return value holds the edits of this delta from
+//     version on, and the same cursor.
+//
+//   void apply_delta(sequence<value_type>& target) const
+//     Precondition: target holds the items its source held at from_version( ).
+//     Postcondition: The edits have been made to target, in order, so that
+//     it holds the items its source held at to_version( ), and its cursor is
+//     at cursor( ). Each edit moves target's cursor to its index with go_to,
+//     walking forward from the last edit when it can, so a batch of edits in
+//     one part of a long sequence costs about O(edits + span of the edits),
+//     not O(size).
+//
+//   void write(std::ostream& out) const
+//     Precondition: value_type is trivially copyable.
+//     Postcondition: The delta has been written to out as: the four bytes
+//     "SQD1", then from_version, to_version and cursor as variable-length
+//     integers (7 bits per byte, low bits first), then each edit as one
+//     operation byte, its index as a variable-length integer, and (for an
+//     insert) the raw bytes of the item.
+
+#ifndef COEN_70_SEQUENCE_DELTA_H
+#define COEN_70_SEQUENCE_DELTA_H
+#include <cstdlib>  // Provides size_t
+#include <istream>  // Provides istream
+#include <ostream>  // Provides ostream
+#include <vector>   // Provides vector
+#include "sequence4.h"  // Provides the sequence class
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    class sequence_delta
+    {
+    public:
+        // TYPEDEFS
+        typedef Item value_type;
+        typedef std::size_t size_type;
+        // CONSTRUCTOR
+        sequence_delta(size_type version = 0);
+        // MODIFICATION MEMBER FUNCTIONS
+        void record_insert(size_type index, const value_type& entry);
+        void record_remove(size_type index);
+        void record_clear( );
+        void set_cursor(size_type index) { cursor_index = index; }
+        void trim(size_type version);
+        bool read(std::istream& in);
+        // CONSTANT MEMBER FUNCTIONS
+        size_type from_version( ) const { return first_version; }
+        size_type to_version( ) const { return first_version + edits.size( ); }
+        size_type cursor( ) const { return cursor_index; }
+        sequence_delta since(size_type version) const;
+        void apply_delta(sequence<Item>& target) const;
+        void write(std::ostream& out) const;
+    private:
+        enum operation { INSERT_AT = 1, REMOVE_AT = 2, CLEAR = 3 };
+        struct edit
+        {
+            unsigned char op;
+            size_type index;
+            Item value;             // Only used by INSERT_AT
+        };
+
+        std::vector<edit> edits;
+        size_type first_version;
+        size_type cursor_index;
+
+        static void write_number(std::ostream& out, size_type number);
+        static bool read_number(std::istream& in, size_type& number);
+    };
+}
+#include "sequence_delta.cxx"
+#endif
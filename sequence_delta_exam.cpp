@@ -0,0 +1,410 @@
+// FILE: sequence_delta_exam.cpp
+// Non-interactive test program for the change journal of the sequence class
+// and the sequence_delta class (see sequence_delta.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the journal, returning some
+// number of points to indicate how much of the test was passed.
+// A description and result of each test is printed to cout.
+// A journaled master sequence gets a long run of random edits (insert,
+// attach, remove_current, clear, append, sort and reverse, with the cursor
+// moved about in between), and now and then a stale replica is brought up
+// to date by delta_since and apply_delta, directly or through the "SQD1"
+// binary form (write, then read). The replica must then equal the master,
+// items and cursor. Other tests check that write and read round-trip
+// exactly, and that read rejects truncated or corrupt input and leaves the
+// delta unchanged. The program returns EXIT_FAILURE unless every test
+// passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_delta_exam.cpp -o sequence_delta_exam
+//     ./sequence_delta_exam
+
+#include <iostream>     // Provides cout.
+#include <cstdlib>      // Provides size_t.
+#include <random>       // Provides mt19937 for the edits.
+#include <sstream>      // Provides stringstream for the binary form.
+#include <string>       // Provides string.
+#include <vector>       // Provides vector.
+#include "sequence4.h"  // Provides the template sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 3;
+const int POINTS[MANY_TESTS+1] = {
+    12,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4   // Test 3 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the change journal of the sequence class",
+    "Testing apply_delta after random edits, directly and through write/read",
+    "Testing that write and read round-trip exactly",
+    "Testing that read rejects truncated or corrupt input"
+};
+
+
+// **************************************************************************
+// bool same(const sequence<double>& a, const sequence<double>& b)
+//   Postcondition: A return value of true indicates that a and b hold the
+//   same items in the same order, and have their cursors at the same
+//   position (or neither has a current item).
+// **************************************************************************
+bool same(const sequence<double>& a, const sequence<double>& b)
+{
+    sequence<double>::const_iterator i = a.begin( );
+    sequence<double>::const_iterator j = b.begin( );
+
+    if ((a.size( ) != b.size( )) || (a.position( ) != b.position( )) || (a.is_item( ) != b.is_item( )))
+        return false;
+    for (; (i != a.end( )) && (j != b.end( )); ++i, ++j)
+    {
+        if (*i != *j)
+            return false;
+    }
+    return (i == a.end( )) && (j == b.end( ));
+}
+
+
+// **************************************************************************
+// string bytes_of(const sequence_delta<double>& delta)
+//   Postcondition: The return value is what delta.write writes.
+// **************************************************************************
+string bytes_of(const sequence_delta<double>& delta)
+{
+    ostringstream out;
+
+    delta.write(out);
+    return out.str( );
+}
+
+
+// **************************************************************************
+// void random_edit(sequence<double>& master, mt19937& random)
+//   Postcondition: One random edit has been made to master, or its cursor
+//   has been moved.
+// **************************************************************************
+void random_edit(sequence<double>& master, mt19937& random)
+{
+    double value = double(random( ) % 1000) / 8.0;
+    double run[3] = { value, value + 1, value + 2 };
+
+    switch (random( ) % 16)
+    {
+    case 0: case 1: case 2:
+        master.insert(value);
+        break;
+    case 3: case 4: case 5:
+        master.attach(value);
+        break;
+    case 6: case 7: case 8:
+        if (master.is_item( ))
+            master.remove_current( );
+        break;
+    case 9:
+        if (random( ) % 8 == 0)
+            master.clear( );
+        break;
+    case 10:
+        master.append(run, run + 3);
+        break;
+    case 11:
+        master.sort( );
+        break;
+    case 12:
+        master.reverse( );
+        break;
+    case 13:
+        master.start( );
+        break;
+    default:
+        master.go_to(random( ) % (master.size( ) + 1));
+        break;
+    }
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Makes 20000 random edits to a journaled master and syncs two replicas
+//   every few edits: one by apply_delta, one through write and read. Returns
+//   POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    sequence<double> master;
+    mt19937 random(2024);
+    size_t synced;
+    size_t edits = 0;
+
+    cout << "Syncing replicas of a master through 20000 random edits ... ";
+    cout.flush( );
+    for (size_t i = 0; i < 20; ++i)
+        master.attach(double(i));
+    master.journal_start( );
+
+    sequence<double> direct(master);
+    sequence<double> streamed(master);
+    synced = master.version( );
+    while (edits < 20000)
+    {
+        size_t batch = random( ) % 40;
+
+        for (size_t i = 0; i < batch; ++i, ++edits)
+            random_edit(master, random);
+
+        sequence_delta<double> delta = master.delta_since(synced);
+        sequence_delta<double> received;
+        stringstream wire;
+
+        delta.apply_delta(direct);
+        delta.write(wire);
+        if (!received.read(wire))
+        {
+            cout << "Failed: read rejected what write wrote." << endl;
+            return 0;
+        }
+        received.apply_delta(streamed);
+        if (!same(direct, master) || !same(streamed, master))
+        {
+            cout << "Failed: a replica differs from the master after ";
+            cout << edits << " edits." << endl;
+            return 0;
+        }
+        synced = master.version( );
+        // Keep the journal short, as a long-running master would
+        if (random( ) % 4 == 0)
+            master.journal_trim(synced);
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Writes deltas (empty, small, and with versions, indexes and a cursor
+//   that need several bytes each), reads them back, and checks that the
+//   copy writes the same bytes and has the same versions and cursor.
+//   Returns POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    vector<sequence_delta<double> > deltas;
+    sequence_delta<double> empty;
+    sequence_delta<double> small;
+    sequence_delta<double> wide(size_t(1) << 40);
+
+    small.record_insert(0, 1.5);
+    small.record_insert(1, -2.25);
+    small.record_remove(0);
+    small.set_cursor(1);
+    wide.record_clear( );
+    wide.record_insert(0, 3.0);
+    wide.record_insert(200, 4.0);
+    wide.record_remove(123456789);
+    wide.set_cursor(size_t(1) << 33);
+    deltas.push_back(empty);
+    deltas.push_back(small);
+    deltas.push_back(wide);
+
+    cout << "Writing and reading back deltas ... ";
+    cout.flush( );
+    for (size_t d = 0; d < deltas.size( ); ++d)
+    {
+        string written = bytes_of(deltas[d]);
+        istringstream in(written);
+        sequence_delta<double> copy;
+
+        if ((written.compare(0, 4, "SQD1") != 0) || !copy.read(in))
+        {
+            cout << "Failed: delta " << d << " was not read back." << endl;
+            return 0;
+        }
+        if ((copy.from_version( ) != deltas[d].from_version( ))
+            || (copy.to_version( ) != deltas[d].to_version( ))
+            || (copy.cursor( ) != deltas[d].cursor( ))
+            || (bytes_of(copy) != written)
+            || (in.peek( ) != istringstream::traits_type::eof( )))
+        {
+            cout << "Failed: delta " << d << " changed in the round trip." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Applying a read-back delta ... ";
+    cout.flush( );
+    {
+        sequence<double> target;
+        sequence<double> expected;
+        istringstream in(bytes_of(small));
+        sequence_delta<double> copy;
+
+        copy.read(in);
+        copy.apply_delta(target);
+        expected.attach(-2.25);
+        expected.seek_end( );   // The cursor was set past the last item
+        if (!same(target, expected))
+        {
+            cout << "Failed." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// bool rejected(const string& input)
+//   Postcondition: A return value of true indicates that read returned
+//   false for input and left a delta that already held edits unchanged.
+// **************************************************************************
+bool rejected(const string& input)
+{
+    sequence_delta<double> delta(7);
+    string before;
+    istringstream in(input);
+
+    delta.record_insert(0, 42.0);
+    delta.set_cursor(1);
+    before = bytes_of(delta);
+    return !delta.read(in) && (bytes_of(delta) == before);
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Feeds read every strict prefix of a valid delta, and valid deltas with
+//   a wrong magic number, an unknown operation byte, to < from, and a
+//   number too long for size_type. Returns POINTS[3] if the tests are
+//   passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    sequence_delta<double> delta(300);
+    string valid;
+    string corrupt;
+
+    delta.record_insert(0, 1.0);
+    delta.record_insert(1, 2.0);
+    delta.record_remove(0);
+    delta.record_clear( );
+    delta.record_insert(0, 3.0);
+    delta.set_cursor(1);
+    valid = bytes_of(delta);
+
+    cout << "Reading every truncation of a valid delta ... ";
+    cout.flush( );
+    for (size_t length = 0; length < valid.size( ); ++length)
+    {
+        if (!rejected(valid.substr(0, length)))
+        {
+            cout << "Failed: read accepted the first " << length << " of ";
+            cout << valid.size( ) << " bytes." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Reading a delta with a wrong magic number ... ";
+    cout.flush( );
+    corrupt = valid;
+    corrupt[3] = '2';
+    if (!rejected(corrupt) || !rejected("") || !rejected("SQD"))
+    {
+        cout << "Failed." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Reading a delta with an unknown operation ... ";
+    cout.flush( );
+    // "SQD1", from (300, two bytes), to (305, two bytes), cursor (one byte),
+    // then the first edit's operation byte
+    corrupt = valid;
+    corrupt[9] = char(0x7E);
+    if (!rejected(corrupt))
+    {
+        cout << "Failed." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Reading a delta that ends before it starts ... ";
+    cout.flush( );
+    {
+        ostringstream out;
+
+        out.write("SQD1", 4);
+        out.put(char(5));   // from
+        out.put(char(2));   // to
+        out.put(char(0));   // cursor
+        if (!rejected(out.str( )))
+        {
+            cout << "Failed." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Reading a number too long for size_type ... ";
+    cout.flush( );
+    corrupt = "SQD1" + string(12, char(0xFF)) + string(1, char(0x01));
+    if (!rejected(corrupt))
+    {
+        cout << "Failed." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
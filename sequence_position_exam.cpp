@@ -0,0 +1,420 @@
+// FILE: sequence_position_exam.cpp
+// Non-interactive test program for the cursor index of the sequence class
+// (position, advance(steps), go_to and seek_end; see sequence4.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the cursor index, returning
+// some number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. position( ) is
+// kept up to date by every member rather than counted when asked, so the
+// tests check it after each kind of edit: the single-item edits against a
+// vector that models the sequence, the moves from every starting spot, and
+// the members that relink or remove many nodes at once, including with no
+// current item, where position( ) must equal the new size( ). The program
+// returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_position_exam.cpp -o sequence_position_exam
+//     ./sequence_position_exam
+
+#include <algorithm>    // Provides find, sort, reverse.
+#include <iostream>     // Provides cout.
+#include <cstdlib>      // Provides size_t.
+#include <random>       // Provides mt19937 for the random edits.
+#include <vector>       // Provides vector for the expected items.
+#include "sequence4.h"  // Provides the template sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 3;
+const int POINTS[MANY_TESTS+1] = {
+    12,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4   // Test 3 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the cursor index of the sequence class",
+    "Testing position after random inserts, attaches, removes and moves",
+    "Testing advance(steps), go_to and seek_end from every spot",
+    "Testing position after sort, reverse, rotate, stable_partition and unique"
+};
+
+// The sizes of the sequences moved through.
+const size_t SIZES[] = { 0, 1, 2, 7 };
+const size_t MANY_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+
+// **************************************************************************
+// bool matches(const sequence<int>& test, const vector<int>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item (at
+//   position cursor_spot), or that it has no current item and position( ) ==
+//   size( ) if cursor_spot >= items.size( ). The cursor is not moved.
+// **************************************************************************
+bool matches(const sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+{
+    sequence<int>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || (*it != items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// void fill(sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+//   Postcondition: test holds the items, and item [cursor_spot] is its
+//   current item (no item, if cursor_spot >= items.size( )).
+// **************************************************************************
+void fill(sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+{
+    for (size_t i = 0; i < items.size( ); ++i)
+        test.attach(items[i]);
+    test.go_to(cursor_spot);
+}
+
+
+// **************************************************************************
+// vector<int> count_up(size_t n)
+//   Postcondition: The return value holds 0, 1, ..., n-1.
+// **************************************************************************
+vector<int> count_up(size_t n)
+{
+    vector<int> answer(n);
+
+    for (size_t i = 0; i < n; ++i)
+        answer[i] = int(i);
+    return answer;
+}
+
+
+// **************************************************************************
+// template<class Rearrange>
+// bool check(const char name[], const vector<int>& items, Rearrange rearrange,
+//            const vector<int>& expected, const vector<size_t>& moved_to)
+//   Precondition: rearrange(test) calls the member under test on test.
+//   expected is what items become, and moved_to[i] is where the cursor goes
+//   from item [i] (an index of expected, or expected.size( ) for none).
+//   Postcondition: A return value of true indicates that, with the cursor
+//   at each item and at none, rearrange left expected with the cursor at
+//   moved_to (none staying none), and that attach after seek_end lands at
+//   the end. Otherwise a message naming the case is printed.
+// **************************************************************************
+template<class Rearrange>
+bool check(const char name[], const vector<int>& items, Rearrange rearrange,
+           const vector<int>& expected, const vector<size_t>& moved_to)
+{
+    for (size_t spot = 0; spot <= items.size( ); ++spot)
+    {
+        sequence<int> test;
+        vector<int> longer = expected;
+        size_t after = (spot < items.size( )) ? moved_to[spot] : expected.size( );
+
+        fill(test, items, spot);
+        rearrange(test);
+        if (!matches(test, expected, after))
+        {
+            cout << name << " on " << items.size( ) << " items, cursor at ";
+            cout << spot << ", left the wrong items or position." << endl;
+            return false;
+        }
+        test.seek_end( );
+        test.attach(-1);
+        longer.push_back(-1);
+        if (!matches(test, longer, expected.size( )))
+        {
+            cout << name << " on " << items.size( ) << " items, cursor at ";
+            cout << spot << ": attach after seek_end went wrong." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Makes 20000 random edits and moves, checking position( ) after each
+//   against a vector edited the same way. Returns POINTS[1] if the tests
+//   are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    mt19937 random(34);
+    sequence<int> test;
+    vector<int> items;
+    size_t spot = 0;
+    int next = 0;
+
+    cout << "Making random edits ... ";
+    cout.flush( );
+    for (int step = 0; step < 20000; ++step)
+    {
+        bool have = spot < items.size( );
+
+        switch (random( ) % 9)
+        {
+        case 0:
+        case 1:
+            test.insert(next);
+            spot = have ? spot : 0;
+            items.insert(items.begin( ) + spot, next++);
+            break;
+        case 2:
+        case 3:
+            test.attach(next);
+            spot = have ? spot + 1 : items.size( );
+            items.insert(items.begin( ) + spot, next++);
+            break;
+        case 4:
+            if (have)
+            {
+                test.remove_current( );
+                items.erase(items.begin( ) + spot);
+            }
+            break;
+        case 5:
+            if (have)
+            {
+                test.advance( );
+                ++spot;
+            }
+            break;
+        case 6:
+            spot = items.empty( ) ? 0 : random( ) % (items.size( ) + 1);
+            test.go_to(spot);
+            break;
+        case 7:
+            if (random( ) % 4 == 0)
+            {
+                test.seek_end( );
+                spot = items.size( );
+            }
+            else
+            {
+                test.start( );
+                spot = 0;
+            }
+            break;
+        case 8:
+            {
+                // A copy keeps the cursor at the same position.
+                sequence<int> copy(test);
+                test = copy;
+            }
+            break;
+        }
+        spot = (spot < items.size( )) ? spot : items.size( );
+        if (!matches(test, items, spot))
+        {
+            cout << "step " << step << " left the wrong items or position." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Tests advance(steps) for every valid steps, and go_to(k) for every k up
+//   to size( ) + 1, from every starting spot, and seek_end. Returns
+//   POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+        vector<int> items = count_up(n);
+
+        cout << "Moving through a sequence of " << n << " items ... ";
+        cout.flush( );
+        for (size_t from = 0; from <= n; ++from)
+        {
+            for (size_t steps = 0; from + steps <= n; ++steps)
+            {
+                sequence<int> test;
+
+                fill(test, items, from);
+                test.advance(steps);
+                if (!matches(test, items, from + steps))
+                {
+                    cout << "advance(" << steps << ") from " << from << " failed." << endl;
+                    return 0;
+                }
+            }
+            for (size_t k = 0; k <= n + 1; ++k)
+            {
+                sequence<int> test;
+
+                fill(test, items, from);
+                test.go_to(k);
+                if (!matches(test, items, k))
+                {
+                    cout << "go_to(" << k << ") from " << from << " failed." << endl;
+                    return 0;
+                }
+            }
+            {
+                sequence<int> test;
+
+                fill(test, items, from);
+                test.seek_end( );
+                if (!matches(test, items, n))
+                {
+                    cout << "seek_end( ) from " << from << " failed." << endl;
+                    return 0;
+                }
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Tests position( ) after the members that relink or remove many nodes at
+//   once, with the cursor at each item and at none. unique with no current
+//   item used to leave position( ) at the old size( ). Returns POINTS[3] if
+//   the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    // Items with duplicates, unsorted (the hash path of unique) and sorted.
+    const vector<int> LISTS[] = {
+        { }, { 5 }, { 5, 5 }, { 3, 1, 3, 2, 1, 1, 4 }, { 1, 1, 2, 2, 2, 3, 4, 4 }
+    };
+
+    for (const vector<int>& items : LISTS)
+    {
+        size_t n = items.size( );
+        vector<size_t> order(n);
+        vector<int> sorted;
+        vector<int> reversed(items.rbegin( ), items.rend( ));
+        vector<int> rotated = items;
+        vector<int> evens;
+        vector<int> kept;
+        vector<size_t> to_sorted(n);
+        vector<size_t> to_reversed(n);
+        vector<size_t> to_rotated(n);
+        vector<size_t> to_evens(n);
+        vector<size_t> to_kept(n);
+        size_t k = (n > 0) ? n / 2 : 0;
+
+        cout << "Rearranging a sequence of " << n << " items ... ";
+        cout.flush( );
+        // The stable orders of the items, and where each item goes.
+        for (size_t i = 0; i < n; ++i)
+            order[i] = i;
+        stable_sort(order.begin( ), order.end( ),
+                    [&items](size_t a, size_t b) { return items[a] < items[b]; });
+        for (size_t i = 0; i < n; ++i)
+        {
+            sorted.push_back(items[order[i]]);
+            to_sorted[order[i]] = i;
+            to_reversed[i] = n - 1 - i;
+            to_rotated[i] = (i + n - k) % n;
+        }
+        if (n > 0)
+            std::rotate(rotated.begin( ), rotated.begin( ) + k, rotated.end( ));
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if ((items[i] % 2 == 0) == (pass == 0))
+                {
+                    to_evens[i] = evens.size( );
+                    evens.push_back(items[i]);
+                }
+            }
+        }
+        // A removed cursor moves to the next item kept.
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (find(kept.begin( ), kept.end( ), items[i]) == kept.end( ))
+                kept.push_back(items[i]);
+            to_kept[i] = kept.size( ) - 1;
+        }
+        for (size_t i = n; i-- > 0; )
+        {
+            bool first = find(items.begin( ), items.begin( ) + i, items[i]) == items.begin( ) + i;
+            if (!first)
+                to_kept[i] = (i + 1 < n) ? to_kept[i+1] : kept.size( );
+        }
+
+        if (!check("sort", items, [](sequence<int>& t) { t.sort( ); }, sorted, to_sorted)
+            || !check("reverse", items, [](sequence<int>& t) { t.reverse( ); }, reversed, to_reversed)
+            || !check("rotate", items, [k](sequence<int>& t) { t.rotate(k); }, rotated, to_rotated)
+            || !check("stable_partition", items,
+                      [](sequence<int>& t) { t.stable_partition([](int x) { return x % 2 == 0; }); },
+                      evens, to_evens)
+            || !check("unique", items, [](sequence<int>& t) { t.unique( ); }, kept, to_kept))
+            return 0;
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,444 @@
+// FILE: sequence_rearrange_exam.cpp
+// Non-interactive test program for the rearranging members of the sequence
+// class (reverse, rotate, partition and stable_partition; see sequence4.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the rearranging members,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout.
+// Each member relinks head_ptr, tail_ptr, cursor and precursor, so every
+// call is made on sequences of 0, 1, 2 and 7 items with the cursor at each
+// item (the head, the middle and the tail among them) and with no current
+// item. After the call the test checks the items, that the cursor is still
+// on the same item, and then that insert, attach, and seek_end followed by
+// attach land where they should, which they do only if the precursor and
+// tail_ptr were relinked correctly. The program returns EXIT_FAILURE unless
+// every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_rearrange_exam.cpp -o sequence_rearrange_exam
+//     ./sequence_rearrange_exam
+
+#include <algorithm>    // Provides find, reverse, rotate, stable_partition.
+#include <iostream>     // Provides cout.
+#include <cstdlib>      // Provides size_t.
+#include <vector>       // Provides vector for the expected items.
+#include "sequence4.h"  // Provides the template sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the rearranging members of the sequence class",
+    "Testing reverse",
+    "Testing rotate, including rotate(0), rotate(size()) and rotate(k > size())",
+    "Testing partition and stable_partition",
+    "Testing stable_partition with a predicate that throws"
+};
+
+// The sizes of the sequences rearranged.
+const size_t SIZES[] = { 0, 1, 2, 7 };
+const size_t MANY_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+
+// **************************************************************************
+// bool matches(const sequence<int>& test, const vector<int>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item (at
+//   position cursor_spot), or that it has no current item and position( ) ==
+//   size( ) if cursor_spot >= items.size( ). The cursor is not moved.
+// **************************************************************************
+bool matches(const sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+{
+    sequence<int>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || (*it != items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// void fill(sequence<int>& test, size_t n, size_t cursor_spot)
+//   Postcondition: test holds 0, 1, ..., n-1, and item [cursor_spot] is its
+//   current item (no item, if cursor_spot >= n).
+// **************************************************************************
+void fill(sequence<int>& test, size_t n, size_t cursor_spot)
+{
+    for (size_t i = 0; i < n; ++i)
+        test.attach(int(i));
+    test.go_to(cursor_spot);
+}
+
+
+// **************************************************************************
+// void expect_edit(vector<int>& items, size_t& spot, bool inserting)
+//   Postcondition: -1 has been added to items where insert (or attach, if
+//   inserting is false) puts it in a sequence holding items with the cursor
+//   at [spot], and spot is where the new current item is, as documented in
+//   sequence4.h.
+// **************************************************************************
+void expect_edit(vector<int>& items, size_t& spot, bool inserting)
+{
+    if (inserting)
+        spot = (spot < items.size( )) ? spot : 0;
+    else
+        spot = (spot < items.size( )) ? spot + 1 : items.size( );
+    items.insert(items.begin( ) + spot, -1);
+}
+
+
+// **************************************************************************
+// template<class Rearrange>
+// bool check(const char name[], size_t n, size_t spot, Rearrange rearrange,
+//            const vector<int>& expected)
+//   Precondition: rearrange(test) calls the member under test on test, and
+//   returns false if it did not behave as expected otherwise (a wrong
+//   return value, say). expected is what 0, 1, ..., n-1 become.
+//   Postcondition: A return value of true indicates that, on sequences
+//   made by fill(test, n, spot), rearrange left the items in expected with
+//   the cursor on the item it was on (or no current item), and that insert,
+//   attach, and seek_end and attach afterwards put -1 where they should.
+//   Otherwise a description of the failure is printed to cout.
+// **************************************************************************
+template<class Rearrange>
+bool check(const char name[], size_t n, size_t spot, Rearrange rearrange,
+           const vector<int>& expected)
+{
+    size_t expected_spot = n;
+    vector<int> inserted = expected;
+    vector<int> attached = expected;
+    vector<int> appended;
+    size_t inserted_spot;
+    size_t attached_spot;
+    size_t appended_spot;
+    sequence<int> first;
+    sequence<int> second;
+
+    if (spot < n)
+        expected_spot = size_t(find(expected.begin( ), expected.end( ), int(spot)) - expected.begin( ));
+    inserted_spot = expected_spot;
+    attached_spot = expected_spot;
+    expect_edit(inserted, inserted_spot, true);
+    expect_edit(attached, attached_spot, false);
+    appended = inserted;
+    appended_spot = appended.size( );
+    expect_edit(appended, appended_spot, false);
+
+    fill(first, n, spot);
+    if (!rearrange(first) || !matches(first, expected, expected_spot))
+    {
+        cout << "\n    " << name << " on " << n << " items with the cursor at [";
+        cout << spot << "] left the wrong items or cursor." << endl;
+        return false;
+    }
+    first.insert(-1);
+    if (!matches(first, inserted, inserted_spot))
+    {
+        cout << "\n    insert after " << name << " on " << n << " items with the cursor at [";
+        cout << spot << "] went wrong (precursor or head_ptr)." << endl;
+        return false;
+    }
+    first.seek_end( );
+    first.attach(-1);
+    if (!matches(first, appended, appended_spot))
+    {
+        cout << "\n    seek_end and attach after " << name << " on " << n << " items with the cursor at [";
+        cout << spot << "] went wrong (tail_ptr)." << endl;
+        return false;
+    }
+
+    fill(second, n, spot);
+    rearrange(second);
+    second.attach(-1);
+    if (!matches(second, attached, attached_spot))
+    {
+        cout << "\n    attach after " << name << " on " << n << " items with the cursor at [";
+        cout << spot << "] went wrong (cursor or tail_ptr)." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// vector<int> count_up(size_t n)
+//   Postcondition: The return value holds 0, 1, ..., n-1.
+// **************************************************************************
+vector<int> count_up(size_t n)
+{
+    vector<int> answer;
+
+    for (size_t i = 0; i < n; ++i)
+        answer.push_back(int(i));
+    return answer;
+}
+
+
+// Calls reverse( ).
+struct do_reverse
+{
+    bool operator ( )(sequence<int>& test) const { test.reverse( ); return true; }
+};
+
+// Calls rotate(k).
+struct do_rotate
+{
+    size_t k;
+    bool operator ( )(sequence<int>& test) const { test.rotate(k); return true; }
+};
+
+// The predicate partitioned by: even items first.
+struct is_even
+{
+    bool operator ( )(int x) const { return (x % 2) == 0; }
+};
+
+// Calls partition (or stable_partition) with is_even, and checks its
+// return value.
+struct do_partition
+{
+    bool stable;
+    size_t evens;
+    bool operator ( )(sequence<int>& test) const
+    {
+        size_t answer = stable ? test.stable_partition(is_even( )) : test.partition(is_even( ));
+        return answer == evens;
+    }
+};
+
+// A predicate that throws on its call number fail_at (counting from 1).
+struct is_even_until
+{
+    size_t* calls;
+    size_t fail_at;
+    bool operator ( )(int x) const
+    {
+        if (++*calls == fail_at)
+            throw fail_at;
+        return (x % 2) == 0;
+    }
+};
+
+// Calls stable_partition with an is_even_until predicate, and checks that
+// it threw.
+struct do_failing_partition
+{
+    size_t fail_at;
+    bool operator ( )(sequence<int>& test) const
+    {
+        size_t calls = 0;
+        is_even_until pred = { &calls, fail_at };
+
+        try
+        {
+            test.stable_partition(pred);
+        }
+        catch (size_t)
+        {
+            return true;
+        }
+        return false;
+    }
+};
+
+
+// **************************************************************************
+// int test1( )
+//   Tests reverse. Returns POINTS[1] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test1( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+        vector<int> expected = count_up(n);
+
+        cout << "Reversing a sequence of " << n << " items ... ";
+        cout.flush( );
+        reverse(expected.begin( ), expected.end( ));
+        for (size_t spot = 0; spot <= n; ++spot)
+        {
+            if (!check("reverse", n, spot, do_reverse( ), expected))
+                return 0;
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Tests rotate(k) for every k from 0 to 2 * size( ) + 1. Returns POINTS[2]
+//   if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+
+        cout << "Rotating a sequence of " << n << " items by 0 to " << 2 * n + 1 << " ... ";
+        cout.flush( );
+        for (size_t k = 0; k <= 2 * n + 1; ++k)
+        {
+            vector<int> expected = count_up(n);
+            do_rotate rotation = { k };
+
+            if (n > 0)
+                rotate(expected.begin( ), expected.begin( ) + (k % n), expected.end( ));
+            for (size_t spot = 0; spot <= n; ++spot)
+            {
+                if (!check("rotate", n, spot, rotation, expected))
+                {
+                    cout << "    (rotate(" << k << "))" << endl;
+                    return 0;
+                }
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Tests partition and stable_partition, and their return values. Returns
+//   POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+        vector<int> expected = count_up(n);
+        size_t evens;
+
+        cout << "Partitioning a sequence of " << n << " items ... ";
+        cout.flush( );
+        evens = size_t(stable_partition(expected.begin( ), expected.end( ), is_even( )) - expected.begin( ));
+        for (int stable = 0; stable < 2; ++stable)
+        {
+            do_partition partitioning = { stable != 0, evens };
+
+            for (size_t spot = 0; spot <= n; ++spot)
+            {
+                if (!check(stable ? "stable_partition" : "partition", n, spot, partitioning, expected))
+                    return 0;
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Tests stable_partition with a predicate that throws on each of its
+//   calls in turn: the exception must be passed on, with the items already
+//   tested partitioned and the rest after them in their original order.
+//   Returns POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        size_t n = SIZES[s];
+
+        if (n == 0)
+            continue;
+        cout << "Throwing from the predicate on a sequence of " << n << " items ... ";
+        cout.flush( );
+        for (size_t fail_at = 1; fail_at <= n; ++fail_at)
+        {
+            vector<int> expected = count_up(n);
+            do_failing_partition partitioning = { fail_at };
+
+            // The first fail_at - 1 items were tested before the throw
+            stable_partition(expected.begin( ), expected.begin( ) + (fail_at - 1), is_even( ));
+            for (size_t spot = 0; spot <= n; ++spot)
+            {
+                if (!check("a throwing stable_partition", n, spot, partitioning, expected))
+                {
+                    cout << "    (throwing on call " << fail_at << ")" << endl;
+                    return 0;
+                }
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
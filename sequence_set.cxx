@@ -0,0 +1,147 @@
+// FILE: sequence_set.cxx
+// IMPLEMENTS: The set operations of sequence_set.h (see sequence_set.h for
+// documentation).
+
+#include <unordered_set>  // Provides unordered_set for the hash path
+
+namespace scu_coen70_6B
+{
+    // Turns a pointer gathered by set_merge or set_hash back into its item.
+    template<class Item>
+    struct item_at
+    {
+        const Item& operator ( )(const Item* p) const { return *p; }
+    };
+
+    template<class Item>
+    bool sequence_is_sorted(const sequence<Item>& s)
+    {
+        typename sequence<Item>::const_iterator before = s.begin( );
+        typename sequence<Item>::const_iterator it = before;
+
+        if (it == s.end( ))
+            return true;
+        for (++it; it != s.end( ); ++it, ++before)
+        {
+            if (*it < *before)
+                return false;
+        }
+        return true;
+    }
+
+    template<class Item>
+    sequence<Item> sequence_union(const sequence<Item>& a, const sequence<Item>& b)
+    {
+        set_choice take = { true, true, true };
+        return set_combine(a, b, take);
+    }
+
+    template<class Item>
+    sequence<Item> sequence_intersection(const sequence<Item>& a, const sequence<Item>& b)
+    {
+        set_choice take = { false, true, false };
+        return set_combine(a, b, take);
+    }
+
+    template<class Item>
+    sequence<Item> sequence_difference(const sequence<Item>& a, const sequence<Item>& b)
+    {
+        set_choice take = { true, false, false };
+        return set_combine(a, b, take);
+    }
+
+    template<class Item>
+    sequence<Item> sequence_symmetric_difference(const sequence<Item>& a, const sequence<Item>& b)
+    {
+        set_choice take = { true, false, true };
+        return set_combine(a, b, take);
+    }
+
+    // Picks the answer's items by whichever path applies, then copies them
+    // into the result with one append.
+    template<class Item>
+    sequence<Item> set_combine(const sequence<Item>& a, const sequence<Item>& b, set_choice take)
+    {
+        std::vector<const Item*> picked;
+
+        if (sequence_is_sorted(a) && sequence_is_sorted(b))
+            set_merge(a, b, take, picked);
+        else
+            set_hash(a, b, take, picked);
+        return to_sequence(transform(picked, item_at<Item>( )));
+    }
+
+    // Walks the sorted inputs side by side. Each step looks at the smaller
+    // of the two front items (both, if they are equal), picks it if take
+    // says so, and skips every copy of it in its input.
+    template<class Item>
+    void set_merge(const sequence<Item>& a, const sequence<Item>& b, set_choice take,
+                   std::vector<const Item*>& picked)
+    {
+        typename sequence<Item>::const_iterator i = a.begin( );
+        typename sequence<Item>::const_iterator j = b.begin( );
+        const Item* x;
+        bool from_a, from_b;
+
+        while ((i != a.end( )) || (j != b.end( )))
+        {
+            from_a = (j == b.end( )) || ((i != a.end( )) && !(*j < *i));
+            from_b = (i == a.end( )) || ((j != b.end( )) && !(*i < *j));
+            x = from_a ? &*i : &*j;
+            if ((from_a && from_b) ? take.both : (from_a ? take.a_only : take.b_only))
+                picked.push_back(x);
+            if (from_a)
+            {
+                while ((i != a.end( )) && !(*x < *i))
+                    ++i;
+            }
+            if (from_b)
+            {
+                while ((j != b.end( )) && !(*x < *j))
+                    ++j;
+            }
+        }
+    }
+
+    // seen holds the items met so far, so an item is picked at most once.
+    // Once a has been walked it holds all of a's items, so an item of b that
+    // is new to seen is in b only.
+    template<class Item>
+    void set_hash(const sequence<Item>& a, const sequence<Item>& b, set_choice take,
+                  std::vector<const Item*>& picked)
+    {
+        typedef std::unordered_set<const Item*, item_pointer_hash<Item>, item_pointer_equal<Item>> pointer_set;
+        pointer_set seen;
+        pointer_set in_b;
+        typename sequence<Item>::const_iterator it;
+        bool pick;
+
+        // Union takes every item of a whether or not b has it
+        if (take.a_only != take.both)
+        {
+            in_b.reserve(b.size( ));
+            for (it = b.begin( ); it != b.end( ); ++it)
+                in_b.insert(&*it);
+        }
+        seen.reserve(a.size( ) + (take.b_only ? b.size( ) : 0));
+        for (it = a.begin( ); it != a.end( ); ++it)
+        {
+            if (!seen.insert(&*it).second)
+                continue;
+            if (take.a_only == take.both)
+                pick = take.both;
+            else
+                pick = (in_b.count(&*it) > 0) ? take.both : take.a_only;
+            if (pick)
+                picked.push_back(&*it);
+        }
+        if (take.b_only)
+        {
+            for (it = b.begin( ); it != b.end( ); ++it)
+            {
+                if (seen.insert(&*it).second)
+                    picked.push_back(&*it);
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+// FILE: sequence_set.h
+// PROVIDES: Set operations on sequences, within the namespace
+// scu_coen70_6B. Requires C++17 (see sequence_view.h).
+//
+// Each operation treats its arguments as sets: the result holds every
+// distinct item of the answer once, whatever the inputs' duplicates. Each
+// takes O(n + m) (expected, on the hash path) for inputs of n and m items,
+// instead of the O(n * m) of searching one sequence for every item of the
+// other:
+//
+//   Merge path: when both inputs are in order by operator < (checked with
+//   one pass over each), they are walked side by side as std::set_union and
+//   its kin do, and the result is in order too.
+//
+//   Hash path: otherwise, the items are looked up in hash sets of pointers
+//   to the items (see item_pointer_hash in sequence4.h), so nothing is
+//   copied but the answer. The result keeps the order of first appearance:
+//   the items taken from a in a's order, then those taken from b in b's.
+//
+// The answer is gathered as a vector of pointers to the inputs' items and
+// copied into the result with one sequence::append (see to_sequence in
+// sequence_view.h). The result has no current item; the inputs are
+// unchanged. To drop the duplicates of one sequence in place, use
+// sequence::unique( ).
+//
+// REQUIREMENTS on the item type: operator <, operator == and a std::hash
+// specialization, which agree on which items are equal.
+//
+// SET OPERATIONS:
+//   sequence<Item> sequence_union(const sequence<Item>& a, const sequence<Item>& b)
+//     Postcondition: The return value holds each item that is in a or b.
+//
+//   sequence<Item> sequence_intersection(const sequence<Item>& a, const sequence<Item>& b)
+//     Postcondition: The return value holds each item that is in both a and b.
+//
+//   sequence<Item> sequence_difference(const sequence<Item>& a, const sequence<Item>& b)
+//     Postcondition: The return value holds each item that is in a but not b.
+//
+//   sequence<Item> sequence_symmetric_difference(const sequence<Item>& a, const sequence<Item>& b)
+//     Postcondition: The return value holds each item that is in exactly one
+//     of a and b.
+//
+//   bool sequence_is_sorted(const sequence<Item>& s)
+//     Postcondition: The return value is true if no item of s is less than
+//     the one before it (so the merge path applies).
+//
+// DYNAMIC MEMORY usage:
+//   If there is insufficient dynamic memory, the set operations throw
+//   bad_alloc, and the inputs are unchanged.
+
+#ifndef COEN_70_SEQUENCE_SET_H
+#define COEN_70_SEQUENCE_SET_H
+#include <vector>             // Provides vector
+#include "sequence4.h"        // Provides the sequence class
+#include "sequence_view.h"    // Provides transform and to_sequence
+
+namespace scu_coen70_6B
+{
+    // Which items of a set operation's inputs its answer takes: those only
+    // in a, those in both (taken from a), and those only in b.
+    struct set_choice
+    {
+        bool a_only;
+        bool both;
+        bool b_only;
+    };
+
+    template<class Item>
+    bool sequence_is_sorted(const sequence<Item>& s);
+    template<class Item>
+    sequence<Item> sequence_union(const sequence<Item>& a, const sequence<Item>& b);
+    template<class Item>
+    sequence<Item> sequence_intersection(const sequence<Item>& a, const sequence<Item>& b);
+    template<class Item>
+    sequence<Item> sequence_difference(const sequence<Item>& a, const sequence<Item>& b);
+    template<class Item>
+    sequence<Item> sequence_symmetric_difference(const sequence<Item>& a, const sequence<Item>& b);
+    template<class Item>
+    sequence<Item> set_combine(const sequence<Item>& a, const sequence<Item>& b, set_choice take);
+    template<class Item>
+    void set_merge(const sequence<Item>& a, const sequence<Item>& b, set_choice take,
+                   std::vector<const Item*>& picked);
+    template<class Item>
+    void set_hash(const sequence<Item>& a, const sequence<Item>& b, set_choice take,
+                  std::vector<const Item*>& picked);
+}
+#include "sequence_set.cxx"
+#endif
@@ -0,0 +1,416 @@
+// FILE: sequence_set_exam.cpp
+// Non-interactive test program for the set operations on sequences (see
+// sequence_set.h) and sequence::unique (see sequence4.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the set operations,
+// returning some number of points to indicate how much of the test was
+// passed. A description and result of each test is printed to cout. Every
+// answer is checked against a plain O(n * m) model: the items the
+// operation takes, in order of first appearance (those from a, then those
+// from b), which is the answer of the hash path, and the same items in
+// order when both inputs are sorted, which is the answer of the merge
+// path. The inputs must come back unchanged, cursors included, and the
+// answer must have no current item. The program returns EXIT_FAILURE
+// unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_set_exam.cpp -o sequence_set_exam
+//     ./sequence_set_exam
+
+#include <algorithm>        // Provides find, sort, is_sorted.
+#include <iostream>         // Provides cout.
+#include <cstdlib>          // Provides size_t.
+#include <random>           // Provides mt19937 for the random inputs.
+#include <string>           // Provides string, to_string.
+#include <vector>           // Provides vector for the expected items.
+#include "sequence_set.h"   // Provides the set operations
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the set operations on sequences and sequence::unique",
+    "Testing sequence_is_sorted and the four operations on small cases",
+    "Testing the merge path: both inputs sorted, with duplicates",
+    "Testing the hash path: unsorted inputs, and one sorted with one not",
+    "Testing unique on both paths, and operations on strings"
+};
+
+// The operations, in the order of set_choice below.
+const char* const NAMES[] = {
+    "sequence_union", "sequence_intersection", "sequence_difference",
+    "sequence_symmetric_difference"
+};
+const set_choice CHOICES[] = {
+    { true, true, true }, { false, true, false }, { true, false, false }, { true, false, true }
+};
+const size_t MANY_OPERATIONS = 4;
+
+
+// **************************************************************************
+// template<class Item>
+// sequence<Item> operate(size_t which, const sequence<Item>& a,
+//                        const sequence<Item>& b)
+//   Postcondition: The return value is operation NAMES[which] of a and b.
+// **************************************************************************
+template<class Item>
+sequence<Item> operate(size_t which, const sequence<Item>& a, const sequence<Item>& b)
+{
+    switch (which)
+    {
+    case 0: return sequence_union(a, b);
+    case 1: return sequence_intersection(a, b);
+    case 2: return sequence_difference(a, b);
+    default: return sequence_symmetric_difference(a, b);
+    }
+}
+
+
+// **************************************************************************
+// template<class Item>
+// vector<Item> model(const vector<Item>& a, const vector<Item>& b,
+//                    set_choice take)
+//   Postcondition: The return value holds each distinct item that take
+//   chooses (see set_choice in sequence_set.h), in order of first
+//   appearance: those from a in a's order, then those from b in b's. If
+//   both a and b are sorted, it is sorted instead.
+// **************************************************************************
+template<class Item>
+vector<Item> model(const vector<Item>& a, const vector<Item>& b, set_choice take)
+{
+    vector<Item> answer;
+
+    for (size_t i = 0; i < a.size( ); ++i)
+    {
+        bool in_b = find(b.begin( ), b.end( ), a[i]) != b.end( );
+        if ((find(answer.begin( ), answer.end( ), a[i]) == answer.end( ))
+            && (in_b ? take.both : take.a_only))
+            answer.push_back(a[i]);
+    }
+    for (size_t i = 0; i < b.size( ); ++i)
+    {
+        bool in_a = find(a.begin( ), a.end( ), b[i]) != a.end( );
+        if (!in_a && take.b_only && (find(answer.begin( ), answer.end( ), b[i]) == answer.end( )))
+            answer.push_back(b[i]);
+    }
+    if (is_sorted(a.begin( ), a.end( )) && is_sorted(b.begin( ), b.end( )))
+        sort(answer.begin( ), answer.end( ));
+    return answer;
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool holds(const sequence<Item>& test, const vector<Item>& items,
+//            size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is current (or that
+//   there is no current item and position( ) == size( ), if cursor_spot >=
+//   items.size( )).
+// **************************************************************************
+template<class Item>
+bool holds(const sequence<Item>& test, const vector<Item>& items, size_t cursor_spot)
+{
+    typename sequence<Item>::const_iterator it = test.begin( );
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (size_t i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || !(*it == items[i]))
+            return false;
+    }
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// template<class Item>
+// sequence<Item> make(const vector<Item>& items, size_t cursor_spot)
+//   Postcondition: The return value holds the items, with item [cursor_spot]
+//   current (or none, if cursor_spot >= items.size( )).
+// **************************************************************************
+template<class Item>
+sequence<Item> make(const vector<Item>& items, size_t cursor_spot)
+{
+    sequence<Item> answer;
+
+    for (size_t i = 0; i < items.size( ); ++i)
+        answer.attach(items[i]);
+    answer.go_to(cursor_spot);
+    return answer;
+}
+
+
+// **************************************************************************
+// template<class Item>
+// bool check_all(const vector<Item>& a, const vector<Item>& b)
+//   Postcondition: A return value of true indicates that all four
+//   operations of a and b (with the cursors of the inputs in the middle)
+//   match the model, leave the inputs unchanged, and return a sequence with
+//   no current item. Otherwise a message is printed.
+// **************************************************************************
+template<class Item>
+bool check_all(const vector<Item>& a, const vector<Item>& b)
+{
+    sequence<Item> first = make(a, a.size( ) / 2);
+    sequence<Item> second = make(b, b.size( ) / 3);
+
+    if (sequence_is_sorted(first) != is_sorted(a.begin( ), a.end( ))
+        || sequence_is_sorted(second) != is_sorted(b.begin( ), b.end( )))
+    {
+        cout << "sequence_is_sorted was wrong for inputs of " << a.size( ) << " and ";
+        cout << b.size( ) << " items." << endl;
+        return false;
+    }
+    for (size_t which = 0; which < MANY_OPERATIONS; ++which)
+    {
+        vector<Item> expected = model(a, b, CHOICES[which]);
+        sequence<Item> answer = operate(which, first, second);
+
+        if (!holds(answer, expected, expected.size( )))
+        {
+            cout << NAMES[which] << " of " << a.size( ) << " and " << b.size( );
+            cout << " items gave the wrong answer." << endl;
+            return false;
+        }
+        if (!holds(first, a, a.size( ) / 2) || !holds(second, b, b.size( ) / 3))
+        {
+            cout << NAMES[which] << " changed an input." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// **************************************************************************
+// vector<int> random_items(mt19937& random, size_t n, int range, bool sorted)
+//   Postcondition: The return value holds n items from 0 to range - 1 (so
+//   that small ranges give many duplicates), sorted if sorted is true.
+// **************************************************************************
+vector<int> random_items(mt19937& random, size_t n, int range, bool sorted)
+{
+    vector<int> answer(n);
+
+    for (size_t i = 0; i < n; ++i)
+        answer[i] = int(random( ) % unsigned(range));
+    if (sorted)
+        sort(answer.begin( ), answer.end( ));
+    return answer;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Tests sequence_is_sorted and the operations on empty, one-item, equal
+//   and disjoint inputs. Returns POINTS[1] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    const vector<int> CASES[] = {
+        { }, { 4 }, { 4, 4, 4 }, { 1, 2, 3 }, { 3, 2, 1 }, { 7, 8 }, { 2, 1, 2, 1 }, { 1, 3, 2 }
+    };
+
+    cout << "Checking small cases ... ";
+    cout.flush( );
+    for (const vector<int>& a : CASES)
+    {
+        for (const vector<int>& b : CASES)
+        {
+            if (!check_all(a, b))
+                return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Checks 2000 pairs of sorted inputs of up to 80 items with many, few and
+//   no duplicates. Returns POINTS[2] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test2( )
+{
+    mt19937 random(47);
+    const int RANGES[] = { 3, 20, 1000 };
+
+    cout << "Checking 2000 pairs of sorted inputs ... ";
+    cout.flush( );
+    for (int round = 0; round < 2000; ++round)
+    {
+        int range = RANGES[round % 3];
+        vector<int> a = random_items(random, random( ) % 81, range, true);
+        vector<int> b = random_items(random, random( ) % 81, range, true);
+
+        if (!check_all(a, b))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Checks 2000 pairs where at least one input is unsorted, so the hash path
+//   runs and the answer keeps the order of first appearance. Returns
+//   POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    mt19937 random(48);
+    const int RANGES[] = { 3, 20, 1000 };
+
+    cout << "Checking 2000 pairs with an unsorted input ... ";
+    cout.flush( );
+    for (int round = 0; round < 2000; ++round)
+    {
+        int range = RANGES[round % 3];
+        vector<int> a = random_items(random, random( ) % 81, range, round % 4 == 1);
+        vector<int> b = random_items(random, random( ) % 81, range, round % 4 == 2);
+
+        if (!check_all(a, b))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Tests unique on sorted and unsorted sequences, with the cursor on each
+//   item and on none, and the operations on strings (a type whose copies
+//   are not trivial). Returns POINTS[4] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test4( )
+{
+    mt19937 random(49);
+
+    cout << "Checking unique on 600 sequences ... ";
+    cout.flush( );
+    for (int round = 0; round < 600; ++round)
+    {
+        vector<int> items = random_items(random, random( ) % 40, (round % 2 == 0) ? 5 : 50, round % 3 == 0);
+        vector<int> kept;
+        size_t removed;
+
+        for (size_t i = 0; i < items.size( ); ++i)
+        {
+            if (find(kept.begin( ), kept.end( ), items[i]) == kept.end( ))
+                kept.push_back(items[i]);
+        }
+        for (size_t spot = 0; spot <= items.size( ); ++spot)
+        {
+            sequence<int> test = make(items, spot);
+            size_t after = items.size( );
+
+            // A removed cursor moves to the next item kept.
+            for (size_t i = spot; i < items.size( ); ++i)
+            {
+                if (find(items.begin( ), items.begin( ) + i, items[i]) == items.begin( ) + i)
+                {
+                    after = size_t(find(kept.begin( ), kept.end( ), items[i]) - kept.begin( ));
+                    break;
+                }
+            }
+            if (after == items.size( ))
+                after = kept.size( );
+            removed = test.unique( );
+            if ((removed != items.size( ) - kept.size( )) || !holds(test, kept, after))
+            {
+                cout << "unique on " << items.size( ) << " items with the cursor at ";
+                cout << spot << " went wrong." << endl;
+                return 0;
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking the operations on strings ... ";
+    cout.flush( );
+    for (int round = 0; round < 300; ++round)
+    {
+        vector<int> a_numbers = random_items(random, random( ) % 30, 25, round % 2 == 0);
+        vector<int> b_numbers = random_items(random, random( ) % 30, 25, round % 3 == 0);
+        vector<string> a;
+        vector<string> b;
+
+        // Long strings, so that they are not stored inside the string object.
+        for (int x : a_numbers)
+            a.push_back(string(40, 'a') + to_string(x));
+        for (int x : b_numbers)
+            b.push_back(string(40, 'a') + to_string(x));
+        if (!check_all(a, b))
+            return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
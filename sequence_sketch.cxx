@@ -0,0 +1,488 @@
+// FILE: sequence_sketch.cxx
+// CLASSES IMPLEMENTED: kll_sketch, hyperloglog, space_saving and
+// sequence_sketch (see sequence_sketch.h for documentation)
+// INVARIANT for the kll_sketch class:
+//   1. levels[h] holds items that each stand for 2^h added items; held is the
+//      total number of items in levels, and many the number added.
+//   2. total is the sum of capacity(h) over the levels, and after each add,
+//      held is below it.
+//   3. If summary_valid, summary holds every item of levels sorted, each
+//      paired with the total weight of the items up to and including it.
+//
+// INVARIANT for the hyperloglog class:
+//   registers[i] is the highest rank seen among hashes whose top precision
+//   bits are i; inverse_sum is the sum of 2^-registers[i], and zeros counts
+//   the registers that are 0.
+//
+// INVARIANT for the space_saving class:
+//   counters holds at most limit counters. heap holds their indexes as a
+//   min-heap on count, counters[heap[i]].place == i, and where maps each
+//   counted value to its index in counters.
+//
+// INVARIANT for the sequence_sketch class:
+//   1. Unless rescan is true, the three sketches hold the items of the last
+//      scan and the covered - (scanned) items added since, and forgotten is
+//      the number removed since; space_saving has had the removals taken off.
+//   2. rescan is set when forgotten exceeds fraction * covered, or when the
+//      sequence was reset; the next query then scans the sequence.
+
+#include <algorithm>    // Provides sort, lower_bound, upper_bound
+#include <cassert>      // Provides assert
+#include <cmath>        // Provides ldexp, log, pow
+#include <cstring>      // Provides memcpy
+#include <type_traits>  // Provides is_floating_point
+#include <utility>      // Provides move, swap
+
+namespace scu_coen70_6B
+{
+    // KLL SKETCH
+    template<class Item>
+    kll_sketch<Item>::kll_sketch(std::size_t k) : k(k)
+    {
+        assert(k >= 8);
+        random_state = 0x9E3779B97F4A7C15ULL;
+        clear( );
+    }
+
+    template<class Item>
+    void kll_sketch<Item>::clear( )
+    {
+        levels.assign(1, std::vector<Item>( ));
+        total = capacity(0);
+        many = 0;
+        held = 0;
+        summary.clear( );
+        summary_valid = false;
+    }
+
+    // A level depth levels below the top holds about k * (2/3)^depth items.
+    template<class Item>
+    std::size_t kll_sketch<Item>::capacity(std::size_t level) const
+    {
+        std::size_t depth = levels.size( ) - 1 - level;
+        std::size_t answer = std::size_t(double(k) * std::pow(2.0 / 3.0, double(depth)) + 0.5);
+
+        return (answer < 8) ? 8 : answer;
+    }
+
+    template<class Item>
+    void kll_sketch<Item>::add(const Item& x)
+    {
+        levels[0].push_back(x);
+        ++held;
+        ++many;
+        summary_valid = false;
+        if (held >= total)
+            compress( );
+    }
+
+    // Halves the lowest full level: sorts it and moves every other item
+    // (from a random one of the first two) up a level, where it stands for
+    // twice as many. With an odd count the first item stays behind.
+    template<class Item>
+    void kll_sketch<Item>::compress( )
+    {
+        std::size_t h = 0;
+        std::size_t start;
+
+        while (levels[h].size( ) < capacity(h))
+            ++h;
+        if (h + 1 == levels.size( ))
+        {
+            // Every level is one deeper now, so the capacities change
+            levels.push_back(std::vector<Item>( ));
+            total = 0;
+            for (std::size_t i = 0; i < levels.size( ); ++i)
+                total += capacity(i);
+        }
+
+        std::vector<Item>& full = levels[h];
+        std::vector<Item>& above = levels[h + 1];
+        std::sort(full.begin( ), full.end( ));
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        start = full.size( ) % 2;
+        held -= (full.size( ) - start) / 2;
+        for (std::size_t i = start + (random_state & 1); i < full.size( ); i += 2)
+            above.push_back(full[i]);
+        full.resize(start);
+    }
+
+    template<class Item>
+    void kll_sketch<Item>::build_summary( ) const
+    {
+        std::uint64_t weight = 0;
+
+        summary.clear( );
+        summary.reserve(held);
+        for (std::size_t h = 0; h < levels.size( ); ++h)
+        {
+            for (std::size_t i = 0; i < levels[h].size( ); ++i)
+                summary.push_back(std::pair<Item, std::uint64_t>(levels[h][i], std::uint64_t(1) << h));
+        }
+        std::sort(summary.begin( ), summary.end( ));
+        for (std::size_t i = 0; i < summary.size( ); ++i)
+        {
+            weight += summary[i].second;
+            summary[i].second = weight;
+        }
+        summary_valid = true;
+    }
+
+    template<class Item>
+    Item kll_sketch<Item>::quantile(double q) const
+    {
+        assert((q >= 0) && (q <= 1) && (many > 0));
+        std::uint64_t target;
+        std::size_t low = 0;
+        std::size_t high;
+
+        if (!summary_valid)
+            build_summary( );
+        target = std::uint64_t(q * double(summary.back( ).second));
+        // The first item whose cumulative weight reaches target
+        high = summary.size( ) - 1;
+        while (low < high)
+        {
+            std::size_t middle = low + (high - low) / 2;
+            if (summary[middle].second < target)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return summary[low].first;
+    }
+
+    template<class Item>
+    double kll_sketch<Item>::rank(const Item& x) const
+    {
+        std::size_t low = 0;
+        std::size_t high;
+
+        if (many == 0)
+            return 0;
+        if (!summary_valid)
+            build_summary( );
+        // The number of items <= x
+        high = summary.size( );
+        while (low < high)
+        {
+            std::size_t middle = low + (high - low) / 2;
+            if (x < summary[middle].first)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        if (low == 0)
+            return 0;
+        return double(summary[low - 1].second) / double(summary.back( ).second);
+    }
+
+    // HYPERLOGLOG
+    inline hyperloglog::hyperloglog(unsigned precision) : precision(precision)
+    {
+        assert((precision >= 4) && (precision <= 18));
+        clear( );
+    }
+
+    inline void hyperloglog::clear( )
+    {
+        registers.assign(std::size_t(1) << precision, 0);
+        inverse_sum = double(registers.size( ));
+        zeros = registers.size( );
+    }
+
+    inline std::uint64_t hyperloglog::mix(std::uint64_t bits)
+    {
+        bits ^= bits >> 30;
+        bits *= 0xBF58476D1CE4E5B9ULL;
+        bits ^= bits >> 27;
+        bits *= 0x94D049BB133111EBULL;
+        bits ^= bits >> 31;
+        return bits;
+    }
+
+    // The rank is the position of the first 1 bit after the register index;
+    // the bit planted below the index bits caps it at 64 - precision + 1.
+    inline void hyperloglog::add(std::uint64_t hash)
+    {
+        std::size_t index = std::size_t(hash >> (64 - precision));
+        std::uint64_t rest = (hash << precision) | (std::uint64_t(1) << (precision - 1));
+        std::uint8_t rank = 1;
+
+        while ((rest & (std::uint64_t(1) << 63)) == 0)
+        {
+            rest <<= 1;
+            ++rank;
+        }
+        if (rank > registers[index])
+        {
+            if (registers[index] == 0)
+                --zeros;
+            inverse_sum += std::ldexp(1.0, -int(rank)) - std::ldexp(1.0, -int(registers[index]));
+            registers[index] = rank;
+        }
+    }
+
+    // The raw estimate, or linear counting while it is small enough for
+    // empty registers to be the better guide.
+    inline double hyperloglog::estimate( ) const
+    {
+        double m = double(registers.size( ));
+        double answer = 0.7213 / (1 + 1.079 / m) * m * m / inverse_sum;
+
+        if ((answer <= 2.5 * m) && (zeros > 0))
+            answer = m * std::log(m / double(zeros));
+        return answer;
+    }
+
+    // SPACE-SAVING
+    template<class Item>
+    space_saving<Item>::space_saving(std::size_t capacity) : limit(capacity)
+    {
+        assert(capacity > 0);
+        counters.reserve(capacity);
+        heap.reserve(capacity);
+    }
+
+    template<class Item>
+    void space_saving<Item>::clear( )
+    {
+        counters.clear( );
+        heap.clear( );
+        where.clear( );
+    }
+
+    template<class Item>
+    void space_saving<Item>::swap_counters(std::size_t i, std::size_t j)
+    {
+        std::swap(heap[i], heap[j]);
+        counters[heap[i]].place = i;
+        counters[heap[j]].place = j;
+    }
+
+    template<class Item>
+    void space_saving<Item>::sift_up(std::size_t i)
+    {
+        while ((i > 0) && (counters[heap[i]].count < counters[heap[(i - 1) / 2]].count))
+        {
+            swap_counters(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    template<class Item>
+    void space_saving<Item>::sift_down(std::size_t i)
+    {
+        std::size_t smallest;
+
+        for (;;)
+        {
+            smallest = i;
+            if ((2 * i + 1 < heap.size( )) && (counters[heap[2 * i + 1]].count < counters[heap[smallest]].count))
+                smallest = 2 * i + 1;
+            if ((2 * i + 2 < heap.size( )) && (counters[heap[2 * i + 2]].count < counters[heap[smallest]].count))
+                smallest = 2 * i + 2;
+            if (smallest == i)
+                return;
+            swap_counters(i, smallest);
+            i = smallest;
+        }
+    }
+
+    // A new value takes over the smallest counter, one above its count.
+    template<class Item>
+    void space_saving<Item>::add(const Item& x)
+    {
+        typename std::unordered_map<Item, std::size_t>::iterator found = where.find(x);
+        counter fresh;
+        std::size_t c;
+
+        if (found != where.end( ))
+        {
+            c = found->second;
+            ++counters[c].count;
+            sift_down(counters[c].place);
+        }
+        else if (counters.size( ) < limit)
+        {
+            fresh.value = x;
+            fresh.count = 1;
+            fresh.place = heap.size( );
+            counters.push_back(fresh);
+            heap.push_back(counters.size( ) - 1);
+            where[x] = counters.size( ) - 1;
+            sift_up(heap.size( ) - 1);
+        }
+        else
+        {
+            c = heap[0];
+            typename std::unordered_map<Item, std::size_t>::node_type entry = where.extract(counters[c].value);
+            entry.key( ) = x;
+            where.insert(std::move(entry));
+            counters[c].value = x;
+            ++counters[c].count;
+            sift_down(0);
+        }
+    }
+
+    template<class Item>
+    void space_saving<Item>::remove(const Item& x)
+    {
+        typename std::unordered_map<Item, std::size_t>::iterator found = where.find(x);
+        std::size_t c;
+
+        if ((found != where.end( )) && (counters[found->second].count > 0))
+        {
+            c = found->second;
+            --counters[c].count;
+            sift_up(counters[c].place);
+        }
+    }
+
+    template<class Item>
+    std::vector<std::pair<Item, std::uint64_t>> space_saving<Item>::top(std::size_t k) const
+    {
+        std::vector<std::pair<Item, std::uint64_t>> answer;
+
+        answer.reserve(counters.size( ));
+        for (std::size_t i = 0; i < counters.size( ); ++i)
+        {
+            if (counters[i].count > 0)
+                answer.push_back(std::pair<Item, std::uint64_t>(counters[i].value, counters[i].count));
+        }
+        std::sort(answer.begin( ), answer.end( ),
+                  [](const std::pair<Item, std::uint64_t>& a, const std::pair<Item, std::uint64_t>& b)
+                  { return a.second > b.second; });
+        if (answer.size( ) > k)
+            answer.resize(k);
+        return answer;
+    }
+
+    // SEQUENCE SKETCH
+    template<class Item>
+    sequence_sketch<Item>::sequence_sketch(sequence<Item>& source, std::size_t top_capacity,
+                                           std::size_t quantile_k, unsigned hll_precision,
+                                           double rebuild_fraction)
+        : watched(&source), fraction(rebuild_fraction), quantiles(quantile_k),
+          values(hll_precision), frequent(top_capacity), scans(0)
+    {
+        assert(rebuild_fraction > 0);
+        scan( );
+        source.observe(this);
+    }
+
+    template<class Item>
+    sequence_sketch<Item>::~sequence_sketch( )
+    {
+        watched->observe(NULL);
+    }
+
+    template<class Item>
+    std::uint64_t sequence_sketch<Item>::hash(const Item& x)
+    {
+        std::uint64_t bits = 0;
+
+        if constexpr (std::is_floating_point<Item>::value)
+        {
+            // -0.0 == 0.0, so both must hash alike
+            double value = (x == 0) ? 0.0 : double(x);
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+        else
+            bits = std::uint64_t(x);
+        return hyperloglog::mix(bits);
+    }
+
+    template<class Item>
+    void sequence_sketch<Item>::scan( ) const
+    {
+        const sequence<Item>& items = *watched;
+
+        quantiles.clear( );
+        values.clear( );
+        frequent.clear( );
+        for (typename sequence<Item>::const_iterator it = items.begin( ); it != items.end( ); ++it)
+        {
+            quantiles.add(*it);
+            values.add(hash(*it));
+            frequent.add(*it);
+        }
+        covered = items.size( );
+        forgotten = 0;
+        rescan = false;
+        ++scans;
+    }
+
+    template<class Item>
+    void sequence_sketch<Item>::refresh( ) const
+    {
+        if (rescan)
+            scan( );
+    }
+
+    // While a rescan is pending, changes need not be followed.
+    template<class Item>
+    void sequence_sketch<Item>::added(const Item& entry)
+    {
+        if (rescan)
+            return;
+        quantiles.add(entry);
+        values.add(hash(entry));
+        frequent.add(entry);
+        ++covered;
+    }
+
+    template<class Item>
+    void sequence_sketch<Item>::removed(const Item& entry)
+    {
+        if (rescan)
+            return;
+        frequent.remove(entry);
+        ++forgotten;
+        if (double(forgotten) > fraction * double(covered))
+            rescan = true;
+    }
+
+    template<class Item>
+    void sequence_sketch<Item>::reset( )
+    {
+        rescan = true;
+    }
+
+    template<class Item>
+    void sequence_sketch<Item>::rebuild( )
+    {
+        scan( );
+    }
+
+    template<class Item>
+    Item sequence_sketch<Item>::quantile(double q) const
+    {
+        assert(size( ) > 0);
+        refresh( );
+        return quantiles.quantile(q);
+    }
+
+    template<class Item>
+    double sequence_sketch<Item>::rank(const Item& x) const
+    {
+        refresh( );
+        return quantiles.rank(x);
+    }
+
+    template<class Item>
+    double sequence_sketch<Item>::distinct( ) const
+    {
+        refresh( );
+        return values.estimate( );
+    }
+
+    template<class Item>
+    std::vector<std::pair<Item, std::uint64_t>> sequence_sketch<Item>::top(std::size_t k) const
+    {
+        refresh( );
+        return frequent.top(k);
+    }
+}
@@ -0,0 +1,274 @@
+// FILE: sequence_sketch.h
+// CLASSES PROVIDED: kll_sketch, hyperloglog, space_saving and
+// sequence_sketch (all part of the namespace scu_coen70_6B)
+// Streaming summaries of the numbers in a sequence, kept up to date as the
+// sequence changes, so that monitoring can ask for quantiles, the number of
+// distinct values and the most frequent values without scanning the nodes:
+//
+//     sequence<double> latencies;
+//     sequence_sketch<double> summary(latencies);   // scans latencies once
+//     ...                                           // insert, attach, ...
+//     double p99 = summary.quantile(0.99);          // no scan
+//
+// sequence_sketch observes its sequence (see observe in sequence4.h) and
+// feeds every added item to three sketches:
+//
+//   kll_sketch      quantiles. Items are kept in levels of buffers, an item
+//                   on level h standing for 2^h of the originals; when the
+//                   buffers are full, the lowest full level is sorted and
+//                   every other item (starting at a random one of the first
+//                   two) moves up a level. With k = 200, about 0.6k to 3k
+//                   items are kept, plus a few for each doubling of the
+//                   count (614 at a million), and a rank is off by at most
+//                   about 1.7% of the count with 99% confidence.
+//   hyperloglog     distinct values. 2^precision registers of 6-bit ranks of
+//                   a 64-bit hash; with precision 12 (4 KiB) the standard
+//                   error is about 1.6%.
+//   space_saving    frequent values. capacity counters; an unseen value takes
+//                   over the counter with the lowest count. Every value
+//                   occurring more than n / capacity times has a counter,
+//                   and each count is too high by at most n / capacity.
+//
+// REMOVALS:
+//   KLL and HyperLogLog summaries cannot forget an item. A removal is
+//   counted instead (and taken off the value's space_saving counter), and
+//   once the removals since the last scan exceed rebuild_fraction of the
+//   items scanned or added since, the next query rescans the sequence and
+//   builds the sketches anew. Until then the removed items still count in
+//   quantile, rank and distinct. An assignment or clear of the sequence
+//   also triggers a rescan at the next query.
+//
+// CLASS kll_sketch<Item>:
+//   kll_sketch(std::size_t k = 200)
+//     Precondition: k >= 8.
+//     Postcondition: The sketch is empty; k sets its accuracy and size.
+//   void add(const Item& x)
+//   void clear( )
+//   std::uint64_t count( ) const
+//     Postcondition: The number of items added since the last clear( ).
+//   std::size_t retained( ) const
+//     Postcondition: The number of items the sketch holds.
+//   Item quantile(double q) const
+//     Precondition: 0 <= q <= 1 and count( ) > 0.
+//     Postcondition: An item whose rank is about q * count( ).
+//   double rank(const Item& x) const
+//     Postcondition: About the fraction of the items that are <= x (0 if
+//     the sketch is empty).
+//
+// CLASS hyperloglog:
+//   hyperloglog(unsigned precision = 12)
+//     Precondition: 4 <= precision <= 18.
+//   void add(std::uint64_t hash)
+//     Postcondition: A value with this (well mixed) 64-bit hash is counted.
+//   void clear( )
+//   double estimate( ) const
+//     Postcondition: The estimated number of distinct hashes added. This
+//     takes O(1): the harmonic sum of the registers is kept as they change.
+//   static std::uint64_t mix(std::uint64_t bits)
+//     Postcondition: A hash of bits (the splitmix64 finalizer).
+//
+// CLASS space_saving<Item>:
+//   space_saving(std::size_t capacity = 64)
+//     Precondition: capacity > 0.
+//   void add(const Item& x)
+//   void remove(const Item& x)
+//     Postcondition: If x has a counter with a count above 0, the count is
+//     one lower.
+//   void clear( )
+//   std::vector<std::pair<Item, std::uint64_t>> top(std::size_t k) const
+//     Postcondition: Up to k values with their (over)estimated counts, the
+//     highest first.
+//   A heap of the counters' indexes keeps the smallest count at hand, so add
+//   and remove take O(log capacity), and a value taking over a counter
+//   reuses the hash table entry of the one it replaces.
+//
+// CLASS sequence_sketch<Item>:
+//   Item is a built-in arithmetic type. NaN items are not supported.
+//
+//   sequence_sketch(sequence<Item>& source, std::size_t top_capacity = 64,
+//                   std::size_t quantile_k = 200, unsigned hll_precision = 12,
+//                   double rebuild_fraction = 0.25)
+//     Precondition: The sequence has no other observer and outlives the
+//     sketch; rebuild_fraction > 0.
+//     Postcondition: The sketches hold every item of source (scanned once),
+//     and the sketch observes source from now on.
+//
+//   ~sequence_sketch( )
+//     Postcondition: source is no longer observed.
+//
+//   std::size_t size( ) const
+//     Postcondition: The number of items in the sequence (exact).
+//
+//   Item quantile(double q) const
+//     Precondition: 0 <= q <= 1 and size( ) > 0.
+//     Postcondition: About the q-th quantile of the items (see kll_sketch).
+//
+//   double rank(const Item& x) const
+//     Postcondition: About the fraction of the items that are <= x.
+//
+//   double distinct( ) const
+//     Postcondition: About the number of distinct items.
+//
+//   std::vector<std::pair<Item, std::uint64_t>> top(std::size_t k) const
+//     Postcondition: Up to k of the most frequent items with their counts
+//     (see space_saving), the most frequent first.
+//
+//   void rebuild( )
+//     Postcondition: The sketches have been built anew from a scan of the
+//     sequence.
+//
+//   std::size_t rebuilds( ) const
+//     Postcondition: The number of scans so far, counting the first.
+//
+//   The queries are const: a pending rescan, and the sorted summary that
+//   kll_sketch keeps for its queries, live in mutable members.
+//
+// QUERY COSTS:
+//   Only distinct( ) and size( ) take O(1). Keeping the KLL summary sorted
+//   on every add would cost each add O(k) and be thrown away at the next
+//   compaction, so the summary is sorted lazily instead: the first quantile
+//   or rank after a change costs O(k log k) (about 25 us with k = 200), and
+//   later ones O(log k) (about 16 ns) until the next change. top(k) sorts
+//   the capacity counters each time, in O(capacity log capacity) (about
+//   0.6 us for 64). A caller that polls after every change should poll
+//   quantile less often, or keep its own copy of the answer. Any query may
+//   first have to rescan the sequence (see REMOVALS).
+//
+// VALUE SEMANTICS:
+//   kll_sketch, hyperloglog and space_saving may be copied and assigned.
+//   sequence_sketch may not, since it is tied to its sequence.
+//
+// THREAD SAFETY:
+//   None beyond that of the sequence: the sketch is updated by the thread
+//   that changes the sequence, and queries must not run at the same time.
+
+#ifndef COEN_70_SEQUENCE_SKETCH_H
+#define COEN_70_SEQUENCE_SKETCH_H
+#include <cstdlib>        // Provides size_t
+#include <cstdint>        // Provides uint64_t, uint8_t
+#include <unordered_map>  // Provides unordered_map
+#include <utility>        // Provides pair
+#include <vector>         // Provides vector
+#include "sequence4.h"    // Provides sequence and sequence_observer
+
+namespace scu_coen70_6B
+{
+    template<class Item>
+    class kll_sketch
+    {
+    public:
+        // CONSTRUCTOR
+        explicit kll_sketch(std::size_t k = 200);
+        // MODIFICATION MEMBER FUNCTIONS
+        void add(const Item& x);
+        void clear( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::uint64_t count( ) const { return many; }
+        std::size_t retained( ) const { return held; }
+        Item quantile(double q) const;
+        double rank(const Item& x) const;
+    private:
+        std::size_t k;
+        std::vector<std::vector<Item>> levels;
+        std::uint64_t many;
+        std::size_t held;
+        std::size_t total;
+        std::uint64_t random_state;
+        mutable std::vector<std::pair<Item, std::uint64_t>> summary;  // Sorted, cumulative weights
+        mutable bool summary_valid;
+
+        std::size_t capacity(std::size_t level) const;
+        void compress( );
+        void build_summary( ) const;
+    };
+
+    class hyperloglog
+    {
+    public:
+        // CONSTRUCTOR
+        explicit hyperloglog(unsigned precision = 12);
+        // MODIFICATION MEMBER FUNCTIONS
+        void add(std::uint64_t hash);
+        void clear( );
+        // CONSTANT MEMBER FUNCTIONS
+        double estimate( ) const;
+        static std::uint64_t mix(std::uint64_t bits);
+    private:
+        unsigned precision;
+        std::vector<std::uint8_t> registers;
+        double inverse_sum;     // Sum of 2^-registers[i]
+        std::size_t zeros;      // Registers still 0
+    };
+
+    template<class Item>
+    class space_saving
+    {
+    public:
+        // CONSTRUCTOR
+        explicit space_saving(std::size_t capacity = 64);
+        // MODIFICATION MEMBER FUNCTIONS
+        void add(const Item& x);
+        void remove(const Item& x);
+        void clear( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::vector<std::pair<Item, std::uint64_t>> top(std::size_t k) const;
+    private:
+        struct counter
+        {
+            Item value;
+            std::uint64_t count;
+            std::size_t place;                          // Index in heap
+        };
+
+        std::size_t limit;
+        std::vector<counter> counters;
+        std::vector<std::size_t> heap;                  // Counter indexes, min-heap on count
+        std::unordered_map<Item, std::size_t> where;    // Value -> counter index
+
+        void sift_up(std::size_t i);
+        void sift_down(std::size_t i);
+        void swap_counters(std::size_t i, std::size_t j);
+    };
+
+    template<class Item>
+    class sequence_sketch : public sequence_observer<Item>
+    {
+    public:
+        // CONSTRUCTOR and DESTRUCTOR
+        sequence_sketch(sequence<Item>& source, std::size_t top_capacity = 64,
+                        std::size_t quantile_k = 200, unsigned hll_precision = 12,
+                        double rebuild_fraction = 0.25);
+        sequence_sketch(const sequence_sketch&) = delete;
+        sequence_sketch& operator =(const sequence_sketch&) = delete;
+        ~sequence_sketch( );
+        // OBSERVER MEMBER FUNCTIONS (called by the sequence)
+        void added(const Item& entry);
+        void removed(const Item& entry);
+        void reset( );
+        // MODIFICATION MEMBER FUNCTIONS
+        void rebuild( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::size_t size( ) const { return watched->size( ); }
+        Item quantile(double q) const;
+        double rank(const Item& x) const;
+        double distinct( ) const;
+        std::vector<std::pair<Item, std::uint64_t>> top(std::size_t k) const;
+        std::size_t rebuilds( ) const { return scans; }
+    private:
+        sequence<Item>* watched;
+        double fraction;
+        mutable kll_sketch<Item> quantiles;
+        mutable hyperloglog values;
+        mutable space_saving<Item> frequent;
+        mutable std::uint64_t covered;      // Items scanned or added since the last scan
+        mutable std::uint64_t forgotten;    // Items removed since the last scan
+        mutable bool rescan;
+        mutable std::size_t scans;
+
+        void scan( ) const;
+        void refresh( ) const;
+        static std::uint64_t hash(const Item& x);
+    };
+}
+#include "sequence_sketch.cxx"
+#endif
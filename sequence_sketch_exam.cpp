@@ -0,0 +1,520 @@
+// FILE: sequence_sketch_exam.cpp
+// Non-interactive test program for the streaming summaries of a sequence
+// (kll_sketch, hyperloglog, space_saving and sequence_sketch; see
+// sequence_sketch.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the sketches, returning some
+// number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. The accuracy
+// tests feed a fixed pseudo-random stream, so every run sees the same
+// answers, and compare each sketch with the exact answer worked out from a
+// sorted copy or a count of every value; the worst error found is printed
+// next to the bound it is checked against. The bounds are those of
+// sequence_sketch.h widened to about three standard errors, since the
+// documented ones hold for one query with 99% confidence and each test
+// asks many. The last test checks that sequence_sketch follows its
+// sequence: inserts and attaches at once, removals through a rescan once
+// they pass rebuild_fraction, and an assignment or clear of the sequence.
+// The program returns EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_sketch_exam.cpp -o sequence_sketch_exam
+//     ./sequence_sketch_exam
+
+#include <algorithm>          // Provides sort, lower_bound, upper_bound.
+#include <cmath>              // Provides fabs, exp, log.
+#include <cstdint>            // Provides uint64_t.
+#include <cstdlib>            // Provides size_t.
+#include <iostream>           // Provides cout.
+#include <map>                // Provides map for the exact counts.
+#include <random>             // Provides mt19937_64 and the distributions.
+#include <vector>             // Provides vector for the sorted copies.
+#include "sequence_sketch.h"  // Provides the sketches
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the sketches of sequence_sketch.h",
+    "Testing kll_sketch quantiles and ranks against a sorted copy",
+    "Testing hyperloglog estimates against the exact number of distinct values",
+    "Testing space_saving counts against exact counts, with removals",
+    "Testing that sequence_sketch follows its sequence, and when it rescans"
+};
+
+// How far a KLL rank may be off (1.7% is the 99% bound for one query).
+const double RANK_ERROR = 0.025;
+// How many items kll_sketch(200) may keep: about 3k, plus a few more for
+// each doubling of the count (614 at a million items).
+const size_t MOST_RETAINED = 700;
+// How far a HyperLogLog estimate may be off, relative (three standard errors).
+const double DISTINCT_ERROR = 0.05;
+
+
+// **************************************************************************
+// double exact_rank(const vector<double>& sorted, double x)
+//   Precondition: sorted is in order and not empty.
+//   Postcondition: The return value is the fraction of sorted that is <= x.
+// **************************************************************************
+double exact_rank(const vector<double>& sorted, double x)
+{
+    return double(upper_bound(sorted.begin( ), sorted.end( ), x) - sorted.begin( )) / double(sorted.size( ));
+}
+
+
+// **************************************************************************
+// double quantile_error(const vector<double>& sorted, double x, double q)
+//   Precondition: sorted is in order and not empty.
+//   Postcondition: The return value is how far q is from the ranks x may
+//   be given: from the fraction of sorted below x to the fraction <= x (so
+//   0 if x is an exact q-quantile, even when x is repeated).
+// **************************************************************************
+double quantile_error(const vector<double>& sorted, double x, double q)
+{
+    double below = double(lower_bound(sorted.begin( ), sorted.end( ), x) - sorted.begin( )) / double(sorted.size( ));
+    double through = exact_rank(sorted, x);
+
+    if (q < below)
+        return below - q;
+    return (q > through) ? q - through : 0.0;
+}
+
+
+// **************************************************************************
+// double worst_quantile_error(const kll_sketch<double>& sketch,
+//                             const vector<double>& sorted)
+//   Precondition: The sketch was fed exactly the items of sorted.
+//   Postcondition: The return value is the largest quantile_error of
+//   quantile(q), and difference between rank(x) and the exact rank of x,
+//   for q and the exact q-quantile x at q = 0.01, 0.02, ..., 0.99.
+// **************************************************************************
+double worst_quantile_error(const kll_sketch<double>& sketch, const vector<double>& sorted)
+{
+    double worst = 0;
+
+    for (int percent = 1; percent < 100; ++percent)
+    {
+        double q = percent / 100.0;
+        double x = sorted[size_t(q * double(sorted.size( ) - 1))];
+        double error = quantile_error(sorted, sketch.quantile(q), q);
+
+        worst = (error > worst) ? error : worst;
+        error = fabs(sketch.rank(x) - exact_rank(sorted, x));
+        worst = (error > worst) ? error : worst;
+    }
+    return worst;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Feeds kll_sketch (k = 200) 1000, 100000 and 1000000 items, uniform,
+//   log-normal, with many repeats and in sorted order, and checks every
+//   percentile, the count and how many items are retained. Returns
+//   POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    const size_t SIZES[] = { 1000, 100000, 1000000 };
+    const char* const SHAPES[] = { "uniform", "log-normal", "repeats", "sorted" };
+    mt19937_64 random(49);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    lognormal_distribution<double> skewed(0.0, 1.5);
+
+    cout.precision(4);
+    cout << fixed;
+    for (size_t n : SIZES)
+    {
+        for (int shape = 0; shape < 4; ++shape)
+        {
+            kll_sketch<double> sketch(200);
+            vector<double> items(n);
+            double worst;
+
+            cout << "Quantiles of " << n << " " << SHAPES[shape] << " items ... ";
+            cout.flush( );
+            for (size_t i = 0; i < n; ++i)
+            {
+                switch (shape)
+                {
+                case 0: items[i] = uniform(random); break;
+                case 1: items[i] = skewed(random); break;
+                case 2: items[i] = double(random( ) % 20); break;
+                case 3: items[i] = double(i); break;
+                }
+                sketch.add(items[i]);
+            }
+            sort(items.begin( ), items.end( ));
+            worst = worst_quantile_error(sketch, items);
+            cout << "worst rank error " << worst << ", " << sketch.retained( ) << " kept ... ";
+            if ((sketch.count( ) != n) || (worst > RANK_ERROR) || (sketch.retained( ) > MOST_RETAINED))
+            {
+                cout << "beyond " << RANK_ERROR << " or " << MOST_RETAINED << " kept." << endl;
+                return 0;
+            }
+            cout << "Passed." << endl;
+        }
+    }
+
+    cout << "Clearing a sketch ... ";
+    {
+        kll_sketch<double> sketch(50);
+        kll_sketch<double> copy;
+
+        for (int i = 0; i < 5000; ++i)
+            sketch.add(double(i));
+        copy = sketch;
+        sketch.clear( );
+        sketch.add(7.0);
+        if ((sketch.count( ) != 1) || (sketch.quantile(0.5) != 7.0) || (sketch.rank(6.0) != 0.0)
+            || (copy.count( ) != 5000) || (fabs(copy.rank(2500.0) - 0.5) > RANK_ERROR))
+        {
+            cout << "clear( ) or a copy went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Adds streams with 10, 1000, 100000 and 2000000 distinct values (each
+//   value added three times) to hyperloglog with precision 12, and checks
+//   each estimate; then checks precision 4 and 18 at 100000. Returns
+//   POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    const uint64_t DISTINCTS[] = { 10, 1000, 100000, 2000000 };
+
+    for (uint64_t distinct : DISTINCTS)
+    {
+        hyperloglog counter(12);
+        double error;
+
+        cout << "Counting " << distinct << " distinct values ... ";
+        cout.flush( );
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            for (uint64_t v = 0; v < distinct; ++v)
+                counter.add(hyperloglog::mix(v * 7919 + 13));
+        }
+        error = fabs(counter.estimate( ) - double(distinct)) / double(distinct);
+        cout << "estimate " << counter.estimate( ) << ", error " << error << " ... ";
+        if (error > DISTINCT_ERROR)
+        {
+            cout << "beyond " << DISTINCT_ERROR << "." << endl;
+            return 0;
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "Counting with precision 4 and 18 ... ";
+    cout.flush( );
+    {
+        hyperloglog coarse(4);
+        hyperloglog fine(18);
+        hyperloglog copy;
+
+        for (uint64_t v = 0; v < 100000; ++v)
+        {
+            coarse.add(hyperloglog::mix(v));
+            fine.add(hyperloglog::mix(v));
+        }
+        copy = fine;
+        fine.clear( );
+        // Precision 4 has 16 registers: a standard error of 26%.
+        if ((fabs(coarse.estimate( ) - 100000.0) > 0.78 * 100000.0)
+            || (fabs(copy.estimate( ) - 100000.0) > DISTINCT_ERROR * 100000.0)
+            || (fine.estimate( ) != 0.0))
+        {
+            cout << "an estimate was out of bounds." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Feeds space_saving (capacity 64) a Zipf-like stream of 200000 values,
+//   and checks that every value occurring more than n / 64 times is in
+//   top(64) with a count at least its own and at most n / 64 higher, that
+//   the counts come highest first, and that remove lowers a count. Returns
+//   POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    const size_t N = 200000;
+    const size_t CAPACITY = 64;
+    mt19937_64 random(50);
+    space_saving<int> counter(CAPACITY);
+    map<int, uint64_t> exact;
+    vector<pair<int, uint64_t>> top;
+    uint64_t slack = N / CAPACITY;
+
+    cout << "Counting a skewed stream of " << N << " values ... ";
+    cout.flush( );
+    for (size_t i = 0; i < N; ++i)
+    {
+        // A value v about as often as 1 / v, over 1 to 5000.
+        int v = int(exp(uniform_real_distribution<double>(0.0, log(5000.0))(random)));
+        counter.add(v);
+        ++exact[v];
+    }
+    top = counter.top(CAPACITY);
+    for (size_t i = 1; i < top.size( ); ++i)
+    {
+        if (top[i].second > top[i-1].second)
+        {
+            cout << "top( ) was not in order of count." << endl;
+            return 0;
+        }
+    }
+    for (map<int, uint64_t>::const_iterator it = exact.begin( ); it != exact.end( ); ++it)
+    {
+        size_t j = 0;
+
+        while ((j < top.size( )) && (top[j].first != it->first))
+            ++j;
+        if (j < top.size( ) && ((top[j].second < it->second) || (top[j].second > it->second + slack)))
+        {
+            cout << "the count of " << it->first << " was " << top[j].second;
+            cout << ", not " << it->second << " to " << it->second + slack << "." << endl;
+            return 0;
+        }
+        if ((j == top.size( )) && (it->second > slack))
+        {
+            cout << it->first << ", seen " << it->second << " times, was missing." << endl;
+            return 0;
+        }
+    }
+    if (counter.top(3).size( ) != 3)
+    {
+        cout << "top(3) did not give 3 values." << endl;
+        return 0;
+    }
+    cout << "Passed." << endl;
+
+    cout << "Removing values ... ";
+    cout.flush( );
+    {
+        space_saving<int> small(4);
+        vector<pair<int, uint64_t>> answer;
+
+        for (int i = 0; i < 10; ++i)
+            small.add(1);
+        for (int i = 0; i < 4; ++i)
+            small.add(2);
+        small.remove(1);
+        small.remove(1);
+        small.remove(3);        // Has no counter: nothing changes.
+        answer = small.top(2);
+        if ((answer.size( ) != 2) || (answer[0] != make_pair(1, uint64_t(8)))
+            || (answer[1] != make_pair(2, uint64_t(4))))
+        {
+            cout << "remove did not lower the counts." << endl;
+            return 0;
+        }
+        small.clear( );
+        if (!small.top(4).empty( ))
+        {
+            cout << "clear( ) left counters." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// bool close_quantiles(const sequence_sketch<double>& summary,
+//                      const sequence<double>& items)
+//   Precondition: items is not empty.
+//   Postcondition: A return value of true indicates that the median and
+//   the 0.9 quantile of summary are within RANK_ERROR of their exact ranks
+//   in items, and that size( ) is exact.
+// **************************************************************************
+bool close_quantiles(const sequence_sketch<double>& summary, const sequence<double>& items)
+{
+    vector<double> sorted(items.begin( ), items.end( ));
+
+    sort(sorted.begin( ), sorted.end( ));
+    return (summary.size( ) == items.size( ))
+        && (quantile_error(sorted, summary.quantile(0.5), 0.5) <= RANK_ERROR)
+        && (quantile_error(sorted, summary.quantile(0.9), 0.9) <= RANK_ERROR);
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Builds a sequence_sketch on a sequence of 10000 items and checks it as
+//   items are inserted and attached, as removals approach and then pass
+//   rebuild_fraction (0.25), after an assignment to the sequence and after
+//   clear( ), and that a new sketch can observe the sequence once the old
+//   one is gone. Returns POINTS[4] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test4( )
+{
+    sequence<double> items;
+    size_t distinct_before;
+
+    cout << "Following inserts and attaches ... ";
+    cout.flush( );
+    for (int i = 0; i < 10000; ++i)
+        items.attach(double(i % 5000));
+    {
+        sequence_sketch<double> summary(items);
+
+        if ((summary.rebuilds( ) != 1) || !close_quantiles(summary, items)
+            || (fabs(summary.distinct( ) - 5000.0) > DISTINCT_ERROR * 5000.0))
+        {
+            cout << "the first scan was wrong." << endl;
+            return 0;
+        }
+        // 10000 more items, all above the first ones: the median moves up.
+        items.start( );
+        for (int i = 0; i < 5000; ++i)
+            items.insert(double(10000 + i));
+        items.seek_end( );
+        for (int i = 0; i < 5000; ++i)
+            items.attach(double(15000 + i));
+        if ((summary.rebuilds( ) != 1) || !close_quantiles(summary, items)
+            || (summary.top(1).size( ) != 1) || (summary.top(1)[0].second < 2))
+        {
+            cout << "the sketch did not follow the additions." << endl;
+            return 0;
+        }
+        cout << "Passed." << endl;
+
+        cout << "Removing items up to and past rebuild_fraction ... ";
+        cout.flush( );
+        // 20000 items were scanned or added: 5000 removals are the limit.
+        distinct_before = size_t(summary.distinct( ));
+        items.start( );
+        for (int i = 0; i < 5000; ++i)
+            items.remove_current( );
+        if ((summary.size( ) != 15000) || (summary.rebuilds( ) != 1)
+            || (fabs(summary.distinct( ) - double(distinct_before)) > 1.0))
+        {
+            cout << "the sketch rescanned before the removals passed the limit." << endl;
+            return 0;
+        }
+        items.remove_current( );
+        if ((summary.size( ) != 14999) || !close_quantiles(summary, items) || (summary.rebuilds( ) != 2))
+        {
+            cout << "the sketch did not rescan once the removals passed the limit." << endl;
+            return 0;
+        }
+        cout << "Passed." << endl;
+
+        cout << "Following an assignment and a clear ... ";
+        cout.flush( );
+        {
+            sequence<double> other;
+            for (int i = 0; i < 3000; ++i)
+                other.attach(double(-i));
+            items = other;
+        }
+        if ((summary.size( ) != 3000) || !close_quantiles(summary, items) || (summary.rebuilds( ) != 3))
+        {
+            cout << "the sketch did not rescan after an assignment." << endl;
+            return 0;
+        }
+        items.clear( );
+        items.attach(4.0);
+        if ((summary.size( ) != 1) || (summary.quantile(0.5) != 4.0) || (summary.rebuilds( ) != 4)
+            || (summary.distinct( ) > 1.5))
+        {
+            cout << "the sketch did not rescan after clear( )." << endl;
+            return 0;
+        }
+        summary.rebuild( );
+        if (summary.rebuilds( ) != 5)
+        {
+            cout << "rebuild( ) did not rescan." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Observing the sequence again after the sketch is gone ... ";
+    cout.flush( );
+    for (int i = 0; i < 999; ++i)
+        items.attach(double(i));
+    {
+        sequence_sketch<double> again(items);
+        items.attach(1000.0);
+        if ((again.size( ) != 1001) || !close_quantiles(again, items) || (again.rebuilds( ) != 1))
+        {
+            cout << "a second sketch went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,531 @@
+// FILE: sequence_sort_exam.cpp
+// Non-interactive test program for sorting sequences: list_merge and
+// list_sort (see node2.h), and sequence::sort and sequence::sort_parallel
+// (see sequence4.h).
+//
+// DESCRIPTION:
+// Each function of this program tests part of the sort, returning some
+// number of points to indicate how much of the test was passed.
+// A description and result of each test is printed to cout.
+// The items are records with a key, sorted by key alone, and a tag giving
+// each record's original place, so that a test can tell equal keys apart:
+// a stable sort must leave records with equal keys in tag order. Each sort
+// of a sequence is checked against std::stable_sort, with the cursor on
+// each item in turn (and with no current item): the cursor must stay on
+// the same record, and insert, attach, and seek_end followed by attach
+// must land where they should afterwards, which they do only if the
+// precursor and tail_ptr were relinked correctly.
+//
+// SEQUENCE_PARALLEL_COPY_MIN is defined to 64 below, so sort( ) takes the
+// parallel run/merge path for the larger sequences here whenever there are
+// two cores or more. sort_parallel is also called directly with 1 to 16
+// workers, which reaches that path on one core too. The program returns
+// EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_sort_exam.cpp -o sequence_sort_exam
+//     ./sequence_sort_exam
+
+#define SEQUENCE_PARALLEL_COPY_MIN 64
+#include <algorithm>    // Provides find_if, stable_sort.
+#include <iostream>     // Provides cout.
+#include <cstdlib>      // Provides size_t.
+#include <random>       // Provides mt19937 for the keys.
+#include <vector>       // Provides vector for the expected items.
+#include "sequence4.h"  // Provides the template sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for sorting the sequence class",
+    "Testing list_merge and list_sort",
+    "Testing sort: stability, the cursor, and insert/attach afterwards",
+    "Testing sort_parallel with 1 to 16 workers",
+    "Testing sort with SEQUENCE_PARALLEL_COPY_MIN defined to 64"
+};
+
+// A record sorted by key; tag is its place before the sort.
+struct record
+{
+    int key;
+    int tag;
+};
+
+bool operator ==(const record& a, const record& b)
+{
+    return (a.key == b.key) && (a.tag == b.tag);
+}
+
+bool operator !=(const record& a, const record& b)
+{
+    return !(a == b);
+}
+
+// The sort order: by key only.
+struct key_less
+{
+    bool operator ( )(const record& a, const record& b) const { return a.key < b.key; }
+};
+
+// The record insert and attach add after a sort.
+const record NEW_RECORD = { -1, -1 };
+
+
+// **************************************************************************
+// vector<record> make_records(size_t n, int keys, unsigned seed)
+//   Postcondition: The return value holds n records with random keys from 0
+//   to keys - 1 (so many keys repeat) and tags 0, 1, ..., n-1.
+// **************************************************************************
+vector<record> make_records(size_t n, int keys, unsigned seed)
+{
+    vector<record> answer;
+    mt19937 random(seed);
+    record r;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        r.key = int(random( ) % unsigned(keys));
+        r.tag = int(i);
+        answer.push_back(r);
+    }
+    return answer;
+}
+
+
+// **************************************************************************
+// bool matches(const sequence<record>& test, const vector<record>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item (at
+//   position cursor_spot), or that it has no current item and position( ) ==
+//   size( ) if cursor_spot >= items.size( ). The cursor is not moved.
+// **************************************************************************
+bool matches(const sequence<record>& test, const vector<record>& items, size_t cursor_spot)
+{
+    sequence<record>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || (*it != items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// void fill(sequence<record>& test, const vector<record>& items,
+//           size_t cursor_spot)
+//   Postcondition: test holds the items, and item [cursor_spot] is its
+//   current item (no item, if cursor_spot >= items.size( )).
+// **************************************************************************
+void fill(sequence<record>& test, const vector<record>& items, size_t cursor_spot)
+{
+    for (size_t i = 0; i < items.size( ); ++i)
+        test.attach(items[i]);
+    test.go_to(cursor_spot);
+}
+
+
+// **************************************************************************
+// void expect_edit(vector<record>& items, size_t& spot, bool inserting)
+//   Postcondition: NEW_RECORD has been added to items where insert (or
+//   attach, if inserting is false) puts it in a sequence holding items with
+//   the cursor at [spot], and spot is where the new current item is, as
+//   documented in sequence4.h.
+// **************************************************************************
+void expect_edit(vector<record>& items, size_t& spot, bool inserting)
+{
+    if (inserting)
+        spot = (spot < items.size( )) ? spot : 0;
+    else
+        spot = (spot < items.size( )) ? spot + 1 : items.size( );
+    items.insert(items.begin( ) + spot, NEW_RECORD);
+}
+
+
+// Tells whether a record has a given tag.
+struct has_tag
+{
+    int tag;
+    bool operator ( )(const record& r) const { return r.tag == tag; }
+};
+
+
+// **************************************************************************
+// template<class Sorter>
+// bool check(const char name[], const vector<record>& items, size_t spot,
+//            Sorter sort_it)
+//   Precondition: sort_it(test) sorts test by key_less.
+//   Postcondition: A return value of true indicates that, on sequences
+//   holding items with the cursor at [spot], sort_it left the records in the
+//   order std::stable_sort gives, with the cursor on the record it was on
+//   (or no current item), and that insert, attach, and seek_end and attach
+//   afterwards put NEW_RECORD where they should. Otherwise a description of
+//   the failure is printed to cout.
+// **************************************************************************
+template<class Sorter>
+bool check(const char name[], const vector<record>& items, size_t spot, Sorter sort_it)
+{
+    vector<record> expected = items;
+    size_t expected_spot = items.size( );
+    vector<record> inserted;
+    vector<record> attached;
+    vector<record> appended;
+    size_t inserted_spot;
+    size_t attached_spot;
+    size_t appended_spot;
+    sequence<record> first;
+    sequence<record> second;
+
+    stable_sort(expected.begin( ), expected.end( ), key_less( ));
+    if (spot < items.size( ))
+    {
+        has_tag same = { items[spot].tag };
+        expected_spot = size_t(find_if(expected.begin( ), expected.end( ), same) - expected.begin( ));
+    }
+    inserted = attached = expected;
+    inserted_spot = attached_spot = expected_spot;
+    expect_edit(inserted, inserted_spot, true);
+    expect_edit(attached, attached_spot, false);
+    appended = inserted;
+    appended_spot = appended.size( );
+    expect_edit(appended, appended_spot, false);
+
+    fill(first, items, spot);
+    sort_it(first);
+    if (!matches(first, expected, expected_spot))
+    {
+        cout << "\n    " << name << " of " << items.size( ) << " items with the cursor at [";
+        cout << spot << "] is not stable, or moved the cursor." << endl;
+        return false;
+    }
+    first.insert(NEW_RECORD);
+    if (!matches(first, inserted, inserted_spot))
+    {
+        cout << "\n    insert after " << name << " of " << items.size( ) << " items with the cursor at [";
+        cout << spot << "] went wrong (precursor or head_ptr)." << endl;
+        return false;
+    }
+    first.seek_end( );
+    first.attach(NEW_RECORD);
+    if (!matches(first, appended, appended_spot))
+    {
+        cout << "\n    seek_end and attach after " << name << " of " << items.size( );
+        cout << " items with the cursor at [" << spot << "] went wrong (tail_ptr)." << endl;
+        return false;
+    }
+
+    fill(second, items, spot);
+    sort_it(second);
+    second.attach(NEW_RECORD);
+    if (!matches(second, attached, attached_spot))
+    {
+        cout << "\n    attach after " << name << " of " << items.size( ) << " items with the cursor at [";
+        cout << spot << "] went wrong (cursor or tail_ptr)." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+// Calls sort(key_less( )).
+struct do_sort
+{
+    void operator ( )(sequence<record>& test) const { test.sort(key_less( )); }
+};
+
+// Calls sort_parallel(key_less( ), workers).
+struct do_sort_parallel
+{
+    unsigned workers;
+    void operator ( )(sequence<record>& test) const { test.sort_parallel(key_less( ), workers); }
+};
+
+
+// **************************************************************************
+// bool list_is(const node<record>* head_ptr, const node<record>* tail_ptr,
+//              const vector<record>& items)
+//   Postcondition: A return value of true indicates that the list holds
+//   exactly the items, in order, and that tail_ptr is its last node.
+// **************************************************************************
+bool list_is(const node<record>* head_ptr, const node<record>* tail_ptr, const vector<record>& items)
+{
+    const node<record>* last = NULL;
+    size_t i = 0;
+
+    for (const node<record>* p = head_ptr; p != NULL; p = p->link( ), ++i)
+    {
+        if ((i >= items.size( )) || (p->data( ) != items[i]))
+            return false;
+        last = p;
+    }
+    return (i == items.size( )) && (last == tail_ptr);
+}
+
+
+// **************************************************************************
+// void make_list(const vector<record>& items, node<record>*& head_ptr,
+//                node<record>*& tail_ptr)
+//   Postcondition: head_ptr and tail_ptr are the head and tail pointers of
+//   a new list holding the items.
+// **************************************************************************
+void make_list(const vector<record>& items, node<record>*& head_ptr, node<record>*& tail_ptr)
+{
+    head_ptr = NULL;
+    tail_ptr = NULL;
+    for (size_t i = 0; i < items.size( ); ++i)
+    {
+        if (tail_ptr == NULL)
+        {
+            list_head_insert(head_ptr, items[i]);
+            tail_ptr = head_ptr;
+        }
+        else
+        {
+            list_insert(tail_ptr, items[i]);
+            tail_ptr = tail_ptr->link( );
+        }
+    }
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Tests list_merge on sorted lists with shared keys (the first list's
+//   records must come before the other's equal ones) and list_sort on lists
+//   of 0 to 300 records. Returns POINTS[1] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    const size_t sizes[] = { 0, 1, 2, 3, 17, 64, 300 };
+    const size_t many_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    cout << "Merging pairs of sorted lists of 0 to 300 records ... ";
+    cout.flush( );
+    for (size_t a = 0; a < many_sizes; ++a)
+    {
+        for (size_t b = 0; b < many_sizes; ++b)
+        {
+            vector<record> left = make_records(sizes[a], 4, unsigned(a));
+            vector<record> right = make_records(sizes[b], 4, unsigned(100 + b));
+            vector<record> expected;
+            node<record> *head_ptr, *tail_ptr, *other_head, *other_tail;
+
+            // Tag the right list's records after the left's, so that the
+            // stable merge is std::stable_sort of the two, in turn
+            for (size_t i = 0; i < right.size( ); ++i)
+                right[i].tag += int(left.size( ));
+            stable_sort(left.begin( ), left.end( ), key_less( ));
+            stable_sort(right.begin( ), right.end( ), key_less( ));
+            expected = left;
+            expected.insert(expected.end( ), right.begin( ), right.end( ));
+            stable_sort(expected.begin( ), expected.end( ), key_less( ));
+
+            make_list(left, head_ptr, tail_ptr);
+            make_list(right, other_head, other_tail);
+            list_merge(head_ptr, tail_ptr, other_head, other_tail, key_less( ));
+            if (!list_is(head_ptr, tail_ptr, expected))
+            {
+                cout << "Failed merging " << sizes[a] << " and " << sizes[b] << " records." << endl;
+                return 0;
+            }
+            list_clear(head_ptr);
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Sorting lists of 0 to 300 records ... ";
+    cout.flush( );
+    for (size_t s = 0; s < many_sizes; ++s)
+    {
+        for (int keys = 1; keys <= 1000; keys *= 10)
+        {
+            vector<record> items = make_records(sizes[s], keys, unsigned(s));
+            vector<record> expected = items;
+            node<record> *head_ptr, *tail_ptr;
+
+            stable_sort(expected.begin( ), expected.end( ), key_less( ));
+            make_list(items, head_ptr, tail_ptr);
+            list_sort(head_ptr, tail_ptr, key_less( ));
+            if (!list_is(head_ptr, tail_ptr, expected))
+            {
+                cout << "Failed sorting " << sizes[s] << " records with " << keys << " keys." << endl;
+                return 0;
+            }
+            list_clear(head_ptr);
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Tests sort on sequences of up to 40 records, with the cursor on each.
+//   Returns POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    const size_t sizes[] = { 0, 1, 2, 3, 7, 40 };
+    const size_t many_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (size_t s = 0; s < many_sizes; ++s)
+    {
+        cout << "Sorting a sequence of " << sizes[s] << " records ... ";
+        cout.flush( );
+        for (int keys = 1; keys <= 100; keys *= 10)
+        {
+            vector<record> items = make_records(sizes[s], keys, unsigned(s + 7));
+
+            for (size_t spot = 0; spot <= items.size( ); ++spot)
+            {
+                if (!check("sort", items, spot, do_sort( )))
+                    return 0;
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Tests sort_parallel with 1 to 16 workers on sequences of up to 300
+//   records, with the cursor on several of them. Returns POINTS[3] if the
+//   tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    const size_t sizes[] = { 0, 1, 5, 63, 64, 65, 300 };
+    const size_t many_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (size_t s = 0; s < many_sizes; ++s)
+    {
+        vector<record> items = make_records(sizes[s], 8, unsigned(s + 31));
+        size_t step = (items.size( ) / 10) + 1;
+
+        cout << "Sorting a sequence of " << sizes[s] << " records in parallel ... ";
+        cout.flush( );
+        for (unsigned workers = 1; workers <= 16; ++workers)
+        {
+            do_sort_parallel sorter = { workers };
+
+            for (size_t spot = 0; spot <= items.size( ); spot += step)
+            {
+                if (!check("sort_parallel", items, spot, sorter))
+                {
+                    cout << "    (" << workers << " workers)" << endl;
+                    return 0;
+                }
+            }
+            // The last item and no current item, whatever the step
+            if ((!items.empty( ) && !check("sort_parallel", items, items.size( ) - 1, sorter))
+                || !check("sort_parallel", items, items.size( ), sorter))
+            {
+                cout << "    (" << workers << " workers)" << endl;
+                return 0;
+            }
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Tests sort on sequences of SEQUENCE_PARALLEL_COPY_MIN records or more,
+//   which it sorts in parallel when there are two cores or more. Returns
+//   POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    const size_t sizes[] = { 64, 100, 1000, 5000 };
+    const size_t many_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (size_t s = 0; s < many_sizes; ++s)
+    {
+        vector<record> items = make_records(sizes[s], 16, unsigned(s + 57));
+        const size_t spots[4] = { 0, items.size( ) / 2, items.size( ) - 1, items.size( ) };
+
+        cout << "Sorting a sequence of " << sizes[s] << " records ... ";
+        cout.flush( );
+        for (size_t i = 0; i < 4; ++i)
+        {
+            if (!check("sort", items, spots[i], do_sort( )))
+                return 0;
+        }
+        cout << "Passed." << endl;
+    }
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
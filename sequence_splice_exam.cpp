@@ -0,0 +1,409 @@
+// FILE: sequence_splice_exam.cpp
+// Non-interactive test program for sequence::splice_back (see sequence4.h)
+// and sharded_sequence::concatenate (see sharded_sequence.h), which is built
+// on it.
+//
+// DESCRIPTION:
+// Each function of this program tests part of the splicing, returning some
+// number of points to indicate how much of the test was passed.
+// A description and result of each test is printed to cout.
+// The tests splice sequences of several sizes, with the cursors of both at
+// every index (and with no current item), and check the items, the cursors,
+// and where insert and attach land afterwards. Others check that journals
+// and observers of both sequences hear of the move, that an observer which
+// throws part way through leaves both sequences whole (the spliced nodes
+// owned by the receiver alone), and that concatenate gathers every item
+// attached by several threads, in each thread's order. The program returns
+// EXIT_FAILURE unless every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_splice_exam.cpp -o sequence_splice_exam
+//     ./sequence_splice_exam
+
+#include <iostream>             // Provides cout.
+#include <cstdlib>              // Provides size_t.
+#include <stdexcept>            // Provides runtime_error for the observer.
+#include <thread>               // Provides thread for the shards.
+#include <vector>               // Provides vector for the expected items.
+#include "sharded_sequence.h"   // Provides the sequence and sharded_sequence classes
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 3;
+const int POINTS[MANY_TESTS+1] = {
+    12,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4   // Test 3 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for splice_back and concatenate",
+    "Testing splice_back's items and cursors, and editing after it",
+    "Testing journals and observers of splice_back, and a throwing observer",
+    "Testing concatenate after attaches from several threads"
+};
+
+// The sizes of the sequences spliced.
+const size_t SIZES[] = { 0, 1, 2, 5 };
+const size_t MANY_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+
+// **************************************************************************
+// bool matches(const sequence<int>& test, const vector<int>& items,
+//              size_t cursor_spot)
+//   Postcondition: A return value of true indicates that test holds exactly
+//   the items, in order, and that item [cursor_spot] is its current item (at
+//   position cursor_spot), or that it has no current item and position( ) ==
+//   size( ) if cursor_spot >= items.size( ). The cursor is not moved.
+// **************************************************************************
+bool matches(const sequence<int>& test, const vector<int>& items, size_t cursor_spot)
+{
+    sequence<int>::const_iterator it = test.begin( );
+    size_t i;
+
+    if (test.size( ) != items.size( ))
+        return false;
+    for (i = 0; i < items.size( ); ++i, ++it)
+    {
+        if ((it == test.end( )) || (*it != items[i]))
+            return false;
+    }
+    if (it != test.end( ))
+        return false;
+    if (cursor_spot >= items.size( ))
+        return !test.is_item( ) && (test.position( ) == test.size( ));
+    return test.is_item( ) && (test.position( ) == cursor_spot)
+        && (test.current( ) == items[cursor_spot]);
+}
+
+
+// **************************************************************************
+// void fill(sequence<int>& test, vector<int>& items, size_t n, int first,
+//           size_t cursor_spot)
+//   Postcondition: test and items hold first, first+1, ..., first+n-1, and
+//   item [cursor_spot] is test's current item (no item, if cursor_spot >= n).
+// **************************************************************************
+void fill(sequence<int>& test, vector<int>& items, size_t n, int first, size_t cursor_spot)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        test.attach(first + int(i));
+        items.push_back(first + int(i));
+    }
+    test.go_to(cursor_spot);
+}
+
+
+// Counts what it is told, and throws from added once it has been told
+// fail_after items (never, if fail_after is 0).
+class counting_observer : public sequence_observer<int>
+{
+public:
+    counting_observer(size_t fail_after = 0)
+        : many_added(0), many_removed(0), many_resets(0), limit(fail_after) { }
+    void added(const int& entry)
+    {
+        (void)entry;
+        ++many_added;
+        if (many_added == limit)
+            throw runtime_error("observer failed");
+    }
+    void removed(const int& entry) { (void)entry; ++many_removed; }
+    void reset( ) { ++many_resets; }
+    size_t many_added;
+    size_t many_removed;
+    size_t many_resets;
+private:
+    size_t limit;
+};
+
+
+// **************************************************************************
+// int test1( )
+//   Splices every pair of sizes, with the cursors of both sequences at every
+//   spot, and checks both sequences, then an attach (at the receiver's
+//   cursor), an insert into the emptied source, and an attach at the end.
+//   Returns POINTS[1] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test1( )
+{
+    cout << "Splicing sequences of 0, 1, 2 and 5 items ... ";
+    cout.flush( );
+    for (size_t s = 0; s < MANY_SIZES; ++s)
+    {
+        for (size_t t = 0; t < MANY_SIZES; ++t)
+        {
+            for (size_t spot = 0; spot <= SIZES[s]; ++spot)
+            {
+                for (size_t other_spot = 0; other_spot <= SIZES[t]; ++other_spot)
+                {
+                    sequence<int> receiver;
+                    sequence<int> other;
+                    vector<int> items;
+                    vector<int> other_items;
+                    size_t new_spot;
+
+                    fill(receiver, items, SIZES[s], 0, spot);
+                    fill(other, other_items, SIZES[t], 100, other_spot);
+                    receiver.splice_back(other);
+                    items.insert(items.end( ), other_items.begin( ), other_items.end( ));
+                    // The current item stays; with none, the cursor is past the new end
+                    new_spot = (spot < SIZES[s]) ? spot : items.size( );
+                    if (!matches(receiver, items, new_spot) || !matches(other, vector<int>( ), 0))
+                    {
+                        cout << "Failed splicing " << SIZES[t] << " items after " << SIZES[s];
+                        cout << " with the cursors at [" << spot << "] and [" << other_spot << "]." << endl;
+                        return 0;
+                    }
+
+                    // attach lands after the current item, or at the new end
+                    new_spot = (spot < SIZES[s]) ? spot + 1 : items.size( );
+                    items.insert(items.begin( ) + new_spot, -1);
+                    receiver.attach(-1);
+                    other.insert(-2);
+                    other.seek_end( );
+                    other.attach(-3);
+                    receiver.seek_end( );
+                    receiver.attach(-4);
+                    items.push_back(-4);
+                    other_items.clear( );
+                    other_items.push_back(-2);
+                    other_items.push_back(-3);
+                    if (!matches(receiver, items, items.size( ) - 1) || !matches(other, other_items, 1))
+                    {
+                        cout << "Failed editing after splicing " << SIZES[t] << " items after " << SIZES[s];
+                        cout << " with the cursors at [" << spot << "] and [" << other_spot << "]." << endl;
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Splices sequences with journals and observers on both, and checks what
+//   each was told; then splices into a sequence whose observer throws on
+//   the third item it is told of, and checks that both sequences are whole.
+//   Returns POINTS[2] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    cout << "Replaying the journals of both sequences ... ";
+    cout.flush( );
+    {
+        sequence<int> receiver;
+        sequence<int> other;
+        vector<int> items;
+        vector<int> other_items;
+
+        fill(receiver, items, 3, 0, 1);
+        fill(other, other_items, 4, 100, 0);
+        receiver.journal_start( );
+        other.journal_start( );
+
+        sequence<int> receiver_replica(receiver);
+        sequence<int> other_replica(other);
+        size_t receiver_version = receiver.version( );
+        size_t other_version = other.version( );
+
+        receiver.splice_back(other);
+        receiver.delta_since(receiver_version).apply_delta(receiver_replica);
+        other.delta_since(other_version).apply_delta(other_replica);
+        items.insert(items.end( ), other_items.begin( ), other_items.end( ));
+        if (!matches(receiver_replica, items, 1) || (other_replica.size( ) != 0))
+        {
+            cout << "Failed." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Telling the observers of both sequences ... ";
+    cout.flush( );
+    {
+        sequence<int> receiver;
+        sequence<int> other;
+        vector<int> items;
+        counting_observer watch_receiver;
+        counting_observer watch_other;
+
+        fill(receiver, items, 2, 0, 0);
+        fill(other, items, 5, 100, 0);
+        receiver.observe(&watch_receiver);
+        other.observe(&watch_other);
+        receiver.splice_back(other);
+        if ((watch_receiver.many_added != 5) || (watch_receiver.many_resets != 0)
+            || (watch_other.many_resets != 1) || (watch_other.many_added != 0))
+        {
+            cout << "Failed." << endl;
+            return 0;
+        }
+        receiver.observe(NULL);
+        other.observe(NULL);
+    }
+    cout << "Passed." << endl;
+
+    cout << "Splicing into a sequence whose observer throws ... ";
+    cout.flush( );
+    {
+        sequence<int> receiver;
+        sequence<int> other;
+        vector<int> items;
+        vector<int> other_items;
+        counting_observer failing(3);
+        bool thrown = false;
+
+        fill(receiver, items, 1, 0, 0);
+        fill(other, other_items, 3, 100, 1);
+        receiver.observe(&failing);
+        try
+        {
+            receiver.splice_back(other);
+        }
+        catch (const runtime_error&)
+        {
+            thrown = true;
+        }
+        receiver.observe(NULL);
+        items.insert(items.end( ), other_items.begin( ), other_items.end( ));
+        if (!thrown || !matches(receiver, items, 0) || !matches(other, vector<int>( ), 0))
+        {
+            cout << "Failed: the sequences do not hold the spliced nodes once each." << endl;
+            return 0;
+        }
+        // Both go on working; destroying them frees each node once
+        receiver.seek_end( );
+        receiver.attach(7);
+        other.attach(8);
+        items.push_back(7);
+        if (!matches(receiver, items, items.size( ) - 1) || !matches(other, vector<int>(1, 8), 0))
+        {
+            cout << "Failed editing after the throw." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Has four threads attach to a sharded_sequence with two and with eight
+//   shards, concatenates it, and checks that every item is there once, that
+//   each thread's items kept their order, and that the sharded_sequence is
+//   then empty. Returns POINTS[3] if the tests are passed. Otherwise returns
+//   0.
+// **************************************************************************
+int test3( )
+{
+    const size_t THREADS = 4;
+    const size_t EACH = 5000;
+    const size_t SHARDS[] = { 2, 8 };
+
+    cout << "Concatenating the attaches of four threads ... ";
+    cout.flush( );
+    for (size_t k = 0; k < 2; ++k)
+    {
+        sharded_sequence<int> sharded(SHARDS[k]);
+        vector<thread> workers;
+        vector<size_t> next(THREADS, 0);
+        size_t many = 0;
+
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+            workers.push_back(thread([&sharded, t, EACH]( )
+            {
+                for (size_t i = 0; i < EACH; ++i)
+                    sharded.attach(int(t * EACH + i));
+            }));
+        }
+        for (size_t t = 0; t < THREADS; ++t)
+            workers[t].join( );
+        if (sharded.size( ) != THREADS * EACH)
+        {
+            cout << "Failed: size( ) is " << sharded.size( ) << "." << endl;
+            return 0;
+        }
+
+        sequence<int> all = sharded.concatenate( );
+        for (sequence<int>::const_iterator it = all.begin( ); it != all.end( ); ++it, ++many)
+        {
+            size_t thread_number = size_t(*it) / EACH;
+
+            // Each thread's items come in the order it attached them
+            if ((thread_number >= THREADS) || (size_t(*it) % EACH != next[thread_number]))
+            {
+                cout << "Failed: item " << *it << " is out of place." << endl;
+                return 0;
+            }
+            ++next[thread_number];
+        }
+        if ((many != THREADS * EACH) || (all.size( ) != many) || all.is_item( )
+            || (sharded.size( ) != 0))
+        {
+            cout << "Failed with " << SHARDS[k] << " shards." << endl;
+            return 0;
+        }
+        sharded.attach(1);
+        if (sharded.concatenate( ).size( ) != 1)
+        {
+            cout << "Failed: a shard did not work after concatenate." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
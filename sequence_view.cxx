@@ -0,0 +1,80 @@
+// FILE: sequence_view.cxx
+// IMPLEMENTS: The view functions of sequence_view.h (see sequence_view.h for
+// documentation). The view classes themselves are defined in the header.
+
+namespace scu_coen70_6B
+{
+    template<class Range>
+    range_view<typename range_iterator<Range>::type> view(Range&& r)
+    {
+        return range_view<typename range_iterator<Range>::type>(r.begin( ), r.end( ));
+    }
+
+    template<class Iterator>
+    range_view<Iterator> view(Iterator first, Iterator last)
+    {
+        return range_view<Iterator>(first, last);
+    }
+
+    template<class Range, class Predicate>
+    filter_view<typename range_iterator<Range>::type, Predicate> filter(Range&& r, Predicate pred)
+    {
+        return filter_view<typename range_iterator<Range>::type, Predicate>(r.begin( ), r.end( ), pred);
+    }
+
+    template<class Range, class Function>
+    transform_view<typename range_iterator<Range>::type, Function> transform(Range&& r, Function f)
+    {
+        return transform_view<typename range_iterator<Range>::type, Function>(r.begin( ), r.end( ), f);
+    }
+
+    template<class Range>
+    take_view<typename range_iterator<Range>::type> take(Range&& r, std::size_t n)
+    {
+        return take_view<typename range_iterator<Range>::type>(r.begin( ), r.end( ), n);
+    }
+
+    template<class Range>
+    range_view<typename range_iterator<Range>::type> drop(Range&& r, std::size_t n)
+    {
+        typename range_iterator<Range>::type first = r.begin( );
+        typename range_iterator<Range>::type last = r.end( );
+
+        while ((n > 0) && (first != last))
+        {
+            ++first;
+            --n;
+        }
+        return range_view<typename range_iterator<Range>::type>(first, last);
+    }
+
+    template<class Range1, class Range2>
+    zip_view<typename range_iterator<Range1>::type, typename range_iterator<Range2>::type>
+    zip(Range1&& a, Range2&& b)
+    {
+        return zip_view<typename range_iterator<Range1>::type, typename range_iterator<Range2>::type>
+            (a.begin( ), a.end( ), b.begin( ), b.end( ));
+    }
+
+    template<class Item>
+    range_view<typename sequence<Item>::iterator> slice(sequence<Item>& s)
+    {
+        // With no current item, at_current( ) is already end( ).
+        return range_view<typename sequence<Item>::iterator>(s.at_current( ), s.end( ));
+    }
+
+    template<class Item>
+    take_view<typename sequence<Item>::iterator> slice(sequence<Item>& s, std::size_t n)
+    {
+        return take_view<typename sequence<Item>::iterator>(s.at_current( ), s.end( ), n);
+    }
+
+    template<class Range>
+    sequence<typename Range::value_type> to_sequence(const Range& r)
+    {
+        sequence<typename Range::value_type> answer;
+
+        answer.append(r.begin( ), r.end( ));
+        return answer;
+    }
+}
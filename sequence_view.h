@@ -0,0 +1,406 @@
+// FILE: sequence_view.h
+// PROVIDES: Lazy views over a sequence (or any range with begin( ) and
+// end( ) of one iterator type, such as a pair of node iterators), all within
+// the namespace scu_coen70_6B. Requires C++17.
+//
+// A view does not copy or allocate anything: it holds iterators into the
+// underlying sequence and computes each element when it is reached, so views
+// can be stacked freely:
+//     sequence<double> s;
+//     ...
+//     sequence<double> big = to_sequence(take(filter(s, is_big), 10));
+// A view is only valid while the sequence it looks at is alive, and (like an
+// iterator) may be invalidated by remove_current on that sequence.
+//
+// In C++20 every view derives from std::ranges::view_base and its iterators
+// satisfy std::forward_iterator, so the views also combine with the standard
+// range adaptors and algorithms (forward ones only), for example
+//     for (double x : filter(s, is_big) | std::views::take(10)) ...
+//     std::ranges::count_if(transform(s, f), pred);
+//
+// VIEW FUNCTIONS:
+//   range_view<I> view(R& r)
+//     Postcondition: The return value is a view of all of r.
+//
+//   range_view<I> view(I first, I last)
+//     Postcondition: The return value is a view of [first, last).
+//
+//   filter_view<I, P> filter(R& r, P pred)
+//     Postcondition: The return value is a view of the elements x of r for
+//     which pred(x) is true, in order.
+//
+//   transform_view<I, F> transform(R& r, F f)
+//     Postcondition: The return value is a view of f(x) for each element x
+//     of r. f is called again each time an element is dereferenced.
+//
+//   take_view<I> take(R& r, std::size_t n)
+//     Postcondition: The return value is a view of the first n elements of r
+//     (or all of them if r has fewer).
+//
+//   range_view<I> drop(R& r, std::size_t n)
+//     Postcondition: The return value is a view of r without its first n
+//     elements. Skipping them costs O(n) when drop is called.
+//
+//   zip_view<I1, I2> zip(R1& a, R2& b)
+//     Postcondition: The return value is a view of std::pair(x, y) for the
+//     elements x of a and y of b taken in step; it ends with the shorter one.
+//
+//   range_view<...> slice(sequence<Item>& s)
+//   take_view<...> slice(sequence<Item>& s, std::size_t n)
+//     Postcondition: The return value is a view of the items of s from the
+//     current item on (all of them, or at most n). It is empty if s has no
+//     current item.
+//
+//   Each R above may also be a const range (viewed through const iterators),
+//   or another view, including a temporary one: views hold only iterators,
+//   so they are cheap to copy.
+//
+// MATERIALIZING:
+//   sequence<V> to_sequence(const R& r)
+//     Postcondition: The return value is a new sequence holding the elements
+//     of r (V is r's value_type), built with one sequence::append. It has no
+//     current item.
+//
+// MEMBERS OF EVERY VIEW:
+//   typedef ____ iterator
+//   typedef ____ value_type
+//   iterator begin( ) const
+//   iterator end( ) const
+//   bool empty( ) const
+//     Postcondition: empty( ) is true when begin( ) == end( ).
+
+#ifndef COEN_70_SEQUENCE_VIEW_H
+#define COEN_70_SEQUENCE_VIEW_H
+#include <cstdlib>      // Provides size_t
+#include <cstddef>      // Provides ptrdiff_t
+#include <iterator>     // Provides iterator_traits
+#include <optional>     // Provides optional
+#include <type_traits>  // Provides decay, invoke_result
+#include <utility>      // Provides pair
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>      // Provides __cpp_lib_ranges
+#endif
+#endif
+#if defined(__cpp_lib_ranges)
+#include <ranges>       // Provides view_base
+#endif
+#include "sequence4.h"  // Provides the sequence class
+
+namespace scu_coen70_6B
+{
+#if defined(__cpp_lib_ranges)
+    typedef std::ranges::view_base sequence_view_base;
+#else
+    struct sequence_view_base { };
+#endif
+
+    // Holds a function object so that the iterators that carry it stay
+    // default constructible and copy assignable even when it is a lambda.
+    template<class Function>
+    class function_box
+    {
+    public:
+        function_box( ) { }
+        function_box(const Function& f) : held(f) { }
+        function_box(const function_box& other) : held(other.held) { }
+        function_box& operator =(const function_box& other)
+        {
+            if (this != &other)
+            {
+                if (other.held)
+                    held.emplace(*other.held);
+                else
+                    held.reset( );
+            }
+            return *this;
+        }
+        const Function& get( ) const { return *held; }
+    private:
+        std::optional<Function> held;
+    };
+
+    // RANGE VIEW
+    template<class Iterator>
+    class range_view : public sequence_view_base
+    {
+    public:
+        typedef Iterator iterator;
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+        range_view( ) { }
+        range_view(Iterator first, Iterator last) : first_it(first), last_it(last) { }
+        iterator begin( ) const { return first_it; }
+        iterator end( ) const { return last_it; }
+        bool empty( ) const { return first_it == last_it; }
+    private:
+        Iterator first_it;
+        Iterator last_it;
+    };
+
+    // FILTER VIEW
+    template<class Iterator, class Predicate>
+    class filter_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::iterator_traits<Iterator>::pointer pointer;
+        typedef typename std::iterator_traits<Iterator>::reference reference;
+
+        filter_iterator( ) { }
+        filter_iterator(Iterator at, Iterator last, const function_box<Predicate>& pred)
+            : current(at), last_it(last), test(pred) { skip( ); }
+        reference operator *( ) const { return *current; }
+        filter_iterator& operator ++( )
+        {
+            ++current;
+            skip( );
+            return *this;
+        }
+        filter_iterator operator ++(int)
+        {
+            filter_iterator orig(*this);
+            ++*this;
+            return orig;
+        }
+        bool operator ==(const filter_iterator& other) const { return current == other.current; }
+        bool operator !=(const filter_iterator& other) const { return !(current == other.current); }
+    private:
+        Iterator current;
+        Iterator last_it;
+        function_box<Predicate> test;
+
+        void skip( )
+        {
+            while ((current != last_it) && !test.get( )(*current))
+                ++current;
+        }
+    };
+
+    template<class Iterator, class Predicate>
+    class filter_view : public sequence_view_base
+    {
+    public:
+        typedef filter_iterator<Iterator, Predicate> iterator;
+        typedef typename iterator::value_type value_type;
+
+        filter_view( ) { }
+        filter_view(Iterator first, Iterator last, const Predicate& pred)
+            : first_it(first), last_it(last), test(pred) { }
+        iterator begin( ) const { return iterator(first_it, last_it, test); }
+        iterator end( ) const { return iterator(last_it, last_it, test); }
+        bool empty( ) const { return begin( ) == end( ); }
+    private:
+        Iterator first_it;
+        Iterator last_it;
+        function_box<Predicate> test;
+    };
+
+    // TRANSFORM VIEW
+    template<class Iterator, class Function>
+    class transform_iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::forward_iterator_tag iterator_concept;
+        typedef typename std::invoke_result<const Function&,
+                typename std::iterator_traits<Iterator>::reference>::type reference;
+        typedef typename std::decay<reference>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+
+        transform_iterator( ) { }
+        transform_iterator(Iterator at, const function_box<Function>& f) : current(at), apply(f) { }
+        reference operator *( ) const { return apply.get( )(*current); }
+        transform_iterator& operator ++( )
+        {
+            ++current;
+            return *this;
+        }
+        transform_iterator operator ++(int)
+        {
+            transform_iterator orig(*this);
+            ++current;
+            return orig;
+        }
+        bool operator ==(const transform_iterator& other) const { return current == other.current; }
+        bool operator !=(const transform_iterator& other) const { return !(current == other.current); }
+    private:
+        Iterator current;
+        function_box<Function> apply;
+    };
+
+    template<class Iterator, class Function>
+    class transform_view : public sequence_view_base
+    {
+    public:
+        typedef transform_iterator<Iterator, Function> iterator;
+        typedef typename iterator::value_type value_type;
+
+        transform_view( ) { }
+        transform_view(Iterator first, Iterator last, const Function& f)
+            : first_it(first), last_it(last), apply(f) { }
+        iterator begin( ) const { return iterator(first_it, apply); }
+        iterator end( ) const { return iterator(last_it, apply); }
+        bool empty( ) const { return first_it == last_it; }
+    private:
+        Iterator first_it;
+        Iterator last_it;
+        function_box<Function> apply;
+    };
+
+    // TAKE VIEW
+    template<class Iterator>
+    class take_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::iterator_traits<Iterator>::pointer pointer;
+        typedef typename std::iterator_traits<Iterator>::reference reference;
+
+        take_iterator( ) : remaining(0) { }
+        take_iterator(Iterator at, Iterator last, std::size_t n) : current(at), last_it(last), remaining(n) { }
+        reference operator *( ) const { return *current; }
+        take_iterator& operator ++( )
+        {
+            ++current;
+            --remaining;
+            return *this;
+        }
+        take_iterator operator ++(int)
+        {
+            take_iterator orig(*this);
+            ++*this;
+            return orig;
+        }
+        // Every exhausted iterator is equal to every other one (and to end).
+        bool operator ==(const take_iterator& other) const
+        {
+            return (done( ) == other.done( )) && (done( ) || (current == other.current));
+        }
+        bool operator !=(const take_iterator& other) const { return !(*this == other); }
+    private:
+        Iterator current;
+        Iterator last_it;
+        std::size_t remaining;
+
+        bool done( ) const { return (remaining == 0) || (current == last_it); }
+    };
+
+    template<class Iterator>
+    class take_view : public sequence_view_base
+    {
+    public:
+        typedef take_iterator<Iterator> iterator;
+        typedef typename iterator::value_type value_type;
+
+        take_view( ) : count(0) { }
+        take_view(Iterator first, Iterator last, std::size_t n) : first_it(first), last_it(last), count(n) { }
+        iterator begin( ) const { return iterator(first_it, last_it, count); }
+        iterator end( ) const { return iterator(last_it, last_it, 0); }
+        bool empty( ) const { return (count == 0) || (first_it == last_it); }
+    private:
+        Iterator first_it;
+        Iterator last_it;
+        std::size_t count;
+    };
+
+    // ZIP VIEW
+    template<class Iterator1, class Iterator2>
+    class zip_iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::forward_iterator_tag iterator_concept;
+        typedef std::pair<typename std::iterator_traits<Iterator1>::value_type,
+                          typename std::iterator_traits<Iterator2>::value_type> value_type;
+        typedef value_type reference;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+
+        zip_iterator( ) { }
+        zip_iterator(Iterator1 at1, Iterator1 last1, Iterator2 at2, Iterator2 last2)
+            : current1(at1), last1_it(last1), current2(at2), last2_it(last2) { }
+        reference operator *( ) const { return value_type(*current1, *current2); }
+        zip_iterator& operator ++( )
+        {
+            ++current1;
+            ++current2;
+            return *this;
+        }
+        zip_iterator operator ++(int)
+        {
+            zip_iterator orig(*this);
+            ++*this;
+            return orig;
+        }
+        // Every exhausted iterator is equal to every other one (and to end).
+        bool operator ==(const zip_iterator& other) const
+        {
+            return (done( ) == other.done( )) && (done( ) || (current1 == other.current1));
+        }
+        bool operator !=(const zip_iterator& other) const { return !(*this == other); }
+    private:
+        Iterator1 current1;
+        Iterator1 last1_it;
+        Iterator2 current2;
+        Iterator2 last2_it;
+
+        bool done( ) const { return (current1 == last1_it) || (current2 == last2_it); }
+    };
+
+    template<class Iterator1, class Iterator2>
+    class zip_view : public sequence_view_base
+    {
+    public:
+        typedef zip_iterator<Iterator1, Iterator2> iterator;
+        typedef typename iterator::value_type value_type;
+
+        zip_view( ) { }
+        zip_view(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2)
+            : first1_it(first1), last1_it(last1), first2_it(first2), last2_it(last2) { }
+        iterator begin( ) const { return iterator(first1_it, last1_it, first2_it, last2_it); }
+        iterator end( ) const { return iterator(last1_it, last1_it, last2_it, last2_it); }
+        bool empty( ) const { return begin( ) == end( ); }
+    private:
+        Iterator1 first1_it;
+        Iterator1 last1_it;
+        Iterator2 first2_it;
+        Iterator2 last2_it;
+    };
+
+    // VIEW FUNCTIONS
+    template<class Range>
+    struct range_iterator
+    {
+        typedef typename std::decay<decltype(std::declval<Range&>( ).begin( ))>::type type;
+    };
+
+    template<class Range>
+    range_view<typename range_iterator<Range>::type> view(Range&& r);
+    template<class Iterator>
+    range_view<Iterator> view(Iterator first, Iterator last);
+    template<class Range, class Predicate>
+    filter_view<typename range_iterator<Range>::type, Predicate> filter(Range&& r, Predicate pred);
+    template<class Range, class Function>
+    transform_view<typename range_iterator<Range>::type, Function> transform(Range&& r, Function f);
+    template<class Range>
+    take_view<typename range_iterator<Range>::type> take(Range&& r, std::size_t n);
+    template<class Range>
+    range_view<typename range_iterator<Range>::type> drop(Range&& r, std::size_t n);
+    template<class Range1, class Range2>
+    zip_view<typename range_iterator<Range1>::type, typename range_iterator<Range2>::type>
+    zip(Range1&& a, Range2&& b);
+    template<class Item>
+    range_view<typename sequence<Item>::iterator> slice(sequence<Item>& s);
+    template<class Item>
+    take_view<typename sequence<Item>::iterator> slice(sequence<Item>& s, std::size_t n);
+    template<class Range>
+    sequence<typename Range::value_type> to_sequence(const Range& r);
+}
+#include "sequence_view.cxx"
+#endif
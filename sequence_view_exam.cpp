@@ -0,0 +1,501 @@
+// FILE: sequence_view_exam.cpp
+// Non-interactive test program for the lazy views over sequences (see
+// sequence_view.h) and sequence::append, which to_sequence uses.
+//
+// DESCRIPTION:
+// Each function of this program tests part of the views, returning some
+// number of points to indicate how much of the test was passed. A
+// description and result of each test is printed to cout. Each view is
+// checked against a vector computed directly from the items, on sequences
+// of many lengths, on const sequences, on vectors and on other views;
+// counters in the function objects check that views are lazy (nothing is
+// called until an element is reached) and that take stops early. When the
+// library has C++20 ranges, the last test also checks that the views work
+// with the standard range adaptors. The program returns EXIT_FAILURE unless
+// every test passes.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sequence_view_exam.cpp -o sequence_view_exam
+//     ./sequence_view_exam
+// (or with -std=c++20 to include the checks against std::ranges).
+
+#include <iostream>             // Provides cout.
+#include <cstdlib>              // Provides size_t.
+#include <random>               // Provides mt19937 for the random items.
+#include <string>               // Provides string, to_string.
+#include <utility>              // Provides pair.
+#include <vector>               // Provides vector for the expected elements.
+#include "sequence_view.h"      // Provides the views
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Descriptions and points for each of the tests:
+const size_t MANY_TESTS = 4;
+const int POINTS[MANY_TESTS+1] = {
+    16,  // Total points for all tests.
+     4,  // Test 1 points
+     4,  // Test 2 points
+     4,  // Test 3 points
+     4   // Test 4 points
+};
+const char DESCRIPTION[MANY_TESTS+1][256] = {
+    "tests for the views over sequences",
+    "Testing view, filter, transform, take, drop, zip and slice one at a time",
+    "Testing stacked views, to_sequence and views of other ranges",
+    "Testing that views are lazy and that take stops early",
+    "Testing view iterators, copies of views, and std::ranges where available"
+};
+
+// The number of calls made to the counting function objects below.
+size_t calls = 0;
+
+// Counting function objects, for checking when views call them.
+struct is_even
+{
+    bool operator ( )(int x) const { ++calls; return x % 2 == 0; }
+};
+
+struct square
+{
+    long operator ( )(int x) const { ++calls; return long(x) * x; }
+};
+
+
+// **************************************************************************
+// template<class Range>
+// vector<typename Range::value_type> collect(const Range& r)
+//   Postcondition: The return value holds the elements of r, in order.
+// **************************************************************************
+template<class Range>
+vector<typename Range::value_type> collect(const Range& r)
+{
+    vector<typename Range::value_type> answer;
+
+    for (typename Range::iterator it = r.begin( ); it != r.end( ); ++it)
+        answer.push_back(*it);
+    return answer;
+}
+
+
+// **************************************************************************
+// sequence<int> make(const vector<int>& items, size_t cursor_spot)
+//   Postcondition: The return value holds the items, with item [cursor_spot]
+//   current (or none, if cursor_spot >= items.size( )).
+// **************************************************************************
+sequence<int> make(const vector<int>& items, size_t cursor_spot)
+{
+    sequence<int> answer;
+
+    for (size_t i = 0; i < items.size( ); ++i)
+        answer.attach(items[i]);
+    answer.go_to(cursor_spot);
+    return answer;
+}
+
+
+// **************************************************************************
+// vector<int> random_items(mt19937& random, size_t n)
+//   Postcondition: The return value holds n random items from -50 to 49.
+// **************************************************************************
+vector<int> random_items(mt19937& random, size_t n)
+{
+    vector<int> answer(n);
+
+    for (size_t i = 0; i < n; ++i)
+        answer[i] = int(random( ) % 100) - 50;
+    return answer;
+}
+
+
+// **************************************************************************
+// vector<int> first(const vector<int>& items, size_t from, size_t n)
+//   Postcondition: The return value holds items [from] onward, at most n of
+//   them.
+// **************************************************************************
+vector<int> first(const vector<int>& items, size_t from, size_t n)
+{
+    vector<int> answer;
+
+    for (size_t i = from; (i < items.size( )) && (answer.size( ) < n); ++i)
+        answer.push_back(items[i]);
+    return answer;
+}
+
+
+// **************************************************************************
+// int test1( )
+//   Checks each view function on its own against the items, for sequences
+//   of 0 to 20 items, counts around each length, and the cursor at each
+//   spot for slice. Returns POINTS[1] if the tests are passed. Otherwise
+//   returns 0.
+// **************************************************************************
+int test1( )
+{
+    mt19937 random(33);
+    const size_t ALL = size_t(-1);
+
+    cout << "Checking each view on sequences of 0 to 20 items ... ";
+    cout.flush( );
+    for (size_t n = 0; n <= 20; ++n)
+    {
+        vector<int> items = random_items(random, n);
+        vector<int> others = random_items(random, n / 2 + 1);
+        const sequence<int> test = make(items, n / 2);
+        sequence<int> shorter = make(others, 0);
+        vector<int> evens;
+        vector<long> squares;
+        vector<pair<int, int> > pairs;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (items[i] % 2 == 0)
+                evens.push_back(items[i]);
+            squares.push_back(long(items[i]) * items[i]);
+            if (i < others.size( ))
+                pairs.push_back(pair<int, int>(items[i], others[i]));
+        }
+        if ((collect(view(test)) != items) || (collect(view(test.begin( ), test.end( ))) != items)
+            || (collect(filter(test, is_even( ))) != evens) || (collect(transform(test, square( ))) != squares)
+            || (collect(zip(test, shorter)) != pairs) || (view(test).empty( ) != (n == 0)))
+        {
+            cout << "view, filter, transform or zip went wrong on " << n << " items." << endl;
+            return 0;
+        }
+        for (size_t count = 0; count <= n + 2; ++count)
+        {
+            if ((collect(take(test, count)) != first(items, 0, count))
+                || (collect(drop(test, count)) != first(items, count, ALL))
+                || (take(test, count).empty( ) != ((count == 0) || (n == 0))))
+            {
+                cout << "take or drop of " << count << " from " << n << " items went wrong." << endl;
+                return 0;
+            }
+        }
+        for (size_t spot = 0; spot <= n; ++spot)
+        {
+            sequence<int> moving = make(items, spot);
+
+            if ((collect(slice(moving)) != first(items, spot, ALL))
+                || (collect(slice(moving, 3)) != first(items, spot, 3)))
+            {
+                cout << "slice with the cursor at " << spot << " of " << n << " went wrong." << endl;
+                return 0;
+            }
+        }
+        if ((collect(view(test)) != items) || (test.position( ) != n / 2))
+        {
+            cout << "A view changed the sequence it looks at." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this first function have been passed." << endl;
+    return POINTS[1];
+}
+
+
+// **************************************************************************
+// int test2( )
+//   Checks stacks of views (including temporaries), to_sequence of them
+//   (which must give a sequence with no current item), views of vectors and
+//   writing through a view. Returns POINTS[2] if the tests are passed.
+//   Otherwise returns 0.
+// **************************************************************************
+int test2( )
+{
+    mt19937 random(34);
+
+    cout << "Checking stacked views and to_sequence ... ";
+    cout.flush( );
+    for (int round = 0; round < 200; ++round)
+    {
+        vector<int> items = random_items(random, random( ) % 40);
+        sequence<int> test = make(items, 0);
+        vector<long> expected;
+        size_t skipped = 0;
+
+        // The squares of the even items after the first two, at most five.
+        for (size_t i = 0; i < items.size( ); ++i)
+        {
+            if (items[i] % 2 != 0)
+                continue;
+            if (skipped++ < 2)
+                continue;
+            if (expected.size( ) < 5)
+                expected.push_back(long(items[i]) * items[i]);
+        }
+        sequence<long> built = to_sequence(take(transform(drop(filter(test, is_even( )), 2), square( )), 5));
+        if ((collect(take(transform(drop(filter(test, is_even( )), 2), square( )), 5)) != expected)
+            || (collect(view(built)) != expected) || built.is_item( ) || (built.size( ) != expected.size( )))
+        {
+            cout << "A stack of filter, drop, transform and take went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking views of vectors and of strings ... ";
+    cout.flush( );
+    {
+        vector<int> items = random_items(random, 30);
+        vector<string> names;
+        vector<string> expected;
+
+        for (size_t i = 0; i < items.size( ); ++i)
+        {
+            names.push_back(string(30, 'v') + to_string(items[i]));
+            if (items[i] > 0)
+                expected.push_back(names.back( ));
+        }
+        auto positive = [](const pair<int, string>& p) { return p.first > 0; };
+        auto name = [](const pair<int, string>& p) { return p.second; };
+        sequence<string> built = to_sequence(transform(filter(zip(items, names), positive), name));
+
+        if (collect(view(built)) != expected)
+        {
+            cout << "A view of two vectors went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking writes through a view ... ";
+    cout.flush( );
+    {
+        vector<int> items = random_items(random, 25);
+        sequence<int> test = make(items, 10);
+
+        for (int& x : slice(test, 5))
+            x = 1000;
+        for (int& x : filter(test, [](int x) { return x < 0; }))
+            x = -x;
+        for (size_t i = 0; i < items.size( ); ++i)
+        {
+            if ((i >= 10) && (i < 15))
+                items[i] = 1000;
+            else if (items[i] < 0)
+                items[i] = -items[i];
+        }
+        if ((collect(view(test)) != items) || (test.current( ) != 1000))
+        {
+            cout << "Writes through slice and filter went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this second function have been passed." << endl;
+    return POINTS[2];
+}
+
+
+// **************************************************************************
+// int test3( )
+//   Counts the calls made to a predicate and a function: making a view must
+//   call neither, transform must call its function once per dereference,
+//   and take over a filter must stop testing items soon after the last one
+//   it takes. Returns POINTS[3] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test3( )
+{
+    sequence<int> test;
+
+    for (int i = 0; i < 1000; ++i)
+        test.attach(i);
+
+    cout << "Checking that making views calls nothing ... ";
+    cout.flush( );
+    calls = 0;
+    {
+        filter_view<sequence<int>::iterator, is_even> evens = filter(test, is_even( ));
+        transform_view<sequence<int>::iterator, square> squares = transform(test, square( ));
+        take_view<transform_view<sequence<int>::iterator, square>::iterator> few = take(squares, 3);
+
+        if (calls != 0)
+        {
+            cout << "Making a filter or transform view made " << calls << " calls." << endl;
+            return 0;
+        }
+        if ((*few.begin( ) != 0) || (calls != 1) || (*evens.begin( ) != 0) || (calls != 2))
+        {
+            cout << "Reaching the first element made the wrong number of calls." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking that transform calls once per dereference ... ";
+    cout.flush( );
+    calls = 0;
+    {
+        long total = 0;
+
+        for (long x : transform(test, square( )))
+            total += x;
+        if ((calls != 1000) || (total != 332833500L))
+        {
+            cout << "Summing 1000 squares made " << calls << " calls." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking that take stops early ... ";
+    cout.flush( );
+    calls = 0;
+    {
+        vector<int> got = collect(take(filter(test, is_even( )), 4));
+
+        // 0 to 6 are tested on the way to the fourth; stepping past it tests 7 and 8.
+        if ((got != vector<int>{ 0, 2, 4, 6 }) || (calls > 9))
+        {
+            cout << "Taking 4 even items of 1000 made " << calls << " calls." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "All tests of this third function have been passed." << endl;
+    return POINTS[3];
+}
+
+
+// **************************************************************************
+// int test4( )
+//   Checks that view iterators are default constructible and can be
+//   assigned even when they carry a lambda, that exhausted take and zip
+//   iterators compare equal to end( ), that a copy of a view is independent
+//   of the original, and (with C++20 ranges) that the views are forward
+//   ranges that combine with std::views and std::ranges algorithms. Returns
+//   POINTS[4] if the tests are passed. Otherwise returns 0.
+// **************************************************************************
+int test4( )
+{
+    sequence<int> test;
+    int limit = 5;
+
+    for (int i = 0; i < 10; ++i)
+        test.attach(i);
+
+    cout << "Checking iterators that carry lambdas ... ";
+    cout.flush( );
+    {
+        auto below = filter(test, [limit](int x) { return x < limit; });
+        decltype(below.begin( )) it;
+        decltype(below.begin( )) other = below.begin( );
+
+        it = below.begin( );
+        ++it;
+        other++;
+        if ((*it != 1) || (it != other) || (collect(below) != vector<int>{ 0, 1, 2, 3, 4 }))
+        {
+            cout << "A default-constructed filter iterator could not be assigned." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking exhausted take and zip iterators ... ";
+    cout.flush( );
+    {
+        take_view<sequence<int>::iterator> three = take(test, 3);
+        sequence<int> two;
+        two.attach(1);
+        two.attach(2);
+        auto pairs = zip(test, two);
+        take_view<sequence<int>::iterator>::iterator t = three.begin( );
+        auto z = pairs.begin( );
+
+        ++t; ++t; ++t;
+        ++z; ++z;
+        if ((t != three.end( )) || (z != pairs.end( )) || take(test, 0).begin( ) != take(test, 0).end( ))
+        {
+            cout << "An exhausted iterator was not equal to end( )." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+    cout << "Checking copies of views ... ";
+    cout.flush( );
+    {
+        auto odd = [](int x) { return x % 2 != 0; };
+        auto odds = filter(test, odd);
+        auto copy = odds;
+
+        odds = filter(drop(test, 4), odd);
+        if ((collect(copy) != vector<int>{ 1, 3, 5, 7, 9 }) || (collect(odds) != vector<int>{ 5, 7, 9 }))
+        {
+            cout << "A copy of a view went wrong." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+
+#if defined(__cpp_lib_ranges)
+    cout << "Checking the views with std::ranges ... ";
+    cout.flush( );
+    {
+        static_assert(std::ranges::forward_range<filter_view<sequence<int>::iterator, is_even> >);
+        static_assert(std::ranges::forward_range<transform_view<sequence<int>::iterator, square> >);
+        static_assert(std::ranges::view<take_view<sequence<int>::iterator> >);
+        static_assert(std::ranges::forward_range<zip_view<sequence<int>::iterator, sequence<int>::iterator> >);
+        vector<int> got;
+
+        for (int x : filter(test, is_even( )) | std::views::take(3))
+            got.push_back(x);
+        if ((got != vector<int>{ 0, 2, 4 })
+            || (std::ranges::count_if(transform(test, square( )), [](long x) { return x > 10; }) != 6))
+        {
+            cout << "A view did not combine with std::views or std::ranges." << endl;
+            return 0;
+        }
+    }
+    cout << "Passed." << endl;
+#endif
+
+    cout << "All tests of this fourth function have been passed." << endl;
+    return POINTS[4];
+}
+
+
+int run_a_test(int number, const char message[], int test_function( ), int max)
+{
+    int result;
+
+    cout << endl << "START OF TEST " << number << ":" << endl;
+    cout << message << " (" << max << " points)." << endl;
+    result = test_function( );
+    if (result > 0)
+    {
+        cout << "Test " << number << " got " << result << " points";
+        cout << " out of a possible " << max << "." << endl;
+    }
+    else
+        cout << "Test " << number << " failed." << endl;
+    cout << "END OF TEST " << number << "." << endl << endl;
+
+    return result;
+}
+
+
+// **************************************************************************
+// int main( )
+//   The main program calls all tests and prints the sum of all points
+//   earned from the tests.
+// **************************************************************************
+int main( )
+{
+    int sum = 0;
+
+    cout << "Running " << DESCRIPTION[0] << endl;
+    sum += run_a_test(1, DESCRIPTION[1], test1, POINTS[1]);
+    sum += run_a_test(2, DESCRIPTION[2], test2, POINTS[2]);
+    sum += run_a_test(3, DESCRIPTION[3], test3, POINTS[3]);
+    sum += run_a_test(4, DESCRIPTION[4], test4, POINTS[4]);
+
+    cout << sum << " points out of the " << POINTS[0];
+    cout << " points from this test program.\n";
+    return (sum == POINTS[0]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,124 @@
+// FILE: sharded_bench.cpp
+// Benchmark for sharded_sequence (see sharded_sequence.h).
+//
+// DESCRIPTION:
+// For 1, 2, 4, ... up to max_threads threads, every thread attaches
+// operations items, first to one sequence<long> shared by all of them
+// behind a single mutex, then to a sharded_sequence<long> with one shard
+// per core. The run prints the total attaches per second of each, and the
+// time concatenate takes to turn the sharded_sequence into one sequence.
+// With the single sequence the threads take turns at its tail, so the total
+// stays flat (or falls, as the lock's cache line moves between cores) as
+// threads are added; with the shards it should grow with the thread count
+// up to the number of cores. concatenate should take microseconds whatever
+// the number of items, since it relinks one list per shard.
+//
+// Build and run:
+//     g++ -std=c++17 -O2 -pthread sharded_bench.cpp -o sharded_bench
+//     ./sharded_bench 64
+// The optional arguments are the largest thread count (default 64) and the
+// attaches per thread (default 1000000).
+
+#include <chrono>               // Provides steady_clock
+#include <cstdlib>              // Provides size_t, strtoul
+#include <iostream>             // Provides cout
+#include <mutex>                // Provides mutex, lock_guard
+#include <thread>               // Provides thread
+#include <vector>               // Provides vector
+#include "sharded_sequence.h"   // Provides the sharded_sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+// Timer returning the seconds since construction.
+class stopwatch
+{
+public:
+    stopwatch( ) : started(chrono::steady_clock::now( )) { }
+    double seconds( ) const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now( ) - started).count( );
+    }
+private:
+    chrono::steady_clock::time_point started;
+};
+
+// **************************************************************************
+// void attach_locked(sequence<long>& shared, mutex& lock, size_t operations)
+// void attach_sharded(sharded_sequence<long>& shared, size_t operations)
+//   Postcondition: operations items have been attached to shared, the first
+//   under lock, one at a time.
+// **************************************************************************
+void attach_locked(sequence<long>& shared, mutex& lock, size_t operations)
+{
+    for (size_t i = 0; i < operations; ++i)
+    {
+        lock_guard<mutex> hold(lock);
+        shared.attach(long(i));
+    }
+}
+
+void attach_sharded(sharded_sequence<long>& shared, size_t operations)
+{
+    for (size_t i = 0; i < operations; ++i)
+        shared.attach(long(i));
+}
+
+// Starts threads running job, waits for all of them and returns the seconds
+// that took.
+template<class Job>
+double run_threads(size_t threads, Job job)
+{
+    vector<thread> workers;
+    stopwatch timer;
+
+    for (size_t t = 0; t < threads; ++t)
+        workers.push_back(thread(job));
+    for (size_t t = 0; t < threads; ++t)
+        workers[t].join( );
+    return timer.seconds( );
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_threads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64;
+    size_t operations = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000000;
+
+    cout << operations << " attaches per thread, "
+         << thread::hardware_concurrency( ) << " cores" << endl;
+    cout << "threads   one lock (Mops/s)   sharded (Mops/s)   concatenate (us)" << endl;
+    cout.precision(1);
+    cout << fixed;
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        sequence<long> single;
+        mutex single_lock;
+        sharded_sequence<long> sharded;
+        double locked_seconds;
+        double sharded_seconds;
+        double concatenate_seconds;
+
+        locked_seconds = run_threads(threads, [&]( ) { attach_locked(single, single_lock, operations); });
+        sharded_seconds = run_threads(threads, [&]( ) { attach_sharded(sharded, operations); });
+        {
+            stopwatch timer;
+            sequence<long> all = sharded.concatenate( );
+            concatenate_seconds = timer.seconds( );
+            if (all.size( ) != single.size( ))
+            {
+                cout << "size mismatch: " << all.size( ) << " != " << single.size( ) << endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        cout.width(7);
+        cout << threads;
+        cout.width(20);
+        cout << double(threads * operations) / locked_seconds / 1e6;
+        cout.width(19);
+        cout << double(threads * operations) / sharded_seconds / 1e6;
+        cout.width(19);
+        cout << concatenate_seconds * 1e6 << endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+// FILE: sharded_sequence.cxx
+// CLASS IMPLEMENTED: sharded_sequence (see sharded_sequence.h for
+// documentation)
+// INVARIANT for the sharded_sequence class:
+//   1. table holds many_shards shards (many_shards > 0), each a sequence and
+//      the mutex that guards it, aligned so that no two share a cache line.
+//
+//   2. Every shard's sequence has its last item as its current item, or no
+//      current item, so that sequence::attach adds at its end.
+//
+//   3. A const_iterator is at shard index's item *within, or at end( ) with
+//      index == many_shards and within at the end of a sequence. ++ moves
+//      past empty shards, so within is never at the end of a shard before
+//      the last.
+
+#include <atomic>     // Provides atomic for the thread numbers
+#include <cassert>    // Provides assert
+#include <thread>     // Provides thread::hardware_concurrency
+
+namespace scu_coen70_6B
+{
+    inline std::size_t sharded_sequence_ticket( )
+    {
+        static std::atomic<std::size_t> next_ticket(0);
+        static thread_local std::size_t ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+
+        return ticket;
+    }
+
+    // ITERATOR
+    template<class Item>
+    sharded_sequence<Item>::const_iterator::const_iterator(const sharded_sequence* source, std::size_t first)
+        : owner(source), index(first)
+    {
+        if (index < owner->many_shards)
+        {
+            within = owner->table[index].items.begin( );
+            skip_empty( );
+        }
+    }
+
+    // Moves on from the end of a shard to the first item of the next
+    // non-empty one, or to end( ).
+    template<class Item>
+    void sharded_sequence<Item>::const_iterator::skip_empty( )
+    {
+        while (within == owner->table[index].items.end( ))
+        {
+            if (++index == owner->many_shards)
+            {
+                within = typename sequence<Item>::const_iterator( );
+                return;
+            }
+            within = owner->table[index].items.begin( );
+        }
+    }
+
+    template<class Item>
+    typename sharded_sequence<Item>::const_iterator& sharded_sequence<Item>::const_iterator::operator ++( )
+    {
+        ++within;
+        skip_empty( );
+        return *this;
+    }
+
+    template<class Item>
+    typename sharded_sequence<Item>::const_iterator sharded_sequence<Item>::const_iterator::operator ++(int)
+    {
+        const_iterator orig(*this);
+
+        ++*this;
+        return orig;
+    }
+
+    // SHARDED SEQUENCE
+    template<class Item>
+    sharded_sequence<Item>::sharded_sequence(std::size_t shards)
+    {
+        if (shards == 0)
+            shards = std::thread::hardware_concurrency( );
+        if (shards == 0)
+            shards = 1;
+        many_shards = shards;
+        table.reset(new shard[many_shards]);
+    }
+
+    template<class Item>
+    void sharded_sequence<Item>::attach_to(std::size_t shard_index, const Item& entry)
+    {
+        assert(shard_index < many_shards);
+        std::lock_guard<std::mutex> hold(table[shard_index].lock);
+
+        table[shard_index].items.attach(entry);
+    }
+
+    template<class Item>
+    template<class InputIterator>
+    void sharded_sequence<Item>::append(InputIterator first, InputIterator last)
+    {
+        shard& home = table[home_shard( )];
+        std::lock_guard<std::mutex> hold(home.lock);
+
+        // append leaves the current item alone, which is no longer the last
+        home.items.append(first, last);
+        home.items.seek_end( );
+    }
+
+    // Takes each shard's whole list in turn and links it after the last.
+    template<class Item>
+    sequence<Item> sharded_sequence<Item>::concatenate( )
+    {
+        sequence<Item> answer;
+
+        for (std::size_t i = 0; i < many_shards; ++i)
+        {
+            std::lock_guard<std::mutex> hold(table[i].lock);
+            answer.splice_back(table[i].items);
+        }
+        return answer;
+    }
+
+    template<class Item>
+    void sharded_sequence<Item>::clear( )
+    {
+        for (std::size_t i = 0; i < many_shards; ++i)
+        {
+            std::lock_guard<std::mutex> hold(table[i].lock);
+            table[i].items.clear( );
+        }
+    }
+
+    template<class Item>
+    typename sharded_sequence<Item>::size_type sharded_sequence<Item>::size( ) const
+    {
+        size_type answer = 0;
+
+        for (std::size_t i = 0; i < many_shards; ++i)
+            answer += shard_size(i);
+        return answer;
+    }
+
+    template<class Item>
+    typename sharded_sequence<Item>::size_type sharded_sequence<Item>::shard_size(std::size_t shard_index) const
+    {
+        assert(shard_index < many_shards);
+        std::lock_guard<std::mutex> hold(table[shard_index].lock);
+
+        return table[shard_index].items.size( );
+    }
+
+    template<class Item>
+    template<class Function>
+    void sharded_sequence<Item>::for_each(Function f) const
+    {
+        typename sequence<Item>::const_iterator it;
+
+        for (std::size_t i = 0; i < many_shards; ++i)
+        {
+            std::lock_guard<std::mutex> hold(table[i].lock);
+            for (it = table[i].items.begin( ); it != table[i].items.end( ); ++it)
+                f(*it);
+        }
+    }
+}
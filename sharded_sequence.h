@@ -0,0 +1,193 @@
+// FILE: sharded_sequence.h
+// CLASS PROVIDED: sharded_sequence (part of the namespace scu_coen70_6B)
+// A sequence split into shards, so that many threads can add items at once.
+// A single sequence (sequence4.h) has one tail_ptr, and threads that attach
+// to it take turns. A sharded_sequence keeps one sequence per shard, each
+// with its own head_ptr, tail_ptr and lock, and a thread attaches to the
+// shard it was given the first time it used any sharded_sequence: threads
+// are dealt out to the shards in turn, so as long as there are no more
+// threads than shards, no two of them share a lock or a tail:
+//
+//     sharded_sequence<event> events;            // one shard per core
+//     ...                                        // on every worker thread:
+//     events.attach(e);                          // its own shard's tail
+//     ...                                        // once the workers are done:
+//     sequence<event> all = events.concatenate( );   // O(shards), no copy
+//
+// The items of a shard keep the order its threads attached them in; there is
+// no order between shards. Each shard's sequence takes its nodes from the
+// shared node_pool, whose per-thread caches (see node_pool.h) keep the
+// allocation off any shared lock too.
+//
+// TYPEDEFS for the sharded_sequence class:
+//   typedef ____ value_type
+//   typedef ____ size_type
+//     As in sequence4.h.
+//
+//   const_iterator
+//     A forward iterator over every item, shard by shard (see begin( )).
+//
+// CONSTRUCTOR for the sharded_sequence class:
+//   sharded_sequence(std::size_t shards = 0)
+//     Postcondition: The sequence is empty, with the given number of shards
+//     (0 means one per core, as std::thread::hardware_concurrency( ) reports
+//     them, or 1 if it does not know).
+//
+// MODIFICATION MEMBER FUNCTIONS for the sharded_sequence class:
+//   void attach(const value_type& entry)
+//     Postcondition: entry has been added at the end of the calling thread's
+//     shard (home_shard( )).
+//
+//   void attach_to(std::size_t shard, const value_type& entry)
+//     Precondition: shard < shards( ).
+//     Postcondition: entry has been added at the end of the given shard.
+//
+//   template<class InputIterator>
+//   void append(InputIterator first, InputIterator last)
+//     Postcondition: Copies of the items in [first, last) have been added at
+//     the end of the calling thread's shard, in order, under one lock (see
+//     sequence::append).
+//
+//   sequence<value_type> concatenate( )
+//     Postcondition: The return value holds every item, shard 0's first,
+//     then shard 1's, and so on, and the sharded_sequence is empty. The
+//     shards' lists are relinked end to end (see sequence::splice_back), so
+//     this takes O(shards) whatever the number of items. The result has no
+//     current item.
+//
+//   void clear( )
+//     Postcondition: Every shard is empty.
+//
+// CONSTANT MEMBER FUNCTIONS for the sharded_sequence class:
+//   std::size_t shards( ) const
+//     Postcondition: The return value is the number of shards.
+//
+//   std::size_t home_shard( ) const
+//     Postcondition: The return value is the shard that attach and append
+//     use on the calling thread.
+//
+//   size_type size( ) const
+//     Postcondition: The return value is the number of items in all shards.
+//
+//   size_type shard_size(std::size_t shard) const
+//     Precondition: shard < shards( ).
+//     Postcondition: The return value is the number of items in that shard.
+//
+//   template<class Function>
+//   void for_each(Function f) const
+//     Postcondition: f(item) has been called for every item, shard by shard
+//     as concatenate would order them. Each shard is locked while f visits
+//     it, so other threads may keep attaching (to the shards not being
+//     visited, or after the visit to that shard).
+//
+// STANDARD ITERATOR MEMBER FUNCTIONS (provide a forward iterator):
+//   const_iterator begin( ) const
+//   const_iterator end( ) const
+//     Postcondition: [begin( ), end( )) is every item, shard by shard as
+//     concatenate would order them, with empty shards skipped. The
+//     iterators take no lock: no thread may change the sharded_sequence
+//     while they are in use.
+//
+// THREAD SAFETY:
+//   attach, attach_to, append, concatenate, clear, size, shard_size and
+//   for_each may be called from any number of threads at once. Attaches on
+//   threads with different home shards do not wait for each other; more
+//   threads than shards share locks. concatenate and clear lock every
+//   shard, one at a time, so an attach running alongside lands either in
+//   the result or in the emptied shard.
+//
+// VALUE SEMANTICS:
+//   A sharded_sequence may not be copied or assigned (its locks cannot be);
+//   concatenate gives a sequence that can.
+//
+// DYNAMIC MEMORY USAGE by sharded_sequence:
+//   The constructor, attach, attach_to and append throw bad_alloc if there
+//   is not enough memory, leaving the items as they were.
+
+#ifndef COEN_70_SHARDED_SEQUENCE_H
+#define COEN_70_SHARDED_SEQUENCE_H
+#include <cstdlib>      // Provides size_t
+#include <iterator>     // Provides forward_iterator_tag
+#include <memory>       // Provides unique_ptr
+#include <mutex>        // Provides mutex
+#include "sequence4.h"  // Provides the sequence class
+
+#ifndef SHARDED_SEQUENCE_ALIGN
+#define SHARDED_SEQUENCE_ALIGN 64   // Cache line size: no two shards share one
+#endif
+
+namespace scu_coen70_6B
+{
+    // The calling thread's number, dealt out in turn on first use; a thread's
+    // home shard is its number modulo the number of shards.
+    inline std::size_t sharded_sequence_ticket( );
+
+    template<class Item>
+    class sharded_sequence
+    {
+    public:
+        // TYPEDEFS
+        typedef Item value_type;
+        typedef typename sequence<Item>::size_type size_type;
+
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Item value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Item* pointer;
+            typedef const Item& reference;
+
+            const_iterator( ) : owner(NULL), index(0) { }
+            const Item& operator *( ) const { return *within; }
+            const_iterator& operator ++( );
+            const_iterator operator ++(int);
+            bool operator ==(const const_iterator& other) const
+                { return (index == other.index) && (within == other.within); }
+            bool operator !=(const const_iterator& other) const { return !(*this == other); }
+        private:
+            friend class sharded_sequence;
+
+            const_iterator(const sharded_sequence* source, std::size_t first);
+            void skip_empty( );
+
+            const sharded_sequence* owner;
+            std::size_t index;                                  // Shard of *within
+            typename sequence<Item>::const_iterator within;
+        };
+
+        // CONSTRUCTOR
+        explicit sharded_sequence(std::size_t shards = 0);
+        sharded_sequence(const sharded_sequence&) = delete;
+        sharded_sequence& operator =(const sharded_sequence&) = delete;
+        // MODIFICATION MEMBER FUNCTIONS
+        void attach(const value_type& entry) { attach_to(home_shard( ), entry); }
+        void attach_to(std::size_t shard, const value_type& entry);
+        template<class InputIterator>
+        void append(InputIterator first, InputIterator last);
+        sequence<Item> concatenate( );
+        void clear( );
+        // CONSTANT MEMBER FUNCTIONS
+        std::size_t shards( ) const { return many_shards; }
+        std::size_t home_shard( ) const { return sharded_sequence_ticket( ) % many_shards; }
+        size_type size( ) const;
+        size_type shard_size(std::size_t shard) const;
+        template<class Function>
+        void for_each(Function f) const;
+        // STANDARD ITERATOR MEMBER FUNCTIONS
+        const_iterator begin( ) const { return const_iterator(this, 0); }
+        const_iterator end( ) const { return const_iterator(this, many_shards); }
+    private:
+        struct alignas(SHARDED_SEQUENCE_ALIGN) shard
+        {
+            mutable std::mutex lock;
+            sequence<Item> items;
+        };
+
+        std::size_t many_shards;
+        std::unique_ptr<shard[]> table;
+    };
+}
+#include "sharded_sequence.cxx"
+#endif
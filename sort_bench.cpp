@@ -0,0 +1,160 @@
+// FILE: sort_bench.cpp
+// Benchmark for sequence::sort (see sequence4.h).
+//
+// DESCRIPTION:
+// Fills a sequence with many_records records of a random 64-bit key and a
+// 56-byte payload, and sorts it by key three ways, each on a fresh copy:
+//   copy + stable_sort   copies the records into a vector, runs
+//                        std::stable_sort (with std::execution::par where
+//                        the library has it) and copies them back.
+//   sort, 1 thread       sequence::sort_parallel(less, 1): list_sort alone.
+//   sort, N threads      sequence::sort_parallel(less, N), N = the number of
+//                        cores (or the third argument).
+// and checks that all three agree.
+//
+// The relinking sort never copies a record, while the vector sort copies
+// every one three times (out, while merging, back), so the gap narrows as
+// records grow; the vector sort walks memory in order, while every merge of
+// the list follows links to nodes that are scattered after the first pass.
+//
+// Build (the parallel algorithms of libstdc++ need TBB):
+//     g++ -std=c++17 -O2 -pthread sort_bench.cpp -o sort_bench -ltbb
+//     ./sort_bench 4000000
+// Without <execution>, or with -DSORT_BENCH_NO_EXECUTION, the vector sort
+// is std::stable_sort on one thread. The optional arguments are the number
+// of records (default 2000000), the thread count and the random seed.
+
+#include <algorithm>    // Provides stable_sort
+#include <chrono>       // Provides steady_clock
+#include <cstdlib>      // Provides size_t, strtoul
+#include <iostream>     // Provides cout
+#include <random>       // Provides mt19937_64
+#include <thread>       // Provides hardware_concurrency
+#include <vector>       // Provides vector
+#if !defined(SORT_BENCH_NO_EXECUTION) && defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>    // Provides execution::par
+#endif
+#endif
+#include "sequence4.h"  // Provides the sequence class
+using namespace std;
+using namespace scu_coen70_6B;
+
+struct record
+{
+    unsigned long long key;
+    char payload[56];
+};
+
+struct by_key
+{
+    bool operator ( )(const record& a, const record& b) const { return a.key < b.key; }
+};
+
+// Timer returning the seconds since construction.
+class stopwatch
+{
+public:
+    stopwatch( ) : started(chrono::steady_clock::now( )) { }
+    double seconds( ) const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now( ) - started).count( );
+    }
+private:
+    chrono::steady_clock::time_point started;
+};
+
+void report(const char* name, double seconds, size_t n)
+{
+    cout.width(22);
+    cout << left << name << right;
+    cout.width(10);
+    cout << seconds * 1e9 / double(n) << " ns/record" << endl;
+}
+
+// **************************************************************************
+// void vector_sort(sequence<record>& s)
+//   Postcondition: The items of s have been copied into a vector, stably
+//   sorted by key there, and copied back into s in sorted order.
+// **************************************************************************
+void vector_sort(sequence<record>& s)
+{
+    vector<record> items(s.begin( ), s.end( ));
+    size_t i = 0;
+
+#if defined(__cpp_lib_parallel_algorithm) && !defined(SORT_BENCH_NO_EXECUTION)
+    stable_sort(execution::par, items.begin( ), items.end( ), by_key( ));
+#else
+    stable_sort(items.begin( ), items.end( ), by_key( ));
+#endif
+    for (sequence<record>::iterator it = s.begin( ); it != s.end( ); ++it)
+        *it = items[i++];
+}
+
+bool same_order(const sequence<record>& a, const sequence<record>& b)
+{
+    sequence<record>::const_iterator j = b.begin( );
+
+    for (sequence<record>::const_iterator i = a.begin( ); i != a.end( ); ++i, ++j)
+    {
+        if (((*i).key != (*j).key) || ((*i).payload[0] != (*j).payload[0]))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 2000000;
+    unsigned threads = (argc > 2) ? unsigned(strtoul(argv[2], NULL, 10)) : thread::hardware_concurrency( );
+    unsigned seed = (argc > 3) ? unsigned(strtoul(argv[3], NULL, 10)) : 42;
+    mt19937_64 random(seed);
+    sequence<record> original;
+    record r;
+
+    if (threads == 0)
+        threads = 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        r.key = random( ) % (n / 4 + 1);       // Plenty of equal keys
+        for (size_t j = 0; j < sizeof(r.payload); ++j)
+            r.payload[j] = char(i >> (8 * (j % 4)));
+        original.attach(r);
+    }
+
+#if defined(__cpp_lib_parallel_algorithm) && !defined(SORT_BENCH_NO_EXECUTION)
+    cout << n << " records, vector sort with execution::par, " << threads << " threads" << endl;
+#else
+    cout << n << " records, serial vector sort, " << threads << " threads" << endl;
+#endif
+    cout.precision(1);
+    cout << fixed;
+
+    sequence<record> by_vector(original);
+    {
+        stopwatch timer;
+        vector_sort(by_vector);
+        report("copy + stable_sort", timer.seconds( ), n);
+    }
+
+    sequence<record> by_list(original);
+    {
+        stopwatch timer;
+        by_list.sort_parallel(by_key( ), 1);
+        report("sort, 1 thread", timer.seconds( ), n);
+    }
+
+    sequence<record> by_threads(original);
+    {
+        stopwatch timer;
+        by_threads.sort_parallel(by_key( ), threads);
+        report("sort, N threads", timer.seconds( ), n);
+    }
+
+    if (!same_order(by_vector, by_list) || !same_order(by_vector, by_threads))
+    {
+        cout << "MISMATCH between the sorts" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}